@@ -29,7 +29,9 @@ SOFTWARE.
 
 #include "CmdLineParser.h"
 #include "Common.h"
+#ifndef __linux__
 #include "XmlProfileParser.h"
+#endif
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -147,6 +149,305 @@ bool CmdLineParser::_GetRandomDataWriteBufferData(const string& sArg, UINT64& cb
     return fOk;
 }
 
+//
+// Parse compressible and dedupable write data of the form <compression>[:<dedup>[:<chunk>]], e.g. 2:3:8K
+//
+
+bool CmdLineParser::_ParseReducibleWriteData(const char *arg, vector<Target>& vTargets)
+{
+    double lfCompressionRatio, lfDedupRatio = 1;
+    UINT64 cbChunk = ReducibleDataPool::DefaultChunkSize;
+    char *rest = nullptr;
+
+    lfCompressionRatio = strtod(arg, &rest);
+    if (rest == arg)
+    {
+        fprintf(stderr, "ERROR: invalid compression ratio passed to -Zc\n");
+        return false;
+    }
+
+    if (*rest == ':')
+    {
+        arg = rest + 1;
+        lfDedupRatio = strtod(arg, &rest);
+        if (rest == arg)
+        {
+            fprintf(stderr, "ERROR: invalid dedup ratio passed to -Zc\n");
+            return false;
+        }
+    }
+
+    if (*rest == ':')
+    {
+        if (!_GetSizeInBytes(rest + 1, cbChunk, nullptr) || cbChunk >= MAXUINT32)
+        {
+            fprintf(stderr, "ERROR: invalid dedup chunk size passed to -Zc\n");
+            return false;
+        }
+    }
+    else if (*rest != '\0')
+    {
+        fprintf(stderr, "ERROR: invalid write data passed to -Zc; use -Zc<compression>[:<dedup>[:<chunk>]]\n");
+        return false;
+    }
+
+    // ranges are checked with the rest of the profile
+    for (auto &i : vTargets)
+    {
+        i.SetReducibleWriteData(lfCompressionRatio, lfDedupRatio, (UINT32)cbChunk);
+    }
+    return true;
+}
+
+//
+// Parse a block size mix of the form <size>:<weight>[,<size>:<weight>...], e.g. 4K:60,64K:30,1M:10
+//
+
+bool CmdLineParser::_ParseBlockSizeMix(const char *arg, vector<BlockSizeWeight>& vMix)
+{
+    vMix.clear();
+
+    while (*arg != '\0')
+    {
+        UINT64 ullBlockSize, ullWeight;
+        const char *rest = nullptr;
+
+        if (!_GetSizeInBytes(arg, ullBlockSize, &rest) || *rest != ':' ||
+            ullBlockSize == 0 || ullBlockSize >= MAXUINT32)
+        {
+            fprintf(stderr, "ERROR: invalid block size in block size mix passed to -b\n");
+            return false;
+        }
+
+        arg = rest + 1;
+        if (!Util::ParseUInt(arg, ullWeight, rest) || (*rest != ',' && *rest != '\0') ||
+            ullWeight == 0 || ullWeight > MAXUINT32)
+        {
+            fprintf(stderr, "ERROR: invalid weight in block size mix passed to -b\n");
+            return false;
+        }
+
+        vMix.push_back({ (DWORD)ullBlockSize, (UINT32)ullWeight });
+
+        arg = rest;
+        if (*arg == ',')
+        {
+            arg++;
+        }
+    }
+
+    return true;
+}
+
+//
+// Parse a sweep dimension of the form <o|t|b><point>[,<point>...], where each point is a value
+// or a range <from>-<to> of values doubling from <from> up to <to>, e.g. o1-32 or b4K,64K,1M
+//
+
+bool CmdLineParser::_ParseSweep(const char *arg, TimeSpan *pTimeSpan)
+{
+    const char chDimension = *arg++;
+    const bool fSize = (chDimension == 'b');
+    vector<DWORD> vdwPoints;
+
+    if (chDimension != 'o' && chDimension != 't' && chDimension != 'b')
+    {
+        fprintf(stderr, "ERROR: invalid sweep (-Y): use -Yo, -Yt or -Yb for outstanding IOs, threads or block sizes\n");
+        return false;
+    }
+
+    do
+    {
+        UINT64 ullFrom, ullTo;
+        const char *rest = nullptr;
+
+        bool fOk = fSize ? _GetSizeInBytes(arg, ullFrom, &rest) : Util::ParseUInt(arg, ullFrom, rest);
+        ullTo = ullFrom;
+        if (fOk && *rest == '-')
+        {
+            arg = rest + 1;
+            fOk = fSize ? _GetSizeInBytes(arg, ullTo, &rest) : Util::ParseUInt(arg, ullTo, rest);
+        }
+
+        if (!fOk || (*rest != ',' && *rest != '\0') ||
+            ullFrom == 0 || ullTo < ullFrom || ullTo >= MAXUINT32)
+        {
+            fprintf(stderr, "ERROR: invalid sweep point passed to -Y%c\n", chDimension);
+            return false;
+        }
+
+        for (UINT64 ullPoint = ullFrom; ullPoint <= ullTo; ullPoint *= 2)
+        {
+            vdwPoints.push_back(static_cast<DWORD>(ullPoint));
+        }
+
+        arg = rest;
+    } while (*arg++ == ',');
+
+    switch (chDimension)
+    {
+    case 'o':
+        pTimeSpan->SetSweepRequestCounts(vdwPoints);
+        break;
+    case 't':
+        pTimeSpan->SetSweepThreadCounts(vdwPoints);
+        break;
+    case 'b':
+        pTimeSpan->SetSweepBlockSizes(vdwPoints);
+        break;
+    }
+
+    return true;
+}
+
+// <seconds>, which may be fractional, in whole milliseconds
+bool CmdLineParser::_ParsePhaseSeconds(const char *arg, UINT32 *pulMilliseconds, const char **pRest)
+{
+    char *rest = nullptr;
+    double lfSeconds = strtod(arg, &rest);
+
+    *pRest = rest;
+    if (rest == arg || !(lfSeconds * 1000 >= 1 && lfSeconds * 1000 < MAXUINT32))
+    {
+        return false;
+    }
+
+    *pulMilliseconds = static_cast<UINT32>(lfSeconds * 1000 + 0.5);
+    return true;
+}
+
+// <seconds>[:<shape>][:<setting>...]
+//   shape: constant, ramp, sine<period>, square<period>[/<duty>]
+//   setting: i (IOPS), w (write ratio) or o (outstanding IOs), then <from>[-<to>]
+bool CmdLineParser::_ParsePhase(const char *arg, TimeSpan *pTimeSpan)
+{
+    LoadPhase phase;
+    UINT32 ulMilliseconds;
+    const char *rest = nullptr;
+    bool fRange = false;
+
+    if (!_ParsePhaseSeconds(arg, &ulMilliseconds, &rest))
+    {
+        fprintf(stderr, "ERROR: invalid load phase duration passed to -H\n");
+        return false;
+    }
+    phase.SetDurationInMilliseconds(ulMilliseconds);
+
+    while (*rest == ':')
+    {
+        arg = rest + 1;
+
+        if (!strncmp(arg, "constant", 8))
+        {
+            phase.SetShape(PhaseShape::Constant);
+            rest = arg + 8;
+        }
+        else if (!strncmp(arg, "ramp", 4))
+        {
+            phase.SetShape(PhaseShape::Ramp);
+            rest = arg + 4;
+        }
+        else if (!strncmp(arg, "sine", 4) || !strncmp(arg, "square", 6))
+        {
+            bool fSine = (arg[1] == 'i');
+
+            phase.SetShape(fSine ? PhaseShape::Sine : PhaseShape::Square);
+            if (!_ParsePhaseSeconds(arg + (fSine ? 4 : 6), &ulMilliseconds, &rest))
+            {
+                fprintf(stderr, "ERROR: invalid load phase period passed to -H; use sine<seconds> or square<seconds>[/<duty>]\n");
+                return false;
+            }
+            phase.SetPeriodInMilliseconds(ulMilliseconds);
+
+            if (!fSine && *rest == '/')
+            {
+                UINT32 ulDuty;
+                if (!Util::ParseUInt(rest + 1, ulDuty, rest))
+                {
+                    fprintf(stderr, "ERROR: invalid load phase square duty passed to -H\n");
+                    return false;
+                }
+                phase.SetDutyPercent(ulDuty);
+            }
+        }
+        else if (*arg == 'i' || *arg == 'w' || *arg == 'o')
+        {
+            UINT32 ulFrom, ulTo;
+
+            if (!Util::ParseUInt(arg + 1, ulFrom, rest))
+            {
+                fprintf(stderr, "ERROR: invalid load phase setting passed to -H: %s\n", arg);
+                return false;
+            }
+
+            ulTo = ulFrom;
+            if (*rest == '-')
+            {
+                fRange = true;
+                if (!Util::ParseUInt(rest + 1, ulTo, rest))
+                {
+                    fprintf(stderr, "ERROR: invalid load phase setting passed to -H: %s\n", arg);
+                    return false;
+                }
+            }
+
+            switch (*arg)
+            {
+            case 'i':
+                phase.SetIOPS(ulFrom, ulTo);
+                break;
+            case 'w':
+                phase.SetWriteRatio(ulFrom, ulTo);
+                break;
+            case 'o':
+                phase.SetQueueDepth(ulFrom, ulTo);
+                break;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: unrecognized load phase shape or setting passed to -H: %s\n", arg);
+            return false;
+        }
+    }
+
+    if (*rest != '\0')
+    {
+        fprintf(stderr, "ERROR: invalid load phase passed to -H; use -H<seconds>[:<shape>][:<setting>...]\n");
+        return false;
+    }
+
+    if (fRange && phase.GetShape() == PhaseShape::Constant)
+    {
+        fprintf(stderr, "ERROR: a constant load phase (-H) states one value for each setting; use ramp, sine or square to vary it\n");
+        return false;
+    }
+
+    pTimeSpan->AddPhase(phase);
+    return true;
+}
+
+// <value>[i]: bytes per millisecond, or with the i qualifier IOPS
+bool CmdLineParser::_ParseTotalThroughput(const char *arg, DWORD *pdwValue, bool *pfIOPS)
+{
+    UINT64 ullValue;
+    const char *rest = nullptr;
+
+    if (!Util::ParseUInt(arg, ullValue, rest) || ullValue == 0 || ullValue > MAXDWORD)
+    {
+        return false;
+    }
+
+    *pfIOPS = (*rest == 'i');
+    if (*pfIOPS)
+    {
+        rest++;
+    }
+
+    *pdwValue = static_cast<DWORD>(ullValue);
+    return (*rest == '\0');
+}
+
 void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
 {
     // ISSUE-REVIEW: this formats badly in the default 80 column command prompt
@@ -160,6 +461,7 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "     file_path\n"
         "     #<physical drive number>\n"
         "     <drive_letter>:\n"
+        "     directory_path (with -m)\n"
         "\n"
         "Sizes, offsets and lengths are specified as integer bytes, or with an\n"
         "optional suffix of KMGT (KiB/MiB/GiB/TiB) or b (for blocks, see -b).\n"
@@ -169,7 +471,7 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "Available options:\n"
         "  -?                    display usage information\n"
         "  -:<flags>             experimental behaviors, as a bitmask of flags. current:\n"
-        "                          1 - allow throughput rate limit sleeps >1ms if indicated by rate\n"
+        "                          1 - (no longer used; throughput rate limit waits are always calculated from the rate)\n"
         "  -ag                   group affinity - threads assigned round-robin to CPUs by processor groups, 0 - n.\n"
         "                          Groups are filled from lowest to highest processor before moving to the next.\n"
         "                          [default; use -n to disable default affinity]\n"
@@ -180,7 +482,17 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "                          Examples: -a0,1,2 and -ag0,0,1,2 are equivalent.\n"
         "                                    -ag0,0,1,2,g1,0,1,2 specifies the first three CPUs in groups 0 and 1.\n"
         "                                    -ag0,0,1,2,g1,0,1,2 and -ag0,0,1,2 -ag1,0,1,2 are equivalent.\n"
+        "  -A[<count>]           use Linux AIO (io_submit/io_getevents) instead of I/O Completion Ports (Linux only)\n"
+        "                          IOs are submitted in batches, and completions reaped in batches once at least\n"
+        "                          <count> are available, or as many as are in flight if fewer [default=1]\n"
+        "                          (conflicts with -u and -x; IO is only asynchronous for unbuffered targets, -Su/-Sh)\n"
         "  -b<size>              IO size, defines the block \'b\' for sizes stated in units of blocks [default=64K]\n"
+        "  -b<size>:<weight>[,<size>:<weight>...]\n"
+        "                        block size mix; each IO is of one of the sizes, chosen in proportion to its weight.\n"
+        "                          Buffers are sized for the largest; the smallest defines the block \'b\' and the default\n"
+        "                          alignment. Sequential IO advances by the stride or the size of the IO, whichever is\n"
+        "                          larger. Results are also broken down by size.\n"
+        "                          Example: -b4K:60,64K:30,1M:10\n"
         "  -B<base>[:length]     bounds; specify range of target to issue IO to - base offset and length\n"
         "                          (default: IO is issued across the entire target)\n"
         "  -c<size>              create file targets of the given size. Conflicts with non-file target specifications.\n"
@@ -200,13 +512,64 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "  -g<value>[i]          throughput per-thread per-target throttled to given value; defaults to bytes per millisecond\n"
         "                          With the optional i qualifier the value is IOPS of the specified block size (-b).\n"
         "                          Throughput limits cannot be specified when using completion routines (-x)\n"
+        "                          IOs are paced by a token bucket: each waits until a block's worth of throughput has\n"
+        "                          accrued since the last. Waits are slept in whole milliseconds; see -gs.\n"
         "                          [default: no limit]\n"
+        "  -gs<microseconds>     spin (poll) rather than sleep through the last <microseconds> of each -g throughput or\n"
+        "                          -j think time wait, for even pacing below the millisecond at the cost of CPU. A\n"
+        "                          value of at least the wait spins it entirely. [default: waits are slept]\n"
+        "  -gt<value>[i]         throughput per-target throttled to given value across all threads, as for -g. Threads\n"
+        "                          draw from a shared token bucket without locking, up to 100us of throughput at a time.\n"
+        "                          Can be combined with -g and -gr; an IO waits for all of them. [default: no limit]\n"
+        "  -gr<value>[i]         throughput of the whole run (all targets, all threads) throttled to given value, as for\n"
+        "                          -gt. With the i qualifier IOs of every size count the same. [default: no limit]\n"
+        "  -ga<iops>[p]          open-loop load: IOs arrive per-thread per-target at the given rate, independent of\n"
+        "                          completions, and latency is measured from each IO's scheduled arrival. Arrivals\n"
+        "                          are evenly spaced, or with the p qualifier Poisson distributed. Outstanding IOs are\n"
+        "                          still bounded by -o; arrivals beyond it wait and their wait counts toward latency.\n"
+        "                          [default: closed-loop, an IO is issued as soon as another completes]\n"
         "  -h                    deprecated, see -Sh\n"
+        "  -H<seconds>[:<shape>][:<setting>...]\n"
+        "                        load phase: for <seconds>, the settings stated follow the shape from their first\n"
+        "                          to their second value. Phases run in the order given, from the start of the\n"
+        "                          measured interval, and repeat for as long as it lasts; warmup runs at the start\n"
+        "                          of the first. Results are also broken down by phase. Settings are <from>[-<to>] of\n"
+        "                          i : IOPS of the whole run (all targets, all threads), as for -gr<value>i\n"
+        "                          w : percentage of writes, in place of -w\n"
+        "                          o : outstanding IOs per thread, up to the requests each has (-o/-O)\n"
+        "                          Settings a phase does not state are left as the timespan and targets have them.\n"
+        "                          Shapes: constant (one value) [default]; ramp from <from> to <to>; sine<period> from\n"
+        "                          <from> to <to> and back each <period> seconds; square<period>[/<duty>] <from>, then\n"
+        "                          <to> for the last <duty> percent [default=50] of each <period> seconds.\n"
+        "                          Example: -H60:ramp:i1000-20000 -H300:sine60:i5000-20000:w10-50 -H30:square10/20:i5000-40000\n"
         "  -i<count>             number of IOs per burst; see -j [default: inactive]\n"
         "  -j<milliseconds>      interval in <milliseconds> between issuing IO bursts; see -i [default: inactive]\n"
         "  -I<priority>          Set IO priority to <priority>. Available values are: 1-very low, 2-low, 3-normal (default)\n"
+        "  -K<percentile>:<milliseconds>[:<count>]\n"
+        "                        latency SLO search: run the timespan repeatedly, varying the outstanding IOs per\n"
+        "                          target per thread (-o) from 1 up to <count> [default=256], to find the most IOPS\n"
+        "                          whose latency at <percentile> stays within <milliseconds>. Each run lasts -W and -d.\n"
+        "                          The IOPS/latency curve is reported, followed by the results of the run at the knee.\n"
+        "                          Implies -L. Example: -K99.9:2 finds the most IOPS with p99.9 latency of 2ms or less\n"
         "  -l                    Use large pages for IO buffers\n"
         "  -L                    measure latency statistics\n"
+        "  -Lt:<file>            measure latency statistics and capture a binary trace of each IO completed during\n"
+        "                          the measured interval to <file> for offline analysis\n"
+        "  -Ld<digits>           measure latency statistics, resolving latencies to 1-5 significant digits [default=3]\n"
+        "                          more digits cost more memory and more buckets to walk for percentiles\n"
+        "  -m<count>             file set: each target is a directory of <count> files, file0.dat ... file<count-1>.dat,\n"
+        "                          each IO is directed to one of them. With -c the files are created, in parallel, of\n"
+        "                          that size; else they must exist and are taken to be the size of file0.dat\n"
+        "  -mz<theta>            IO is spread over the files of the set with a Zipf skew, 0 < theta < 1, the first\n"
+        "                          file the hottest [default: uniform]\n"
+        "  -mo                   open and close the file around each IO. The open and close are timed as metadata\n"
+        "                          operations, and are not part of the IO's latency\n"
+        "  -mm<percentage>[:<operations>]  percentage of IOs which are metadata operations in the set's directory,\n"
+        "                          equally of the <operations> given [default=csur]:\n"
+        "                          c : create, s : stat of a file of the set, u : unlink, r : rename\n"
+        "                          creates, unlinks and renames act on scratch files of each thread's own, which are\n"
+        "                          removed when it ends. -wf, -wt and -mm together are at most 100%%. Each operation\n"
+        "                          is reported with its own count and latency (with -L)\n"
         "  -n                    disable default affinity (-a)\n"
         "  -N<vni>               specify the flush mode for memory mapped I/O\n"
         "                          v : uses the FlushViewOfFile API\n"
@@ -222,11 +585,18 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "                          (ignored if -r is specified, makes sense only with -o2 or greater)\n"
         "  -P<count>             enable printing a progress dot after each <count> [default=65536]\n"
         "                          completed I/O operations, counted separately by each thread \n"
+        "  -Q[t|f]:<trace>       replay a trace in place of generated IO: t - at the trace's timestamps [default],\n"
+        "                          f - as fast as possible. Formats: CSV of <timestamp (us)>,<R|W>,<offset>,<length>;\n"
+        "                          fio iolog (v2/v3); blkparse text output (queue events, else issue events).\n"
+        "                          The trace is streamed from disk and repeats until the test ends. Threads of a\n"
+        "                          target (-t/-F) share its trace, each record being issued by one of them.\n"
+        "                          Offsets past the end of the target wrap; buffers grow to the largest IO if needed.\n"
+        "                          Conflicts with -r, -rd, -si, -p, -w, -ga and a block size mix.\n"
         "  -r[align]             random I/O aligned to [align] byte offsets within the target range (overrides -s)\n"
         "                          [default alignment=block size (-b)]\n"
         "  -rd<dist>[params]     specify an non-uniform distribution for random IO in the target\n"
         "                          [default uniformly random]\n"
-        "                           distributions: pct, abs\n"
+        "                           distributions: pct, abs, zipf, pareto\n"
         "                           all:  IO%% and %%Target/Size are cumulative. If the sum of IO%% is less than 100%% the\n"
         "                                 remainder is applied to the remainder of the target. An IO%% of 0 indicates a gap -\n"
         "                                 no IO will be issued to that range of the target.\n"
@@ -240,6 +610,15 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "                                   next 10GiB, 5%% IO in the next 20GiB and the remaining 5%% of IO in the remaining\n"
         "                                   capacity of the target. If the target is only 20G, the distribution truncates at\n"
         "                                   90/10G:0:10G and all IO is directed to the first 10G (equivalent to -f10G).\n"
+        "                           zipf: optional parameter theta, 0 < theta < 1 [default 0.99]. Aligned offsets are ranked\n"
+        "                                 from the start of the target and the IO to each is proportional to 1/rank^theta.\n"
+        "                                 Example: -rdzipf0.8\n"
+        "                           pareto: optional parameter h, 0 < h < 0.5 [default 0.2]. 1-h of IO is directed to the first\n"
+        "                                 h of the target, and recursively within it; the default is the 80/20 rule.\n"
+        "                                 Example: -rdpareto0.1 specifies 90%% of IO to the first 10%% of the target\n"
+        "                           zipf, pareto: the hot set is contiguous from the start of the target. A trailing s scatters\n"
+        "                                 the ranked offsets across the target by a fixed permutation, shared by all threads.\n"
+        "                                 Example: -rdzipf0.9s, -rdparetos\n"
         "  -rs<percentage>       percentage of requests which should be issued randomly; -r is used to specify IO alignment.\n"
         "                          Sequential IO runs are homogeneous when a mixed r/w ratio is specified (-w) and their lengths\n"
         "                          follow a geometric distribution based on the percentage (chance of next IO being sequential).\n"
@@ -270,10 +649,28 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "  -T<offs>              starting separation between I/O operations performed on the same target by different threads\n"
         "                          [default=0] (starting offset = base target offset + (thread number * <offs>)\n"
         "                          only applies to -s sequential IO with #threads > 1, conflicts with -r and -si\n"
+        "  -u[f][p]              use io_uring submission and completion rings instead of I/O Completion Ports (Linux only)\n"
+        "                          IOs are submitted and completions reaped in batches (conflicts with -x)\n"
+        "                          options may be combined; ex: -ufp\n"
+        "                          f : register IO buffers and target files with the ring once per thread, so that\n"
+        "                              IOs use fixed buffers and files (no per-IO page pinning or file lookup)\n"
+        "                          p : a kernel thread polls the submission queue, so that IOs are submitted without\n"
+        "                              system calls; the poller runs on the thread's assigned CPU (unpinned with -n)\n"
+        "                              and its CPU time is reported separately in the CPU utilization section\n"
+        "  -U<milliseconds>[j]   report IOPS, throughput and latency percentiles (with -L) of each interval of\n"
+        "                          <milliseconds> as the measured run progresses, on stderr; j : as JSON lines\n"
         "  -v[s]                 verbose mode - with s, only provide additional summary statistics\n"
         "  -w<percentage>        percentage of write requests (-w and -w0 are equivalent and result in a read-only workload).\n"
         "                        absence of this switch indicates 100%% reads\n"
         "                          IMPORTANT: a write test will destroy existing data without a warning\n"
+        "  -wf<percentage>       percentage of IOs which are flushes of the target (fdatasync on Linux, FlushFileBuffers\n"
+        "                          on Windows); -w then splits the remaining IOs between reads and writes [default=0]\n"
+        "  -wu<percentage>       percentage of writes issued with forced unit access, completing only once the data\n"
+        "                          is on stable media (Linux only; RWF_DSYNC) [default=0]\n"
+        "  -wt<percentage>[:<size>[K|M|G]]  percentage of IOs which are trims (discards) of <size> bytes [default=block size]\n"
+        "                          at offsets from the same sequential/random pattern as reads and writes: BLKDISCARD\n"
+        "                          or a punched hole on Linux, a storage or file level trim on Windows. -wf and -wt\n"
+        "                          together are at most 100%%; -w splits the remaining IOs between reads and writes\n"
         "  -W<seconds>           warm up time - duration of the test before measurements start [default=5s]\n"
         "  -x                    use completion routines instead of I/O Completion Ports\n"
         "  -X<filepath>          use an XML file to configure the workload. Profile defaults for -W/d/C (durations) and -R/v/z\n"
@@ -282,6 +679,12 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "                          When run, specify the paths to substitute for the template paths in order on the command line.\n"
         "                          The first specified target is *1, second is *2, and so on.\n"
         "                          Example: diskspd -d60 -Xprof.xml first.bin second.bin (prof.xml using *1 and *2, 60s run)\n"
+        "  -Y<o|t|b><points>     sweep: run the test once for each combination of the outstanding IOs (-Yo), threads\n"
+        "                          (-Yt) and block sizes (-Yb) given, as one timespan each and reported together\n"
+        "                          with a summary table. <points> are comma separated values or ranges <from>-<to> of\n"
+        "                          values doubling from <from> to <to>. Files and buffers are kept between runs where\n"
+        "                          possible. -Yo and -Yt apply to -O and -F if given, else to -o and -t.\n"
+        "                          Example: -Yb4K,64K -Yo1-32 runs 12 timespans, -o1 to -o32 with 4KiB then 64KiB\n"
         "  -z[seed]              set random seed [with no -z, seed=0; with plain -z, seed is based on system run time]\n"
         "\n"
         "Write buffers:\n"
@@ -291,6 +694,17 @@ void CmdLineParser::_DisplayUsageInfo(const char *pszFilename) const
         "                         without -Zr\n"
         "  -Z<size>              use a <size> buffer filled with random data as a source for write operations.\n"
         "  -Z<size>,<file>       use a <size> buffer filled with data from <file> as a source for write operations.\n"
+        "  -Zc<c>[:<d>[:<chunk>]] per IO write data which compresses by the ratio <c> and dedups by the ratio <d>\n"
+        "                         [default=1, all unique] in <chunk> size units [default=4K]. <c> and <d> are\n"
+        "                         decimals of at least 1. Each write is built from a pool prepared before the run;\n"
+        "                         set <chunk> to the dedup unit of the storage and align IO (-r/-s) on it.\n"
+        "                         Example: -Zc2:3 for 2:1 compression and 3:1 dedup in 4KiB units\n"
+        "  -Zv[<unit>]           verify data end to end: each <unit> [default=4K] of write data starts with a header of\n"
+        "                         the target, offset, generation and run it was written by, and a CRC32C of the unit.\n"
+        "                         Reads check the units which were written by the run and had no write in flight,\n"
+        "                         reporting lost, misdirected and corrupt writes; any failure fails the run.\n"
+        "                         IO sizes and offsets (-b/-r/-s/-B/-T) must be multiples of <unit>.\n"
+        "                         Example: -w30 -r -Zv for a random soak which verifies its reads\n"
         "\n"
         "  By default, write source buffers are filled with a repeating pattern (0, 1, 2, ..., 255, 0, 1, ...)\n"
         "\n"
@@ -591,6 +1005,49 @@ bool CmdLineParser::_ParseRandomDistribution(const char *arg, vector<Target>& vT
     UINT32 pctAcc = 0, pctCur;          // accumulated/cur pct io
     UINT64 targetAcc = 0, targetCur;    // accumulated/cur target
 
+    //
+    // Skewed distributions take an optional single parameter, range validation
+    // is delayed to common code:
+    //
+    //  * zipf[theta][s]: default 0.99
+    //  * pareto[h][s]: default 0.2, i.e. 80% of IO to 20% of the target
+    //
+    // A trailing s scatters the ranked offsets across the target.
+    //
+
+    if (!strncmp(arg, "zipf", 4) || !strncmp(arg, "pareto", 6))
+    {
+        bool fZipf = (*arg == 'z');
+        double lfSkew = fZipf ? 0.99 : 0.2;
+
+        arg += fZipf ? 4 : 6;
+
+        string sSkew(arg);
+        bool fScatter = (!sSkew.empty() && sSkew.back() == 's');
+        if (fScatter)
+        {
+            sSkew.pop_back();
+        }
+
+        if (!sSkew.empty())
+        {
+            char *end;
+            lfSkew = strtod(sSkew.c_str(), &end);
+            if (end == sSkew.c_str() || *end != '\0')
+            {
+                fprintf(stderr, "Invalid %s distribution parameter '%s'\n", fZipf ? "Zipf" : "Pareto", arg);
+                return false;
+            }
+        }
+
+        for (auto& t : vTargets)
+        {
+            t.SetDistributionSkew(fZipf ? DistributionType::Zipf : DistributionType::Pareto, lfSkew, fScatter);
+        }
+
+        return true;
+    }
+
     if (!strncmp(arg, "pct", 3))
     {
         dType = DistributionType::Percent;
@@ -659,13 +1116,13 @@ bool CmdLineParser::_ParseRandomDistribution(const char *arg, vector<Target>& vT
             fOk = Util::ParseUInt(arg, targetCur, arg);
             if (!fOk)
             {
-                fprintf(stderr, "Invalid integer Target%%: must be > 0 and <= %I64u\n", 100 - targetAcc);
+                fprintf(stderr, "Invalid integer Target%%: must be > 0 and <= %llu\n", 100 - targetAcc);
                 return false;
             }
             // no hole
             else if (targetCur == 0 || targetCur > 100)
             {
-                fprintf(stderr, "Invalid Target%% %I64u: must be > 0 and <= %I64u\n", targetCur, 100 - targetAcc);
+                fprintf(stderr, "Invalid Target%% %llu: must be > 0 and <= %llu\n", targetCur, 100 - targetAcc);
                 return false;
             }
         }
@@ -804,6 +1261,27 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
                     fprintf(stderr, "ERROR: -b is not compatible with -X XML profile specification\n");
                     return false;
                 }
+                else if (strchr(arg, ':') != nullptr)
+                {
+                    vector<BlockSizeWeight> vMix;
+                    if (!_ParseBlockSizeMix(arg, vMix))
+                    {
+                        return false;
+                    }
+                    for (auto &i : vTargets)
+                    {
+                        i.SetBlockSizeMix(vMix);
+                    }
+
+                    // the block 'b' unit and default alignment are the smallest size of the mix
+                    _dwBlockSize = vMix[0].dwBlockSize;
+                    for (const auto &b : vMix)
+                    {
+                        _dwBlockSize = min(_dwBlockSize, b.dwBlockSize);
+                    }
+
+                    isXMLSet = ParseState::False;
+                }
                 else
                 {
                     UINT64 ullBlockSize;
@@ -1101,6 +1579,33 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
+        case 'A':    //Linux AIO, with optional minimum completion batch
+            {
+                if (timeSpan.GetIoEngine() == IoEngine::IoUring)
+                {
+                    fprintf(stderr, "ERROR: -A and -u cannot be used together\n");
+                    fError = true;
+                    break;
+                }
+
+                timeSpan.SetIoEngine(IoEngine::LinuxAio);
+
+                if (*(arg + 1) != '\0')
+                {
+                    int c = atoi(arg + 1);
+                    if (c > 0)
+                    {
+                        timeSpan.SetAioMinEvents(c);
+                    }
+                    else
+                    {
+                        fprintf(stderr, "ERROR: invalid completion count passed to -A\n");
+                        fError = true;
+                    }
+                }
+            }
+            break;
+
         case 'b':    //block size
             // handled during composable parameter evaluation
             break;
@@ -1310,7 +1815,80 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
-        case 'g':    //throughput in bytes per millisecond (gNNN) OR iops (gNNNi)
+        case 'g':    //throughput in bytes per millisecond (gNNN) OR iops (gNNNi) OR open-loop arrival rate (gaNNN[p]) OR throttle spin time (gsNNN)
+                     //OR throughput of all threads per target (gtNNN[i]) or per run (grNNN[i])
+            if (arg[1] == 't' || arg[1] == 'r')
+            {
+                DWORD dwValue;
+                bool fIOPS;
+                if (!_ParseTotalThroughput(arg + 2, &dwValue, &fIOPS))
+                {
+                    fprintf(stderr, "ERROR: invalid throughput limit (-g%c): use -g%c<bytes per ms> or -g%c<iops>i\n", arg[1], arg[1], arg[1]);
+                    fError = true;
+                }
+                else if (arg[1] == 'r')
+                {
+                    if (fIOPS)
+                    {
+                        timeSpan.SetTotalThroughputIOPS(dwValue);
+                    }
+                    else
+                    {
+                        timeSpan.SetTotalThroughput(dwValue);
+                    }
+                }
+                else
+                {
+                    for (auto &i : vTargets)
+                    {
+                        if (fIOPS)
+                        {
+                            i.SetTotalThroughputIOPS(dwValue);
+                        }
+                        else
+                        {
+                            i.SetTotalThroughput(dwValue);
+                        }
+                    }
+                }
+            }
+            else if (arg[1] == 's')
+            {
+                UINT64 ullMicroseconds;
+                const char *rest = nullptr;
+                if (Util::ParseUInt(arg + 2, ullMicroseconds, rest) && *rest == '\0' &&
+                    ullMicroseconds > 0 && ullMicroseconds <= MAXDWORD)
+                {
+                    for (auto &i : vTargets)
+                    {
+                        i.SetThrottleSpinMicroseconds(static_cast<DWORD>(ullMicroseconds));
+                    }
+                }
+                else
+                {
+                    fError = true;
+                }
+            }
+            else if (arg[1] == 'a')
+            {
+                UINT64 ullIOPS;
+                const char *rest = nullptr;
+                if (Util::ParseUInt(arg + 2, ullIOPS, rest) &&
+                    (*rest == '\0' || (*rest == 'p' && *(rest + 1) == '\0')) &&
+                    ullIOPS > 0 && ullIOPS <= MAXDWORD)
+                {
+                    for (auto &i : vTargets)
+                    {
+                        i.SetArrivalRate(static_cast<DWORD>(ullIOPS));
+                        i.SetPoissonArrivals(*rest == 'p');
+                    }
+                }
+                else
+                {
+                    fError = true;
+                }
+            }
+            else
             {
                 // units?
                 bool isBpms = false;
@@ -1363,6 +1941,13 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
+        case 'H':    //load phase
+            if (!_ParsePhase(arg + 1, &timeSpan))
+            {
+                fError = true;
+            }
+            break;
+
         case 'i':    //number of IOs to issue before think time
             {
                 int c = atoi(arg + 1);
@@ -1417,6 +2002,46 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
+        case 'K':    //latency SLO search
+            {
+                char *pszRest = nullptr;
+                double lfPercentile = strtod(arg + 1, &pszRest);
+                double lfMilliseconds = 0;
+                ULONG ulMaxRequestCount = TimeSpan::LatencySloDefaultMaxRequestCount;
+
+                if (pszRest != arg + 1 && *pszRest == ':')
+                {
+                    const char *pszLatency = pszRest + 1;
+                    lfMilliseconds = strtod(pszLatency, &pszRest);
+                    if (pszRest == pszLatency)
+                    {
+                        lfMilliseconds = 0;
+                    }
+                    else if (*pszRest == ':')
+                    {
+                        const char *pszCount = pszRest + 1;
+                        ulMaxRequestCount = strtoul(pszCount, &pszRest, 10);
+                        if (pszRest == pszCount)
+                        {
+                            ulMaxRequestCount = 0;
+                        }
+                    }
+                }
+
+                if (!(lfPercentile > 0 && lfPercentile < 100) || !(lfMilliseconds > 0) || ulMaxRequestCount == 0 || *pszRest != '\0')
+                {
+                    fprintf(stderr, "ERROR: invalid latency SLO search (-K): '%s'; use -K<percentile>:<milliseconds>[:<count>]\n", arg);
+                    fError = true;
+                    break;
+                }
+
+                timeSpan.SetLatencySloPercentile(lfPercentile);
+                timeSpan.SetLatencySloMilliseconds(lfMilliseconds);
+                timeSpan.SetLatencySloMaxRequestCount(ulMaxRequestCount);
+                timeSpan.SetMeasureLatency(true);
+            }
+            break;
+
         case 'l':    //large pages
             for (auto &i : vTargets)
             {
@@ -1425,9 +2050,146 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             break;
 
         case 'L':    //measure latency
+            if (*(arg + 1) == 't')
+            {
+                // ... and capture a trace of each IO
+                if (*(arg + 2) != ':' || *(arg + 3) == '\0')
+                {
+                    fprintf(stderr, "ERROR: -Lt requires a trace file: -Lt:<file>\n");
+                    fError = true;
+                    break;
+                }
+                timeSpan.SetIoTracePath(arg + 3);
+            }
+            else if (*(arg + 1) == 'd')
+            {
+                // ... to the given number of significant digits
+                UINT32 ulDigits = 0;
+                const char *rest = nullptr;
+                if (!Util::ParseUInt(arg + 2, ulDigits, rest) || *rest != '\0' ||
+                    ulDigits < 1 || ulDigits > Histogram<float>::MaxSignificantDigits)
+                {
+                    fprintf(stderr, "ERROR: -Ld requires a precision of 1 to %u significant digits\n", Histogram<float>::MaxSignificantDigits);
+                    fError = true;
+                    break;
+                }
+                timeSpan.SetLatencySignificantDigits(ulDigits);
+            }
             timeSpan.SetMeasureLatency(true);
             break;
 
+        case 'm':    //file set: -m<count>, -mz<theta>, -mo, -mm<percentage>[:<operations>]
+            if (*(arg + 1) == 'z')
+            {
+                char *pszEnd = nullptr;
+                double lfSkew = strtod(arg + 2, &pszEnd);
+
+                if (*(arg + 2) == '\0' || *pszEnd != '\0' || lfSkew <= 0 || lfSkew >= 1)
+                {
+                    fprintf(stderr, "ERROR: Zipf skew passed to -mz must be between 0 and 1\n");
+                    fError = true;
+                }
+                else
+                {
+                    for (auto &i : vTargets)
+                    {
+                        i.SetFileSetSkew(lfSkew);
+                    }
+                }
+            }
+            else if (*(arg + 1) == 'o')
+            {
+                for (auto &i : vTargets)
+                {
+                    i.SetOpenPerIO(true);
+                }
+            }
+            else if (*(arg + 1) == 'm')
+            {
+                int c = 0;
+                UINT32 ulOps = 0;
+
+                if (*(arg + 2) == '\0')
+                {
+                    fprintf(stderr, "ERROR: no ratio passed to -mm\n");
+                    fError = true;
+                }
+                else
+                {
+                    c = atoi(arg + 2);
+                    if (c < 0 || c > 100)
+                    {
+                        fprintf(stderr, "ERROR: ratio passed to -mm must be between 0 and 100 (percent)\n");
+                        fError = true;
+                    }
+
+                    const char *pszOps = strchr(arg + 2, ':');
+                    if (pszOps == nullptr)
+                    {
+                        ulOps = MetadataOpMask(MetadataOp::Create) | MetadataOpMask(MetadataOp::Stat) |
+                                MetadataOpMask(MetadataOp::Unlink) | MetadataOpMask(MetadataOp::Rename);
+                    }
+                    else
+                    {
+                        for (const char *pszOp = pszOps + 1; *pszOp != '\0' && !fError; pszOp++)
+                        {
+                            switch (*pszOp)
+                            {
+                            case 'c':
+                                ulOps |= MetadataOpMask(MetadataOp::Create);
+                                break;
+                            case 's':
+                                ulOps |= MetadataOpMask(MetadataOp::Stat);
+                                break;
+                            case 'u':
+                                ulOps |= MetadataOpMask(MetadataOp::Unlink);
+                                break;
+                            case 'r':
+                                ulOps |= MetadataOpMask(MetadataOp::Rename);
+                                break;
+                            default:
+                                fprintf(stderr, "ERROR: invalid metadata operation '%c' passed to -mm; valid are c, s, u and r\n", *pszOp);
+                                fError = true;
+                                break;
+                            }
+                        }
+
+                        if (!fError && ulOps == 0)
+                        {
+                            fprintf(stderr, "ERROR: no metadata operations passed to -mm\n");
+                            fError = true;
+                        }
+                    }
+                }
+                if (!fError)
+                {
+                    for (auto &i : vTargets)
+                    {
+                        i.SetMetadataRatio(c);
+                        i.SetMetadataOps(ulOps);
+                    }
+                }
+            }
+            else
+            {
+                char *pszEnd = nullptr;
+                unsigned long ulCount = strtoul(arg + 1, &pszEnd, 10);
+
+                if (*(arg + 1) == '\0' || *pszEnd != '\0' || ulCount == 0 || ulCount > MAXDWORD)
+                {
+                    fprintf(stderr, "ERROR: -m requires a positive count of files\n");
+                    fError = true;
+                }
+                else
+                {
+                    for (auto &i : vTargets)
+                    {
+                        i.SetFileSetCount((DWORD)ulCount);
+                    }
+                }
+            }
+            break;
+
         case 'n':    //disable affinity (by default simple affinity is turned on)
             timeSpan.SetDisableAffinity(true);
             break;
@@ -1489,6 +2251,33 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
+        case 'Q':    //trace replay
+            {
+                bool fTimestamps = true;
+                const char *pszPath = arg + 1;
+
+                if (*pszPath == 't' || *pszPath == 'f')
+                {
+                    fTimestamps = (*pszPath == 't');
+                    pszPath++;
+                }
+
+                if (*pszPath != ':' || *(pszPath + 1) == '\0')
+                {
+                    fprintf(stderr, "ERROR: -Q requires a trace file: -Q[t|f]:<trace>\n");
+                    fError = true;
+                }
+                else
+                {
+                    for (auto &i : vTargets)
+                    {
+                        i.SetTracePath(pszPath + 1);
+                        i.SetTraceTimestamps(fTimestamps);
+                    }
+                }
+            }
+            break;
+
         case 'r':    //random access
             {
                 // mixed random/sequential pct split?
@@ -1595,6 +2384,7 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
                                 break;
                             }
                             i.SetBlockAlignmentInBytes(cb);
+                            i.SetBlockAlignmentFromBlockSize(*(arg + 1) == '\0');
                         }
                     }
                 }
@@ -1672,7 +2462,8 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
                     // -rs/-s intent conflicts when attempting to set -rs
                     for (auto &i : vTargets)
                     {
-                        i.SetBlockAlignmentInBytes(i.GetBlockSizeInBytes());
+                        i.SetBlockAlignmentInBytes(i.GetMinBlockSizeInBytes());
+                        i.SetBlockAlignmentFromBlockSize(true);
                     }
                 }
             }
@@ -1818,11 +2609,123 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             }
             break;
 
+        case 'u':    //io_uring
+            {
+                if (timeSpan.GetIoEngine() == IoEngine::LinuxAio)
+                {
+                    fprintf(stderr, "ERROR: -A and -u cannot be used together\n");
+                    fError = true;
+                    break;
+                }
+
+                timeSpan.SetIoEngine(IoEngine::IoUring);
+
+                int idx;
+                for (idx = 1; !fError && arg[idx]; idx++)
+                {
+                    switch (arg[idx])
+                    {
+                    case 'f':
+                        if (timeSpan.GetRegisteredIo())
+                        {
+                            fprintf(stderr, "ERROR: -uf specified multiple times\n");
+                            fError = true;
+                            break;
+                        }
+                        timeSpan.SetRegisteredIo(true);
+                        break;
+                    case 'p':
+                        if (timeSpan.GetSqPoll())
+                        {
+                            fprintf(stderr, "ERROR: -up specified multiple times\n");
+                            fError = true;
+                            break;
+                        }
+                        timeSpan.SetSqPoll(true);
+                        break;
+                    default:
+                        fprintf(stderr, "ERROR: unrecognized option provided to -u\n");
+                        fError = true;
+                        break;
+                    }
+                }
+            }
+            break;
+
+        case 'U':    //interval reporting
+            {
+                char *pszRest = nullptr;
+                ULONG ulInterval = strtoul(arg + 1, &pszRest, 10);
+
+                if (pszRest == arg + 1 || ulInterval == 0 ||
+                    (*pszRest != '\0' && (*pszRest != 'j' || *(pszRest + 1) != '\0')))
+                {
+                    fprintf(stderr, "ERROR: invalid interval reporting (-U): '%s'; use -U<milliseconds>[j]\n", arg);
+                    fError = true;
+                    break;
+                }
+
+                timeSpan.SetReportIntervalInMilliseconds(ulInterval);
+                timeSpan.SetReportIntervalJson(*pszRest == 'j');
+            }
+            break;
+
         case 'v':    //verbose mode
             // handled during composable parameter evaluation
             break;
 
         case 'w':    //write test [default=read]
+            if (*(arg + 1) == 'f' || *(arg + 1) == 'u' || *(arg + 1) == 't')
+            {
+                // -wf<percentage> flushes in the IO mix, -wu<percentage> forced unit access writes,
+                // -wt<percentage>[:<size>] trims
+                char chKind = *(arg + 1);
+                int c = 0;
+                UINT64 cbTrim = 0;
+
+                if (*(arg + 2) == '\0')
+                {
+                    fprintf(stderr, "ERROR: no ratio passed to -w%c\n", *(arg + 1));
+                    fError = true;
+                }
+                else
+                {
+                    c = atoi(arg + 2);
+                    if (c < 0 || c > 100)
+                    {
+                        fprintf(stderr, "ERROR: ratio passed to -w%c must be between 0 and 100 (percent)\n", *(arg + 1));
+                        fError = true;
+                    }
+
+                    const char *pszSize = strchr(arg + 2, ':');
+                    if (pszSize != nullptr &&
+                        (chKind != 't' || !_GetSizeInBytes(pszSize + 1, cbTrim, nullptr) || cbTrim == 0 || cbTrim >= MAXUINT32))
+                    {
+                        fprintf(stderr, "ERROR: invalid size passed to -w%c\n", chKind);
+                        fError = true;
+                    }
+                }
+                if (!fError)
+                {
+                    for (auto &i : vTargets)
+                    {
+                        if (chKind == 'f')
+                        {
+                            i.SetFlushRatio(c);
+                        }
+                        else if (chKind == 'u')
+                        {
+                            i.SetFuaWriteRatio(c);
+                        }
+                        else
+                        {
+                            i.SetTrimRatio(c);
+                            i.SetTrimSize((DWORD)cbTrim);
+                        }
+                    }
+                }
+            }
+            else
             {
                 int c = 0;
 
@@ -1921,6 +2824,13 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
                 fError = true;
             }
 
+        case 'Y':    //sweep
+            if (!_ParseSweep(arg + 1, &timeSpan))
+            {
+                fError = true;
+            }
+            break;
+
         case 'z':    //random seed
             // handled during composable parameter evaluation
             break;
@@ -1937,6 +2847,26 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
             {
                 timeSpan.SetRandomWriteData(true);
             }
+            else if (*(arg + 1) == 'c')
+            {
+                fError = !_ParseReducibleWriteData(arg + 2, vTargets);
+            }
+            else if (*(arg + 1) == 'v')
+            {
+                UINT64 cbUnit = DataVerifier::DefaultUnitSize;
+                if (*(arg + 2) != '\0' && (!_GetSizeInBytes(arg + 2, cbUnit, nullptr) || cbUnit == 0 || cbUnit >= MAXUINT32))
+                {
+                    fprintf(stderr, "ERROR: invalid verify unit size passed to -Zv\n");
+                    fError = true;
+                }
+                else
+                {
+                    for (auto &i : vTargets)
+                    {
+                        i.SetVerifyUnitSize((UINT32)cbUnit);
+                    }
+                }
+            }
             else
             {
                 UINT64 cb = 0;
@@ -2021,9 +2951,17 @@ bool CmdLineParser::_ReadParametersFromCmdLine(const int argc, const char *argv[
 
 bool CmdLineParser::_ReadParametersFromXmlFile(const char *pszPath, Profile *pProfile, vector<Target> *pvSubstTargets)
 {
+#ifdef __linux__
+    // the XML profile parser is built on MSXML
+    UNREFERENCED_PARAMETER(pProfile);
+    UNREFERENCED_PARAMETER(pvSubstTargets);
+    fprintf(stderr, "ERROR: XML profiles are not supported on this platform (%s)\n", pszPath);
+    return false;
+#else
     XmlProfileParser parser;
 
     return parser.ParseFile(pszPath, pProfile, pvSubstTargets, NULL);
+#endif
 }
 
 bool CmdLineParser::ParseCmdLine(const int argc, const char *argv[], Profile *pProfile, struct Synchronization *synch, SystemInformation *pSystem)
@@ -2061,6 +2999,21 @@ bool CmdLineParser::ParseCmdLine(const int argc, const char *argv[], Profile *pP
     // system consistency in profile-only operation (this is only required at
     // execution time).
 
+    // a sweep runs as a timespan per point; a latency SLO search chooses its own outstanding IOs
+    if (fOk)
+    {
+        for (const auto& timeSpan : pProfile->GetTimeSpans())
+        {
+            if (timeSpan.GetLatencySloPercentile() > 0 && !timeSpan.GetSweepRequestCounts().empty())
+            {
+                fprintf(stderr, "ERROR: -K latency SLO search cannot be used with an outstanding IO sweep (-Yo)\n");
+                fOk = false;
+            }
+        }
+
+        pProfile->ExpandSweeps();
+    }
+
     if (fOk)
     {
         fOk = pProfile->Validate(!fXMLProfile, pProfile->GetProfileOnly() ? nullptr : pSystem);
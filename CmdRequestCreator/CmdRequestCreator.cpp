@@ -31,13 +31,17 @@ SOFTWARE.
 //
 
 #include "CmdRequestCreator.h"
+#ifndef __linux__
 #include <windows.h>
+#endif
 #include <stdlib.h>
 #include <assert.h>
-#include "common.h"
+#include "Common.h"
 #include "errors.h"
 #include "CmdLineParser.h"
+#ifndef __linux__
 #include "XmlProfileParser.h"
+#endif
 #include "IORequestGenerator.h"
 #include "ResultParser.h"
 #include "XmlResultParser.h"
@@ -48,12 +48,23 @@ private:
     bool _ParseFlushParameter(const char *arg, MemoryMappedIoFlushMode *FlushMode );
     bool _ParseAffinity(const char *arg, TimeSpan *pTimeSpan);
     bool _ParseRandomDistribution(const char *arg, vector<Target>& vTargets);
+    bool _ParseBlockSizeMix(const char *arg, vector<BlockSizeWeight>& vMix);
+    bool _ParseSweep(const char *arg, TimeSpan *pTimeSpan);
+    bool _ParseTotalThroughput(const char *arg, DWORD *pdwValue, bool *pfIOPS);
+    bool _ParsePhase(const char *arg, TimeSpan *pTimeSpan);
+    static bool _ParsePhaseSeconds(const char *arg, UINT32 *pulMilliseconds, const char **pRest);
 
     void _DisplayUsageInfo(const char *pszFilename) const;
     bool _GetSizeInBytes(const char *pszSize, UINT64& ullSize, const char **pszRest) const;
     bool _GetRandomDataWriteBufferData(const string& sArg, UINT64& cb, string& sPath);
+    bool _ParseReducibleWriteData(const char *arg, vector<Target>& vTargets);
 
+#ifdef __linux__
+    // '/' begins absolute paths, so only '-' introduces switches
+    static bool _IsSwitchChar(const char c) { return (c == '-'); }
+#else
     static bool _IsSwitchChar(const char c) { return (c == '/' || c == '-'); }
+#endif
     enum class ParseState {
         Unknown,
         True,
@@ -34,5 +34,7 @@ SOFTWARE.
 
 #pragma once
 
+#ifndef __linux__
 #include <tchar.h>
+#endif
 #include <stdio.h>
\ No newline at end of file
@@ -97,7 +97,9 @@ UINT64 PerfTimer::SecondsToPerfTime(const double seconds)
     return static_cast<UINT64>(TIMER_FREQ * seconds);
 }
 
-Random::Random(UINT64 ulSeed)
+Random::Random(UINT64 ulSeed) :
+    _fLanesSeeded(false),
+    _fill(GetBestFill())
 {
     UINT32 i;
 
@@ -111,131 +113,43 @@ Random::Random(UINT64 ulSeed)
     }
 }
 
-void Random::RandBuffer(BYTE *pBuffer, UINT32 ulLength, bool fPseudoRandomOkay)
+string Util::DoubleToStringHelper(const double d)
 {
-    UINT64 *pBuffer64;
-    UINT32 Remaining = (UINT32)(((ULONG_PTR)pBuffer) & 7);
-    UINT64 r1, r2, r3, r4, r5;
-
-    //
-    // Align to 8 bytes
-    //
-
-    if (Remaining != 0) {
-        r1 = Rand64();
-
-        while (Remaining != 0 && ulLength != 0) {
-            *pBuffer = (BYTE)(r1 & 0xFF);
-            r1 >>= 8;
-            pBuffer++;
-            ulLength--;
-            Remaining--;
-        }
-    }
-
-    pBuffer64 = (UINT64*)pBuffer;
-    Remaining = ulLength / 8;
-    ulLength -= Remaining * 8;
-    pBuffer += Remaining * 8;
-
-    if (fPseudoRandomOkay) {
-
-        //
-        // Generate 5 random numbers and then mix them to produce
-        // 16 random (but correlated) numbers.  We want to do 16
-        // numbers at a time for optimal cache line alignment.
-        // Only do this if the caller is okay with numbers that
-        // aren't independent.  A detailed analysis of the data
-        // could probably detect that the first 5 numbers determine
-        // the next 11.  For most purposes this won't matter (for
-        // instance it's unlikely compression algorithms will be
-        // able to detect this and utilize it).
-        //
-
-        while (Remaining > 16) {
-            r1 = Rand64();
-            r2 = Rand64();
-            r3 = Rand64();
-            r4 = Rand64();
-            r5 = Rand64();
-
-            pBuffer64[0]  = r1;
-            pBuffer64[1]  = r2;
-            pBuffer64[2]  = r3;
-            pBuffer64[3]  = r4;
-            pBuffer64[4]  = r5;
-
-            //
-            // Throw in some rotates so that the below numbers
-            // aren't the xor sum of previous numbers.
-            //
-
-            r1 = _rotl64(r1, 7);
-            pBuffer64[5]  = r1 ^ r2;
-            pBuffer64[6]  = r1 ^ r3;
-            pBuffer64[7]  = r1 ^ r4;
-            pBuffer64[8]  = r1 ^ r5;
-
-            r2 = _rotl64(r2, 13);
-            pBuffer64[9]  = r2 ^ r3;
-            pBuffer64[10] = r2 ^ r4;
-            pBuffer64[11] = r2 ^ r5;
-
-            r3 = _rotl64(r3, 19);
-            pBuffer64[12] = r3 ^ r4;
-            pBuffer64[13] = r3 ^ r5;
-
-            pBuffer64[14] = r1 ^ r2 ^ r3;
-            pBuffer64[15] = r1 ^ _rotl64(r4 ^ r5, 39);
-
-            pBuffer64 += 16;
-            Remaining -= 16;
-        }
-    }
-
-    //
-    // Fill in the tail of the buffer
-    //
-
-    while (Remaining >= 4) {
-        r1 = Rand64();
-        r2 = Rand64();
-        r3 = Rand64();
-        r4 = Rand64();
+    char szFloatBuffer[100];
+    sprintf_s(szFloatBuffer, _countof(szFloatBuffer), "%10.3lf", d);
 
-        pBuffer64[0]  = r1;
-        pBuffer64[1]  = r2;
-        pBuffer64[2]  = r3;
-        pBuffer64[3]  = r4;
+    return string(szFloatBuffer);
+}
 
-        pBuffer64 += 4;
-        Remaining -= 4;
-    }
+//
+// Generalized harmonic number: the sum of i^-theta for i = 1..n. The first terms are summed
+// directly and the remainder approximated by the integral over [k + 1/2, n + 1/2], which is
+// accurate to well beyond double precision for the k used here and keeps this cheap for
+// targets with billions of offsets.
+//
+double Util::Zeta(UINT64 n, double theta)
+{
+    const UINT64 k = 1024;
+    double zeta = 0;
 
-    while (Remaining != 0) {
-        *pBuffer64 = Rand64();
-        pBuffer64++;
-        Remaining--;
+    for (UINT64 i = 1; i <= n && i <= k; i++)
+    {
+        zeta += pow((double)i, -theta);
     }
 
-    if (ulLength != 0) {
-        r1 = Rand64();
-
-        while (ulLength != 0) {
-            *pBuffer = (BYTE)(r1 & 0xFF);
-            r1 >>= 8;
-            pBuffer++;
-            ulLength--;
+    if (n > k)
+    {
+        if (theta == 1.0)
+        {
+            zeta += log((n + 0.5) / (k + 0.5));
+        }
+        else
+        {
+            zeta += (pow(n + 0.5, 1.0 - theta) - pow(k + 0.5, 1.0 - theta)) / (1.0 - theta);
         }
     }
-}
-
-string Util::DoubleToStringHelper(const double d)
-{
-    char szFloatBuffer[100];
-    sprintf_s(szFloatBuffer, _countof(szFloatBuffer), "%10.3lf", d);
 
-    return string(szFloatBuffer);
+    return zeta;
 }
 
 string ThreadTarget::GetXml(UINT32 indent) const
@@ -270,7 +184,18 @@ string Target::GetXml(UINT32 indent) const
     sprintf_s(buffer, _countof(buffer), "<BlockSize>%u</BlockSize>\n", _dwBlockSize);
     AddXml(sXml, buffer);
 
-    sprintf_s(buffer, _countof(buffer), "<BaseFileOffset>%I64u</BaseFileOffset>\n", _ullBaseFileOffset);
+    if (_vBlockSizeMix.size())
+    {
+        AddXmlInc(sXml, "<BlockSizeMix>\n");
+        for (const auto& b : _vBlockSizeMix)
+        {
+            sprintf_s(buffer, _countof(buffer), "<BlockSize Weight=\"%u\">%u</BlockSize>\n", b.ulWeight, b.dwBlockSize);
+            AddXml(sXml, buffer);
+        }
+        AddXmlDec(sXml, "</BlockSizeMix>\n");
+    }
+
+    sprintf_s(buffer, _countof(buffer), "<BaseFileOffset>%llu</BaseFileOffset>\n", _ullBaseFileOffset);
     AddXml(sXml, buffer);
 
     AddXml(sXml, _fSequentialScanHint ? "<SequentialScan>true</SequentialScan>\n" : "<SequentialScan>false</SequentialScan>\n");
@@ -324,6 +249,18 @@ string Target::GetXml(UINT32 indent) const
     {
         AddXml(sXml, "<Pattern>zero</Pattern>\n");
     }
+    else if (GetReducibleWriteData())
+    {
+        AddXml(sXml, "<Pattern>reducible</Pattern>\n");
+        AddXmlInc(sXml, "<DataReduction>\n");
+        sprintf_s(buffer, _countof(buffer), "<CompressionRatio>%.2f</CompressionRatio>\n", _lfCompressionRatio);
+        AddXml(sXml, buffer);
+        sprintf_s(buffer, _countof(buffer), "<DedupRatio>%.2f</DedupRatio>\n", _lfDedupRatio);
+        AddXml(sXml, buffer);
+        sprintf_s(buffer, _countof(buffer), "<ChunkSize>%u</ChunkSize>\n", _cbDedupChunk);
+        AddXml(sXml, buffer);
+        AddXmlDec(sXml, "</DataReduction>\n");
+    }
     else if (_cbRandomDataWriteBuffer == 0)
     {
         AddXml(sXml, "<Pattern>sequential</Pattern>\n");
@@ -332,7 +269,7 @@ string Target::GetXml(UINT32 indent) const
     {
         AddXml(sXml, "<Pattern>random</Pattern>\n");
         AddXmlInc(sXml, "<RandomDataSource>\n");
-        sprintf_s(buffer, _countof(buffer), "<SizeInBytes>%I64u</SizeInBytes>\n", _cbRandomDataWriteBuffer);
+        sprintf_s(buffer, _countof(buffer), "<SizeInBytes>%llu</SizeInBytes>\n", _cbRandomDataWriteBuffer);
         AddXml(sXml, buffer);
         if (_sRandomDataWriteBufferSourcePath != "")
         {
@@ -340,6 +277,11 @@ string Target::GetXml(UINT32 indent) const
         }
         AddXmlDec(sXml, "</RandomDataSource>\n");
     }
+    if (_cbVerifyUnit != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<VerifyUnitSize>%u</VerifyUnitSize>\n", _cbVerifyUnit);
+        AddXml(sXml, buffer);
+    }
     AddXmlDec(sXml, "</WriteBufferContent>\n");
 
     AddXml(sXml, _fParallelAsyncIO ? "<ParallelAsyncIO>true</ParallelAsyncIO>\n" : "<ParallelAsyncIO>false</ParallelAsyncIO>\n");
@@ -358,14 +300,14 @@ string Target::GetXml(UINT32 indent) const
 
     if (_fCreateFile)
     {
-        sprintf_s(buffer, _countof(buffer), "<FileSize>%I64u</FileSize>\n", _ullFileSize);
+        sprintf_s(buffer, _countof(buffer), "<FileSize>%llu</FileSize>\n", _ullFileSize);
         AddXml(sXml, buffer);
     }
 
     // If XML contains <Random>, <StrideSize> is ignored
     if (_ulRandomRatio > 0)
     {
-        sprintf_s(buffer, _countof(buffer), "<Random>%I64u</Random>\n", GetBlockAlignmentInBytes());
+        sprintf_s(buffer, _countof(buffer), "<Random>%llu</Random>\n", GetBlockAlignmentInBytes());
         AddXml(sXml, buffer);
 
         // 100% random is <Random> alone
@@ -379,7 +321,7 @@ string Target::GetXml(UINT32 indent) const
 
         if (_vDistributionRange.size())
         {
-            char *type = nullptr;
+            const char *type = nullptr;
 
             switch (_distributionType)
             {
@@ -402,7 +344,7 @@ string Target::GetXml(UINT32 indent) const
 
             for (auto r : _vDistributionRange)
             {
-                sprintf_s(buffer, _countof(buffer), "<Range IO=\"%u\">%I64u", r._span, r._dst.second);
+                sprintf_s(buffer, _countof(buffer), "<Range IO=\"%u\">%llu", r._span, r._dst.second);
                 AddXml(sXml, buffer);
                 sXml += "</Range>\n";
             }
@@ -412,10 +354,20 @@ string Target::GetXml(UINT32 indent) const
             sXml += ">\n";
             AddXmlDec(sXml, "</Distribution>\n");
         }
+        else if (_distributionType == DistributionType::Zipf ||
+                 _distributionType == DistributionType::Pareto)
+        {
+            const char *type = (_distributionType == DistributionType::Zipf) ? "Zipf" : "Pareto";
+
+            AddXmlInc(sXml, "<Distribution>\n");
+            sprintf_s(buffer, _countof(buffer), "<%s%s>%g</%s>\n", type, _fDistributionScatter ? " scatter=\"true\"" : "", _lfDistributionSkew, type);
+            AddXml(sXml, buffer);
+            AddXmlDec(sXml, "</Distribution>\n");
+        }
     }
     else
     {
-        sprintf_s(buffer, _countof(buffer), "<StrideSize>%I64u</StrideSize>\n", GetBlockAlignmentInBytes());
+        sprintf_s(buffer, _countof(buffer), "<StrideSize>%llu</StrideSize>\n", GetBlockAlignmentInBytes());
         AddXml(sXml, buffer);
 
         AddXml(sXml, _fInterlockedSequential ?
@@ -423,10 +375,10 @@ string Target::GetXml(UINT32 indent) const
             "<InterlockedSequential>false</InterlockedSequential>\n");
     }
 
-    sprintf_s(buffer, _countof(buffer), "<ThreadStride>%I64u</ThreadStride>\n", _ullThreadStride);
+    sprintf_s(buffer, _countof(buffer), "<ThreadStride>%llu</ThreadStride>\n", _ullThreadStride);
     AddXml(sXml, buffer);
 
-    sprintf_s(buffer, _countof(buffer), "<MaxFileSize>%I64u</MaxFileSize>\n", _ullMaxFileSize);
+    sprintf_s(buffer, _countof(buffer), "<MaxFileSize>%llu</MaxFileSize>\n", _ullMaxFileSize);
     AddXml(sXml, buffer);
 
     sprintf_s(buffer, _countof(buffer), "<RequestCount>%u</RequestCount>\n", _dwRequestCount);
@@ -435,6 +387,69 @@ string Target::GetXml(UINT32 indent) const
     sprintf_s(buffer, _countof(buffer), "<WriteRatio>%u</WriteRatio>\n", _ulWriteRatio);
     AddXml(sXml, buffer);
 
+    if (_ulFlushRatio != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<FlushRatio>%u</FlushRatio>\n", _ulFlushRatio);
+        AddXml(sXml, buffer);
+    }
+
+    if (_ulFuaWriteRatio != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<FuaWriteRatio>%u</FuaWriteRatio>\n", _ulFuaWriteRatio);
+        AddXml(sXml, buffer);
+    }
+
+    if (_ulTrimRatio != 0)
+    {
+        sprintf_s(buffer, _countof(buffer), "<TrimRatio>%u</TrimRatio>\n", _ulTrimRatio);
+        AddXml(sXml, buffer);
+
+        if (_dwTrimSize != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<TrimSize>%u</TrimSize>\n", _dwTrimSize);
+            AddXml(sXml, buffer);
+        }
+    }
+
+    if (_dwFileSetCount != 0)
+    {
+        AddXmlInc(sXml, "<FileSet>\n");
+
+        sprintf_s(buffer, _countof(buffer), "<FileCount>%u</FileCount>\n", _dwFileSetCount);
+        AddXml(sXml, buffer);
+
+        if (_lfFileSetSkew != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<Zipf>%g</Zipf>\n", _lfFileSetSkew);
+            AddXml(sXml, buffer);
+        }
+
+        if (_fOpenPerIO)
+        {
+            AddXml(sXml, "<OpenPerIO>true</OpenPerIO>\n");
+        }
+
+        if (_ulMetadataRatio != 0)
+        {
+            sprintf_s(buffer, _countof(buffer), "<MetadataRatio>%u</MetadataRatio>\n", _ulMetadataRatio);
+            AddXml(sXml, buffer);
+
+            string sOps;
+            for (UINT32 i = 0; i < static_cast<UINT32>(MetadataOp::Open); i++)
+            {
+                if (_ulMetadataOps & MetadataOpMask(static_cast<MetadataOp>(i)))
+                {
+                    sOps += MetadataOpName(static_cast<MetadataOp>(i))[0];
+                }
+            }
+
+            sprintf_s(buffer, _countof(buffer), "<MetadataOperations>%s</MetadataOperations>\n", sOps.c_str());
+            AddXml(sXml, buffer);
+        }
+
+        AddXmlDec(sXml, "</FileSet>\n");
+    }
+
     // Preserve specified units
     if (_dwThroughputIOPS)
     {
@@ -447,6 +462,36 @@ string Target::GetXml(UINT32 indent) const
         AddXml(sXml, buffer);
     }
 
+    if (_dwThrottleSpinMicroseconds)
+    {
+        sprintf_s(buffer, _countof(buffer), "<ThrottleSpin>%u</ThrottleSpin>\n", _dwThrottleSpinMicroseconds);
+        AddXml(sXml, buffer);
+    }
+
+    if (_dwTotalThroughputIOPS)
+    {
+        sprintf_s(buffer, _countof(buffer), "<TotalThroughput unit=\"IOPS\">%u</TotalThroughput>\n", _dwTotalThroughputIOPS);
+        AddXml(sXml, buffer);
+    }
+    else if (_dwTotalThroughputBytesPerMillisecond)
+    {
+        sprintf_s(buffer, _countof(buffer), "<TotalThroughput>%u</TotalThroughput>\n", _dwTotalThroughputBytesPerMillisecond);
+        AddXml(sXml, buffer);
+    }
+
+    if (_dwArrivalRate)
+    {
+        sprintf_s(buffer, _countof(buffer), "<ArrivalRate distribution=\"%s\">%u</ArrivalRate>\n", _fPoissonArrivals ? "Poisson" : "Fixed", _dwArrivalRate);
+        AddXml(sXml, buffer);
+    }
+
+    if (!_sTracePath.empty())
+    {
+        AddXml(sXml, "<Trace pacing=\"");
+        sXml += _fTraceTimestamps ? "Timestamps" : "Fast";
+        sXml += "\">" + _sTracePath + "</Trace>\n";
+    }
+
     sprintf_s(buffer, _countof(buffer), "<ThreadsPerFile>%u</ThreadsPerFile>\n", _dwThreadsPerFile);
     AddXml(sXml, buffer);
 
@@ -487,6 +532,32 @@ string Target::GetXml(UINT32 indent) const
     return sXml;
 }
 
+string Target::GetFileSetFilePath(DWORD iFile) const
+{
+    char szName[32];
+
+    sprintf_s(szName, _countof(szName), "file%u.dat", iFile);
+
+    return GetFileSetFilePath(szName);
+}
+
+string Target::GetFileSetFilePath(const char *pszName) const
+{
+#ifdef __linux__
+    const char chSeparator = '/';
+#else
+    const char chSeparator = '\\';
+#endif
+
+    string sPath(_sPath);
+    if (!sPath.empty() && sPath.back() != chSeparator)
+    {
+        sPath += chSeparator;
+    }
+
+    return sPath + pszName;
+}
+
 bool Target::_FillRandomDataWriteBuffer(Random *pRand)
 {
     assert(_pRandomDataWriteBuffer != nullptr);
@@ -507,7 +578,7 @@ bool Target::_FillRandomDataWriteBuffer(Random *pRand)
             bool fReadSuccess = true;
             while (fReadSuccess && cbLeftToRead > 0)
             {
-                DWORD cbToRead = static_cast<DWORD>(min(64 * 1024, cbLeftToRead));
+                DWORD cbToRead = static_cast<DWORD>(min<UINT64>(64 * 1024, cbLeftToRead));
                 DWORD cbRead;
                 fReadSuccess = ((ReadFile(hFile, pBuffer, cbToRead, &cbRead, nullptr) == TRUE) && (cbRead > 0));
                 pBuffer += cbRead;
@@ -570,6 +641,34 @@ void Target::FreeRandomDataWriteBuffer()
     }
 }
 
+bool Target::AllocateDataPool(Random *pRand)
+{
+    assert(_pDataPool == nullptr);
+
+    _pDataPool = new ReducibleDataPool();
+    return _pDataPool->Initialize(_lfCompressionRatio, _lfDedupRatio, _cbDedupChunk, GetBlockSizeInBytes(), pRand);
+}
+
+void Target::FreeDataPool()
+{
+    delete _pDataPool;
+    _pDataPool = nullptr;
+}
+
+void Target::AllocateVerifier(UINT32 ulTarget, UINT32 ulSeed)
+{
+    assert(_pVerifier == nullptr);
+
+    // the generation map is sized once the threads open the target
+    _pVerifier = new DataVerifier(_sPath, ulTarget, _cbVerifyUnit, ulSeed);
+}
+
+void Target::FreeVerifier()
+{
+    delete _pVerifier;
+    _pVerifier = nullptr;
+}
+
 BYTE* Target::GetRandomDataWriteBuffer(Random *pRand)
 {
     size_t cbBuffer = static_cast<size_t>(GetRandomDataWriteBufferSize());
@@ -603,7 +702,38 @@ string TimeSpan::GetXml(UINT32 indent) const
 
     AddXmlInc(sXml, "<TimeSpan>\n");
     AddXml(sXml, _fCompletionRoutines ? "<CompletionRoutines>true</CompletionRoutines>\n" : "<CompletionRoutines>false</CompletionRoutines>\n");
+    if (_ioEngine == IoEngine::IoUring)
+    {
+        // only output if on so that downlevel doesn't get (and fail: not in downlevel xsd) unless actually specified
+        AddXml(sXml, "<IoEngine>IoUring</IoEngine>\n");
+    }
+    else if (_ioEngine == IoEngine::LinuxAio)
+    {
+        AddXml(sXml, "<IoEngine>LinuxAio</IoEngine>\n");
+    }
+    if (_fRegisteredIo)
+    {
+        AddXml(sXml, "<RegisteredIo>true</RegisteredIo>\n");
+    }
+    if (_fSqPoll)
+    {
+        AddXml(sXml, "<SqPoll>true</SqPoll>\n");
+    }
+    if (_ulAioMinEvents != 1)
+    {
+        sprintf_s(buffer, _countof(buffer), "<AioMinEvents>%u</AioMinEvents>\n", _ulAioMinEvents);
+        AddXml(sXml, buffer);
+    }
     AddXml(sXml,_fMeasureLatency ? "<MeasureLatency>true</MeasureLatency>\n" : "<MeasureLatency>false</MeasureLatency>\n");
+    if (_ulLatencySignificantDigits != Histogram<float>::DefaultSignificantDigits)
+    {
+        sprintf_s(buffer, _countof(buffer), "<LatencySignificantDigits>%u</LatencySignificantDigits>\n", _ulLatencySignificantDigits);
+        AddXml(sXml, buffer);
+    }
+    if (!_sIoTracePath.empty())
+    {
+        AddXml(sXml, "<IoTrace>" + _sIoTracePath + "</IoTrace>\n");
+    }
     AddXml(sXml, _fCalculateIopsStdDev ? "<CalculateIopsStdDev>true</CalculateIopsStdDev>\n" : "<CalculateIopsStdDev>false</CalculateIopsStdDev>\n");
     AddXml(sXml, _fDisableAffinity ? "<DisableAffinity>true</DisableAffinity>\n" : "<DisableAffinity>false</DisableAffinity>\n");
 
@@ -625,6 +755,91 @@ string TimeSpan::GetXml(UINT32 indent) const
     sprintf_s(buffer, _countof(buffer), "<IoBucketDuration>%u</IoBucketDuration>\n", _ulIoBucketDurationInMilliseconds);
     AddXml(sXml, buffer);
 
+    if (_ulReportIntervalInMilliseconds)
+    {
+        sprintf_s(buffer, _countof(buffer), "<ReportInterval format=\"%s\">%u</ReportInterval>\n", _fReportIntervalJson ? "Json" : "Text", _ulReportIntervalInMilliseconds);
+        AddXml(sXml, buffer);
+    }
+
+    if (_lfLatencySloPercentile > 0)
+    {
+        AddXmlInc(sXml, "<LatencySlo>\n");
+        sprintf_s(buffer, _countof(buffer), "<Percentile>%g</Percentile>\n", _lfLatencySloPercentile);
+        AddXml(sXml, buffer);
+        sprintf_s(buffer, _countof(buffer), "<Latency>%g</Latency>\n", _lfLatencySloMilliseconds);
+        AddXml(sXml, buffer);
+        sprintf_s(buffer, _countof(buffer), "<MaxRequestCount>%u</MaxRequestCount>\n", _dwLatencySloMaxRequestCount);
+        AddXml(sXml, buffer);
+        AddXmlDec(sXml, "</LatencySlo>\n");
+    }
+
+    if (_dwTotalThroughputIOPS)
+    {
+        sprintf_s(buffer, _countof(buffer), "<TotalThroughput unit=\"IOPS\">%u</TotalThroughput>\n", _dwTotalThroughputIOPS);
+        AddXml(sXml, buffer);
+    }
+    else if (_dwTotalThroughputBytesPerMillisecond)
+    {
+        sprintf_s(buffer, _countof(buffer), "<TotalThroughput>%u</TotalThroughput>\n", _dwTotalThroughputBytesPerMillisecond);
+        AddXml(sXml, buffer);
+    }
+
+    if (_vPhases.size() > 0)
+    {
+        AddXmlInc(sXml, "<Phases>\n");
+        for (const auto& phase : _vPhases)
+        {
+            AddXmlInc(sXml, "<Phase>\n");
+            sprintf_s(buffer, _countof(buffer), "<DurationMilliseconds>%u</DurationMilliseconds>\n", phase.GetDurationInMilliseconds());
+            AddXml(sXml, buffer);
+
+            switch (phase.GetShape())
+            {
+                case PhaseShape::Ramp:
+                AddXml(sXml, "<Shape>Ramp</Shape>\n");
+                break;
+
+                case PhaseShape::Sine:
+                AddXml(sXml, "<Shape>Sine</Shape>\n");
+                break;
+
+                case PhaseShape::Square:
+                AddXml(sXml, "<Shape>Square</Shape>\n");
+                break;
+
+                default:
+                AddXml(sXml, "<Shape>Constant</Shape>\n");
+            }
+
+            if (phase.GetShape() == PhaseShape::Sine || phase.GetShape() == PhaseShape::Square)
+            {
+                sprintf_s(buffer, _countof(buffer), "<PeriodMilliseconds>%u</PeriodMilliseconds>\n", phase.GetPeriodInMilliseconds());
+                AddXml(sXml, buffer);
+            }
+            if (phase.GetShape() == PhaseShape::Square)
+            {
+                sprintf_s(buffer, _countof(buffer), "<Duty>%u</Duty>\n", phase.GetDutyPercent());
+                AddXml(sXml, buffer);
+            }
+
+            const struct { const char *pszName; const PhaseSetting& setting; } aSettings[] = {
+                { "IOPS", phase.GetIOPS() },
+                { "WriteRatio", phase.GetWriteRatio() },
+                { "QueueDepth", phase.GetQueueDepth() } };
+
+            for (const auto& named : aSettings)
+            {
+                if (named.setting.fSet)
+                {
+                    sprintf_s(buffer, _countof(buffer), "<%s><From>%u</From><To>%u</To></%s>\n", named.pszName, named.setting.ulFrom, named.setting.ulTo, named.pszName);
+                    AddXml(sXml, buffer);
+                }
+            }
+            AddXmlDec(sXml, "</Phase>\n");
+        }
+        AddXmlDec(sXml, "</Phases>\n");
+    }
+
     sprintf_s(buffer, _countof(buffer), "<RandSeed>%u</RandSeed>\n", _ulRandSeed);
     AddXml(sXml, buffer);
 
@@ -663,6 +878,78 @@ void TimeSpan::MarkFilesAsPrecreated(const vector<string> vFiles)
     }
 }
 
+bool TimeSpan::GetPhasesSetWriteRatio() const
+{
+    for (const auto& phase : _vPhases)
+    {
+        if (phase.GetWriteRatio().fSet)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+vector<TimeSpan> TimeSpan::ExpandSweep() const
+{
+    vector<TimeSpan> vTimeSpans;
+
+    // an empty dimension is a single point which keeps the timespan's own setting (0)
+    const vector<DWORD> vdwNone(1, 0);
+    const vector<DWORD>& vdwBlockSizes = _vdwSweepBlockSizes.empty() ? vdwNone : _vdwSweepBlockSizes;
+    const vector<DWORD>& vdwThreadCounts = _vdwSweepThreadCounts.empty() ? vdwNone : _vdwSweepThreadCounts;
+    const vector<DWORD>& vdwRequestCounts = _vdwSweepRequestCounts.empty() ? vdwNone : _vdwSweepRequestCounts;
+
+    for (auto dwBlockSize : vdwBlockSizes)
+    {
+        for (auto dwThreadCount : vdwThreadCounts)
+        {
+            for (auto dwRequestCount : vdwRequestCounts)
+            {
+                TimeSpan timeSpan(*this);
+                timeSpan._vdwSweepBlockSizes.clear();
+                timeSpan._vdwSweepThreadCounts.clear();
+                timeSpan._vdwSweepRequestCounts.clear();
+
+                // -F and -O state threads and outstanding IOs for the timespan, -t and -o per target
+                if (dwThreadCount && _dwThreadCount)
+                {
+                    timeSpan._dwThreadCount = dwThreadCount;
+                }
+                if (dwRequestCount && _dwRequestCount)
+                {
+                    timeSpan._dwRequestCount = dwRequestCount;
+                }
+
+                for (auto& target : timeSpan._vTargets)
+                {
+                    if (dwBlockSize)
+                    {
+                        target.SetBlockSizeInBytes(dwBlockSize);
+                        if (target.GetBlockAlignmentFromBlockSize())
+                        {
+                            target.SetBlockAlignmentInBytes(dwBlockSize);
+                        }
+                    }
+                    if (dwThreadCount && !_dwThreadCount)
+                    {
+                        target.SetThreadsPerFile(dwThreadCount);
+                    }
+                    if (dwRequestCount && !_dwRequestCount)
+                    {
+                        target.SetRequestCount(dwRequestCount);
+                    }
+                }
+
+                vTimeSpans.push_back(timeSpan);
+            }
+        }
+    }
+
+    return vTimeSpans;
+}
+
 string Profile::GetXml(UINT32 indent) const
 {
     string sXml;
@@ -749,6 +1036,19 @@ void Profile::MarkFilesAsPrecreated(const vector<string> vFiles)
     }
 }
 
+void Profile::ExpandSweeps()
+{
+    vector<TimeSpan> vTimeSpans;
+
+    for (const auto& timeSpan : _vTimeSpans)
+    {
+        vector<TimeSpan> vPoints = timeSpan.ExpandSweep();
+        vTimeSpans.insert(vTimeSpans.end(), vPoints.begin(), vPoints.end());
+    }
+
+    _vTimeSpans = vTimeSpans;
+}
+
 bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
 {
     bool fOk = true;
@@ -805,14 +1105,152 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                 fOk = false;
             }
 
-            // ISSUE: with XML and the following the target specification validation it would be useful to say what
-            //      target they're for
+            if (!timeSpan.GetIoTracePath().empty() && !timeSpan.GetMeasureLatency())
+            {
+                fprintf(stderr, "ERROR: IO trace capture requires latency measurement (-L)\n");
+                fOk = false;
+            }
 
-            for (const auto& target : timeSpan.GetTargets())
+            if (timeSpan.GetLatencySignificantDigits() < 1 ||
+                timeSpan.GetLatencySignificantDigits() > Histogram<float>::MaxSignificantDigits)
             {
-                const bool targetHasMultipleThreads = (timeSpan.GetThreadCount() > 1) || (target.GetThreadsPerFile() > 1);
+                fprintf(stderr, "ERROR: latency histogram precision must be 1 to %u significant digits\n", Histogram<float>::MaxSignificantDigits);
+                fOk = false;
+            }
+            else if (timeSpan.GetLatencySignificantDigits() != Histogram<float>::DefaultSignificantDigits && !timeSpan.GetMeasureLatency())
+            {
+                fprintf(stderr, "ERROR: latency histogram precision requires latency measurement (-L)\n");
+                fOk = false;
+            }
 
-                if (timeSpan.GetThreadCount() > 0 && target.GetThreadsPerFile() > 1)
+            if (timeSpan.GetLatencySloPercentile() > 0 && !timeSpan.GetMeasureLatency())
+            {
+                fprintf(stderr, "ERROR: -K latency SLO search requires latency measurement (-L)\n");
+                fOk = false;
+            }
+
+            if ((timeSpan.GetTotalThroughputInBytesPerMillisecond() > 0 || timeSpan.GetTotalThroughputIOPS() > 0) &&
+                timeSpan.GetCompletionRoutines())
+            {
+                fprintf(stderr, "ERROR: -gr run throughput control cannot be used with -x completion routines\n");
+                fOk = false;
+            }
+
+            bool fPhaseRate = false;
+            bool fPhaseWriteRatio = false;
+            for (const auto& phase : timeSpan.GetPhases())
+            {
+                fPhaseRate = fPhaseRate || phase.GetIOPS().fSet;
+                fPhaseWriteRatio = fPhaseWriteRatio || phase.GetWriteRatio().fSet;
+
+                if (phase.GetDurationInMilliseconds() == 0)
+                {
+                    fprintf(stderr, "ERROR: load phase (-H) duration must be greater than zero\n");
+                    fOk = false;
+                }
+
+                if ((phase.GetShape() == PhaseShape::Sine || phase.GetShape() == PhaseShape::Square) &&
+                    phase.GetPeriodInMilliseconds() == 0)
+                {
+                    fprintf(stderr, "ERROR: load phase (-H) of %s shape needs a period greater than zero\n", LoadPhase::ShapeToString(phase.GetShape()));
+                    fOk = false;
+                }
+
+                if (phase.GetShape() == PhaseShape::Square &&
+                    (phase.GetDutyPercent() == 0 || phase.GetDutyPercent() >= 100))
+                {
+                    fprintf(stderr, "ERROR: load phase (-H) square duty must be between 1 and 99 percent\n");
+                    fOk = false;
+                }
+
+                if (phase.GetWriteRatio().fSet && (phase.GetWriteRatio().ulFrom > 100 || phase.GetWriteRatio().ulTo > 100))
+                {
+                    fprintf(stderr, "ERROR: load phase (-H) write ratio must be between 0 and 100 percent\n");
+                    fOk = false;
+                }
+
+                if (phase.GetQueueDepth().fSet && (phase.GetQueueDepth().ulFrom == 0 || phase.GetQueueDepth().ulTo == 0))
+                {
+                    fprintf(stderr, "ERROR: load phase (-H) outstanding IOs must be greater than zero\n");
+                    fOk = false;
+                }
+            }
+
+            if (timeSpan.GetPhases().size() > 0 && timeSpan.GetCompletionRoutines())
+            {
+                fprintf(stderr, "ERROR: -H load phases cannot be used with -x completion routines\n");
+                fOk = false;
+            }
+
+            if (timeSpan.GetIoEngine() == IoEngine::IoUring)
+            {
+                if (timeSpan.GetCompletionRoutines())
+                {
+                    fprintf(stderr, "ERROR: -u io_uring cannot be used with -x completion routines\n");
+                    fOk = false;
+                }
+
+#ifndef __linux__
+                if (GetProfileOnly() == false)
+                {
+                    fprintf(stderr, "ERROR: -u io_uring is only available on Linux\n");
+                    fOk = false;
+                }
+#endif
+            }
+            else
+            {
+                if (timeSpan.GetRegisteredIo())
+                {
+                    fprintf(stderr, "ERROR: registered buffers and files (-uf) can only be used with io_uring (-u)\n");
+                    fOk = false;
+                }
+
+                if (timeSpan.GetSqPoll())
+                {
+                    fprintf(stderr, "ERROR: submission queue polling (-up) can only be used with io_uring (-u)\n");
+                    fOk = false;
+                }
+            }
+
+            if (timeSpan.GetIoEngine() == IoEngine::LinuxAio)
+            {
+                if (timeSpan.GetCompletionRoutines())
+                {
+                    fprintf(stderr, "ERROR: -A Linux AIO cannot be used with -x completion routines\n");
+                    fOk = false;
+                }
+
+#ifndef __linux__
+                if (GetProfileOnly() == false)
+                {
+                    fprintf(stderr, "ERROR: -A Linux AIO is only available on Linux\n");
+                    fOk = false;
+                }
+#endif
+            }
+            else if (timeSpan.GetAioMinEvents() != 1)
+            {
+                fprintf(stderr, "ERROR: a minimum completion batch (-A<count>) can only be used with Linux AIO\n");
+                fOk = false;
+            }
+
+#ifdef __linux__
+            if (GetProfileOnly() == false && timeSpan.GetCompletionRoutines())
+            {
+                fprintf(stderr, "ERROR: completion routines (-x) are not supported on Linux\n");
+                fOk = false;
+            }
+#endif
+
+            // ISSUE: with XML and the following the target specification validation it would be useful to say what
+            //      target they're for
+
+            for (const auto& target : timeSpan.GetTargets())
+            {
+                const bool targetHasMultipleThreads = (timeSpan.GetThreadCount() > 1) || (target.GetThreadsPerFile() > 1);
+
+                if (timeSpan.GetThreadCount() > 0 && target.GetThreadsPerFile() > 1)
                 {
                     fprintf(stderr, "ERROR: -F and -t parameters cannot be used together\n");
                     fOk = false;
@@ -824,6 +1262,235 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                     fOk = false;
                 }
 
+                if (target.GetThrottleSpinMicroseconds() > 0 &&
+                    target.GetThroughputInBytesPerMillisecond() == 0 && target.GetThinkTime() == 0 &&
+                    target.GetTotalThroughputInBytesPerMillisecond() == 0 && target.GetTotalThroughputIOPS() == 0 &&
+                    timeSpan.GetTotalThroughputInBytesPerMillisecond() == 0 && timeSpan.GetTotalThroughputIOPS() == 0 &&
+                    !fPhaseRate)
+                {
+                    fprintf(stderr, "ERROR: -gs throttle spin time needs -g throughput control or -j think time\n");
+                    fOk = false;
+                }
+
+                bool fTotalThroughput = (target.GetTotalThroughputInBytesPerMillisecond() > 0 || target.GetTotalThroughputIOPS() > 0);
+                if (fTotalThroughput && timeSpan.GetCompletionRoutines())
+                {
+                    fprintf(stderr, "ERROR: -gt target throughput control cannot be used with -x completion routines\n");
+                    fOk = false;
+                }
+
+                if (target.GetArrivalRate() > 0)
+                {
+                    if (fTotalThroughput ||
+                        timeSpan.GetTotalThroughputInBytesPerMillisecond() > 0 || timeSpan.GetTotalThroughputIOPS() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -ga arrival rate cannot be used with -gt or -gr throughput control\n");
+                        fOk = false;
+                    }
+
+                    if (timeSpan.GetCompletionRoutines())
+                    {
+                        fprintf(stderr, "ERROR: -ga arrival rate cannot be used with -x completion routines\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetThroughputInBytesPerMillisecond() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -ga arrival rate cannot be used with -g throughput control\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetThinkTime() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -ga arrival rate cannot be used with -j think time\n");
+                        fOk = false;
+                    }
+                }
+
+                if (fPhaseRate &&
+                    (target.GetArrivalRate() > 0 || (!target.GetTracePath().empty() && target.GetTraceTimestamps())))
+                {
+                    fprintf(stderr, "ERROR: -H load phase IOPS cannot be used with -ga arrival rates or trace replay paced by timestamps\n");
+                    fOk = false;
+                }
+
+                if (fPhaseWriteRatio && !target.GetTracePath().empty())
+                {
+                    fprintf(stderr, "ERROR: -H load phase write ratio cannot be used with -Q trace replay; the trace states reads and writes\n");
+                    fOk = false;
+                }
+
+                if (timeSpan.GetLatencySloPercentile() > 0 &&
+                    (target.GetArrivalRate() > 0 || (!target.GetTracePath().empty() && target.GetTraceTimestamps())))
+                {
+                    fprintf(stderr, "ERROR: -K latency SLO search varies the outstanding IO count, which does not pace -ga arrival rates or trace replay paced by timestamps\n");
+                    fOk = false;
+                }
+
+                if (!target.GetTracePath().empty())
+                {
+                    if (target.GetRandomRatio() > 0 ||
+                        target.GetUseInterlockedSequential() ||
+                        target.GetUseParallelAsyncIO() ||
+                        target.GetDistributionType() != DistributionType::None ||
+                        target.GetBlockSizeMix().size())
+                    {
+                        fprintf(stderr, "ERROR: -Q trace replay cannot be used with -r, -rd, -si, -p or a block size mix; the trace states offsets and sizes\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetWriteRatio() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -Q trace replay cannot be used with -w; the trace states reads and writes\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetFlushRatio() > 0 || target.GetFuaWriteRatio() > 0 || target.GetTrimRatio() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -Q trace replay cannot be used with -wf flushes, -wu forced unit access writes or -wt trims\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetFileSetCount() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -Q trace replay cannot be used with -m file sets\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetArrivalRate() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -Q trace replay cannot be used with -ga arrival rate\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetTraceTimestamps())
+                    {
+                        if (target.GetThroughputInBytesPerMillisecond() > 0 || target.GetThinkTime() > 0)
+                        {
+                            fprintf(stderr, "ERROR: -Q trace replay paced by timestamps cannot be used with -g throughput control or -j think time; use -Qf\n");
+                            fOk = false;
+                        }
+
+                        if (timeSpan.GetCompletionRoutines())
+                        {
+                            fprintf(stderr, "ERROR: -Q trace replay paced by timestamps cannot be used with -x completion routines\n");
+                            fOk = false;
+                        }
+
+                        if (timeSpan.GetThreadCount() > 0 && timeSpan.GetRequestCount() > 0)
+                        {
+                            fprintf(stderr, "ERROR: -Q trace replay paced by timestamps cannot be used with -O outstanding requests per thread\n");
+                            fOk = false;
+                        }
+                    }
+                }
+
+                if (target.GetFlushRatio() > 100 || target.GetFuaWriteRatio() > 100 || target.GetTrimRatio() > 100)
+                {
+                    fprintf(stderr, "ERROR: flush (-wf), forced unit access write (-wu) and trim (-wt) ratios must be between 0 and 100 (percent)\n");
+                    fOk = false;
+                }
+                else if (target.GetMetadataRatio() > 100)
+                {
+                    fprintf(stderr, "ERROR: metadata operation ratio (-mm) must be between 0 and 100 (percent)\n");
+                    fOk = false;
+                }
+                else if (target.GetFlushRatio() + target.GetTrimRatio() + target.GetMetadataRatio() > 100)
+                {
+                    fprintf(stderr, "ERROR: flushes (-wf), trims (-wt) and metadata operations (-mm) together cannot be more than 100%% of IOs\n");
+                    fOk = false;
+                }
+
+                if (target.GetFuaWriteRatio() > 0 && target.GetWriteRatio() == 0 && !timeSpan.GetPhasesSetWriteRatio())
+                {
+                    fprintf(stderr, "ERROR: forced unit access writes (-wu) need a write ratio (-w)\n");
+                    fOk = false;
+                }
+
+                if (target.GetFlushRatio() > 0)
+                {
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: flushes (-wf) cannot be used with memory mapped IO (-Sm); see -N for its flush modes\n");
+                        fOk = false;
+                    }
+
+                    if (timeSpan.GetCompletionRoutines())
+                    {
+                        fprintf(stderr, "ERROR: flushes (-wf) cannot be used with -x completion routines\n");
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetTrimRatio() > 0)
+                {
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: trims (-wt) cannot be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+
+                    if (timeSpan.GetCompletionRoutines())
+                    {
+                        fprintf(stderr, "ERROR: trims (-wt) cannot be used with -x completion routines\n");
+                        fOk = false;
+                    }
+
+                    // trimmed data reads back as zeroes, or as anything at all
+                    if (target.GetVerifyData())
+                    {
+                        fprintf(stderr, "ERROR: trims (-wt) cannot be used with data verification (-Zv)\n");
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetFileSetCount() > 0)
+                {
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: file sets (-m) cannot be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+
+                    // the verifier keeps one map of written blocks per target, not per file
+                    if (target.GetVerifyData())
+                    {
+                        fprintf(stderr, "ERROR: file sets (-m) cannot be used with data verification (-Zv)\n");
+                        fOk = false;
+                    }
+
+                    if ((target.GetOpenPerIO() || target.GetMetadataRatio() > 0) && timeSpan.GetCompletionRoutines())
+                    {
+                        fprintf(stderr, "ERROR: opening files per IO (-mo) and metadata operations (-mm) cannot be used with -x completion routines\n");
+                        fOk = false;
+                    }
+
+                    if (target.GetMetadataRatio() > 0 && target.GetMetadataOps() == 0)
+                    {
+                        fprintf(stderr, "ERROR: metadata operations (-mm) need at least one of c, s, u or r\n");
+                        fOk = false;
+                    }
+                }
+                else if (target.GetFileSetSkew() != 0 || target.GetOpenPerIO() || target.GetMetadataRatio() > 0)
+                {
+                    fprintf(stderr, "ERROR: -mz, -mo and -mm need a file set (-m<count>)\n");
+                    fOk = false;
+                }
+
+                if (target.GetFileSetSkew() < 0 || target.GetFileSetSkew() >= 1)
+                {
+                    fprintf(stderr, "ERROR: file set Zipf skew (-mz) must be between 0 and 1\n");
+                    fOk = false;
+                }
+
+#ifndef __linux__
+                if (GetProfileOnly() == false && target.GetFuaWriteRatio() > 0)
+                {
+                    fprintf(stderr, "ERROR: forced unit access writes (-wu) are only available on Linux; see -Sw for writethrough\n");
+                    fOk = false;
+                }
+#endif
+
                 //  If burst size is specified think time must be specified and If think time is specified burst size should be non zero
                 if ((target.GetThinkTime() == 0 && target.GetBurstSize() > 0) || (target.GetThinkTime() > 0 && target.GetBurstSize() == 0))
                 {
@@ -839,6 +1506,12 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                         fOk = false;
                     }
 
+                    if (target.GetArrivalRate() > 0)
+                    {
+                        fprintf(stderr, "ERROR: -ga arrival rate cannot be used with -O outstanding requests per thread\n");
+                        fOk = false;
+                    }
+
                     if (target.GetThinkTime() > 0)
                     {
                         fprintf(stderr, "ERROR: -j think time cannot be used with -O outstanding requests per thread\n");
@@ -895,9 +1568,9 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                 }
                 else
                 {
-                    if (target.GetDistributionRange().size() != 0)
+                    if (target.GetDistributionType() != DistributionType::None)
                     {
-                        fprintf(stderr, "ERROR: random distribution ranges (-rd) do not apply to sequential-only IO patterns\n");
+                        fprintf(stderr, "ERROR: random distributions (-rd) do not apply to sequential-only IO patterns\n");
                         fOk = false;
                     }
 
@@ -927,7 +1600,7 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                     }
                     else
                     {
-                        if (targetHasMultipleThreads && !target.GetThreadStrideInBytes())
+                        if (targetHasMultipleThreads && !target.GetThreadStrideInBytes() && target.GetTracePath().empty())
                         {
                             fprintf(stderr, "WARNING: target access pattern will not be sequential, consider -si\n");
                         }
@@ -940,6 +1613,21 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                     }
                 }
 
+                // Skewed distributions: Zipf is generated for 0 < theta < 1, and a Pareto skew h
+                // greater than one half would make the first h of the target the cold part.
+                if (target.GetDistributionType() == DistributionType::Zipf &&
+                    !(target.GetDistributionSkew() > 0 && target.GetDistributionSkew() < 1))
+                {
+                    fprintf(stderr, "ERROR: invalid Zipf distribution theta %g - must be greater than 0 and less than 1\n", target.GetDistributionSkew());
+                    fOk = false;
+                }
+                if (target.GetDistributionType() == DistributionType::Pareto &&
+                    !(target.GetDistributionSkew() > 0 && target.GetDistributionSkew() < 0.5))
+                {
+                    fprintf(stderr, "ERROR: invalid Pareto distribution skew %g - must be greater than 0 and less than 0.5\n", target.GetDistributionSkew());
+                    fOk = false;
+                }
+
                 // Distribution ranges are only applied to random loads. Note validation failure in the sequential case.
                 // TBD this should be moved to a proper Distribution class.
                 {
@@ -959,7 +1647,7 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                             }
                             else if (r._dst.second < target.GetBlockSizeInBytes())
                             {
-                                fprintf(stderr, "ERROR: invalid random distribution target range %I64u - must be a minimum of the specified block size (%u bytes)\n", r._dst.second, target.GetBlockSizeInBytes());
+                                fprintf(stderr, "ERROR: invalid random distribution target range %llu - must be a minimum of the specified block size (%u bytes)\n", r._dst.second, target.GetBlockSizeInBytes());
                                 fOk = false;
                                 break;
                             }
@@ -979,7 +1667,7 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                         {
                             if (targetAcc + r._dst.second > 100)
                             {
-                                fprintf(stderr, "ERROR: invalid random distribution Target%% %I64u: can be at most %I64u - total must be <= 100%%\n", r._dst.second, 100 - targetAcc);
+                                fprintf(stderr, "ERROR: invalid random distribution Target%% %llu: can be at most %llu - total must be <= 100%%\n", r._dst.second, 100 - targetAcc);
                                 fOk = false;
                                 break;
                             }
@@ -1002,7 +1690,7 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                     if (target.GetDistributionType() == DistributionType::Percent &&
                         targetAcc != 100)
                     {
-                        fprintf(stderr, "ERROR: invalid random distribution span: Target%% (%I64u%%) must total 100%%\n", targetAcc);
+                        fprintf(stderr, "ERROR: invalid random distribution span: Target%% (%llu%%) must total 100%%\n", targetAcc);
                         fOk = false;
                     }
                     if (absZero && !absZeroLast)
@@ -1012,11 +1700,82 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                     }
                 }
 
+                if (target.GetReducibleWriteData())
+                {
+                    if (target.GetCompressionRatio() < 1 || target.GetCompressionRatio() > ReducibleDataPool::MaxCompressionRatio)
+                    {
+                        fprintf(stderr, "ERROR: compression ratio of write data (-Zc) must be between 1 and %u\n", ReducibleDataPool::MaxCompressionRatio);
+                        fOk = false;
+                    }
+                    if (target.GetDedupRatio() < 1)
+                    {
+                        fprintf(stderr, "ERROR: dedup ratio of write data (-Zc) must be at least 1\n");
+                        fOk = false;
+                    }
+                    if (target.GetDedupChunkSize() == 0 || (target.GetDedupChunkSize() % ReducibleDataPool::SegmentSize) != 0)
+                    {
+                        fprintf(stderr, "ERROR: dedup chunk size of write data (-Zc) must be a multiple of %u bytes\n", ReducibleDataPool::SegmentSize);
+                        fOk = false;
+                    }
+                    if (target.GetZeroWriteBuffers() || target.GetRandomDataWriteBufferSize() > 0 || timeSpan.GetRandomWriteData())
+                    {
+                        fprintf(stderr, "ERROR: compressible and dedupable write data (-Zc) can not be combined with other write data (-Z, -Zr or -Z<size>)\n");
+                        fOk = false;
+                    }
+                }
+
+                if (target.GetVerifyData())
+                {
+                    UINT32 cbUnit = target.GetVerifyUnitSize();
+                    bool fAligned = (target.GetBlockSizeInBytes() % cbUnit) == 0 &&
+                                    (target.GetBlockAlignmentInBytes() % cbUnit) == 0 &&
+                                    (target.GetBaseFileOffsetInBytes() % cbUnit) == 0 &&
+                                    (target.GetThreadStrideInBytes() % cbUnit) == 0;
+
+                    for (const auto& b : target.GetBlockSizeMix())
+                    {
+                        fAligned = fAligned && (b.dwBlockSize % cbUnit) == 0;
+                    }
+
+                    if (cbUnit < DataVerifier::MinUnitSize || (cbUnit % DataVerifier::MinUnitSize) != 0)
+                    {
+                        fprintf(stderr, "ERROR: verify unit of write data (-Zv) must be a multiple of %u bytes\n", DataVerifier::MinUnitSize);
+                        fOk = false;
+                    }
+                    else if (!fAligned)
+                    {
+                        fprintf(stderr, "ERROR: block sizes, alignment (-r/-s), base offset (-B) and thread stride (-T) must be multiples of the verify unit of write data (-Zv, %u bytes)\n", cbUnit);
+                        fOk = false;
+                    }
+                    if (target.GetRandomDataWriteBufferSize() > 0)
+                    {
+                        fprintf(stderr, "ERROR: verified write data (-Zv) can not be combined with a shared write buffer (-Z<size>)\n");
+                        fOk = false;
+                    }
+                    if (!target.GetTracePath().empty())
+                    {
+                        fprintf(stderr, "ERROR: verified write data (-Zv) can not be combined with -Q trace replay\n");
+                        fOk = false;
+                    }
+
+                    // threads of the same target share its generation map; a second target of the same path would not
+                    UINT32 cSamePath = 0;
+                    for (const auto& otherTarget : timeSpan.GetTargets())
+                    {
+                        cSamePath += (otherTarget.GetPath() == target.GetPath()) ? 1 : 0;
+                    }
+                    if (cSamePath > 1)
+                    {
+                        fprintf(stderr, "ERROR: verified write data (-Zv) requires target '%s' be specified once\n", target.GetPath().c_str());
+                        fOk = false;
+                    }
+                }
+
                 if (target.GetRandomDataWriteBufferSize() > 0)
                 {
                     if (target.GetRandomDataWriteBufferSize() < target.GetBlockSizeInBytes())
                     {
-                        fprintf(stderr, "ERROR: custom write buffer (-Z) is smaller than the block size. Write buffer size: %I64u block size: %u\n",
+                        fprintf(stderr, "ERROR: custom write buffer (-Z) is smaller than the block size. Write buffer size: %llu block size: %u\n",
                             target.GetRandomDataWriteBufferSize(),
                             target.GetBlockSizeInBytes());
                         fOk = false;
@@ -1030,6 +1789,16 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                         fprintf(stderr, "ERROR: completion routines (-x) can't be used with memory mapped IO (-Sm)\n");
                         fOk = false;
                     }
+                    if (timeSpan.GetIoEngine() == IoEngine::IoUring)
+                    {
+                        fprintf(stderr, "ERROR: io_uring (-u) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
+                    if (timeSpan.GetIoEngine() == IoEngine::LinuxAio)
+                    {
+                        fprintf(stderr, "ERROR: Linux AIO (-A) can't be used with memory mapped IO (-Sm)\n");
+                        fOk = false;
+                    }
                     if (target.GetCacheMode() == TargetCacheMode::DisableOSCache)
                     {
                         fprintf(stderr, "ERROR: unbuffered IO (-Su or -Sh) can't be used with memory mapped IO (-Sm)\n");
@@ -1044,6 +1813,27 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
                     fOk = false;
                 }
 
+#ifdef __linux__
+                if (GetProfileOnly() == false)
+                {
+                    if (target.GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+                    {
+                        fprintf(stderr, "ERROR: memory mapped IO (-Sm) is not supported on Linux\n");
+                        fOk = false;
+                    }
+                    if (target.GetCacheMode() == TargetCacheMode::DisableLocalCache)
+                    {
+                        fprintf(stderr, "ERROR: disabling the local cache (-Sr) is not supported on Linux\n");
+                        fOk = false;
+                    }
+                    if (target.GetIOPriorityHint() != IoPriorityHintNormal)
+                    {
+                        fprintf(stderr, "ERROR: IO priority hints (-I) are not supported on Linux\n");
+                        fOk = false;
+                    }
+                }
+#endif
+
                 if (GetProfileOnly() == false)
                 {
                     auto sPath = target.GetPath();
@@ -1077,9 +1867,134 @@ bool Profile::Validate(bool fSingleSpec, SystemInformation *pSystem) const
         }
     }
 
+#ifdef __linux__
+    if (GetProfileOnly() == false && GetEtwEnabled())
+    {
+        fprintf(stderr, "ERROR: ETW tracing (-e) is not supported on Linux\n");
+        fOk = false;
+    }
+#endif
+
     return fOk;
 }
 
+static BYTE *AllocateDataBuffer(size_t cb, bool fLargePages)
+{
+    if (fLargePages)
+    {
+        size_t cbMinLargePage = GetLargePageMinimum();
+        size_t cbRoundedSize = (cb + cbMinLargePage - 1) & ~(cbMinLargePage - 1);
+        return (BYTE *)VirtualAlloc(nullptr, cbRoundedSize, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_EXECUTE_READWRITE);
+    }
+
+    return (BYTE *)VirtualAlloc(nullptr, cb, MEM_COMMIT, PAGE_READWRITE);
+}
+
+HANDLE ThreadResourcePool::AcquireHandle(const UniqueTarget& target)
+{
+    auto i = _mIdleHandles.find(target);
+    if (i == _mIdleHandles.end())
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    HANDLE hFile = i->second;
+    _mIdleHandles.erase(i);
+    return hFile;
+}
+
+void ThreadResourcePool::ReleaseHandle(const UniqueTarget& target, HANDLE hFile)
+{
+    _mIdleHandles.insert(make_pair(target, hFile));
+}
+
+BYTE *ThreadResourcePool::AcquireBuffer(size_t cb, bool fLargePages, BufferFill fill, bool fKeepFill, bool *pfFilled)
+{
+    Buffer *pFit = nullptr;
+    size_t iLargestIdle = _vBuffers.size();
+
+    for (size_t i = 0; i < _vBuffers.size(); i++)
+    {
+        Buffer& buffer = _vBuffers[i];
+        if (buffer.fInUse || buffer.fLargePages != fLargePages)
+        {
+            continue;
+        }
+
+        // prefer a buffer which already holds the fill, else the smallest which is large enough
+        if (buffer.cb >= cb)
+        {
+            bool fFilled = (buffer.fill == fill && buffer.cbFilled == cb);
+            if (pFit == nullptr || fFilled || (!(pFit->fill == fill && pFit->cbFilled == cb) && buffer.cb < pFit->cb))
+            {
+                pFit = &buffer;
+            }
+        }
+        else if (iLargestIdle == _vBuffers.size() || buffer.cb > _vBuffers[iLargestIdle].cb)
+        {
+            iLargestIdle = i;
+        }
+    }
+
+    if (pFit == nullptr)
+    {
+        // the largest idle buffer which is too small is replaced, so that buffers do not pile up as sizes grow
+        if (iLargestIdle != _vBuffers.size())
+        {
+            VirtualFree(_vBuffers[iLargestIdle].pBuffer, 0, MEM_RELEASE);
+            _vBuffers.erase(_vBuffers.begin() + iLargestIdle);
+        }
+
+        Buffer buffer = {};
+        buffer.pBuffer = AllocateDataBuffer(cb, fLargePages);
+        if (buffer.pBuffer == nullptr)
+        {
+            return nullptr;
+        }
+        buffer.cb = cb;
+        buffer.fLargePages = fLargePages;
+        buffer.fill = BufferFill::None;
+
+        _vBuffers.push_back(buffer);
+        pFit = &_vBuffers.back();
+    }
+
+    *pfFilled = (fill != BufferFill::None && pFit->fill == fill && pFit->cbFilled == cb);
+
+    pFit->fInUse = true;
+    pFit->fill = fKeepFill ? fill : BufferFill::None;
+    pFit->cbFilled = cb;
+
+    return pFit->pBuffer;
+}
+
+void ThreadResourcePool::ReleaseBuffer(BYTE *pBuffer)
+{
+    for (auto& buffer : _vBuffers)
+    {
+        if (buffer.pBuffer == pBuffer)
+        {
+            buffer.fInUse = false;
+            break;
+        }
+    }
+}
+
+void ThreadResourcePool::Clear()
+{
+    for (auto& i : _mIdleHandles)
+    {
+        CloseHandle(i.second);
+    }
+    _mIdleHandles.clear();
+
+    for (auto& buffer : _vBuffers)
+    {
+        VirtualFree(buffer.pBuffer, 0, MEM_RELEASE);
+    }
+    _vBuffers.clear();
+}
+
 bool ThreadParameters::AllocateAndFillBufferForTarget(const Target& target)
 {
     bool fOk = true;
@@ -1094,29 +2009,37 @@ bool ThreadParameters::AllocateAndFillBufferForTarget(const Target& target)
         requestCount = pTimeSpan->GetRequestCount();
     }
 
+    // Fill the buffer only if it is used for writes
+    BufferFill fill = BufferFill::None;
+    if (target.GetWriteRatio() > 0 || !target.GetTracePath().empty() || pTimeSpan->GetPhasesSetWriteRatio())
+    {
+        fill = target.GetZeroWriteBuffers() ? BufferFill::Zero : BufferFill::Pattern;
+    }
+    bool fFilled = false;
+
     // Create separate read & write buffers so the write content doesn't get overriden by reads
     cbDataBuffer = (size_t) target.GetBlockSizeInBytes() * requestCount * 2;
-    if (target.GetUseLargePages())
+    if (pResourcePool != nullptr)
     {
-        size_t cbMinLargePage = GetLargePageMinimum();
-        size_t cbRoundedSize = (cbDataBuffer + cbMinLargePage - 1) & ~(cbMinLargePage - 1);
-        pDataBuffer = (BYTE *)VirtualAlloc(nullptr, cbRoundedSize, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_EXECUTE_READWRITE);
+        // random, reducible and verified write data is generated into the write buffers as IO is issued
+        bool fKeepFill = !(pTimeSpan->GetRandomWriteData() && !target.GetZeroWriteBuffers()) && !target.GetReducibleWriteData() && !target.GetVerifyData();
+        pDataBuffer = pResourcePool->AcquireBuffer(cbDataBuffer, target.GetUseLargePages(), fill, fKeepFill, &fFilled);
     }
     else
     {
-        pDataBuffer = (BYTE *)VirtualAlloc(nullptr, cbDataBuffer, MEM_COMMIT, PAGE_READWRITE);
+        pDataBuffer = AllocateDataBuffer(cbDataBuffer, target.GetUseLargePages());
     }
 
     fOk = (pDataBuffer != nullptr);
 
     //fill buffer (useful only for write tests)
-    if (fOk && target.GetWriteRatio() > 0)
+    if (fOk && !fFilled)
     {
-        if (target.GetZeroWriteBuffers())
+        if (fill == BufferFill::Zero)
         {
             memset(pDataBuffer, 0, cbDataBuffer);
         }
-        else
+        else if (fill == BufferFill::Pattern)
         {
             for (size_t i = 0; i < cbDataBuffer; i++)
             {
@@ -1154,11 +2077,16 @@ BYTE* ThreadParameters::GetWriteBuffer(size_t iTarget, size_t iRequest)
         // run-time.  When tested in a single-threaded, CPU limited environment
         // with 4K random writes, doing memset to fill the buffer got 112K IOPS,
         // this algorithm got 111K IOPS.  Using a static buffer got 118K IOPS.
-        // This was tested with a 64-bit diskspd.exe.  With a 32-bit version it
-        // may be more efficient to do 32-bit operations.
+        // This was tested with a 64-bit diskspd.exe.  Large blocks are filled
+        // with the widest vector instructions the processor has, which with
+        // AVX-512 keeps pace with memset at 1MB.
         //
 
-        if (pTimeSpan->GetRandomWriteData() &&
+        if (target.GetDataPool() != nullptr)
+        {
+            target.GetDataPool()->Fill(pBuffer, vTargets[iTarget].GetBlockSizeInBytes(), pRand);
+        }
+        else if (pTimeSpan->GetRandomWriteData() &&
             !target.GetZeroWriteBuffers())
         {
             pRand->RandBuffer(pBuffer, vTargets[iTarget].GetBlockSizeInBytes(), true);
@@ -1173,6 +2101,12 @@ BYTE* ThreadParameters::GetWriteBuffer(size_t iTarget, size_t iRequest)
 
 bool ThreadParameters::InitializeMappedViewForTarget(Target& target, DWORD DesiredAccess)
 {
+#ifdef __linux__
+    // memory mapped IO is rejected during validation
+    UNREFERENCED_PARAMETER(target);
+    UNREFERENCED_PARAMETER(DesiredAccess);
+    return false;
+#else
     bool fOk = true;
     DWORD dwProtect = PAGE_READWRITE;
 
@@ -1208,6 +2142,7 @@ bool ThreadParameters::InitializeMappedViewForTarget(Target& target, DWORD Desir
         fprintf(stderr, "FATAL ERROR: Could not create a file mapping for target '%s'. Error code: 0x%x\n", target.GetPath().c_str(), GetLastError());
     }
     return fOk;
+#endif
 }
 
 DWORD ThreadParameters::GetTotalRequestCount() const
@@ -29,24 +29,26 @@ SOFTWARE.
 
 #pragma once
 
-#include <windows.h>
-#include <powersetting.h>
-#include <powrprof.h>
-#include <VersionHelpers.h>
-#include <TraceLoggingProvider.h>
-#include <TraceLoggingActivity.h>
-#include <evntrace.h>
+#include "Platform.h"
 #include <ctime>
 #include <vector>
 #include <algorithm>
+#include <map>
 #include <set>
+#include <deque>
+#include <new>
 #include <locale>
 #include <codecvt>
-#include <Winternl.h>   //ntdll.dll
 #include <assert.h>
+#include <cmath>
 #include "Histogram.h"
 #include "IoBucketizer.h"
+#include "LoadPhase.h"
+#include "ReducibleData.h"
+#include "DataVerifier.h"
 #include "ThroughputMeter.h"
+#include "TraceReader.h"
+#include "IoTrace.h"
 #include "Version.h"
 
 using namespace std;
@@ -70,7 +72,7 @@ typedef void (WINAPI *PRINTF)(const char*, va_list);
 #define MB (((UINT64)1)<<20)
 #define KB (((UINT64)1)<<10)
 
-#define EXPERIMENT_TPUT_CALC        0x1 // precise ms sleep calculation for low rate throughput control
+#define EXPERIMENT_TPUT_CALC        0x1 // no longer used: throttle waits are always calculated from the rate
 extern ULONG g_ExperimentFlags;
 
 struct ETWEventCounters
@@ -245,7 +247,9 @@ enum class DistributionType
 {
     None,
     Absolute,
-    Percent
+    Percent,
+    Zipf,       // skewed by rank over the target's aligned offsets, parameterized by theta
+    Pareto      // self-similar: 1-h of IO to the first h of the target, recursively
 };
 
 //
@@ -253,6 +257,16 @@ enum class DistributionType
 // See http://burtleburtle.net/bob/rand/smallprng.html for details
 //
 
+// instruction sets Random::RandBuffer can generate with
+enum class RandFill
+{
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512,
+    Neon
+};
+
 class Random
 {
 public:
@@ -276,10 +290,32 @@ public:
         return (UINT32)Rand64();
     }
 
+    // uniform on [0, 1) with the full 53 bit precision of a double
+    inline double RandDouble()
+    {
+        return (double)(Rand64() >> 11) / (double)(1ULL << 53);
+    }
+
     void RandBuffer(BYTE *pBuffer, UINT32 ulLength, bool fPseudoRandomOkay);
 
+    // RandBuffer uses the widest instruction set the processor supports; it can be held
+    // to a narrower one, and generates the same content with each
+    static bool IsFillSupported(RandFill fill);
+    static RandFill GetBestFill();
+    bool SetFill(RandFill fill);
+    RandFill GetFill() const { return _fill; }
+    static const char *FillToString(RandFill fill);
+
+    // generators RandBuffer runs side by side, one 8 byte word of each to a cache line
+    static const UINT32 LaneCount = 8;
+
 private:
+    void _FillLines(UINT64 *pBuffer64, size_t cLines);
+
     UINT64 _ulState[4];
+    UINT64 _ulLaneState[4][LaneCount];
+    bool _fLanesSeeded;
+    RandFill _fill;
 };
 
 struct PercentileDescriptor
@@ -292,6 +328,7 @@ class Util
 {
 public:
     static string DoubleToStringHelper(const double);
+    static double Zeta(UINT64 n, double theta);
     template<typename T> static T QuotientCeiling(T dividend, T divisor)
     {
         return (dividend + divisor - 1) / divisor;
@@ -364,12 +401,215 @@ public:
     }
 };
 
+//
+// Zipf distributed ranks over a number of items, 0 being the hottest, for 0 < theta < 1. The
+// constants are computed once so that each rank is an O(1) draw. Follows Gray et al., "Quickly
+// Generating Billion-Record Synthetic Databases" (SIGMOD 1994).
+//
+class ZipfRanks
+{
+public:
+    ZipfRanks() :
+        _cItems(0),
+        _lfExponent(0),
+        _lfZetaN(0),
+        _lfEta(0),
+        _lfHead(0)
+    {
+    }
+
+    void Initialize(UINT64 cItems, double theta)
+    {
+        _cItems = cItems;
+        _lfExponent = 1.0 / (1.0 - theta);
+        _lfZetaN = Util::Zeta(cItems, theta);
+        _lfHead = 1.0 + pow(0.5, theta);
+
+        // with two or fewer items every draw is resolved by the head of the distribution
+        if (cItems > 2)
+        {
+            _lfEta = (1.0 - pow(2.0 / cItems, 1.0 - theta)) / (1.0 - Util::Zeta(2, theta) / _lfZetaN);
+        }
+    }
+
+    UINT64 GetItemCount() const { return _cItems; }
+
+    // rank of a uniform draw on [0, 1)
+    UINT64 Rank(double u) const
+    {
+        double uz = u * _lfZetaN;
+
+        if (uz < 1.0)
+        {
+            return 0;
+        }
+        if (uz < _lfHead)
+        {
+            return 1;
+        }
+
+        UINT64 rank = (UINT64)(_cItems * pow(_lfEta * u - _lfEta + 1.0, _lfExponent));
+        return rank < _cItems ? rank : _cItems - 1;
+    }
+
+private:
+    UINT64 _cItems;
+    double _lfExponent;                 // 1/(1-theta)
+    double _lfZetaN;                    // zeta(items, theta)
+    double _lfEta;
+    double _lfHead;                     // zeta(2, theta), the weight of the two hottest items
+};
+
+//
+// A fixed permutation of a number of items, used to scatter the ranks of a skewed distribution
+// across them rather than leaving the hottest contiguous. It is a bijection on the power of two
+// covering the items, built of odd multiplies and xor-shifts, which is cycle walked back into
+// range: the expected number of rounds per rank is less than two. The permutation depends only on
+// the number of items, so that threads drawing over the same items share the hot set.
+//
+class RankPermutation
+{
+public:
+    RankPermutation() :
+        _cItems(0),
+        _ullMask(0),
+        _ulShift(1)
+    {
+    }
+
+    void Initialize(UINT64 cItems)
+    {
+        UINT32 cBits = 0;
+
+        _cItems = cItems;
+        _ullMask = 0;
+        while (_ullMask < cItems - 1)
+        {
+            _ullMask = (_ullMask << 1) | 1;
+            cBits++;
+        }
+
+        // fold the high half of the bits into the low half, which the multiplies mix poorly
+        _ulShift = (cBits + 1) / 2;
+        if (_ulShift == 0)
+        {
+            _ulShift = 1;
+        }
+    }
+
+    UINT64 Permute(UINT64 rank) const
+    {
+        assert(rank < _cItems);
+
+        do
+        {
+            rank = (rank * 0x9e3779b97f4a7c15ULL + 0x632be59bd9b4e019ULL) & _ullMask;
+            rank ^= rank >> _ulShift;
+            rank = (rank * 0xbf58476d1ce4e5b9ULL) & _ullMask;
+            rank ^= rank >> _ulShift;
+        } while (rank >= _cItems);
+
+        return rank;
+    }
+
+private:
+    UINT64 _cItems;
+    UINT64 _ullMask;                    // power of two covering the items, less one
+    UINT32 _ulShift;
+};
+
 // To keep track of which type of IO was issued
 enum class IOOperation
 {
     Unknown = 0,
     ReadIO,
-    WriteIO
+    WriteIO,
+    FlushIO,        // flush of the target's written data to stable media; transfers no data
+    TrimIO,         // discard of a range of the target; transfers no data
+    MetadataIO      // create, stat, unlink or rename in a file set target's directory; transfers no data
+};
+
+// Operations on the files of a file set target (-m): those drawn by the IO mix (-mm), then the
+// opens and closes around each IO when files are opened per IO (-mo)
+enum class MetadataOp
+{
+    Create = 0,
+    Stat,
+    Unlink,
+    Rename,
+    Open,
+    Close,
+    Count
+};
+
+// the bit of an operation in a target's mask of the metadata operations its IO mix draws
+inline UINT32 MetadataOpMask(MetadataOp op) { return 1u << static_cast<UINT32>(op); }
+
+inline const char *MetadataOpName(MetadataOp op)
+{
+    static const char *names[] = { "create", "stat", "unlink", "rename", "open", "close" };
+    return names[static_cast<size_t>(op)];
+}
+
+// Results for one kind of metadata operation of a file set target
+class MetadataResults
+{
+public:
+    MetadataResults() :
+        ullCount(0)
+    {
+    }
+
+    UINT64 ullCount;
+
+    Histogram<float> latencyHistogram;
+};
+
+// One size class of a target's block size mix (-b<size>:<weight>,...)
+struct BlockSizeWeight
+{
+    DWORD dwBlockSize;
+    UINT32 ulWeight;
+};
+
+// Results for one size class of a target's block size mix
+class BlockSizeResults
+{
+public:
+    BlockSizeResults(DWORD dwBlockSize = 0) :
+        dwBlockSize(dwBlockSize),
+        ullReadIOCount(0),
+        ullWriteIOCount(0)
+    {
+    }
+
+    DWORD dwBlockSize;
+    UINT64 ullReadIOCount;
+    UINT64 ullWriteIOCount;
+
+    Histogram<float> readLatencyHistogram;
+    Histogram<float> writeLatencyHistogram;
+};
+
+// Results for one load phase of the timespan (-H), over all the times it ran
+class PhaseResults
+{
+public:
+    PhaseResults() :
+        ullReadBytesCount(0),
+        ullReadIOCount(0),
+        ullWriteBytesCount(0),
+        ullWriteIOCount(0)
+    {
+    }
+
+    UINT64 ullReadBytesCount;
+    UINT64 ullReadIOCount;
+    UINT64 ullWriteBytesCount;
+    UINT64 ullWriteIOCount;
+
+    Histogram<float> readLatencyHistogram;
+    Histogram<float> writeLatencyHistogram;
 };
 
 class TargetResults
@@ -382,7 +622,15 @@ public:
         ullReadBytesCount(0),
         ullReadIOCount(0),
         ullWriteBytesCount(0),
-        ullWriteIOCount(0)
+        ullWriteIOCount(0),
+        ullFlushIOCount(0),
+        ullTrimBytesCount(0),
+        ullTrimIOCount(0),
+        ullMetadataIOCount(0),
+        ullFuaWriteBytesCount(0),
+        ullFuaWriteIOCount(0),
+        ullVerifiedCount(0),
+        ullVerifyErrorCount(0)
     {
 
     }
@@ -394,9 +642,21 @@ public:
         UINT64 ullIoEndTime,
         UINT64 ullSpanStartTime,
         bool fMeasureLatency,
-        bool fCalculateIopsStdDev
+        bool fCalculateIopsStdDev,
+        size_t iBlockSize = 0,
+        size_t iPhase = 0,
+        bool fFua = false
         )
     {
+        if (type == IOOperation::FlushIO || type == IOOperation::TrimIO)
+        {
+            _AddFlushOrTrim(dwBytesTransferred, type, ullIoStartTime, ullIoEndTime, ullSpanStartTime, fMeasureLatency, fCalculateIopsStdDev);
+            return;
+        }
+
+        BlockSizeResults *pBlockSizeResults = vBlockSizeResults.size() ? &vBlockSizeResults[iBlockSize] : nullptr;
+        PhaseResults *pPhaseResults = vPhaseResults.size() ? &vPhaseResults[iPhase] : nullptr;
+
         if (type == IOOperation::ReadIO)
         {
             ullReadBytesCount += dwBytesTransferred;    // update read bytes counter
@@ -406,6 +666,38 @@ public:
         {
             ullWriteBytesCount += dwBytesTransferred;   // update write bytes counter
             ullWriteIOCount++;                          // update completed write I/O operations counter
+
+            if (fFua)
+            {
+                ullFuaWriteBytesCount += dwBytesTransferred;
+                ullFuaWriteIOCount++;
+            }
+        }
+
+        if (pBlockSizeResults)
+        {
+            if (type == IOOperation::ReadIO)
+            {
+                pBlockSizeResults->ullReadIOCount++;
+            }
+            else
+            {
+                pBlockSizeResults->ullWriteIOCount++;
+            }
+        }
+
+        if (pPhaseResults)
+        {
+            if (type == IOOperation::ReadIO)
+            {
+                pPhaseResults->ullReadBytesCount += dwBytesTransferred;
+                pPhaseResults->ullReadIOCount++;
+            }
+            else
+            {
+                pPhaseResults->ullWriteBytesCount += dwBytesTransferred;
+                pPhaseResults->ullWriteIOCount++;
+            }
         }
 
         ullBytesCount += dwBytesTransferred;            // update bytes counter
@@ -432,41 +724,465 @@ public:
             else
             {
                 writeLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+
+                if (fFua)
+                {
+                    fuaWriteLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+                }
+            }
+
+            if (pBlockSizeResults)
+            {
+                if (type == IOOperation::ReadIO)
+                {
+                    pBlockSizeResults->readLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+                }
+                else
+                {
+                    pBlockSizeResults->writeLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+                }
+            }
+
+            if (pPhaseResults)
+            {
+                if (type == IOOperation::ReadIO)
+                {
+                    pPhaseResults->readLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+                }
+                else
+                {
+                    pPhaseResults->writeLatencyHistogram.Add(static_cast<float>(lfDurationUsec));
+                }
+            }
+        }
+
+        if (fCalculateIopsStdDev)
+        {
+            UINT64 ullRelativeCompletionTime = ullIoEndTime - ullSpanStartTime;
+
+            if (type == IOOperation::ReadIO)
+            {
+                readBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
+            }
+            else
+            {
+                writeBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
+
+                if (fFua)
+                {
+                    fuaWriteBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
+                }
+            }
+        }
+    }
+
+    string sPath;
+    UINT64 ullFileSize;         //size of the file
+    UINT64 ullBytesCount;       //number of accessed bytes
+    UINT64 ullIOCount;          //number of performed I/O operations
+    UINT64 ullReadBytesCount;   //number of bytes read
+    UINT64 ullReadIOCount;      //number of performed Read I/O operations
+    UINT64 ullWriteBytesCount;  //number of bytes written
+    UINT64 ullWriteIOCount;     //number of performed Write I/O operations
+    UINT64 ullFlushIOCount;     //number of performed flushes (in ullIOCount, transferring no bytes)
+    UINT64 ullTrimBytesCount;   //number of bytes trimmed (not in ullBytesCount)
+    UINT64 ullTrimIOCount;      //number of performed trims (in ullIOCount)
+    UINT64 ullMetadataIOCount;  //number of performed metadata operations of the IO mix (in ullIOCount)
+
+    // writes issued with forced unit access, also counted in the writes
+    UINT64 ullFuaWriteBytesCount;
+    UINT64 ullFuaWriteIOCount;
+
+    // data verification (-Zv), over the whole run including warmup and cooldown
+    UINT64 ullVerifiedCount;    //number of units read and verified
+    UINT64 ullVerifyErrorCount; //number of units which failed verification
+
+    Histogram<float> readLatencyHistogram;
+    Histogram<float> writeLatencyHistogram;
+    Histogram<float> flushLatencyHistogram;
+    Histogram<float> trimLatencyHistogram;
+    Histogram<float> fuaWriteLatencyHistogram;
+
+    IoBucketizer readBucketizer;
+    IoBucketizer writeBucketizer;
+    IoBucketizer flushBucketizer;
+    IoBucketizer trimBucketizer;
+    IoBucketizer fuaWriteBucketizer;
+
+    // Effective distribution after applying to target size (if specified/non-empty)
+    vector<DistributionRange> vDistributionRange;
+
+    // Breakdown by size class, in the order of the target's block size mix (if specified/non-empty)
+    vector<BlockSizeResults> vBlockSizeResults;
+
+    // Breakdown by the timespan's load phases (if specified/non-empty)
+    vector<PhaseResults> vPhaseResults;
+
+    // Breakdown of a file set target's metadata operations, by MetadataOp (if a file set/non-empty)
+    vector<MetadataResults> vMetadataResults;
+
+    // Sets the precision of all latency histograms, including those of the breakdowns, which must
+    // already be sized.
+    void SetLatencySignificantDigits(unsigned significantDigits)
+    {
+        readLatencyHistogram.SetSignificantDigits(significantDigits);
+        writeLatencyHistogram.SetSignificantDigits(significantDigits);
+        flushLatencyHistogram.SetSignificantDigits(significantDigits);
+        trimLatencyHistogram.SetSignificantDigits(significantDigits);
+        fuaWriteLatencyHistogram.SetSignificantDigits(significantDigits);
+
+        for (auto& b : vBlockSizeResults)
+        {
+            b.readLatencyHistogram.SetSignificantDigits(significantDigits);
+            b.writeLatencyHistogram.SetSignificantDigits(significantDigits);
+        }
+        for (auto& phase : vPhaseResults)
+        {
+            phase.readLatencyHistogram.SetSignificantDigits(significantDigits);
+            phase.writeLatencyHistogram.SetSignificantDigits(significantDigits);
+        }
+        for (auto& m : vMetadataResults)
+        {
+            m.latencyHistogram.SetSignificantDigits(significantDigits);
+        }
+    }
+
+    // Metadata operations are not broken down by size class or load phase. Those of the IO mix
+    // count as IOs; the opens and closes of -mo are part of the IO they are made for.
+    void AddMetadata(MetadataOp op, UINT64 ullIoStartTime, UINT64 ullIoEndTime, bool fMeasureLatency)
+    {
+        MetadataResults& metadataResults = vMetadataResults[static_cast<size_t>(op)];
+
+        metadataResults.ullCount++;
+        if (op < MetadataOp::Open)
+        {
+            ullMetadataIOCount++;
+            ullIOCount++;
+        }
+
+        if (fMeasureLatency && ullIoEndTime != 0)
+        {
+            double lfDurationUsec = PerfTimer::PerfTimeToMicroseconds(ullIoEndTime - ullIoStartTime);
+            metadataResults.latencyHistogram.Add(static_cast<float>(lfDurationUsec));
+        }
+    }
+
+private:
+    // flushes and trims are not broken down by size class or load phase
+    void _AddFlushOrTrim(UINT32 dwBytesTransferred, IOOperation type, UINT64 ullIoStartTime, UINT64 ullIoEndTime, UINT64 ullSpanStartTime, bool fMeasureLatency, bool fCalculateIopsStdDev)
+    {
+        bool fTrim = (type == IOOperation::TrimIO);
+
+        if (fTrim)
+        {
+            ullTrimBytesCount += dwBytesTransferred;
+            ullTrimIOCount++;
+        }
+        else
+        {
+            ullFlushIOCount++;
+        }
+        ullIOCount++;
+
+        if (ullIoEndTime == 0)
+        {
+            return;
+        }
+
+        UINT64 ullDuration = ullIoEndTime - ullIoStartTime;
+        double lfDurationUsec = PerfTimer::PerfTimeToMicroseconds(ullDuration);
+
+        if (fMeasureLatency)
+        {
+            (fTrim ? trimLatencyHistogram : flushLatencyHistogram).Add(static_cast<float>(lfDurationUsec));
+        }
+
+        if (fCalculateIopsStdDev)
+        {
+            (fTrim ? trimBucketizer : flushBucketizer).Add(ullIoEndTime - ullSpanStartTime, lfDurationUsec);
+        }
+    }
+};
+
+//
+// Allocates arrays on whole cache lines of their own, so that an array written by one thread never
+// shares a line with data used by another.
+//
+
+template<typename T>
+class CacheLineAllocator
+{
+public:
+    typedef T value_type;
+
+    static const size_t CacheLineSize = 64;
+
+    CacheLineAllocator() {}
+    template<typename U> CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+    T *allocate(size_t n)
+    {
+        size_t cb = (n * sizeof(T) + CacheLineSize - 1) & ~(CacheLineSize - 1);
+        void *p = _aligned_malloc(cb, CacheLineSize);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+    }
+
+    void deallocate(T *p, size_t)
+    {
+        _aligned_free(p);
+    }
+
+    template<typename U> bool operator==(const CacheLineAllocator<U>&) const { return true; }
+    template<typename U> bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+};
+
+//
+// Running counters of the IO a thread completes during the measured interval. The counters only
+// increase, so an observer reports the difference between two snapshots of them.
+//
+// Latencies are counted in a fixed log-linear layout (2 significant digits, nanoseconds up to
+// ~18 minutes) so that the count array never moves under an observer.
+//
+
+class IntervalCounters
+{
+public:
+    IntervalCounters() :
+        ullReadIOCount(0),
+        ullReadBytesCount(0),
+        ullWriteIOCount(0),
+        ullWriteBytesCount(0),
+        ullFlushIOCount(0),
+        ullTrimIOCount(0),
+        ullMetadataIOCount(0),
+        cLatencyBuckets(0)
+    {
+    }
+
+    static const unsigned SubBucketHalfCountMagnitude = 7;
+    static const UINT64 SubBucketHalfCount = 1ULL << SubBucketHalfCountMagnitude;
+    static const UINT64 SubBucketMask = (SubBucketHalfCount << 1) - 1;
+    static const unsigned MaxLatencyMagnitude = 40;
+    static const size_t LatencyBucketCount = ((MaxLatencyMagnitude - SubBucketHalfCountMagnitude - 1) << SubBucketHalfCountMagnitude) + 2 * SubBucketHalfCount;
+
+    typedef vector<UINT64, CacheLineAllocator<UINT64>> LatencyCounts;
+
+    void Initialize()
+    {
+        vLatencyCounts.assign(LatencyBucketCount, 0);
+    }
+
+    void Add(IOOperation type, DWORD dwBytesTransferred, UINT64 ullLatencyNs, bool fLatency)
+    {
+        if (type == IOOperation::ReadIO)
+        {
+            ullReadBytesCount += dwBytesTransferred;
+            ullReadIOCount++;
+        }
+        else if (type == IOOperation::FlushIO)
+        {
+            ullFlushIOCount++;
+        }
+        else if (type == IOOperation::TrimIO)
+        {
+            ullTrimIOCount++;
+        }
+        else if (type == IOOperation::MetadataIO)
+        {
+            ullMetadataIOCount++;
+        }
+        else
+        {
+            ullWriteBytesCount += dwBytesTransferred;
+            ullWriteIOCount++;
+        }
+
+        if (fLatency)
+        {
+            size_t iBucket = LatencyBucket(ullLatencyNs);
+            vLatencyCounts[iBucket]++;
+            if (iBucket >= cLatencyBuckets)
+            {
+                cLatencyBuckets = iBucket + 1;
             }
         }
+    }
+
+    // copies the counters into other, which must be initialized alike
+    void CopyTo(IntervalCounters& other) const
+    {
+        other.ullReadIOCount = ullReadIOCount;
+        other.ullReadBytesCount = ullReadBytesCount;
+        other.ullWriteIOCount = ullWriteIOCount;
+        other.ullWriteBytesCount = ullWriteBytesCount;
+        other.ullFlushIOCount = ullFlushIOCount;
+        other.ullTrimIOCount = ullTrimIOCount;
+        other.ullMetadataIOCount = ullMetadataIOCount;
+        other.cLatencyBuckets = cLatencyBuckets;
+        for (size_t i = 0; i < cLatencyBuckets; i++)
+        {
+            other.vLatencyCounts[i] = vLatencyCounts[i];
+        }
+    }
+
+    static size_t LatencyBucket(UINT64 ullLatencyNs)
+    {
+        UINT64 u = min(ullLatencyNs, (1ULL << MaxLatencyMagnitude) - 1);
+#ifdef _MSC_VER
+        unsigned long highestBit;
+        _BitScanReverse64(&highestBit, u | SubBucketMask);
+#else
+        unsigned highestBit = 63 - __builtin_clzll(u | SubBucketMask);
+#endif
+
+        const unsigned bucketIndex = highestBit - SubBucketHalfCountMagnitude;
+        return static_cast<size_t>((static_cast<UINT64>(bucketIndex) << SubBucketHalfCountMagnitude) + (u >> bucketIndex));
+    }
+
+    // highest latency counted in a bucket
+    static UINT64 LatencyBucketValue(size_t iBucket)
+    {
+        unsigned bucketIndex = static_cast<unsigned>(iBucket >> SubBucketHalfCountMagnitude);
+        UINT64 subBucketIndex = (iBucket & (SubBucketHalfCount - 1)) + SubBucketHalfCount;
+        UINT64 width = 1;
+
+        if (bucketIndex == 0)
+        {
+            subBucketIndex -= SubBucketHalfCount;
+        }
+        else
+        {
+            bucketIndex--;
+            width = 1ULL << bucketIndex;
+        }
+
+        return (subBucketIndex << bucketIndex) + width - 1;
+    }
+
+    UINT64 ullReadIOCount;
+    UINT64 ullReadBytesCount;
+    UINT64 ullWriteIOCount;
+    UINT64 ullWriteBytesCount;
+    UINT64 ullFlushIOCount;
+    UINT64 ullTrimIOCount;
+    UINT64 ullMetadataIOCount;
+    LatencyCounts vLatencyCounts;           // empty unless latency is measured
+    size_t cLatencyBuckets;                 // buckets up to the highest latency counted
+};
+
+//
+// A thread's IntervalCounters, with snapshots of them published for observer threads (such as
+// the interval reporter, -U) to read while the thread runs.
+//
+// The owning thread updates its counters on every IO and publishes a copy of them at most once
+// per publication interval, under a sequence lock: the sequence is odd while a copy is in
+// progress, and an observer retries a read which overlapped one. Neither side ever blocks the
+// other. The thread also publishes what it has left unpublished before it sleeps, so that a low
+// IO rate does not hold counts back for the length of the sleep. The counters and the published
+// copy, including their latency count arrays, are padded onto cache lines of their own so that
+// observers reading the copy, and the threads of neighboring results, never contend with the
+// owning thread for the lines it updates on every IO.
+//
+
+class ThreadStatistics
+{
+public:
+    ThreadStatistics() :
+        _ullPublishInterval(0),
+        _ullNextPublishTime(0),
+        _fUnpublished(false),
+        _lSequence(0)
+    {
+    }
+
+    static const size_t CacheLineSize = CacheLineAllocator<BYTE>::CacheLineSize;
+
+    void Initialize(bool fLatency, UINT64 ullPublishInterval)
+    {
+        _ullPublishInterval = ullPublishInterval;
+        _ullNextPublishTime = PerfTimer::GetTime() + ullPublishInterval;
+        if (fLatency)
+        {
+            _counters.Initialize();
+            _published.Initialize();
+        }
+    }
+
+    // Called only by the owning thread.
+    void Add(IOOperation type, DWORD dwBytesTransferred, UINT64 ullLatencyNs, bool fLatency)
+    {
+        _counters.Add(type, dwBytesTransferred, ullLatencyNs, fLatency);
+        _fUnpublished = true;
+
+        UINT64 ullNow = PerfTimer::GetTime();
+        if (ullNow >= _ullNextPublishTime)
+        {
+            Publish(ullNow);
+        }
+    }
+
+    // Called only by the owning thread, before it sleeps.
+    void PublishPending()
+    {
+        if (_fUnpublished)
+        {
+            Publish(PerfTimer::GetTime());
+        }
+    }
 
-        if (fCalculateIopsStdDev)
+    // Called only by the owning thread.
+    void Publish(UINT64 ullNow)
+    {
+        InterlockedIncrement64(&_lSequence);
+        _counters.CopyTo(_published);
+        InterlockedIncrement64(&_lSequence);
+
+        _fUnpublished = false;
+        _ullNextPublishTime = ullNow + _ullPublishInterval;
+    }
+
+    // Called by any thread. Copies the counters as of their last publication into counters,
+    // which must be initialized alike.
+    void Read(IntervalCounters& counters) const
+    {
+        for (;;)
         {
-            UINT64 ullRelativeCompletionTime = ullIoEndTime - ullSpanStartTime;
+            LONG64 lSequence = _lSequence;
+            MemoryBarrier();
 
-            if (type == IOOperation::ReadIO)
-            {
-                readBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
-            }
-            else
+            if ((lSequence & 1) == 0)
             {
-                writeBucketizer.Add(ullRelativeCompletionTime, lfDurationUsec);
+                _published.CopyTo(counters);
+                MemoryBarrier();
+
+                if (lSequence == _lSequence)
+                {
+                    break;
+                }
             }
+
+            YieldProcessor();
         }
     }
 
-    string sPath;
-    UINT64 ullFileSize;         //size of the file
-    UINT64 ullBytesCount;       //number of accessed bytes
-    UINT64 ullIOCount;          //number of performed I/O operations
-    UINT64 ullReadBytesCount;   //number of bytes read
-    UINT64 ullReadIOCount;      //number of performed Read I/O operations
-    UINT64 ullWriteBytesCount;  //number of bytes written
-    UINT64 ullWriteIOCount;     //number of performed Write I/O operations
-
-    Histogram<float> readLatencyHistogram;
-    Histogram<float> writeLatencyHistogram;
-
-    IoBucketizer readBucketizer;
-    IoBucketizer writeBucketizer;
-
-    // Effective distribution after applying to target size (if specified/non-empty)
-    vector<DistributionRange> vDistributionRange;
+private:
+    BYTE _abLeadingPad[CacheLineSize];
+
+    // owning thread
+    IntervalCounters _counters;
+    UINT64 _ullPublishInterval;
+    UINT64 _ullNextPublishTime;
+    bool _fUnpublished;
+    BYTE _abCountersPad[CacheLineSize];
+
+    // published
+    volatile LONG64 _lSequence;
+    IntervalCounters _published;
+    BYTE _abTrailingPad[CacheLineSize];
 };
 
 typedef struct _WAIT_STATS {
@@ -475,18 +1191,34 @@ typedef struct _WAIT_STATS {
     ULONGLONG ThrottleSleep;
     ULONGLONG Lookaside;
     ULONGLONG LookasideCompletion[8]; // 0 == none, 1 == 1, ... 7 = 7+
+    ULONGLONG CompletionTimeCount;      // completions timestamped for latency
+    ULONGLONG CompletionTimeError;      // sum of their timestamp error bounds (PerfTimer units)
+    ULONGLONG CompletionTimeErrorMax;
 } WAIT_STATS;
 
 class ThreadResults
 {
 public:
-    ThreadResults()
+    ThreadResults() :
+        ulSqPollThreadId(0),
+        fSqPollAffinity(false),
+        wSqPollGroup(0),
+        bSqPollProc(0),
+        ullSqPollTime(0)
     {
         WaitStats = { 0 };
     }
 
     WAIT_STATS WaitStats;
     vector<TargetResults> vTargetResults;
+    ThreadStatistics threadStatistics;      // for interval reporting (-U)
+
+    // io_uring submission queue poller serving this thread (-up)
+    UINT32 ulSqPollThreadId;        // 0 if none
+    bool fSqPollAffinity;           // poller bound to wSqPollGroup/bSqPollProc
+    WORD wSqPollGroup;
+    BYTE bSqPollProc;
+    UINT64 ullSqPollTime;           // poller CPU time during the measured interval, 100ns units
 };
 
 class Results
@@ -525,6 +1257,7 @@ public:
     {
     }
 
+#ifndef __linux__
     ProcessorGroupInformation(
         WORD Group,
         PROCESSOR_GROUP_INFO& GroupInfo) :
@@ -534,6 +1267,7 @@ public:
         _activeProcessorMask(GroupInfo.ActiveProcessorMask)
     {
     }
+#endif
 
     // This logic is strictly unaware that sparse processor masks are not possible;
     // address this later, not important. See comments around RelationGroup query.
@@ -598,6 +1332,7 @@ public:
     BYTE _ubPerformanceEfficiencyClass; // highest performance class present
     bool _fSMT;                         // any SMT cores present
 
+#ifndef __linux__
     ProcessorTopology()
     {
         BOOL fResult;
@@ -860,6 +1595,258 @@ public:
 
         delete [] pInformation;
     }
+#else
+    //
+    // Linux: processors are numbered 0..n-1; present them as groups of 64 so that the group/processor
+    // addressing used throughout (affinity, results) carries over. Active processors are those this
+    // process may run on. NUMA, package and core relations come from sysfs where available.
+    //
+
+    ProcessorTopology()
+    {
+        cpu_set_t cpuSet;
+        int cProcessors = (int)sysconf(_SC_NPROCESSORS_CONF);
+        char szPath[128];
+
+        _ulProcessorCount = 0;
+        _ubPerformanceEfficiencyClass = 0;
+        _fSMT = false;
+
+        if (cProcessors < 1)
+        {
+            cProcessors = 1;
+        }
+
+        CPU_ZERO(&cpuSet);
+        if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0)
+        {
+            for (int i = 0; i < cProcessors && i < CPU_SETSIZE; i++)
+            {
+                CPU_SET(i, &cpuSet);
+            }
+        }
+
+        ////
+        // Group Relations
+        ////
+
+        for (WORD i = 0; i * 64 < cProcessors; i++)
+        {
+            KAFFINITY mask = 0;
+            BYTE cMax = (BYTE)min(64, cProcessors - i * 64);
+
+            for (BYTE j = 0; j < cMax; j++)
+            {
+                if (CPU_ISSET(i * 64 + j, &cpuSet))
+                {
+                    mask |= (KAFFINITY)1 << j;
+                }
+            }
+
+            _vProcessorGroupInformation.emplace_back(i, cMax, (BYTE)MaskCount(mask), mask);
+            _ulProcessorCount += _vProcessorGroupInformation[i]._activeProcessorCount;
+        }
+
+        ////
+        // NUMA Relations
+        ////
+
+        for (DWORD node = 0; ; node++)
+        {
+            vector<int> vCpus;
+
+            sprintf_s(szPath, _countof(szPath), "/sys/devices/system/node/node%u/cpulist", node);
+            if (!_ReadCpuList(szPath, vCpus))
+            {
+                break;
+            }
+
+            ProcessorNumaInformation numa;
+            numa._nodeNumber = node;
+            _AddActiveMasks(vCpus, numa._vProcessorMasks, numa._ulProcCount);
+            _vProcessorNumaInformation.push_back(numa);
+        }
+
+        if (_vProcessorNumaInformation.empty())
+        {
+            ProcessorNumaInformation numa;
+            numa._nodeNumber = 0;
+            numa._ulProcCount = 0;
+            for (const auto& g : _vProcessorGroupInformation)
+            {
+                numa._ulProcCount += MaskCount(g._activeProcessorMask);
+                numa._vProcessorMasks.emplace_back(g._groupNumber, g._activeProcessorMask);
+            }
+            _vProcessorNumaInformation.push_back(numa);
+        }
+
+        ////
+        // Socket/Package and Core Relations
+        ////
+
+        vector<pair<int, vector<int>>> vPackages;       // package id -> processors
+        vector<pair<pair<int, int>, vector<int>>> vCores; // (package id, core id) -> processors
+
+        for (int i = 0; i < cProcessors; i++)
+        {
+            int package = _ReadCpuTopologyValue(i, "physical_package_id");
+            int core = _ReadCpuTopologyValue(i, "core_id");
+            if (core < 0)
+            {
+                core = i;
+            }
+
+            auto itPackage = find_if(vPackages.begin(), vPackages.end(),
+                [package](const pair<int, vector<int>>& e) { return e.first == package; });
+            if (itPackage == vPackages.end())
+            {
+                vPackages.emplace_back(package, vector<int>());
+                itPackage = vPackages.end() - 1;
+            }
+            itPackage->second.push_back(i);
+
+            auto itCore = find_if(vCores.begin(), vCores.end(),
+                [package, core](const pair<pair<int, int>, vector<int>>& e) { return e.first.first == package && e.first.second == core; });
+            if (itCore == vCores.end())
+            {
+                vCores.emplace_back(make_pair(package, core), vector<int>());
+                itCore = vCores.end() - 1;
+            }
+            itCore->second.push_back(i);
+        }
+
+        DWORD socketNumber = 0;
+        for (const auto& package : vPackages)
+        {
+            ProcessorSocketInformation socket;
+            socket._ulSocketNumber = socketNumber++;
+            _AddActiveMasks(package.second, socket._vProcessorMasks, socket._ulProcCount);
+            _vProcessorSocketInformation.push_back(socket);
+        }
+
+        for (const auto& core : vCores)
+        {
+            if (core.second.size() > 1)
+            {
+                _fSMT = true;
+            }
+
+            // a core's processors share a group unless the numbering is very unusual; attribute it to its first
+            KAFFINITY mask = 0;
+            WORD group = (WORD)(core.second[0] / 64);
+            for (int cpu : core.second)
+            {
+                if (cpu / 64 == group)
+                {
+                    mask |= (KAFFINITY)1 << (cpu % 64);
+                }
+            }
+
+            _vProcessorCoreInformation.emplace_back(group, mask, (BYTE)0);
+        }
+
+        sort(_vProcessorCoreInformation.begin(), _vProcessorCoreInformation.end(),
+            [](const ProcessorCoreInformation& a, const ProcessorCoreInformation& b)
+            {
+                return a._groupNumber < b._groupNumber ||
+                      (a._groupNumber == b._groupNumber && a._processorMask < b._processorMask);
+            });
+
+        BYTE coreNumber = 0;
+        WORD group = 0;
+        for (auto& core : _vProcessorCoreInformation)
+        {
+            if (core._groupNumber != group)
+            {
+                group = core._groupNumber;
+                coreNumber = 0;
+            }
+            core._groupCoreNumber = coreNumber++;
+        }
+    }
+
+    // parse a sysfs cpu list ("0-3,8,10-11")
+    static bool _ReadCpuList(const char *pszPath, vector<int>& vCpus)
+    {
+        char szLine[4096];
+        FILE *pFile = fopen(pszPath, "r");
+
+        if (pFile == nullptr)
+        {
+            return false;
+        }
+
+        bool fOk = (fgets(szLine, sizeof(szLine), pFile) != nullptr);
+        fclose(pFile);
+
+        for (char *pszRange = strtok(szLine, ",\n"); fOk && pszRange != nullptr; pszRange = strtok(nullptr, ",\n"))
+        {
+            int first, last;
+            int c = sscanf(pszRange, "%d-%d", &first, &last);
+            if (c == 1)
+            {
+                last = first;
+            }
+            else if (c != 2)
+            {
+                continue;
+            }
+
+            for (int i = first; i <= last; i++)
+            {
+                vCpus.push_back(i);
+            }
+        }
+
+        return fOk;
+    }
+
+    static int _ReadCpuTopologyValue(int cpu, const char *pszName)
+    {
+        char szPath[128];
+        int value = -1;
+
+        sprintf_s(szPath, _countof(szPath), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, pszName);
+        FILE *pFile = fopen(szPath, "r");
+        if (pFile != nullptr)
+        {
+            if (fscanf(pFile, "%d", &value) != 1)
+            {
+                value = -1;
+            }
+            fclose(pFile);
+        }
+
+        return value;
+    }
+
+    // fold processor numbers into per-group masks of the active processors among them
+    void _AddActiveMasks(const vector<int>& vCpus, vector<pair<WORD, KAFFINITY>>& vMasks, DWORD& ulProcCount) const
+    {
+        ulProcCount = 0;
+        for (int cpu : vCpus)
+        {
+            WORD group = (WORD)(cpu / 64);
+            BYTE proc = (BYTE)(cpu % 64);
+
+            if (group >= _vProcessorGroupInformation.size() ||
+                !_vProcessorGroupInformation[group].IsProcessorActive(proc))
+            {
+                continue;
+            }
+
+            auto it = find_if(vMasks.begin(), vMasks.end(),
+                [group](const pair<WORD, KAFFINITY>& e) { return e.first == group; });
+            if (it == vMasks.end())
+            {
+                vMasks.emplace_back(group, 0);
+                it = vMasks.end() - 1;
+            }
+            it->second |= (KAFFINITY)1 << proc;
+            ulProcCount++;
+        }
+    }
+#endif
 
     bool IsGroupValid(WORD Group)
     {
@@ -1002,6 +1989,7 @@ public:
     string sActivePolicyName;
     string sActivePolicyGuid;
 
+#ifndef __linux__
     SystemInformation()
     {
         char buffer[128];
@@ -1065,14 +2053,46 @@ public:
             LocalFree(guid);
         }
     }
+#else
+    SystemInformation()
+    {
+        char buffer[128];
+
+        if (gethostname(buffer, sizeof(buffer)) == 0)
+        {
+            buffer[sizeof(buffer) - 1] = '\0';
+            sComputerName = buffer;
+        }
+
+        // capture start time
+        GetSystemTime(&StartTime);
+
+        // there is no system power scheme; the cpufreq governor is the closest analog
+        FILE *pFile = fopen("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor", "r");
+        if (pFile != nullptr)
+        {
+            if (fgets(buffer, sizeof(buffer), pFile) != nullptr)
+            {
+                buffer[strcspn(buffer, "\n")] = '\0';
+                sActivePolicyName = buffer;
+            }
+            fclose(pFile);
+        }
+
+        if (sActivePolicyName.empty())
+        {
+            sActivePolicyName = "<unknown>";
+        }
+    }
+#endif
 
     // for unit test, squelch variable timestamp
-    void SystemInformation::ResetTime()
+    void ResetTime()
     {
         StartTime = { 0 };
     }
 
-    string SystemInformation::GetText() const
+    string GetText() const
     {
         char szBuffer[128]; // guid (36ch), timestamp and power friendly (up to 64ch)
         int nWritten;
@@ -1126,7 +2146,7 @@ public:
         return sText;
     }
 
-    string SystemInformation::GetXml(UINT32 indent) const
+    string GetXml(UINT32 indent) const
     {
         char szBuffer[64]; // enough for 64bit mask (17ch) and timestamp
         int nWritten;
@@ -1180,7 +2200,7 @@ public:
             sXml += "\" ActiveProcessors=\"";
             sXml += to_string(g._activeProcessorCount);
             sXml += "\" ActiveProcessorMask=\"0x";
-            nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%Ix", g._activeProcessorMask);
+            nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%llx", (ULONGLONG) g._activeProcessorMask);
             assert(nWritten && nWritten < _countof(szBuffer));
             sXml += szBuffer;
             sXml += "\"/>\n";
@@ -1196,7 +2216,7 @@ public:
                 AddXml(sXml, "<Group Group=\"");
                 sXml += to_string(g.first);
                 sXml += "\" Mask=\"0x";
-                nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%Ix", g.second);
+                nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%llx", (ULONGLONG) g.second);
                 assert(nWritten && nWritten < _countof(szBuffer));
                 sXml += szBuffer;
                 sXml += "\"/>\n";
@@ -1213,7 +2233,7 @@ public:
                 AddXml(sXml, "<Group Group=\"");
                 sXml += to_string(g.first);
                 sXml += "\" Mask=\"0x";
-                nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%Ix", g.second);
+                nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%llx", (ULONGLONG) g.second);
                 assert(nWritten && nWritten < _countof(szBuffer));
                 sXml += szBuffer;
                 sXml += "\"/>\n";
@@ -1227,7 +2247,7 @@ public:
             sXml += "\" Core=\"";
             sXml += to_string(h._groupCoreNumber);
             sXml += "\" Mask=\"0x";
-            nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%Ix", h._processorMask);
+            nWritten = sprintf_s(szBuffer, _countof(szBuffer), "%llx", (ULONGLONG) h._processorMask);
             assert(nWritten && nWritten < _countof(szBuffer));
             sXml += szBuffer;
             sXml += "\" EfficiencyClass=\"";
@@ -1297,6 +2317,16 @@ enum class MemoryMappedIoFlushMode {
     NonVolatileMemoryNoDrain,
 };
 
+// IO engines used by threads doing asynchronous IO
+// default -> IO completion ports, or completion routines with -x
+// iouring -> Linux io_uring submission/completion rings (-u)
+// linuxaio -> Linux native AIO contexts, io_submit/io_getevents (-A)
+enum class IoEngine {
+    Default = 0,
+    IoUring,
+    LinuxAio,
+};
+
 enum class IOMode
 {
     Unknown,
@@ -1304,7 +2334,8 @@ enum class IOMode
     Sequential,
     Mixed,
     InterlockedSequential,
-    ParallelAsync
+    ParallelAsync,
+    Trace
 };
 
 class ThreadTarget
@@ -1341,7 +2372,17 @@ public:
         _dwBlockSize(64 * 1024),
         _dwRequestCount(2),
         _ullBlockAlignment(0),
+        _fBlockAlignmentFromBlockSize(false),
         _ulWriteRatio(0),
+        _ulFlushRatio(0),
+        _ulTrimRatio(0),
+        _dwTrimSize(0),
+        _ulFuaWriteRatio(0),
+        _dwFileSetCount(0),
+        _lfFileSetSkew(0),
+        _fOpenPerIO(false),
+        _ulMetadataRatio(0),
+        _ulMetadataOps(0),
         _ulRandomRatio(0),
         _ullBaseFileOffset(0),
         _fParallelAsyncIO(false),
@@ -1372,16 +2413,34 @@ public:
         _ulWeight(1),
         _dwThroughputBytesPerMillisecond(0),
         _dwThroughputIOPS(0),
+        _dwThrottleSpinMicroseconds(0),
+        _dwTotalThroughputBytesPerMillisecond(0),
+        _dwTotalThroughputIOPS(0),
+        _dwArrivalRate(0),
+        _fPoissonArrivals(false),
+        _fTraceTimestamps(true),
         _cbRandomDataWriteBuffer(0),
         _sRandomDataWriteBufferSourcePath(),
         _pRandomDataWriteBuffer(nullptr),
-        _distributionType(DistributionType::None)
+        _lfCompressionRatio(0),
+        _lfDedupRatio(1),
+        _cbDedupChunk(ReducibleDataPool::DefaultChunkSize),
+        _pDataPool(nullptr),
+        _cbVerifyUnit(0),
+        _pVerifier(nullptr),
+        _distributionType(DistributionType::None),
+        _lfDistributionSkew(0),
+        _fDistributionScatter(false)
     {
     }
 
     IOMode GetIOMode() const
     {
-        if (GetRandomRatio() == 100)
+        if (!GetTracePath().empty())
+        {
+            return IOMode::Trace;
+        }
+        else if (GetRandomRatio() == 100)
         {
             return IOMode::Random;
         }
@@ -1407,9 +2466,44 @@ public:
     void SetPath(const char *pPath) { _sPath = pPath; }
     const string& GetPath() const { return _sPath; }
 
-    void SetBlockSizeInBytes(DWORD dwBlockSize) { _dwBlockSize = dwBlockSize; }
+    void SetBlockSizeInBytes(DWORD dwBlockSize) { _dwBlockSize = dwBlockSize; _vBlockSizeMix.clear(); }
     DWORD GetBlockSizeInBytes() const { return _dwBlockSize; }
 
+    // A weighted mix of block sizes. The block size of the target becomes the largest in the
+    // mix, so that buffers and bounds sized by it hold any IO; alignment defaults to the smallest.
+    void SetBlockSizeMix(const vector<BlockSizeWeight>& v)
+    {
+        _vBlockSizeMix = v;
+        _dwBlockSize = 0;
+        for (const auto& b : _vBlockSizeMix)
+        {
+            _dwBlockSize = max(_dwBlockSize, b.dwBlockSize);
+        }
+    }
+    const vector<BlockSizeWeight>& GetBlockSizeMix() const { return _vBlockSizeMix; }
+
+    DWORD GetMinBlockSizeInBytes() const
+    {
+        DWORD dwMin = _dwBlockSize;
+        for (const auto& b : _vBlockSizeMix)
+        {
+            dwMin = min(dwMin, b.dwBlockSize);
+        }
+        return dwMin;
+    }
+
+    // Weighted mean of the mix, or the block size
+    DWORD GetMeanBlockSizeInBytes() const
+    {
+        UINT64 cbWeighted = 0, ullWeight = 0;
+        for (const auto& b : _vBlockSizeMix)
+        {
+            cbWeighted += (UINT64)b.dwBlockSize * b.ulWeight;
+            ullWeight += b.ulWeight;
+        }
+        return ullWeight ? (DWORD)(cbWeighted / ullWeight) : _dwBlockSize;
+    }
+
     void SetBlockAlignmentInBytes(UINT64 ullBlockAlignment)
     {
         _ullBlockAlignment = ullBlockAlignment;
@@ -1418,12 +2512,52 @@ public:
     // like -rs<xx> -s
     UINT64 GetBlockAlignmentInBytes(bool actual = false) const
     {
-        return _ullBlockAlignment ? _ullBlockAlignment : (actual ? 0 : _dwBlockSize);
+        return _ullBlockAlignment ? _ullBlockAlignment : (actual ? 0 : GetMinBlockSizeInBytes());
     }
 
+    // -r and -s without a size state the alignment as the block size given by -b; a block size
+    // sweep (-Yb) then moves it to each swept size
+    void SetBlockAlignmentFromBlockSize(bool fFromBlockSize) { _fBlockAlignmentFromBlockSize = fFromBlockSize; }
+    bool GetBlockAlignmentFromBlockSize() const { return _fBlockAlignmentFromBlockSize; }
+
     void SetWriteRatio(UINT32 writeRatio) { _ulWriteRatio = writeRatio; }
     UINT32 GetWriteRatio() const { return _ulWriteRatio; }
 
+    // percentage of IOs which are flushes; the write ratio splits the rest between reads and writes
+    void SetFlushRatio(UINT32 flushRatio) { _ulFlushRatio = flushRatio; }
+    UINT32 GetFlushRatio() const { return _ulFlushRatio; }
+
+    // percentage of IOs which are trims, of the trim size or else the block size
+    void SetTrimRatio(UINT32 trimRatio) { _ulTrimRatio = trimRatio; }
+    UINT32 GetTrimRatio() const { return _ulTrimRatio; }
+    void SetTrimSize(DWORD dwTrimSize) { _dwTrimSize = dwTrimSize; }
+    DWORD GetTrimSize() const { return _dwTrimSize; }
+
+    // percentage of writes issued with forced unit access
+    void SetFuaWriteRatio(UINT32 fuaWriteRatio) { _ulFuaWriteRatio = fuaWriteRatio; }
+    UINT32 GetFuaWriteRatio() const { return _ulFuaWriteRatio; }
+
+    // A file set: the path is a directory of this many files of the file size, each IO being
+    // directed to one of them; 0 if the target is a single file or device.
+    void SetFileSetCount(DWORD dwFileSetCount) { _dwFileSetCount = dwFileSetCount; }
+    DWORD GetFileSetCount() const { return _dwFileSetCount; }
+    string GetFileSetFilePath(DWORD iFile) const;
+    string GetFileSetFilePath(const char *pszName) const;
+
+    // Zipf theta of IO across the files of the set, the first being the hottest; 0 if uniform
+    void SetFileSetSkew(double lfFileSetSkew) { _lfFileSetSkew = lfFileSetSkew; }
+    double GetFileSetSkew() const { return _lfFileSetSkew; }
+
+    // whether the file of each IO is opened and closed around it, rather than once per thread
+    void SetOpenPerIO(bool fOpenPerIO) { _fOpenPerIO = fOpenPerIO; }
+    bool GetOpenPerIO() const { return _fOpenPerIO; }
+
+    // percentage of IOs which are metadata operations, spread evenly over those in the mask
+    void SetMetadataRatio(UINT32 metadataRatio) { _ulMetadataRatio = metadataRatio; }
+    UINT32 GetMetadataRatio() const { return _ulMetadataRatio; }
+    void SetMetadataOps(UINT32 ulMetadataOps) { _ulMetadataOps = ulMetadataOps; }
+    UINT32 GetMetadataOps() const { return _ulMetadataOps; }
+
     void SetRandomRatio(UINT32 randomRatio) { _ulRandomRatio = randomRatio; }
     UINT32 GetRandomRatio() const { return _ulRandomRatio; }
 
@@ -1472,6 +2606,23 @@ public:
     void SetRandomDataWriteBufferSourcePath(string sPath) { _sRandomDataWriteBufferSourcePath = sPath; }
     string GetRandomDataWriteBufferSourcePath() const { return _sRandomDataWriteBufferSourcePath; }
 
+    // write content which compresses and dedups by the given ratios (-Zc); see ReducibleDataPool
+    void SetReducibleWriteData(double lfCompressionRatio, double lfDedupRatio, UINT32 cbChunk)
+    {
+        _lfCompressionRatio = lfCompressionRatio;
+        _lfDedupRatio = lfDedupRatio;
+        _cbDedupChunk = cbChunk;
+    }
+    bool GetReducibleWriteData() const { return _lfCompressionRatio != 0; }
+    double GetCompressionRatio() const { return _lfCompressionRatio; }
+    double GetDedupRatio() const { return _lfDedupRatio; }
+    UINT32 GetDedupChunkSize() const { return _cbDedupChunk; }
+
+    // stamp each unit of this size written with a header which reads verify (-Zv); 0 if not verified
+    void SetVerifyUnitSize(UINT32 cbUnit) { _cbVerifyUnit = cbUnit; }
+    UINT32 GetVerifyUnitSize() const { return _cbVerifyUnit; }
+    bool GetVerifyData() const { return _cbVerifyUnit != 0; }
+
     void SetUseBurstSize(bool fBool) { _fUseBurstSize = fBool; }
     bool GetUseBurstSize() const { return _fUseBurstSize; }
 
@@ -1534,7 +2685,7 @@ public:
     void SetThroughputIOPS(DWORD dwIOPS)
     {
         _dwThroughputIOPS = dwIOPS;
-        _dwThroughputBytesPerMillisecond = (dwIOPS * _dwBlockSize) / 1000;
+        _dwThroughputBytesPerMillisecond = (dwIOPS * GetMeanBlockSizeInBytes()) / 1000;
     }
     DWORD GetThroughputIOPS() const { return _dwThroughputIOPS; }
     void SetThroughput(DWORD dwThroughputBytesPerMillisecond)
@@ -1543,6 +2694,33 @@ public:
         _dwThroughputBytesPerMillisecond = dwThroughputBytesPerMillisecond;
     }
     DWORD GetThroughputInBytesPerMillisecond() const { return _dwThroughputBytesPerMillisecond; }
+    double GetThroughputInBytesPerMillisecondExact() const
+    {
+        return _dwThroughputIOPS ? ((double)_dwThroughputIOPS * GetMeanBlockSizeInBytes()) / 1000 : _dwThroughputBytesPerMillisecond;
+    }
+
+    // Throttle waits up to this long are spun rather than slept; zero sleeps every wait.
+    void SetThrottleSpinMicroseconds(DWORD dwMicroseconds) { _dwThrottleSpinMicroseconds = dwMicroseconds; }
+    DWORD GetThrottleSpinMicroseconds() const { return _dwThrottleSpinMicroseconds; }
+
+    // Limit on the throughput of all threads on the target together, in bytes per millisecond or IOPS.
+    void SetTotalThroughput(DWORD dwBytesPerMillisecond) { _dwTotalThroughputBytesPerMillisecond = dwBytesPerMillisecond; _dwTotalThroughputIOPS = 0; }
+    DWORD GetTotalThroughputInBytesPerMillisecond() const { return _dwTotalThroughputBytesPerMillisecond; }
+    void SetTotalThroughputIOPS(DWORD dwIOPS) { _dwTotalThroughputIOPS = dwIOPS; _dwTotalThroughputBytesPerMillisecond = 0; }
+    DWORD GetTotalThroughputIOPS() const { return _dwTotalThroughputIOPS; }
+
+    // Open-loop arrival rate in IOPS; zero keeps the default closed-loop issue.
+    void SetArrivalRate(DWORD dwIOPS) { _dwArrivalRate = dwIOPS; }
+    DWORD GetArrivalRate() const { return _dwArrivalRate; }
+    void SetPoissonArrivals(bool fBool) { _fPoissonArrivals = fBool; }
+    bool GetPoissonArrivals() const { return _fPoissonArrivals; }
+
+    // Trace to replay in place of generated offsets, sizes and IO types; empty if none.
+    // Records are issued at their timestamps, or as fast as possible if not paced by them.
+    void SetTracePath(const string& sPath) { _sTracePath = sPath; }
+    const string& GetTracePath() const { return _sTracePath; }
+    void SetTraceTimestamps(bool fBool) { _fTraceTimestamps = fBool; }
+    bool GetTraceTimestamps() const { return _fTraceTimestamps; }
 
     string GetXml(UINT32 indent) const;
 
@@ -1550,6 +2728,14 @@ public:
     void FreeRandomDataWriteBuffer();
     BYTE* GetRandomDataWriteBuffer(Random *pRand);
 
+    bool AllocateDataPool(Random *pRand);
+    void FreeDataPool();
+    const ReducibleDataPool* GetDataPool() const { return _pDataPool; }
+
+    void AllocateVerifier(UINT32 ulTarget, UINT32 ulSeed);
+    void FreeVerifier();
+    DataVerifier* GetVerifier() const { return _pVerifier; }
+
     void SetDistributionRange(const vector<DistributionRange>& v, DistributionType t)
     {
         _vDistributionRange = v; _distributionType = t;
@@ -1586,6 +2772,17 @@ public:
     auto& GetDistributionRange() const { return _vDistributionRange; }
     auto GetDistributionType() const { return _distributionType; }
 
+    // Skewed distributions are stated by a single parameter rather than ranges:
+    // theta for Zipf, h for Pareto. Their hottest offsets are contiguous from the base
+    // of the target unless scattered across it.
+    void SetDistributionSkew(DistributionType t, double lfSkew, bool fScatter = false)
+    {
+        assert(t == DistributionType::Zipf || t == DistributionType::Pareto);
+        _vDistributionRange.clear(); _distributionType = t; _lfDistributionSkew = lfSkew; _fDistributionScatter = fScatter;
+    }
+    double GetDistributionSkew() const { return _lfDistributionSkew; }
+    bool GetDistributionScatter() const { return _fDistributionScatter; }
+
     DWORD GetCreateFlags(bool fAsync)
     {
         DWORD dwFlags = FILE_ATTRIBUTE_NORMAL;
@@ -1626,12 +2823,24 @@ public:
 private:
     string _sPath;
     DWORD _dwBlockSize;
+    vector<BlockSizeWeight> _vBlockSizeMix;
     DWORD _dwRequestCount;      // TODO: change the name to something more descriptive (OutstandingRequestCount?)
 
     UINT64 _ullBlockAlignment;
+    bool _fBlockAlignmentFromBlockSize;
     UINT32 _ulWriteRatio;
+    UINT32 _ulFlushRatio;
+    UINT32 _ulTrimRatio;
+    DWORD _dwTrimSize;
+    UINT32 _ulFuaWriteRatio;
     UINT32 _ulRandomRatio;
 
+    DWORD _dwFileSetCount;
+    double _lfFileSetSkew;
+    bool _fOpenPerIO;
+    UINT32 _ulMetadataRatio;
+    UINT32 _ulMetadataOps;      // mask of MetadataOpMask bits
+
     UINT64 _ullBaseFileOffset;
 
     TargetCacheMode _cacheMode;
@@ -1650,6 +2859,13 @@ private:
 
     DWORD _dwThroughputBytesPerMillisecond; // set to 0 to disable throttling
     DWORD _dwThroughputIOPS;                // if IOPS are specified they are converted to BPMS but saved for fidelity to XML/output
+    DWORD _dwThrottleSpinMicroseconds;      // throttle and think time waits up to this long are spun
+    DWORD _dwTotalThroughputBytesPerMillisecond;    // limit shared by all threads on the target; 0 if none
+    DWORD _dwTotalThroughputIOPS;                   // ... in IOs rather than bytes
+    DWORD _dwArrivalRate;                   // IOPS arriving on an open-loop schedule; set to 0 to issue closed-loop
+    bool _fPoissonArrivals;                 // true = exponentially distributed inter-arrival times, false = fixed
+    string _sTracePath;                     // trace to replay (-Q)
+    bool _fTraceTimestamps;                 // true = issue trace records at their timestamps, false = as fast as possible
 
     bool _fThinkTime:1;             // variable to decide whether to think between IOs (default is false) (removed by using _dwThinkTime==0?)
     bool _fUseBurstSize:1;          // TODO: "use" or "enable"?; since burst size must be specified with the think time, one variable should be sufficient
@@ -1667,6 +2883,14 @@ private:
     string _sRandomDataWriteBufferSourcePath;   // file that should be used for filling the write buffer (if the path is not available, use a crypto provider)
     BYTE *_pRandomDataWriteBuffer;              // a buffer used for write data when _cbWriteBuffer > 0; it's shared by all the threads working on this target
 
+    double _lfCompressionRatio;                 // if > 0, write data is built to compress by this ratio ...
+    double _lfDedupRatio;                       // ... and dedup by this one
+    UINT32 _cbDedupChunk;                       // ... in chunks of this size
+    ReducibleDataPool *_pDataPool;              // the chunks write data is built from; it's shared by all the threads working on this target
+
+    UINT32 _cbVerifyUnit;                       // if > 0, write data is stamped in units of this size and reads verify it
+    DataVerifier *_pVerifier;                   // the target's generation map; it's shared by all the threads working on this target
+
     HANDLE _mappedViewFileHandle;
     BYTE *_mappedView;
 
@@ -1677,6 +2901,8 @@ private:
 
     vector<DistributionRange> _vDistributionRange;
     DistributionType _distributionType;
+    double _lfDistributionSkew;         // parameter of a Zipf/Pareto distribution
+    bool _fDistributionScatter;         // Zipf/Pareto ranks are scattered across the target
 
     bool _FillRandomDataWriteBuffer(Random *pRand);
 
@@ -1711,12 +2937,26 @@ public:
         _fRandomWriteData(false),
         _fDisableAffinity(false),
         _fCompletionRoutines(false),
+        _ioEngine(IoEngine::Default),
+        _fRegisteredIo(false),
+        _fSqPoll(false),
+        _ulAioMinEvents(1),
         _fMeasureLatency(false),
+        _ulLatencySignificantDigits(Histogram<float>::DefaultSignificantDigits),
         _fCalculateIopsStdDev(false),
-        _ulIoBucketDurationInMilliseconds(1000)
+        _ulIoBucketDurationInMilliseconds(1000),
+        _ulReportIntervalInMilliseconds(0),
+        _fReportIntervalJson(false),
+        _lfLatencySloPercentile(0),
+        _lfLatencySloMilliseconds(0),
+        _dwLatencySloMaxRequestCount(LatencySloDefaultMaxRequestCount),
+        _dwTotalThroughputBytesPerMillisecond(0),
+        _dwTotalThroughputIOPS(0)
     {
     }
 
+    static const DWORD LatencySloDefaultMaxRequestCount = 256;
+
     void ClearAffinityAssignment()
     {
         _vAffinity.clear();
@@ -1732,6 +2972,11 @@ public:
         _vTargets.push_back(Target(target));
     }
 
+    void ClearTargets()
+    {
+        _vTargets.clear();
+    }
+
     vector<Target> GetTargets() const { return _vTargets; }
 
     void SetDuration(UINT32 ulDuration) { _ulDuration = ulDuration; }
@@ -1749,26 +2994,94 @@ public:
     void SetRandomWriteData(bool fRandomWriteData) { _fRandomWriteData = fRandomWriteData; }
     bool GetRandomWriteData() const { return _fRandomWriteData; }
 
-    void SetThreadCount(DWORD dwThreadCount) { _dwThreadCount = dwThreadCount; }
-    DWORD GetThreadCount() const { return _dwThreadCount; }
+    void SetThreadCount(DWORD dwThreadCount) { _dwThreadCount = dwThreadCount; }
+    DWORD GetThreadCount() const { return _dwThreadCount; }
+
+    void SetRequestCount(DWORD dwRequestCount) { _dwRequestCount = dwRequestCount; }
+    DWORD GetRequestCount() const { return _dwRequestCount; }
+
+    void SetDisableAffinity(bool fDisableAffinity) { _fDisableAffinity = fDisableAffinity; }
+    bool GetDisableAffinity() const { return _fDisableAffinity; }
+
+    void SetCompletionRoutines(bool fCompletionRoutines) { _fCompletionRoutines = fCompletionRoutines; }
+    bool GetCompletionRoutines() const { return _fCompletionRoutines; }
+
+    void SetIoEngine(IoEngine ioEngine) { _ioEngine = ioEngine; }
+    IoEngine GetIoEngine() const { return _ioEngine; }
+
+    void SetRegisteredIo(bool fRegisteredIo) { _fRegisteredIo = fRegisteredIo; }
+    bool GetRegisteredIo() const { return _fRegisteredIo; }
+
+    void SetSqPoll(bool fSqPoll) { _fSqPoll = fSqPoll; }
+    bool GetSqPoll() const { return _fSqPoll; }
+
+    void SetAioMinEvents(UINT32 ulAioMinEvents) { _ulAioMinEvents = ulAioMinEvents; }
+    UINT32 GetAioMinEvents() const { return _ulAioMinEvents; }
+
+    void SetMeasureLatency(bool fMeasureLatency) { _fMeasureLatency = fMeasureLatency; }
+    bool GetMeasureLatency() const { return _fMeasureLatency; }
+
+    // precision of the latency histograms: more digits cost more buckets per power of two
+    void SetLatencySignificantDigits(UINT32 ulDigits) { _ulLatencySignificantDigits = ulDigits; }
+    UINT32 GetLatencySignificantDigits() const { return _ulLatencySignificantDigits; }
+
+    void SetIoTracePath(const string& sIoTracePath) { _sIoTracePath = sIoTracePath; }
+    const string& GetIoTracePath() const { return _sIoTracePath; }
+
+    void SetCalculateIopsStdDev(bool fCalculateStdDev) { _fCalculateIopsStdDev = fCalculateStdDev; }
+    bool GetCalculateIopsStdDev() const { return _fCalculateIopsStdDev; }
+
+    void SetIoBucketDurationInMilliseconds(UINT32 ulIoBucketDurationInMilliseconds) { _ulIoBucketDurationInMilliseconds = ulIoBucketDurationInMilliseconds; }
+    UINT32 GetIoBucketDurationInMilliseconds() const { return _ulIoBucketDurationInMilliseconds; }
+
+    void SetReportIntervalInMilliseconds(UINT32 ulReportIntervalInMilliseconds) { _ulReportIntervalInMilliseconds = ulReportIntervalInMilliseconds; }
+    UINT32 GetReportIntervalInMilliseconds() const { return _ulReportIntervalInMilliseconds; }
+
+    void SetReportIntervalJson(bool fReportIntervalJson) { _fReportIntervalJson = fReportIntervalJson; }
+    bool GetReportIntervalJson() const { return _fReportIntervalJson; }
+
+    void SetLatencySloPercentile(double lfLatencySloPercentile) { _lfLatencySloPercentile = lfLatencySloPercentile; }
+    double GetLatencySloPercentile() const { return _lfLatencySloPercentile; }
+
+    void SetLatencySloMilliseconds(double lfLatencySloMilliseconds) { _lfLatencySloMilliseconds = lfLatencySloMilliseconds; }
+    double GetLatencySloMilliseconds() const { return _lfLatencySloMilliseconds; }
+
+    void SetLatencySloMaxRequestCount(DWORD dwLatencySloMaxRequestCount) { _dwLatencySloMaxRequestCount = dwLatencySloMaxRequestCount; }
+    DWORD GetLatencySloMaxRequestCount() const { return _dwLatencySloMaxRequestCount; }
+
+    // Limit on the throughput of all threads and targets together, in bytes per millisecond or IOPS.
+    void SetTotalThroughput(DWORD dwBytesPerMillisecond) { _dwTotalThroughputBytesPerMillisecond = dwBytesPerMillisecond; _dwTotalThroughputIOPS = 0; }
+    DWORD GetTotalThroughputInBytesPerMillisecond() const { return _dwTotalThroughputBytesPerMillisecond; }
+    void SetTotalThroughputIOPS(DWORD dwIOPS) { _dwTotalThroughputIOPS = dwIOPS; _dwTotalThroughputBytesPerMillisecond = 0; }
+    DWORD GetTotalThroughputIOPS() const { return _dwTotalThroughputIOPS; }
+
+    // A sweep runs the timespan once for each combination of the listed outstanding IO counts,
+    // thread counts and block sizes; an empty list keeps the timespan's own.
+    void SetSweepRequestCounts(const vector<DWORD>& vdwRequestCounts) { _vdwSweepRequestCounts = vdwRequestCounts; }
+    const vector<DWORD>& GetSweepRequestCounts() const { return _vdwSweepRequestCounts; }
 
-    void SetRequestCount(DWORD dwRequestCount) { _dwRequestCount = dwRequestCount; }
-    DWORD GetRequestCount() const { return _dwRequestCount; }
+    void SetSweepThreadCounts(const vector<DWORD>& vdwThreadCounts) { _vdwSweepThreadCounts = vdwThreadCounts; }
+    const vector<DWORD>& GetSweepThreadCounts() const { return _vdwSweepThreadCounts; }
 
-    void SetDisableAffinity(bool fDisableAffinity) { _fDisableAffinity = fDisableAffinity; }
-    bool GetDisableAffinity() const { return _fDisableAffinity; }
+    void SetSweepBlockSizes(const vector<DWORD>& vdwBlockSizes) { _vdwSweepBlockSizes = vdwBlockSizes; }
+    const vector<DWORD>& GetSweepBlockSizes() const { return _vdwSweepBlockSizes; }
 
-    void SetCompletionRoutines(bool fCompletionRoutines) { _fCompletionRoutines = fCompletionRoutines; }
-    bool GetCompletionRoutines() const { return _fCompletionRoutines; }
+    bool HasSweep() const
+    {
+        return !_vdwSweepRequestCounts.empty() || !_vdwSweepThreadCounts.empty() || !_vdwSweepBlockSizes.empty();
+    }
 
-    void SetMeasureLatency(bool fMeasureLatency) { _fMeasureLatency = fMeasureLatency; }
-    bool GetMeasureLatency() const { return _fMeasureLatency; }
+    // Load phases vary the run's rate, write ratio and queue depth over the measured interval,
+    // in order and repeating for as long as it lasts.
+    void AddPhase(const LoadPhase& phase) { _vPhases.push_back(phase); }
+    const vector<LoadPhase>& GetPhases() const { return _vPhases; }
 
-    void SetCalculateIopsStdDev(bool fCalculateStdDev) { _fCalculateIopsStdDev = fCalculateStdDev; }
-    bool GetCalculateIopsStdDev() const { return _fCalculateIopsStdDev; }
+    // true if a phase states its own write ratio in place of the targets'
+    bool GetPhasesSetWriteRatio() const;
 
-    void SetIoBucketDurationInMilliseconds(UINT32 ulIoBucketDurationInMilliseconds) { _ulIoBucketDurationInMilliseconds = ulIoBucketDurationInMilliseconds; }
-    UINT32 GetIoBucketDurationInMilliseconds() const { return _ulIoBucketDurationInMilliseconds; }
+    // the timespans of each point of the sweep, block sizes outermost and outstanding IO counts
+    // innermost; the timespan itself if there is no sweep
+    vector<TimeSpan> ExpandSweep() const;
 
     string GetXml(UINT32 indent) const;
     void MarkFilesAsPrecreated(const vector<string> vFiles);
@@ -1785,9 +3098,26 @@ private:
     bool _fDisableAffinity;
     vector<AffinityAssignment> _vAffinity;
     bool _fCompletionRoutines;
+    IoEngine _ioEngine;
+    bool _fRegisteredIo;                        // io_uring: buffers and files registered with the ring
+    bool _fSqPoll;                              // io_uring: kernel thread polls the submission queue
+    UINT32 _ulAioMinEvents;                     // Linux AIO: completions to wait for before reaping
     bool _fMeasureLatency;
+    UINT32 _ulLatencySignificantDigits;
+    string _sIoTracePath;                       // binary trace of completed IOs, if captured
     bool _fCalculateIopsStdDev;
     UINT32 _ulIoBucketDurationInMilliseconds;
+    UINT32 _ulReportIntervalInMilliseconds;     // live reporting during the measured interval; 0 if off
+    bool _fReportIntervalJson;                  // ... as JSON lines
+    double _lfLatencySloPercentile;             // search for the most IOPS within a latency SLO; 0 if off
+    double _lfLatencySloMilliseconds;           // ... latency bound at the percentile
+    DWORD _dwLatencySloMaxRequestCount;         // ... largest outstanding IO count to try
+    DWORD _dwTotalThroughputBytesPerMillisecond;    // limit shared by all threads and targets; 0 if none
+    DWORD _dwTotalThroughputIOPS;                   // ... in IOs rather than bytes
+    vector<DWORD> _vdwSweepRequestCounts;       // sweep points; expanded into timespans when parsed
+    vector<DWORD> _vdwSweepThreadCounts;
+    vector<DWORD> _vdwSweepBlockSizes;
+    vector<LoadPhase> _vPhases;
 
     friend class UnitTests::ProfileUnitTests;
 };
@@ -1897,6 +3227,7 @@ public:
     string GetXml(UINT32 indent) const;
     bool Validate(bool fSingleSpec, SystemInformation *pSystem = nullptr) const;
     void MarkFilesAsPrecreated(const vector<string> vFiles);
+    void ExpandSweeps();
 
 private:
     Profile(const Profile& T);
@@ -1933,10 +3264,16 @@ class IORequest
 public:
     IORequest(Random *pRand) :
         _ioType(IOOperation::ReadIO),
+        _fFua(false),
+        _metadataOp(MetadataOp::Create),
+        _iFile(0),
+        _hFile(INVALID_HANDLE_VALUE),
         _pRand(pRand),
         _iCurrentTarget(0),
         _ullStartTime(0),
         _ulRequestIndex(0xFFFFFFFF),
+        _dwBlockSize(0),
+        _iBlockSize(0),
         _ullTotalWeight(0),
         _fEqualWeights(true),
         _ActivityId()
@@ -1994,15 +3331,39 @@ public:
     void SetIoType(IOOperation ioType) { _ioType = ioType; }
     IOOperation GetIoType() const { return _ioType; }
 
+    // a write issued with forced unit access
+    void SetFua(bool fFua) { _fFua = fFua; }
+    bool GetFua() const { return _fFua; }
+
+    // the kind of a metadata operation (MetadataIO)
+    void SetMetadataOp(MetadataOp op) { _metadataOp = op; }
+    MetadataOp GetMetadataOp() const { return _metadataOp; }
+
+    // for a file set target, the file the IO is directed to and, if it is opened per IO (-mo),
+    // the handle opened for it; INVALID_HANDLE_VALUE otherwise
+    void SetFileIndex(DWORD iFile) { _iFile = iFile; }
+    DWORD GetFileIndex() const { return _iFile; }
+    void SetFileHandle(HANDLE hFile) { _hFile = hFile; }
+    HANDLE GetFileHandle() const { return _hFile; }
+
     void SetStartTime(UINT64 ullStartTime) { _ullStartTime = ullStartTime; }
     UINT64 GetStartTime() const { return _ullStartTime; }
 
     void SetRequestIndex(UINT32 ulRequestIndex) { _ulRequestIndex = ulRequestIndex; }
     UINT32 GetRequestIndex() const { return _ulRequestIndex; }
 
+    // size of the IO and, for a target with a block size mix, the index of its size class
+    void SetBlockSize(DWORD dwBlockSize, UINT32 iBlockSize) { _dwBlockSize = dwBlockSize; _iBlockSize = iBlockSize; }
+    DWORD GetBlockSize() const { return _dwBlockSize; }
+    UINT32 GetBlockSizeIndex() const { return _iBlockSize; }
+
     void SetActivityId(GUID ActivityId) { _ActivityId = ActivityId; }
     GUID GetActivityId() const { return _ActivityId; }
 
+    // data verification (-Zv): the generation map entries of the units a read covers, as of its issue
+    void SetVerifySnapshotSize(size_t cUnits) { _vullVerifySnapshot.resize(cUnits); }
+    UINT64 *GetVerifySnapshot() { return _vullVerifySnapshot.data(); }
+
 private:
     OVERLAPPED _overlapped;
     vector<Target*> _vTargets;
@@ -2012,9 +3373,16 @@ private:
     Random *_pRand;
     size_t _iCurrentTarget;
     IOOperation _ioType;
+    bool _fFua;
+    MetadataOp _metadataOp;
+    DWORD _iFile;
+    HANDLE _hFile;
     UINT64 _ullStartTime;
     UINT32 _ulRequestIndex;
+    DWORD _dwBlockSize;
+    UINT32 _iBlockSize;
     GUID _ActivityId;
+    vector<UINT64> _vullVerifySnapshot;
 };
 
 typedef struct _ACTIVITY_ID {
@@ -2025,9 +3393,122 @@ typedef struct _ACTIVITY_ID {
 
 C_ASSERT(sizeof(ACTIVITY_ID) == sizeof(GUID));
 
+struct UniqueTarget {
+    string path;
+    TargetCacheMode caching;
+    PRIORITY_HINT priority;
+    DWORD dwDesiredAccess;
+    DWORD dwFlags;
+
+    bool operator < (const struct UniqueTarget &ut) const {
+        if (path < ut.path) {
+            return true;
+        }
+        else if (ut.path < path) {
+            return false;
+        }
+
+        if (caching < ut.caching) {
+            return true;
+        }
+        else if (ut.caching < caching) {
+            return false;
+        }
+
+        if (priority < ut.priority) {
+            return true;
+        }
+        else if (ut.priority < priority) {
+            return false;
+        }
+
+        if (dwDesiredAccess < ut.dwDesiredAccess) {
+            return true;
+        }
+        else if (ut.dwDesiredAccess < dwDesiredAccess) {
+            return false;
+        }
+
+        if (dwFlags < ut.dwFlags) {
+            return true;
+        }
+
+        return false;
+    }
+};
+
+//
+// Files and data buffers which a thread leaves for the thread of the same number in the next
+// timespan, such as the next point of a sweep, so that it need not reopen and reallocate them.
+// A pool is only used by one thread at a time: its thread while a timespan runs, then the
+// generator, which releases whatever is left when the run is over.
+//
+
+enum class BufferFill
+{
+    None,
+    Zero,
+    Pattern
+};
+
+class ThreadResourcePool
+{
+public:
+    ThreadResourcePool() = default;
+    ~ThreadResourcePool() { Clear(); }
+
+    // an idle handle opened as the target states, or INVALID_HANDLE_VALUE if there is none
+    HANDLE AcquireHandle(const UniqueTarget& target);
+    void ReleaseHandle(const UniqueTarget& target, HANDLE hFile);
+
+    // an idle buffer of at least cb bytes, or a new one; *pfFilled is set if it already holds
+    // the fill over cb bytes, else the caller fills it. fKeepFill states whether the fill
+    // will survive this use for the next.
+    BYTE *AcquireBuffer(size_t cb, bool fLargePages, BufferFill fill, bool fKeepFill, bool *pfFilled);
+    void ReleaseBuffer(BYTE *pBuffer);
+
+    void Clear();
+
+private:
+    ThreadResourcePool(const ThreadResourcePool&);
+    ThreadResourcePool& operator=(const ThreadResourcePool&);
+
+    struct Buffer
+    {
+        BYTE *pBuffer;
+        size_t cb;
+        bool fLargePages;
+        bool fInUse;
+        size_t cbFilled;
+        BufferFill fill;
+    };
+
+    multimap<UniqueTarget, HANDLE> _mIdleHandles;
+    vector<Buffer> _vBuffers;
+};
+
 // Forward declaration
 class ThreadTargetState;
 
+// A thread's state for a file set target (-m)
+struct FileSetState
+{
+    FileSetState() :
+        dwDesiredAccess(0),
+        dwFlags(0),
+        ullNextScratchFile(0)
+    {
+    }
+
+    vector<HANDLE> vhFiles;             // the files of the set; empty if they are opened per IO (-mo)
+    DWORD dwDesiredAccess;              // how the files are opened
+    DWORD dwFlags;
+
+    // the scratch files the thread's creates, renames and unlinks (-mm) act on, oldest first
+    deque<string> dqScratchFiles;
+    UINT64 ullNextScratchFile;
+};
+
 class ThreadParameters
 {
 public:
@@ -2035,6 +3516,14 @@ public:
         pProfile(nullptr),
         pTimeSpan(nullptr),
         pullSharedSequentialOffsets(nullptr),
+        ppTraceReaders(nullptr),
+        ppTargetRateLimits(nullptr),
+        pRunRateLimit(nullptr),
+        pPhaseSchedule(nullptr),
+        pPhaseRateLimit(nullptr),
+        pIoTraceRing(nullptr),
+        pResourcePool(nullptr),
+        hCompletionPort(nullptr),
         ulRandSeed(0),
         ulThreadNo(0),
         ulRelativeThreadNo(0)
@@ -2047,6 +3536,8 @@ public:
     vector<Target> vTargets;
     vector<ThreadTargetState> vTargetStates;
     vector<HANDLE> vhTargets;
+    vector<bool> vfDeviceTargets;       // whether each target is a disk or partition rather than a file
+    vector<FileSetState> vFileSets;     // by target; unused for targets which are not file sets
 
     vector<size_t> vulReadBufferSize;
     vector<BYTE *> vpDataBuffers;
@@ -2057,6 +3548,33 @@ public:
     // Pointers to offsets shared between threads, incremented with an interlocked op
     UINT64* pullSharedSequentialOffsets;
 
+    // For trace replay (-Q):
+    // Pointers to the readers shared between the threads replaying each target's trace
+    TraceReader **ppTraceReaders;
+
+    // For throughput limits across threads (-gt, -gr):
+    // Pointers to the limits shared by the threads on each target (null if none), and by all threads
+    SharedRateLimit **ppTargetRateLimits;
+    SharedRateLimit *pRunRateLimit;
+
+    // For load phases (-H):
+    // The timespan's schedule (null if none), the limit shared by all threads its rates are
+    // applied through (null if no phase states one), and this thread's current point of it
+    const PhaseSchedule *pPhaseSchedule;
+    SharedRateLimit *pPhaseRateLimit;
+    PhaseState phaseState;
+
+    // For IO trace capture (-Lt):
+    // This thread's ring of completed IO records
+    IoTraceRing *pIoTraceRing;
+
+    // Files and buffers kept for the thread of this number in the next timespan, if they can be
+    ThreadResourcePool *pResourcePool;
+
+    // The thread's completion port, which files opened per IO (-mo) are associated with; null if
+    // the thread does not use one
+    HANDLE hCompletionPort;
+
     Random *pRand;
 
     UINT32 ulRandSeed;
@@ -2121,7 +3639,12 @@ class ThreadTargetState
         _nextSeqOffset(0),
         _lastIO(IOOperation::Unknown),
         _sharedSeqOffset(nullptr),
-        _ioDistributionSpan(100)
+        _ioDistributionSpan(100),
+        _cSkewOffsets(0),
+        _lfSkewExponent(0),
+        _ullBlockSizeMixWeight(0),
+        _traceReader(nullptr),
+        _iTraceRecord(0)
     {
         //
         // Now calculate the maximum base-relative file offset that IO can be issued at.
@@ -2148,6 +3671,11 @@ class ThreadTargetState
         _relTargetSizeAligned -= _relTargetSizeAligned % _target->GetBlockAlignmentInBytes();
         _relTargetSizeAligned += _target->GetBlockAlignmentInBytes();
 
+        for (const auto& b : _target->GetBlockSizeMix())
+        {
+            _ullBlockSizeMixWeight += b.ulWeight;
+        }
+
         // Grab the shared sequential pointer if this is interlocked.
 
         if (_mode == IOMode::InterlockedSequential)
@@ -2156,6 +3684,14 @@ class ThreadTargetState
             _sharedSeqOffset = &_tp->pullSharedSequentialOffsets[iTarget];
         }
 
+        // ... and the shared trace reader if this is a replay.
+
+        if (_mode == IOMode::Trace)
+        {
+            assert(_tp->ppTraceReaders != nullptr);
+            _traceReader = _tp->ppTraceReaders[iTarget];
+        }
+
         // Convert and finalize the random distribution stated in the target using final bounds.
 
         switch (_target->GetDistributionType())
@@ -2402,11 +3938,40 @@ class ThreadTargetState
             }
             break;
 
+            //
+            // Skewed distributions rank the aligned offsets of the target, hottest first from its base
+            // unless the ranks are scattered across it.
+            // Constants are computed once here so that each offset is an O(1) draw.
+            //
+
+            case DistributionType::Zipf:
+            {
+                _cSkewOffsets = _relTargetSizeAligned / _target->GetBlockAlignmentInBytes();
+                _zipfOffsets.Initialize(_cSkewOffsets, _target->GetDistributionSkew());
+                _skewScatter.Initialize(_cSkewOffsets);
+            }
+            break;
+
+            case DistributionType::Pareto:
+            {
+                double h = _target->GetDistributionSkew();
+
+                _cSkewOffsets = _relTargetSizeAligned / _target->GetBlockAlignmentInBytes();
+                _lfSkewExponent = log(h) / log(1.0 - h);
+                _skewScatter.Initialize(_cSkewOffsets);
+            }
+            break;
+
             // none
             default:
             break;
         }
 
+        if (_target->GetFileSetCount() != 0 && _target->GetFileSetSkew() != 0)
+        {
+            _zipfFiles.Initialize(_target->GetFileSetCount(), _target->GetFileSetSkew());
+        }
+
         Reset();
     }
 
@@ -2475,9 +4040,51 @@ class ThreadTargetState
 
         ioRequest.GetOverlapped()->Offset = initialOffset.LowPart;
         ioRequest.GetOverlapped()->OffsetHigh = initialOffset.HighPart;
+        ioRequest.SetBlockSize((DWORD)_target->GetBlockAlignmentInBytes(), 0);
+    }
+
+    //
+    // Size of the next IO. With a block size mix this is a weighted choice among its size classes,
+    // returning the index of the class chosen.
+    //
+
+    DWORD NextBlockSize(UINT32& iBlockSize) const
+    {
+        iBlockSize = 0;
+
+        if (!_ullBlockSizeMixWeight)
+        {
+            return _target->GetBlockSizeInBytes();
+        }
+
+        const auto& vMix = _target->GetBlockSizeMix();
+        UINT64 ullWeight = _tp->pRand->Rand64() % _ullBlockSizeMixWeight;
+
+        for (; iBlockSize < vMix.size() - 1; iBlockSize++)
+        {
+            if (ullWeight < vMix[iBlockSize].ulWeight)
+            {
+                break;
+            }
+
+            ullWeight -= vMix[iBlockSize].ulWeight;
+        }
+
+        return vMix[iBlockSize].dwBlockSize;
     }
 
-    UINT64 NextRelativeSeqOffset()
+    //
+    // Distance sequential IO advances past an IO of the given size. This is the stride, though
+    // with a block size mix never less than the IO itself so that sequential IO does not overlap.
+    //
+
+    UINT64 SeqAdvance(DWORD cbIO) const
+    {
+        UINT64 cbStride = _target->GetBlockAlignmentInBytes();
+        return (_ullBlockSizeMixWeight && cbIO > cbStride) ? cbIO : cbStride;
+    }
+
+    UINT64 NextRelativeSeqOffset(DWORD cbIO)
     {
         UINT64 nextOffset;
 
@@ -2485,28 +4092,28 @@ class ThreadTargetState
 
         // Wrap?
 
-        if (nextOffset + _target->GetBlockSizeInBytes() > _relTargetSize) {
+        if (nextOffset + cbIO > _relTargetSize) {
             nextOffset = _target->GetThreadBaseRelativeOffsetInBytes(_tp->ulRelativeThreadNo) % _target->GetBlockAlignmentInBytes();
         }
 
-        _nextSeqOffset = nextOffset + _target->GetBlockAlignmentInBytes();
+        _nextSeqOffset = nextOffset + SeqAdvance(cbIO);
 
         return nextOffset;
     }
 
-    UINT64 NextRelativeInterlockedSeqOffset()
+    UINT64 NextRelativeInterlockedSeqOffset(DWORD cbIO)
     {
         UINT64 nextOffset;
 
         // advance shared and rewind to get offset to use
-        nextOffset = InterlockedAdd64((PLONG64) _sharedSeqOffset, _target->GetBlockAlignmentInBytes());
-        nextOffset -=  _target->GetBlockAlignmentInBytes();
+        nextOffset = InterlockedAdd64((PLONG64) _sharedSeqOffset, SeqAdvance(cbIO));
+        nextOffset -= SeqAdvance(cbIO);
 
         nextOffset %= _relTargetSizeAligned;
         return nextOffset;
     }
 
-    UINT64 NextRelativeParaSeqOffset(IORequest& ioRequest)
+    UINT64 NextRelativeParaSeqOffset(IORequest& ioRequest, DWORD cbIO)
     {
         ULARGE_INTEGER nextOffset;
 
@@ -2519,19 +4126,47 @@ class ThreadTargetState
         nextOffset.LowPart = ioRequest.GetOverlapped()->Offset;
         nextOffset.HighPart = ioRequest.GetOverlapped()->OffsetHigh;
         nextOffset.QuadPart -= _target->GetBaseFileOffsetInBytes();     // absolute -> relative
-        nextOffset.QuadPart += _target->GetBlockAlignmentInBytes();     // advance past last IO (!)
+        nextOffset.QuadPart += SeqAdvance(ioRequest.GetBlockSize());    // advance past last IO (!)
 
         // Wrap?
 
-        if (nextOffset.QuadPart + _target->GetBlockSizeInBytes() > _relTargetSize) {
+        if (nextOffset.QuadPart + cbIO > _relTargetSize) {
             nextOffset.QuadPart = _target->GetThreadBaseRelativeOffsetInBytes(_tp->ulRelativeThreadNo) % _target->GetBlockAlignmentInBytes();
         }
 
         return nextOffset.QuadPart;
     }
 
+    //
+    // Rank of the next offset under a skewed distribution, 0 being the hottest.
+    //
+
+    UINT64 NextSkewedRank() const
+    {
+        double u = _tp->pRand->RandDouble();
+
+        if (_target->GetDistributionType() == DistributionType::Zipf)
+        {
+            return _zipfOffsets.Rank(u);
+        }
+
+        UINT64 rank = (UINT64)(_cSkewOffsets * pow(u, _lfSkewExponent));
+        return rank < _cSkewOffsets ? rank : _cSkewOffsets - 1;
+    }
+
     UINT64 NextRelativeRandomOffset() const
     {
+        if (_cSkewOffsets)
+        {
+            UINT64 rank = NextSkewedRank();
+
+            if (_target->GetDistributionScatter())
+            {
+                rank = _skewScatter.Permute(rank);
+            }
+            return rank * _target->GetBlockAlignmentInBytes();
+        }
+
         UINT64 nextOffset = _tp->pRand->Rand64();
         nextOffset -= nextOffset % _target->GetBlockAlignmentInBytes();
 
@@ -2554,7 +4189,7 @@ class ThreadTargetState
         return nextOffset;
     }
 
-    UINT64 NextRelativeMixedOffset(bool& fRandom)
+    UINT64 NextRelativeMixedOffset(bool& fRandom, DWORD cbIO)
     {
         ULARGE_INTEGER nextOffset;
 
@@ -2563,22 +4198,94 @@ class ThreadTargetState
         if (fRandom)
         {
             nextOffset.QuadPart = NextRelativeRandomOffset();
-            _nextSeqOffset = nextOffset.QuadPart + _target->GetBlockAlignmentInBytes();
+            _nextSeqOffset = nextOffset.QuadPart + SeqAdvance(cbIO);
             return nextOffset.QuadPart;
         }
 
-        return NextRelativeSeqOffset();
+        return NextRelativeSeqOffset(cbIO);
+    }
+
+    //
+    // Trace replay: records are taken in batches from the reader shared by the threads
+    // replaying the target, so that each record is issued once by one of them. The trace
+    // repeats, so it only ends if the reader has been closed; there is then no next record.
+    //
+
+    const TraceRecord* PeekTraceRecord()
+    {
+        if (_iTraceRecord == _vTraceBatch.size())
+        {
+            if (!_traceReader->NextBatch(_vTraceBatch) || _vTraceBatch.empty())
+            {
+                _vTraceBatch.clear();
+                _iTraceRecord = 0;
+                return nullptr;
+            }
+            _iTraceRecord = 0;
+        }
+
+        return &_vTraceBatch[_iTraceRecord];
+    }
+
+    // Time of the next record relative to the start of the trace (perf timer units); false if
+    // the trace has ended
+    bool NextTraceArrival(UINT64& ullArrival)
+    {
+        const TraceRecord* pRecord = PeekTraceRecord();
+        if (pRecord == nullptr)
+        {
+            return false;
+        }
+
+        ullArrival = PerfTimer::MicrosecondsToPerfTime(pRecord->ullTime / 1000.0);
+        return true;
+    }
+
+    bool NextTraceIORequest(IORequest& ioRequest)
+    {
+        const TraceRecord* pRecord = PeekTraceRecord();
+        if (pRecord == nullptr)
+        {
+            return false;
+        }
+
+        const TraceRecord& record = *pRecord;
+        ULARGE_INTEGER nextOffset;
+
+        nextOffset.QuadPart = record.ullOffset;
+
+        // Wrap records past the end of the target back into it, keeping sector alignment.
+        // The target is at least as large as the largest record (see CanStart).
+
+        if (nextOffset.QuadPart + record.dwLength > _relTargetSize)
+        {
+            nextOffset.QuadPart %= _relTargetSize - record.dwLength + 1;
+            nextOffset.QuadPart -= nextOffset.QuadPart % 512;
+        }
+
+        nextOffset.QuadPart += _target->GetBaseFileOffsetInBytes();
+
+        ioRequest.GetOverlapped()->Offset = nextOffset.LowPart;
+        ioRequest.GetOverlapped()->OffsetHigh = nextOffset.HighPart;
+        ioRequest.SetBlockSize(record.dwLength, 0);
+        ioRequest.SetIoType(record.fWrite ? IOOperation::WriteIO : IOOperation::ReadIO);
+
+        _iTraceRecord++;
+        return true;
     }
 
     IOOperation NextIOType(bool newType)
     {
         IOOperation ioType;
 
-        if (_target->GetWriteRatio() == 0)
+        // the current load phase may state its own
+        UINT32 ulWriteRatio = _tp->phaseState.fWriteRatio ? _tp->phaseState.ulWriteRatio : _target->GetWriteRatio();
+
+        if (ulWriteRatio == 0)
         {
            ioType = IOOperation::ReadIO;
         }
-        else if (_target->GetWriteRatio() == 100)
+        else if (ulWriteRatio == 100)
         {
             ioType = IOOperation::WriteIO;
         }
@@ -2589,34 +4296,134 @@ class ThreadTargetState
         }
         else
         {
-            ioType = Util::BooleanRatio(_tp->pRand, _target->GetWriteRatio()) ? IOOperation::WriteIO : IOOperation::ReadIO;
+            ioType = Util::BooleanRatio(_tp->pRand, ulWriteRatio) ? IOOperation::WriteIO : IOOperation::ReadIO;
             _lastIO = ioType;
         }
 
         return ioType;
     }
 
-    void NextIORequest(IORequest &ioRequest)
+    // whether the next IO is a flush, trim or metadata operation, from one draw against their
+    // combined ratios; Unknown if it is a read or write (see NextIOType)
+    IOOperation NextCommandType()
+    {
+        UINT32 ulFlushRatio = _target->GetFlushRatio();
+        UINT32 ulTrimRatio = _target->GetTrimRatio();
+        UINT32 ulMetadataRatio = _target->GetMetadataRatio();
+
+        if (ulFlushRatio == 0 && ulTrimRatio == 0 && ulMetadataRatio == 0)
+        {
+            return IOOperation::Unknown;
+        }
+
+        UINT32 ulDraw = _tp->pRand->Rand32() % 100 + 1;
+        if (ulDraw <= ulFlushRatio)
+        {
+            return IOOperation::FlushIO;
+        }
+        if (ulDraw <= ulFlushRatio + ulTrimRatio)
+        {
+            return IOOperation::TrimIO;
+        }
+        if (ulDraw <= ulFlushRatio + ulTrimRatio + ulMetadataRatio)
+        {
+            return IOOperation::MetadataIO;
+        }
+
+        return IOOperation::Unknown;
+    }
+
+    // the file of a file set the next IO is directed to, uniformly or by its rank
+    DWORD NextFile() const
+    {
+        if (_zipfFiles.GetItemCount())
+        {
+            return (DWORD)_zipfFiles.Rank(_tp->pRand->RandDouble());
+        }
+
+        return _tp->pRand->Rand32() % _target->GetFileSetCount();
+    }
+
+    // one of the kinds of metadata operation in the target's mask, with equal chance
+    MetadataOp NextMetadataOp() const
+    {
+        UINT32 ulOps = _target->GetMetadataOps();
+        UINT32 cOps = 0;
+
+        for (UINT32 i = 0; i < static_cast<UINT32>(MetadataOp::Open); i++)
+        {
+            cOps += (ulOps >> i) & 1;
+        }
+
+        UINT32 iOp = _tp->pRand->Rand32() % cOps;
+        for (UINT32 i = 0; ; i++)
+        {
+            if (((ulOps >> i) & 1) && iOp-- == 0)
+            {
+                return static_cast<MetadataOp>(i);
+            }
+        }
+    }
+
+    // Returns false only if the target replays a trace which has ended (see PeekTraceRecord).
+    bool NextIORequest(IORequest &ioRequest)
     {
+        ioRequest.SetFua(false);
+
+        if (_mode == IOMode::Trace)
+        {
+            return NextTraceIORequest(ioRequest);
+        }
+
+        // in a file set, every IO is directed to one of its files
+        if (_target->GetFileSetCount() != 0)
+        {
+            ioRequest.SetFileIndex(NextFile());
+        }
+
+        // flushes and metadata operations take no offset or size, leaving the offset generators as they are
+        IOOperation commandType = NextCommandType();
+        if (commandType == IOOperation::MetadataIO)
+        {
+            ioRequest.SetBlockSize(0, 0);
+            ioRequest.SetIoType(IOOperation::MetadataIO);
+            ioRequest.SetMetadataOp(NextMetadataOp());
+            return true;
+        }
+        if (commandType == IOOperation::FlushIO)
+        {
+            ioRequest.SetBlockSize(0, 0);
+            ioRequest.SetIoType(IOOperation::FlushIO);
+            return true;
+        }
+
         bool fRandom = false;
         ULARGE_INTEGER nextOffset = { 0 };
+        UINT32 iBlockSize;
+        DWORD cbIO = NextBlockSize(iBlockSize);
+
+        // trims take their offset from the same generators as reads and writes
+        if (commandType == IOOperation::TrimIO && _target->GetTrimSize() != 0)
+        {
+            cbIO = _target->GetTrimSize();
+        }
 
         switch (_mode)
         {
             case IOMode::Sequential:
-            nextOffset.QuadPart = NextRelativeSeqOffset();
+            nextOffset.QuadPart = NextRelativeSeqOffset(cbIO);
             break;
 
             case IOMode::InterlockedSequential:
-            nextOffset.QuadPart = NextRelativeInterlockedSeqOffset();
+            nextOffset.QuadPart = NextRelativeInterlockedSeqOffset(cbIO);
             break;
 
             case IOMode::ParallelAsync:
-            nextOffset.QuadPart = NextRelativeParaSeqOffset(ioRequest);
+            nextOffset.QuadPart = NextRelativeParaSeqOffset(ioRequest, cbIO);
             break;
 
             case IOMode::Mixed:
-            nextOffset.QuadPart = NextRelativeMixedOffset(fRandom);
+            nextOffset.QuadPart = NextRelativeMixedOffset(fRandom, cbIO);
             break;
 
             case IOMode::Random:
@@ -2632,6 +4439,23 @@ class ThreadTargetState
         //  Convert relative offset to absolute.
         //
 
+        if (commandType == IOOperation::TrimIO)
+        {
+            // a trim larger than the block size may run past the end of the target
+            if (nextOffset.QuadPart + cbIO > _relTargetSize)
+            {
+                cbIO = (DWORD)(_relTargetSize - nextOffset.QuadPart);
+            }
+
+            nextOffset.QuadPart += _target->GetBaseFileOffsetInBytes();
+
+            ioRequest.GetOverlapped()->Offset = nextOffset.LowPart;
+            ioRequest.GetOverlapped()->OffsetHigh = nextOffset.HighPart;
+            ioRequest.SetBlockSize(cbIO, 0);
+            ioRequest.SetIoType(IOOperation::TrimIO);
+            return true;
+        }
+
         nextOffset.QuadPart += _target->GetBaseFileOffsetInBytes();
 
         //
@@ -2642,7 +4466,15 @@ class ThreadTargetState
 
         ioRequest.GetOverlapped()->Offset = nextOffset.LowPart;
         ioRequest.GetOverlapped()->OffsetHigh = nextOffset.HighPart;
+        ioRequest.SetBlockSize(cbIO, iBlockSize);
         ioRequest.SetIoType(NextIOType(fRandom));
+
+        if (ioRequest.GetIoType() == IOOperation::WriteIO && _target->GetFuaWriteRatio() != 0)
+        {
+            ioRequest.SetFua(Util::BooleanRatio(_tp->pRand, _target->GetFuaWriteRatio()));
+        }
+
+        return true;
     }
 
     private:
@@ -2672,6 +4504,31 @@ public:
     vector<DistributionRange> _vDistributionRange;
     UINT32 _ioDistributionSpan;
 
+    //
+    // Skewed random distribution (ranked over aligned offsets of target)
+    //
+
+    UINT64 _cSkewOffsets;               // number of ranked offsets; zero if the distribution is not skewed
+    double _lfSkewExponent;             // Pareto: log(h)/log(1-h)
+    ZipfRanks _zipfOffsets;             // Zipf
+    RankPermutation _skewScatter;       // offset of each rank, if scattered
+
+    //
+    // File set (ranked over its files, if skewed)
+    //
+
+    ZipfRanks _zipfFiles;
+
+    UINT64 _ullBlockSizeMixWeight;      // total weight of the block size mix; zero if there is none
+
+    //
+    // Trace replay
+    //
+
+    TraceReader *_traceReader;          // reader shared by the threads replaying the target
+    vector<TraceRecord> _vTraceBatch;   // records taken from the reader for this thread to issue
+    size_t _iTraceRecord;               // next record of the batch
+
     friend class UnitTests::IORequestGeneratorUnitTests;
 };
 
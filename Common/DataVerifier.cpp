@@ -0,0 +1,466 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "Common.h"
+#include <stdarg.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC32C_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// as for RandBuffer, the compiler must be allowed SSE 4.2 for the function which uses it
+#if defined(CRC32C_X64) && !defined(_MSC_VER)
+#define CRC32C_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CRC32C_TARGET(isa)
+#endif
+
+//
+// The CRC is kept uninverted while data is added to it (the "raw" state the crc32 instruction
+// updates), and inverted on the way in and out of Compute.
+//
+
+static const UINT32 Crc32cPolynomial = 0x82f63b78;  // reflected
+
+typedef UINT32 CrcTable[256];
+
+// slicing-by-8: table k advances the CRC of a byte over k more zero bytes
+static const CrcTable *softwareTables()
+{
+    static const struct Tables
+    {
+        CrcTable t[8];
+
+        Tables()
+        {
+            for (UINT32 n = 0; n < 256; n++)
+            {
+                UINT32 crc = n;
+                for (int i = 0; i < 8; i++)
+                {
+                    crc = (crc & 1) ? (crc >> 1) ^ Crc32cPolynomial : crc >> 1;
+                }
+                t[0][n] = crc;
+            }
+            for (UINT32 n = 0; n < 256; n++)
+            {
+                for (int k = 1; k < 8; k++)
+                {
+                    t[k][n] = (t[k - 1][n] >> 8) ^ t[0][t[k - 1][n] & 0xff];
+                }
+            }
+        }
+    } tables;
+
+    return tables.t;
+}
+
+static UINT32 updateSoftware(UINT32 crc, const BYTE *pb, size_t cb)
+{
+    const CrcTable *t = softwareTables();
+
+    for (; cb >= sizeof(UINT64); cb -= sizeof(UINT64), pb += sizeof(UINT64))
+    {
+        UINT64 w;
+        memcpy(&w, pb, sizeof(w));
+        w ^= crc;
+        crc = t[7][w & 0xff] ^ t[6][(w >> 8) & 0xff] ^ t[5][(w >> 16) & 0xff] ^ t[4][(w >> 24) & 0xff] ^
+              t[3][(w >> 32) & 0xff] ^ t[2][(w >> 40) & 0xff] ^ t[1][(w >> 48) & 0xff] ^ t[0][w >> 56];
+    }
+    for (; cb > 0; cb--, pb++)
+    {
+        crc = t[0][(crc ^ *pb) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+#ifdef CRC32C_X64
+
+//
+// The crc32 instruction completes one per cycle but takes three to produce its result, so one
+// CRC runs at a third of its throughput. Three stripes are run side by side instead. Their CRCs
+// are joined by advancing the CRC of the first over the length of a stripe - a linear function
+// of the CRC, looked up a byte at a time - and adding the CRC of the next, and so on.
+//
+
+static const size_t StripeSize = 256;
+
+static const CrcTable *stripeShiftTables()
+{
+    static const struct Tables
+    {
+        CrcTable t[4];
+
+        Tables()
+        {
+            const BYTE abZero[StripeSize] = {};
+
+            for (UINT32 k = 0; k < 4; k++)
+            {
+                for (UINT32 n = 0; n < 256; n++)
+                {
+                    t[k][n] = updateSoftware(n << (8 * k), abZero, StripeSize);
+                }
+            }
+        }
+    } tables;
+
+    return tables.t;
+}
+
+static inline UINT32 shiftStripe(const CrcTable *t, UINT32 crc)
+{
+    return t[0][crc & 0xff] ^ t[1][(crc >> 8) & 0xff] ^ t[2][(crc >> 16) & 0xff] ^ t[3][crc >> 24];
+}
+
+static inline UINT64 load64(const BYTE *pb)
+{
+    UINT64 w;
+    memcpy(&w, pb, sizeof(w));
+    return w;
+}
+
+CRC32C_TARGET("sse4.2")
+static UINT32 updateHardware(UINT32 crc, const BYTE *pb, size_t cb)
+{
+    UINT64 crc0 = crc;
+
+    if (cb >= 3 * StripeSize)
+    {
+        const CrcTable *t = stripeShiftTables();
+
+        do
+        {
+            UINT64 crc1 = 0, crc2 = 0;
+
+            for (size_t i = 0; i < StripeSize; i += sizeof(UINT64))
+            {
+                crc0 = _mm_crc32_u64(crc0, load64(pb + i));
+                crc1 = _mm_crc32_u64(crc1, load64(pb + StripeSize + i));
+                crc2 = _mm_crc32_u64(crc2, load64(pb + 2 * StripeSize + i));
+            }
+
+            crc0 = shiftStripe(t, shiftStripe(t, (UINT32)crc0) ^ (UINT32)crc1) ^ (UINT32)crc2;
+            pb += 3 * StripeSize;
+            cb -= 3 * StripeSize;
+        }
+        while (cb >= 3 * StripeSize);
+    }
+
+    for (; cb >= sizeof(UINT64); cb -= sizeof(UINT64), pb += sizeof(UINT64))
+    {
+        crc0 = _mm_crc32_u64(crc0, load64(pb));
+    }
+
+    crc = (UINT32)crc0;
+    for (; cb > 0; cb--, pb++)
+    {
+        crc = _mm_crc32_u8(crc, *pb);
+    }
+
+    return crc;
+}
+
+#endif
+
+bool Crc32c::IsHardwareSupported()
+{
+#ifdef CRC32C_X64
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+#else
+    return false;
+#endif
+}
+
+UINT32 Crc32c::ComputeSoftware(const void *pData, size_t cb, UINT32 ulCrc)
+{
+    return ~updateSoftware(~ulCrc, static_cast<const BYTE *>(pData), cb);
+}
+
+UINT32 Crc32c::Compute(const void *pData, size_t cb, UINT32 ulCrc)
+{
+#ifdef CRC32C_X64
+    static const bool fHardware = IsHardwareSupported();
+
+    if (fHardware)
+    {
+        return ~updateHardware(~ulCrc, static_cast<const BYTE *>(pData), cb);
+    }
+#endif
+
+    return ComputeSoftware(pData, cb, ulCrc);
+}
+
+//
+// Generation map entries; see DataVerifier.
+//
+
+static const UINT32 NextShift = 0;
+static const UINT32 FirstShift = 16;
+static const UINT32 FloorShift = 32;
+static const UINT32 InFlightShift = 48;
+static const UINT64 GenerationMask = 0xffff;
+static const UINT64 InFlightMask = 0x7fff;
+static const UINT64 WrittenFlag = 1ULL << 63;
+
+static inline UINT32 entryGeneration(UINT64 ullEntry, UINT32 shift)
+{
+    return static_cast<UINT32>((ullEntry >> shift) & GenerationMask);
+}
+
+static inline UINT64 setEntryGeneration(UINT64 ullEntry, UINT32 shift, UINT32 ulGeneration)
+{
+    return (ullEntry & ~(GenerationMask << shift)) | ((ulGeneration & GenerationMask) << shift);
+}
+
+static inline UINT32 entryInFlight(UINT64 ullEntry)
+{
+    return static_cast<UINT32>((ullEntry >> InFlightShift) & InFlightMask);
+}
+
+DataVerifier::DataVerifier(const string& sPath, UINT32 ulTarget, UINT32 cbUnit, UINT32 ulSeed) :
+    _sPath(sPath),
+    _ulTarget(ulTarget),
+    _cbUnit(cbUnit),
+    _ulSeed(ulSeed),
+    _pllMap(nullptr),
+    _cUnits(0),
+    _cErrors(0)
+{
+    assert(cbUnit >= MinUnitSize);
+}
+
+DataVerifier::~DataVerifier()
+{
+    if (_pllMap != nullptr)
+    {
+        VirtualFree((PVOID)_pllMap, 0, MEM_RELEASE);
+    }
+}
+
+bool DataVerifier::Attach(UINT64 cbTarget)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    // the map is zeroed: no unit has been written
+    if (_pllMap == nullptr)
+    {
+        _cUnits = static_cast<size_t>(cbTarget / _cbUnit);
+        _pllMap = (volatile LONG64 *)VirtualAlloc(nullptr, max<size_t>(_cUnits, 1) * sizeof(LONG64), MEM_COMMIT, PAGE_READWRITE);
+    }
+
+    return _pllMap != nullptr;
+}
+
+void DataVerifier::BeginWrite(BYTE *pBuffer, UINT64 ullOffset, DWORD cb)
+{
+    assert(ullOffset % _cbUnit == 0 && cb % _cbUnit == 0);
+    assert((ullOffset + cb) / _cbUnit <= _cUnits);
+
+    size_t iUnit = static_cast<size_t>(ullOffset / _cbUnit);
+
+    for (DWORD ib = 0; ib < cb; ib += _cbUnit, iUnit++)
+    {
+        UINT64 ullEntry, ullNewEntry;
+        UINT32 ulGeneration;
+
+        do
+        {
+            ullEntry = static_cast<UINT64>(_pllMap[iUnit]);
+            ulGeneration = entryGeneration(ullEntry, NextShift);
+
+            ullNewEntry = setEntryGeneration(ullEntry, NextShift, ulGeneration + 1);
+            if (entryInFlight(ullEntry) == 0)
+            {
+                ullNewEntry = setEntryGeneration(ullNewEntry, FirstShift, ulGeneration);
+            }
+            ullNewEntry += 1ULL << InFlightShift;
+        }
+        while (InterlockedCompareExchange64(&_pllMap[iUnit], static_cast<LONG64>(ullNewEntry), static_cast<LONG64>(ullEntry)) != static_cast<LONG64>(ullEntry));
+
+        VerifyHeader header;
+        header.ulChecksum = 0;
+        header.ulMagic = Magic;
+        header.ullOffset = ullOffset + ib;
+        header.ulTarget = _ulTarget;
+        header.ulGeneration = ulGeneration;
+        header.ulSeed = _ulSeed;
+        header.ulReserved = 0;
+
+        BYTE *pUnit = pBuffer + ib;
+        memcpy(pUnit, &header, sizeof(header));
+        header.ulChecksum = Crc32c::Compute(pUnit + sizeof(header.ulChecksum), _cbUnit - sizeof(header.ulChecksum));
+        memcpy(pUnit, &header.ulChecksum, sizeof(header.ulChecksum));
+    }
+}
+
+void DataVerifier::EndWrite(UINT64 ullOffset, DWORD cb)
+{
+    size_t iUnit = static_cast<size_t>(ullOffset / _cbUnit);
+
+    for (DWORD ib = 0; ib < cb; ib += _cbUnit, iUnit++)
+    {
+        UINT64 ullEntry, ullNewEntry;
+
+        do
+        {
+            ullEntry = static_cast<UINT64>(_pllMap[iUnit]);
+            assert(entryInFlight(ullEntry) != 0);
+
+            // the last write of a busy period completes it
+            ullNewEntry = ullEntry - (1ULL << InFlightShift);
+            if (entryInFlight(ullNewEntry) == 0)
+            {
+                ullNewEntry = setEntryGeneration(ullNewEntry, FloorShift, entryGeneration(ullEntry, FirstShift)) | WrittenFlag;
+            }
+        }
+        while (InterlockedCompareExchange64(&_pllMap[iUnit], static_cast<LONG64>(ullNewEntry), static_cast<LONG64>(ullEntry)) != static_cast<LONG64>(ullEntry));
+    }
+}
+
+void DataVerifier::BeginRead(UINT64 ullOffset, DWORD cb, UINT64 *pullSnapshot) const
+{
+    assert(ullOffset % _cbUnit == 0 && cb % _cbUnit == 0);
+    assert((ullOffset + cb) / _cbUnit <= _cUnits);
+
+    size_t iUnit = static_cast<size_t>(ullOffset / _cbUnit);
+
+    for (DWORD ib = 0; ib < cb; ib += _cbUnit, iUnit++)
+    {
+        *pullSnapshot++ = static_cast<UINT64>(_pllMap[iUnit]);
+    }
+}
+
+UINT32 DataVerifier::EndRead(const BYTE *pBuffer, UINT64 ullOffset, DWORD cb, const UINT64 *pullSnapshot, UINT64 *pcChecked)
+{
+    size_t iUnit = static_cast<size_t>(ullOffset / _cbUnit);
+    UINT32 cFailed = 0;
+
+    for (DWORD ib = 0; ib + _cbUnit <= cb; ib += _cbUnit, iUnit++)
+    {
+        UINT64 ullEntry = *pullSnapshot++;
+
+        // skip units with no known content, or with content which may have changed under the read
+        if (!(ullEntry & WrittenFlag) ||
+            entryInFlight(ullEntry) != 0 ||
+            entryGeneration(static_cast<UINT64>(_pllMap[iUnit]), NextShift) != entryGeneration(ullEntry, NextShift))
+        {
+            continue;
+        }
+
+        (*pcChecked)++;
+        if (!_CheckUnit(pBuffer + ib, ullOffset + ib, ullEntry))
+        {
+            cFailed++;
+        }
+    }
+
+    return cFailed;
+}
+
+bool DataVerifier::_CheckUnit(const BYTE *pUnit, UINT64 ullOffset, UINT64 ullEntry)
+{
+    VerifyHeader header;
+    memcpy(&header, pUnit, sizeof(header));
+
+    if (header.ulMagic != Magic || header.ulSeed != _ulSeed)
+    {
+        _Report(ullOffset, ullEntry, "no header written by this run (lost write)");
+        return false;
+    }
+
+    if (header.ulChecksum != Crc32c::Compute(pUnit + sizeof(header.ulChecksum), _cbUnit - sizeof(header.ulChecksum)))
+    {
+        _Report(ullOffset, ullEntry, "checksum mismatch (corrupt data)");
+        return false;
+    }
+
+    if (header.ulTarget != _ulTarget || header.ullOffset != ullOffset)
+    {
+        _Report(ullOffset, ullEntry, "holds the data of target %u offset %llu (misdirected write)", header.ulTarget, header.ullOffset);
+        return false;
+    }
+
+    // the generation is one of [floor, next), modulo the 16 bits of the map
+    UINT32 ulFloor = entryGeneration(ullEntry, FloorShift);
+    if (((header.ulGeneration - ulFloor) & GenerationMask) >= ((entryGeneration(ullEntry, NextShift) - ulFloor) & GenerationMask))
+    {
+        _Report(ullOffset, ullEntry, "holds generation %u (lost write)", header.ulGeneration);
+        return false;
+    }
+
+    return true;
+}
+
+void DataVerifier::_Report(UINT64 ullOffset, UINT64 ullEntry, const char *pszFormat, ...)
+{
+    LONG64 cErrors = InterlockedIncrement64(&_cErrors);
+    if (cErrors > static_cast<LONG64>(MaxReportedErrors))
+    {
+        return;
+    }
+
+    char szReason[128];
+    va_list args;
+    va_start(args, pszFormat);
+    vsprintf_s(szReason, _countof(szReason), pszFormat, args);
+    va_end(args);
+
+    UINT32 ulFloor = entryGeneration(ullEntry, FloorShift);
+    UINT32 ulLast = (entryGeneration(ullEntry, NextShift) - 1) & GenerationMask;
+    char szExpected[32];
+    if (ulFloor == ulLast)
+    {
+        sprintf_s(szExpected, _countof(szExpected), "%u", ulLast);
+    }
+    else
+    {
+        sprintf_s(szExpected, _countof(szExpected), "%u-%u", ulFloor, ulLast);
+    }
+
+    fprintf(stderr, "ERROR: data verification failed on target %u '%s' at offset %llu, expected generation %s: %s\n",
+        _ulTarget, _sPath.c_str(), ullOffset, szExpected, szReason);
+
+    if (cErrors == static_cast<LONG64>(MaxReportedErrors))
+    {
+        fprintf(stderr, "ERROR: further verification failures on target '%s' are counted but not reported\n", _sPath.c_str());
+    }
+}
@@ -0,0 +1,135 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include "Platform.h"
+#include <mutex>
+#include <string>
+
+//
+// CRC32C (Castagnoli), as used by iSCSI and ext4. With SSE 4.2 the crc32 instruction is run
+// over three stripes of the data at once and the stripes are combined, as the instruction's
+// latency is three times its throughput; elsewhere the CRC is computed 8 bytes at a time
+// from tables (slicing-by-8). Compute chains: the CRC of A then B is Compute(B, Compute(A)).
+//
+
+class Crc32c
+{
+public:
+    static UINT32 Compute(const void *pData, size_t cb, UINT32 ulCrc = 0);
+    static UINT32 ComputeSoftware(const void *pData, size_t cb, UINT32 ulCrc = 0);
+    static bool IsHardwareSupported();
+};
+
+//
+// Header of each verify unit of the data written to a target under verification (-Zv).
+// The checksum covers the unit from the field following it to the end of the unit.
+//
+
+struct VerifyHeader
+{
+    UINT32 ulChecksum;
+    UINT32 ulMagic;
+    UINT64 ullOffset;       // offset of the unit in the target
+    UINT32 ulTarget;        // index of the target in the timespan
+    UINT32 ulGeneration;    // count of the writes to the unit issued before this one (16 bits)
+    UINT32 ulSeed;          // identifies the run the unit was written by
+    UINT32 ulReserved;
+};
+
+C_ASSERT(sizeof(VerifyHeader) == 32);
+
+//
+// End-to-end verification of the data written to a target (-Zv). Every write stamps each unit
+// it covers with a VerifyHeader and every read checks them, so that lost, misdirected and
+// corrupt writes are found while the target is under load.
+//
+// Whether the content a read finds is what it should be depends on the writes to the unit
+// before it, whichever threads issued them. A generation map shared by the target's threads
+// holds a 64 bit entry per unit, updated by compare-exchange:
+//
+//   next:      the generation of the next write issued to the unit
+//   first:     the generation of the first write of the current busy period - the writes
+//              which overlapped each other in flight, as storage may complete them in any order
+//   floor:     the first generation of the last busy period to complete; the unit holds one of
+//              the generations [floor, next) once no write to it is in flight
+//   in flight: the count of writes issued to the unit and not yet completed
+//   written:   whether a busy period has completed, so that the unit is known to have a header
+//
+// A read checks the units which had a completed write and none in flight at its issue and
+// which had no write issued while it was in flight; the rest may hold any mix of old and
+// new data. Generations are 16 bits, so a write is missed as lost if it is lost for a
+// multiple of 65536 writes to its unit.
+//
+
+class DataVerifier
+{
+public:
+    DataVerifier(const std::string& sPath, UINT32 ulTarget, UINT32 cbUnit, UINT32 ulSeed);
+    ~DataVerifier();
+
+    static const UINT32 DefaultUnitSize = 4 * 1024;
+    static const UINT32 MinUnitSize = 512;
+    static const UINT32 Magic = 0x56505344;    // DSPV
+    static const UINT64 MaxReportedErrors = 16;
+
+    UINT32 GetUnitSize() const { return _cbUnit; }
+
+    // sizes the generation map to the target; each thread attaches once it has opened the target
+    bool Attach(UINT64 cbTarget);
+
+    // a write stamps the units of its buffer before it is issued; offset and size are multiples of the unit
+    void BeginWrite(BYTE *pBuffer, UINT64 ullOffset, DWORD cb);
+    void EndWrite(UINT64 ullOffset, DWORD cb);
+
+    // a read takes the entries of its units as of its issue into pullSnapshot (one per unit), and
+    // on completion checks the units it can; returns the count which failed, reporting the first
+    // few, and adds the count checked to *pcChecked
+    void BeginRead(UINT64 ullOffset, DWORD cb, UINT64 *pullSnapshot) const;
+    UINT32 EndRead(const BYTE *pBuffer, UINT64 ullOffset, DWORD cb, const UINT64 *pullSnapshot, UINT64 *pcChecked);
+
+private:
+    DataVerifier(const DataVerifier&) = delete;
+    DataVerifier& operator=(const DataVerifier&) = delete;
+
+    bool _CheckUnit(const BYTE *pUnit, UINT64 ullOffset, UINT64 ullEntry);
+    void _Report(UINT64 ullOffset, UINT64 ullEntry, const char *pszFormat, ...);
+
+    const std::string _sPath;
+    const UINT32 _ulTarget;
+    const UINT32 _cbUnit;
+    const UINT32 _ulSeed;
+
+    std::mutex _lock;               // serializes Attach
+    volatile LONG64 *_pllMap;       // generation map entries, one per unit
+    size_t _cUnits;
+    volatile LONG64 _cErrors;       // reported up to MaxReportedErrors
+};
@@ -29,12 +29,18 @@ SOFTWARE.
 
 #pragma once
 
-#include <map>
-#include <unordered_map>
+#include <vector>
 #include <string>
 #include <sstream>
 #include <limits>
 #include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // Plain min/max macros from common headers will interfere with std::numeric_limits
 
@@ -43,74 +49,290 @@ SOFTWARE.
 #undef min
 #undef max
 
+//
+// Log-linear (HDR-style) histogram.
+//
+// Values are counted in a fixed layout of buckets: each power of two range is split into the same
+// number of linear sub-buckets, chosen so that any value is represented to the requested number of
+// significant decimal digits. Recording is an index computation and an increment; merging and
+// percentile queries walk the buckets, independent of how many distinct values were seen.
+//
+// Integral values are recorded as-is (exactly, below 2 x 10^digits). Floating point values are
+// first scaled to FloatUnitsPerValue units, so microsecond latencies are tracked in nanoseconds.
+// Min, max, mean and standard deviation are tracked exactly alongside the buckets.
+//
+// The count array grows to the highest bucket recorded, so memory is bounded by the largest value.
+//
+
 template<typename T>
 class Histogram
 {
+public:
+
+    static const unsigned DefaultSignificantDigits = 3;
+    static const unsigned MaxSignificantDigits = 5;
+    static const unsigned FloatUnitsPerValue = 1000;
+
 private:
 
-    mutable std::unordered_map<T, unsigned> _data;
+    unsigned _significantDigits;
+    unsigned _subBucketHalfCountMagnitude;
+    uint64_t _subBucketHalfCount;
+    uint64_t _subBucketMask;
+
+    mutable std::vector<unsigned> _counts;
     mutable unsigned _samples;
 
-    mutable std::map<T, unsigned> _sdata;
-    mutable unsigned _ssamples;
+    mutable T _min;
+    mutable T _max;
+    mutable double _sum;
+    mutable double _sumSquares;
 
-    // Save most recent percentile/iterator/nth-distance query. If the next is strictly >= it allows
+    // Save most recent percentile/index/nth-distance query. If the next is strictly >= it allows
     // an efficient forward iteration through an ascending set of queries.
 
     mutable double _lastptile;
     mutable unsigned _lastptilen;
-    mutable decltype(_sdata.cbegin()) _lastptilepos;
+    mutable size_t _lastptileindex;
 
     // A histogram starts writable/unsealed and automatically seals after the first read operation.
     // Subsequent writes which add data restart from empty.
 
+    mutable bool _fSealed;
+
     void _SealData() const
     {
-        if (!_data.empty())
+        if (!_fSealed)
         {
-            _sdata.clear();
-
-            _sdata = std::map<T, unsigned>(_data.cbegin(), _data.cend());
-            _ssamples = _samples;
-
             // invalid ptile > 1; first ptile query will initialize
             _lastptile = 1.1;
+            _fSealed = true;
+        }
+    }
+
+    void _Unseal()
+    {
+        if (_fSealed)
+        {
+            Clear();
+        }
+    }
+
+    static uint64_t _ToUnits(T v, std::true_type /* floating point */)
+    {
+        return (v > 0) ? static_cast<uint64_t>(static_cast<double>(v) * FloatUnitsPerValue + 0.5) : 0;
+    }
+
+    static uint64_t _ToUnits(T v, std::false_type)
+    {
+        return (v > 0) ? static_cast<uint64_t>(v) : 0;
+    }
+
+    static T _FromUnits(uint64_t u, std::true_type /* floating point */)
+    {
+        return static_cast<T>(static_cast<double>(u) / FloatUnitsPerValue);
+    }
+
+    static T _FromUnits(uint64_t u, std::false_type)
+    {
+        return static_cast<T>(u);
+    }
+
+    static uint64_t _ToUnits(T v) { return _ToUnits(v, typename std::is_floating_point<T>::type()); }
+    static T _FromUnits(uint64_t u) { return _FromUnits(u, typename std::is_floating_point<T>::type()); }
+
+    static unsigned _HighestBit(uint64_t v)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, v);
+        return index;
+#else
+        return 63 - __builtin_clzll(v);
+#endif
+    }
+
+    size_t _CountsIndex(uint64_t u) const
+    {
+        // power of two range above the linear first range, then the sub-bucket within it
+        const unsigned bucketIndex = _HighestBit(u | _subBucketMask) - _subBucketHalfCountMagnitude;
+        const uint64_t subBucketIndex = u >> bucketIndex;
+
+        return static_cast<size_t>((static_cast<uint64_t>(bucketIndex) << _subBucketHalfCountMagnitude) + subBucketIndex);
+    }
+
+    uint64_t _LowestEquivalentUnits(size_t index) const
+    {
+        unsigned bucketIndex = static_cast<unsigned>(index >> _subBucketHalfCountMagnitude);
+        uint64_t subBucketIndex = (index & (_subBucketHalfCount - 1)) + _subBucketHalfCount;
+
+        if (bucketIndex == 0)
+        {
+            subBucketIndex -= _subBucketHalfCount;
+        }
+        else
+        {
+            bucketIndex--;
+        }
+
+        return subBucketIndex << bucketIndex;
+    }
 
-            _data.clear();
-            _samples = 0;
+    uint64_t _HighestEquivalentUnits(size_t index) const
+    {
+        const unsigned bucketIndex = static_cast<unsigned>(index >> _subBucketHalfCountMagnitude);
+        const uint64_t width = (bucketIndex == 0) ? 1 : (static_cast<uint64_t>(1) << (bucketIndex - 1));
+
+        return _LowestEquivalentUnits(index) + width - 1;
+    }
+
+    // value reported for a bucket: its highest equivalent value, within the observed range
+    T _BucketValue(size_t index) const
+    {
+        const uint64_t u = _HighestEquivalentUnits(index);
+
+        if (u >= _ToUnits(_max))
+        {
+            return _max;
         }
+        if (u <= _ToUnits(_min))
+        {
+            return _min;
+        }
+        return _FromUnits(u);
     }
 
 public:
 
-    Histogram()
-        : _samples(0),
-        _ssamples(0)
-    {}
+    explicit Histogram(unsigned significantDigits = DefaultSignificantDigits)
+        : _significantDigits(significantDigits),
+        _samples(0),
+        _min(0),
+        _max(0),
+        _sum(0),
+        _sumSquares(0),
+        _lastptile(1.1),
+        _lastptilen(0),
+        _lastptileindex(0),
+        _fSealed(false)
+    {
+        SetSignificantDigits(significantDigits);
+    }
+
+    // Changes the precision of the histogram, which discards its data.
+    void SetSignificantDigits(unsigned significantDigits)
+    {
+        if ((significantDigits < 1) || (significantDigits > MaxSignificantDigits))
+        {
+            throw std::invalid_argument("Histogram significant digits must be >= 1 and <= 5");
+        }
+
+        // smallest power of two sub-bucket count which resolves 2 x 10^digits distinct values
+        uint64_t largestSingleUnitResolution = 2;
+        for (unsigned i = 0; i < significantDigits; i++)
+        {
+            largestSingleUnitResolution *= 10;
+        }
+
+        unsigned subBucketCountMagnitude = 0;
+        while ((static_cast<uint64_t>(1) << subBucketCountMagnitude) < largestSingleUnitResolution)
+        {
+            subBucketCountMagnitude++;
+        }
+
+        _significantDigits = significantDigits;
+        _subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+        _subBucketHalfCount = static_cast<uint64_t>(1) << _subBucketHalfCountMagnitude;
+        _subBucketMask = (static_cast<uint64_t>(1) << subBucketCountMagnitude) - 1;
+
+        Clear();
+    }
 
     void Clear()
     {
-        _data.clear();
+        _counts.clear();
         _samples = 0;
 
-        _sdata.clear();
-        _ssamples = 0;
+        _min = 0;
+        _max = 0;
+        _sum = 0;
+        _sumSquares = 0;
+
+        _fSealed = false;
+    }
 
+    unsigned GetSignificantDigits() const
+    {
+        return _significantDigits;
     }
 
     void Add(T v)
     {
-        _data[v]++;
+        _Unseal();
+
+        const size_t index = _CountsIndex(_ToUnits(v));
+        if (index >= _counts.size())
+        {
+            // grow a whole power of two range at a time
+            _counts.resize((index | (_subBucketHalfCount - 1)) + 1, 0);
+        }
+        _counts[index]++;
+
+        if (_samples == 0 || v < _min)
+        {
+            _min = v;
+        }
+        if (_samples == 0 || v > _max)
+        {
+            _max = v;
+        }
+
+        const double d = static_cast<double>(v);
+        _sum += d;
+        _sumSquares += d * d;
         _samples++;
     }
 
+    // An empty histogram takes the precision of the one merged into it, so that totals can be
+    // accumulated from default constructed histograms.
     void Merge(const Histogram<T> &other)
     {
-        for (auto i : other._data)
+        if (other._significantDigits != _significantDigits)
+        {
+            if (_samples || !_counts.empty())
+            {
+                throw std::invalid_argument("Cannot merge histograms of different precision");
+            }
+            SetSignificantDigits(other._significantDigits);
+        }
+
+        if (!other._samples)
+        {
+            return;
+        }
+
+        _Unseal();
+
+        if (other._counts.size() > _counts.size())
         {
-            _data[ i.first ] += i.second;
+            _counts.resize(other._counts.size(), 0);
+        }
+        for (size_t i = 0; i < other._counts.size(); i++)
+        {
+            _counts[i] += other._counts[i];
+        }
+
+        if (_samples == 0 || other._min < _min)
+        {
+            _min = other._min;
+        }
+        if (_samples == 0 || other._max > _max)
+        {
+            _max = other._max;
         }
 
+        _sum += other._sum;
+        _sumSquares += other._sumSquares;
         _samples += other._samples;
     }
 
@@ -119,12 +341,12 @@ public:
         _SealData();
 
         // Default low if empty
-        if (!_ssamples)
+        if (!_samples)
         {
             return std::numeric_limits<T>::min();
         }
 
-        return _sdata.cbegin()->first;
+        return _min;
     }
 
     T GetMax() const
@@ -132,22 +354,32 @@ public:
         _SealData();
 
         // Default low if empty
-        if (!_ssamples)
+        if (!_samples)
         {
             return std::numeric_limits<T>::min();
         }
 
-        return _sdata.crbegin()->first;
+        return _max;
     }
 
     unsigned GetSampleBuckets() const
     {
-        return (unsigned) (_samples ? _data.size() : _sdata.size());
+        unsigned buckets = 0;
+
+        for (const auto c : _counts)
+        {
+            if (c)
+            {
+                buckets++;
+            }
+        }
+
+        return buckets;
     }
 
     unsigned GetSampleSize() const
     {
-        return _samples ? _samples : _ssamples;
+        return _samples;
     }
 
     T GetPercentile(double p) const
@@ -160,39 +392,43 @@ public:
         _SealData();
 
         // Default low if empty
-        if (!_ssamples)
+        if (!_samples)
         {
             return std::numeric_limits<T>::min();
         }
 
-        const double target = p * _ssamples;
+        if (p == 0.0)
+        {
+            return _min;
+        }
+
+        const double target = p * _samples;
 
         // Default to beginning; n is the number of samples iterated over so far
         unsigned n = 0;
-        auto pos = _sdata.cbegin();
+        size_t index = 0;
 
         // Resume from last?
         if (p >= _lastptile)
         {
             n = _lastptilen;
-            pos = _lastptilepos;
+            index = _lastptileindex;
         }
 
-        while (pos != _sdata.cend())
+        for (; index < _counts.size(); index++)
         {
-            if (n + pos->second >= target)
+            if (_counts[index] && (n + _counts[index] >= target))
             {
                 // Save position. Note the pre-incremented distance through the histogram
                 // must be saved in case next is still in the same bucket.
                 _lastptile = p;
                 _lastptilen = n;
-                _lastptilepos = pos;
+                _lastptileindex = index;
 
-                return pos->first;
+                return _BucketValue(index);
             }
 
-            n += pos->second;
-            ++pos;
+            n += _counts[index];
         }
 
         throw std::overflow_error("overran end trying to find percentile");
@@ -216,42 +452,28 @@ public:
         _SealData();
 
         // Default low if empty
-        if (!_ssamples)
+        if (!_samples)
         {
             return std::numeric_limits<T>::min();
         }
 
-        double sum(0);
-
-        for (const auto i : _sdata)
-        {
-            double bucket_val =
-                static_cast<double>(i.first) * i.second / _ssamples;
-
-            if (sum + bucket_val < 0)
-            {
-                throw std::overflow_error("while trying to accumulate sum");
-            }
-
-            sum += bucket_val;
-        }
-
-        return sum;
+        return _sum / _samples;
     }
 
     double GetStandardDeviation() const
     {
-        double mean(GetMean());
-        double ssd(0);
+        _SealData();
 
-        for (const auto i : _sdata)
+        if (!_samples)
         {
-            double dev = static_cast<double>(i.first) - mean;
-            double sqdev = dev * dev;
-            ssd += i.second * sqdev;
+            return 0;
         }
 
-        return sqrt(ssd / _ssamples);
+        const double mean = _sum / _samples;
+        const double variance = (_sumSquares / _samples) - (mean * mean);
+
+        // rounding can leave a tiny negative variance for constant samples
+        return (variance > 0) ? sqrt(variance) : 0;
     }
 
     std::string GetHistogramCsv(const unsigned bins) const
@@ -273,7 +495,7 @@ public:
         std::ostringstream os;
         os.precision(std::numeric_limits<T>::digits10);
 
-        auto pos = _sdata.cbegin();
+        size_t index = 0;
         unsigned cumulative = 0;
 
         for (unsigned bin = 1; bin <= bins; ++bin)
@@ -281,11 +503,11 @@ public:
             unsigned count = 0;
             limit += binSize;
 
-            while (pos != _sdata.end() &&
-                (pos->first < limit || bin == bins))
+            while (index < _counts.size() &&
+                (!_counts[index] || _BucketValue(index) < limit || bin == bins))
             {
-                count += pos->second;
-                ++pos;
+                count += _counts[index];
+                ++index;
             }
 
             cumulative += count;
@@ -303,9 +525,12 @@ public:
         std::ostringstream os;
         os.precision(std::numeric_limits<T>::digits10);
 
-        for (const auto i : _sdata)
+        for (size_t i = 0; i < _counts.size(); i++)
         {
-            os << i.first << "," << i.second << std::endl;
+            if (_counts[i])
+            {
+                os << _BucketValue(i) << "," << _counts[i] << std::endl;
+            }
         }
 
         return os.str();
@@ -317,9 +542,12 @@ public:
 
         std::ostringstream os;
 
-        for (const auto i : _sdata)
+        for (size_t i = 0; i < _counts.size(); i++)
         {
-            os << i.second << " " << i.first << std::endl;
+            if (_counts[i])
+            {
+                os << _counts[i] << " " << _BucketValue(i) << std::endl;
+            }
         }
 
         return os.str();
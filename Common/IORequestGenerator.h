@@ -28,9 +28,12 @@ SOFTWARE.
 */
 
 #pragma once
+#ifndef __linux__
 #define INITGUID        //Include this #define to use SystemTraceControlGuid in Evntrace.h.
 #include <Evntrace.h>   //ETW
 #include <Winternl.h>   //ntdll.dll
+#endif
+#include <memory>
 
 
 void PrintError(const char *format, ...);
@@ -57,13 +60,16 @@ private:
         string sPath;
         UINT64 ullFileSize;
         bool fZeroWriteBuffers;
+        DWORD dwFileSetCount;       // files in the directory at sPath (-m); 0 if sPath is a file
     };
 
     bool _GenerateRequestsForTimeSpan(const Profile& profile, const TimeSpan& timeSpan, Results& results, struct Synchronization *pSynch);
+    bool _SearchLatencySlo(const Profile& profile, const TimeSpan& timeSpan, TimeSpan& kneeTimeSpan, Results& kneeResults, struct Synchronization *pSynch);
     void _AbortWorkerThreads(HANDLE hStartEvent, vector<HANDLE>& vhThreads) const;
     void _CloseOpenFiles(vector<HANDLE>& vhFiles) const;
     DWORD _CreateDirectoryPath(const char *path) const;
     bool _CreateFile(UINT64 ullFileSize, const char *pszFilename, bool fZeroBuffers, bool fVerbose) const;
+    bool _CreateFileSet(UINT64 ullFileSize, const char *pszDirectory, DWORD dwFileCount, bool fZeroBuffers, bool fVerbose) const;
     bool _GetActiveGroupsAndProcs() const;
     struct ETWSessionInfo _GetResultETWSession(const EVENT_TRACE_PROPERTIES *pTraceProperties) const;
     bool _GetSystemPerfInfo(vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION>& vSPPI, bool fVerbose) const;
@@ -78,5 +84,8 @@ private:
 
     HINSTANCE volatile _hNTDLL;     //handle to ntdll.dll
 
+    // files and buffers each thread leaves for the same thread in the next timespan
+    vector<unique_ptr<ThreadResourcePool>> _vpThreadResourcePools;
+
     friend class UnitTests::IORequestGeneratorUnitTests;
 };
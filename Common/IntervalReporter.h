@@ -0,0 +1,98 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+#include "Common.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+//
+// IntervalReporter reports the IO completed in each interval of the measured run (-U) while the
+// run is in progress: IOPS and throughput for reads, writes and in total, and latency percentiles
+// if latency is measured. At each interval it sums the statistics every thread last published
+// (see ThreadStatistics) and reports the difference from the previous sum, so the IO threads are
+// never paused or locked. Reports go to stderr, as text or as JSON lines, so that they do not
+// interleave with the results on stdout.
+//
+
+class IntervalReporter
+{
+public:
+    IntervalReporter();
+    ~IntervalReporter();
+
+    // ullStartTime is the start of the measured interval, which the reports are relative to
+    void Start(const TimeSpan& timeSpan, const vector<ThreadResults>& vThreadResults, UINT64 ullStartTime);
+
+    // stops the periodic reports at the end of the measured interval
+    void Stop();
+
+    // reports the final, partial interval ending at ullEndTime, once the threads have exited and
+    // published the last of their statistics
+    void ReportFinal(UINT64 ullEndTime);
+
+    // latency (ns) at the given percentile of an interval's bucket counts
+    static UINT64 GetLatencyPercentile(const IntervalCounters::LatencyCounts& vLatencyCounts, UINT64 cLatencies, double lfPercentile);
+
+private:
+    IntervalReporter(const IntervalReporter&);
+    IntervalReporter& operator=(const IntervalReporter&);
+
+    struct Snapshot
+    {
+        UINT64 ullTime;
+        UINT64 ullReadIOCount;
+        UINT64 ullReadBytesCount;
+        UINT64 ullWriteIOCount;
+        UINT64 ullWriteBytesCount;
+        UINT64 ullFlushIOCount;
+        UINT64 ullTrimIOCount;
+        UINT64 ullMetadataIOCount;
+        IntervalCounters::LatencyCounts vLatencyCounts;
+    };
+
+    void _TakeSnapshot(Snapshot& snapshot) const;
+    void _Report();
+    void _Run();
+
+    const vector<ThreadResults> *_pvThreadResults;
+    UINT64 _ullStartTime;
+    UINT64 _ullInterval;            // PerfTimer units
+    bool _fJson;
+    bool _fLatency;
+
+    Snapshot _last;
+    Snapshot _current;
+
+    thread _reporter;
+    mutex _lock;
+    condition_variable _cvStop;
+    bool _fStopping;
+};
@@ -29,6 +29,7 @@ SOFTWARE.
 
 #include "IoBucketizer.h"
 #include <stdexcept>
+#include <cmath>
 
 /*
 Calculating stddev using an online algorithm:
@@ -30,6 +30,7 @@ SOFTWARE.
 #pragma once
 
 #include <vector>
+#include "Platform.h"
 
 class IoBucketizer 
 {
@@ -0,0 +1,147 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+#include "Platform.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+//
+// IoTraceWriter captures a record of every IO completed during the measured interval (-Lt) to a
+// binary file for offline analysis. Each thread appends to its own single-producer ring, so the
+// IO path takes no locks; a writer thread drains the rings to the file. If a ring is full when
+// an IO completes the record is dropped and counted rather than stalling the thread.
+//
+// The file is an IoTraceFileHeader followed by IoTraceRecords in the order they were drained,
+// which is completion order per thread but interleaved between threads. Times are in ticks of
+// the performance timer relative to the start of the measured interval; the header states the
+// timer frequency. An IO issued during warm up may have a negative issue time.
+//
+
+#pragma pack(push, 1)
+struct IoTraceFileHeader
+{
+    char szMagic[8];            // "DSPDIOTR"
+    UINT32 ulVersion;
+    UINT32 cbRecord;            // sizeof(IoTraceRecord)
+    UINT64 ullTimerFrequency;   // ticks per second
+    UINT32 cThreads;
+    UINT32 ulReserved;
+};
+
+struct IoTraceRecord
+{
+    INT64 llIssueTime;
+    INT64 llCompletionTime;
+    UINT64 ullOffset;
+    UINT32 ulLength;            // bytes transferred
+    UINT32 ulThread;
+    UINT32 ulTarget;            // index of the target within the thread, as in the per-thread results
+    UINT32 ulIoType;            // IOOperation
+};
+#pragma pack(pop)
+
+//
+// The head of a ring, advanced by the owning thread on every IO, and its tail, advanced by the
+// writer thread as it drains, are padded onto cache lines of their own so that neither side
+// invalidates the other's line.
+//
+
+class IoTraceRing
+{
+public:
+    explicit IoTraceRing(size_t cRecords);
+
+    static const size_t CacheLineSize = 64;
+
+    // Called only by the owning thread. Returns false and counts the record as dropped if the ring is full.
+    bool Push(const IoTraceRecord& record);
+
+    // Called only by the writer thread. Writes all published records to the file and adds them to cRecords.
+    bool Drain(FILE *pFile, UINT64& cRecords);
+
+    UINT64 GetDroppedCount() const { return _cDropped; }
+
+private:
+    IoTraceRing(const IoTraceRing&);
+    IoTraceRing& operator=(const IoTraceRing&);
+
+    std::vector<IoTraceRecord> _vRecords;
+    BYTE _abLeadingPad[CacheLineSize];
+
+    // owning thread
+    std::atomic<UINT64> _ullHead;   // next record to push
+    UINT64 _cDropped;
+    BYTE _abHeadPad[CacheLineSize];
+
+    // writer thread
+    std::atomic<UINT64> _ullTail;   // next record to drain
+    BYTE _abTailPad[CacheLineSize];
+};
+
+class IoTraceWriter
+{
+public:
+    IoTraceWriter();
+    ~IoTraceWriter();
+
+    bool Start(const std::string& sPath, UINT32 cThreads);
+    bool Stop();
+
+    IoTraceRing *GetRing(UINT32 ulThread) { return _vRings[ulThread].get(); }
+
+    UINT64 GetRecordCount() const { return _cRecords; }
+    UINT64 GetDroppedCount() const;
+
+    static const size_t RingRecords = 64 * 1024;    // records per thread
+    static const DWORD FlushIntervalMs = 10;
+
+private:
+    IoTraceWriter(const IoTraceWriter&);
+    IoTraceWriter& operator=(const IoTraceWriter&);
+
+    bool _DrainAll();
+    void _Write();
+
+    std::string _sPath;
+    FILE *_pFile;
+    std::vector<std::unique_ptr<IoTraceRing>> _vRings;
+    UINT64 _cRecords;
+    bool _fError;
+
+    std::thread _writer;
+    std::mutex _lock;
+    std::condition_variable _cvStop;
+    bool _fStopping;
+};
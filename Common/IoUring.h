@@ -0,0 +1,117 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+//
+// IoUring wraps a Linux io_uring submission/completion ring pair. The rings are set up
+// with the raw system calls so that no user mode library is needed at runtime.
+//
+// Submission queue entries are obtained with GetSqe() and are only made visible to the
+// kernel by Enter(), which submits everything prepared since the last call in one system
+// call. Completions are consumed directly from the shared ring: GetCqeCount()/GetCqe()
+// expose the completions available now and AdvanceCq() returns them to the kernel.
+//
+// With submission queue polling (SQPOLL), a kernel thread consumes submissions as they are
+// published and Enter() only makes a system call to wait for completions or to wake an idle
+// poller.
+//
+// Buffers and files may be registered with the ring once, after which the fixed-buffer
+// opcodes and IOSQE_FIXED_FILE refer to them by index. This avoids pinning the buffer
+// pages and looking up the file for every IO.
+//
+class IoUring
+{
+public:
+    IoUring(void);
+    ~IoUring(void);
+
+    bool Initialize(unsigned int cEntries, bool fSqPoll = false, int iSqPollCpu = -1);
+    void Close(void);
+    bool IsInitialized(void) const;
+    bool IsSqPoll(void) const;
+    int GetSqPollThreadId(void) const;
+
+    bool RegisterBuffers(const struct iovec *pIovecs, unsigned int cIovecs);
+    bool RegisterFiles(const int *pFds, unsigned int cFds);
+
+    struct io_uring_sqe * GetSqe(void);
+    bool PrepareTimeout(unsigned int ulMilliseconds);
+    unsigned int GetPendingCount(void) const;
+    int Enter(unsigned int cMinComplete);
+
+    unsigned int GetCqeCount(void) const;
+    const struct io_uring_cqe * GetCqe(unsigned int iCqe) const;
+    void AdvanceCq(unsigned int cCqes);
+
+    static bool IsSupported(void);
+    static bool GetThreadCpuTime(int tid, unsigned long long *pullTime);
+
+    // user_data value reserved for ring-internal requests such as throttle timeouts
+    static const __u64 ReservedUserData = 0;
+
+private:
+    int _fd;
+    unsigned int _cEntries;
+    bool _fSqPoll;
+    int _creatorTid;                // thread which set up the ring, names its SQPOLL thread
+
+    void *_pSqRing;
+    size_t _cbSqRing;
+    void *_pCqRing;
+    size_t _cbCqRing;
+    struct io_uring_sqe *_pSqes;
+    size_t _cbSqes;
+
+    __u32 *_pSqHead;
+    __u32 *_pSqTail;
+    __u32 *_pSqFlags;
+    __u32 _ulSqMask;
+    __u32 _ulSqTail;                // local tail, includes entries not yet published
+    unsigned int _cPending;         // entries prepared but not yet accepted by the kernel
+    __u32 _ulTimeoutSqTail;         // local tail past the last throttle timeout prepared
+
+    __u32 *_pCqHead;
+    __u32 *_pCqTail;
+    __u32 _ulCqMask;
+    struct io_uring_cqe *_pCqes;
+
+    // throttle timeout intervals, one per submission entry: the kernel reads an interval when it
+    // consumes the entry, which with SQPOLL may happen after the next timeout is prepared
+    struct __kernel_timespec *_pTimeouts;
+};
+
+#endif
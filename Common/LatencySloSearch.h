@@ -0,0 +1,86 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+#include "Common.h"
+
+//
+// LatencySloSearch drives a latency SLO search (-K): it chooses the outstanding IO count (-o) of
+// each run of the timespan and finds the knee of the resulting IOPS/latency curve, the run with
+// the most IOPS whose latency at the SLO percentile is within the bound.
+//
+// Outstanding IO counts double from 1 until a run misses the SLO, the IOPS stop growing or the
+// maximum count is reached. Once a run has missed the SLO, the count is bisected between the
+// largest count which met it and the smallest which did not, until they are within an eighth of
+// each other.
+//
+
+class LatencySloSearch
+{
+public:
+    struct Step
+    {
+        DWORD dwRequestCount;
+        double lfIops;
+        double lfBytesPerSecond;
+        double lfMedianMilliseconds;
+        double lfLatencyMilliseconds;       // at the SLO percentile
+        bool fMetSlo;
+    };
+
+    LatencySloSearch(double lfMilliseconds, DWORD dwMaxRequestCount);
+
+    // doubling stops once a run adds less than this to the IOPS of the previous one
+    static constexpr double SaturationGain = 1.02;
+
+    // outstanding IO count of the next run; 0 once the search is done
+    DWORD GetNextRequestCount() const { return _dwNextRequestCount; }
+
+    // records the run at the outstanding IO count GetNextRequestCount returned
+    void AddStep(const Step& step);
+
+    const vector<Step>& GetSteps() const { return _vSteps; }
+
+    // index of the step at the knee; -1 if no run met the SLO
+    int GetKnee() const;
+
+    // IOPS, throughput and latencies of a run; the outstanding IO count and the verdict are left
+    // to the caller and AddStep
+    static Step Measure(const Results& results, double lfPercentile);
+
+private:
+    double _lfMilliseconds;
+    DWORD _dwMaxRequestCount;
+
+    DWORD _dwNextRequestCount;
+    DWORD _dwMetRequestCount;           // largest count which met the SLO; 0 if none
+    DWORD _dwMissedRequestCount;        // smallest count which missed the SLO; 0 if none
+
+    vector<Step> _vSteps;
+};
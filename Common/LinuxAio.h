@@ -0,0 +1,78 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#ifdef __linux__
+
+#include <linux/aio_abi.h>
+#include <stddef.h>
+
+//
+// LinuxAio wraps a Linux native AIO context (io_setup/io_submit/io_getevents). The system
+// calls are made directly so that libaio is not needed at runtime.
+//
+// Each request owns a control block, obtained with GetIocb() by the request's index. Prepared
+// control blocks are queued and submitted together by Submit(). GetEvents() reaps completions
+// in a batch once a minimum number are available, or the timeout expires.
+//
+// Note that the kernel only completes IO asynchronously for files opened with O_DIRECT;
+// buffered IO completes during submission.
+//
+class LinuxAio
+{
+public:
+    LinuxAio(void);
+    ~LinuxAio(void);
+
+    bool Initialize(unsigned int cRequests);
+    void Close(void);
+    bool IsInitialized(void) const;
+
+    struct iocb * GetIocb(unsigned int iRequest);
+    unsigned int GetPendingCount(void) const;
+    int Submit(void);
+
+    int GetEvents(unsigned int cMinEvents, unsigned int ulTimeoutMilliseconds);
+    const struct io_event * GetEvent(unsigned int iEvent) const;
+
+    // timeout for GetEvents which waits until cMinEvents are available
+    static const unsigned int Infinite = 0xffffffff;
+
+private:
+    aio_context_t _ctx;
+    unsigned int _cRequests;
+
+    struct iocb *_pIocbs;           // one control block per request
+    struct iocb **_ppPending;       // prepared control blocks not yet accepted by the kernel
+    unsigned int _cPending;
+    struct io_event *_pEvents;      // completions reaped by the last GetEvents
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "LoadPhase.h"
+#include <cmath>
+#include <assert.h>
+
+double LoadPhase::GetLevel(double lfMilliseconds) const
+{
+    const double lfPi = 3.14159265358979323846;
+    double lfPeriodFraction;
+
+    switch (_shape)
+    {
+        case PhaseShape::Ramp:
+        return _ulDurationInMilliseconds ? lfMilliseconds / _ulDurationInMilliseconds : 1;
+
+        case PhaseShape::Sine:
+        lfPeriodFraction = fmod(lfMilliseconds, _ulPeriodInMilliseconds) / _ulPeriodInMilliseconds;
+        return (1 - cos(2 * lfPi * lfPeriodFraction)) / 2;
+
+        case PhaseShape::Square:
+        lfPeriodFraction = fmod(lfMilliseconds, _ulPeriodInMilliseconds) / _ulPeriodInMilliseconds;
+        return (lfPeriodFraction * 100 >= 100 - _ulDutyPercent) ? 1 : 0;
+
+        default:
+        return 0;
+    }
+}
+
+const char *LoadPhase::ShapeToString(PhaseShape shape)
+{
+    switch (shape)
+    {
+        case PhaseShape::Ramp:
+        return "ramp";
+
+        case PhaseShape::Sine:
+        return "sine";
+
+        case PhaseShape::Square:
+        return "square";
+
+        default:
+        return "constant";
+    }
+}
+
+PhaseSchedule::PhaseSchedule(const std::vector<LoadPhase>& vPhases) :
+    _vPhases(vPhases),
+    _lfCycleMilliseconds(0)
+{
+    assert(_vPhases.size() > 0);
+
+    for (const auto& phase : _vPhases)
+    {
+        _lfCycleMilliseconds += phase.GetDurationInMilliseconds();
+    }
+    assert(_lfCycleMilliseconds > 0);
+}
+
+size_t PhaseSchedule::GetPhase(double lfMilliseconds, double *plfPhaseMilliseconds) const
+{
+    double lfRemaining = fmod(lfMilliseconds > 0 ? lfMilliseconds : 0, _lfCycleMilliseconds);
+    size_t iPhase = 0;
+
+    for (; iPhase < _vPhases.size() - 1; iPhase++)
+    {
+        if (lfRemaining < _vPhases[iPhase].GetDurationInMilliseconds())
+        {
+            break;
+        }
+
+        lfRemaining -= _vPhases[iPhase].GetDurationInMilliseconds();
+    }
+
+    if (plfPhaseMilliseconds != nullptr)
+    {
+        *plfPhaseMilliseconds = lfRemaining;
+    }
+
+    return iPhase;
+}
+
+void PhaseSchedule::GetState(double lfMilliseconds, PhaseState *pState) const
+{
+    double lfPhaseMilliseconds;
+    size_t iPhase = GetPhase(lfMilliseconds, &lfPhaseMilliseconds);
+    const LoadPhase& phase = _vPhases[iPhase];
+
+    pState->iPhase = iPhase;
+
+    // a rate ramping up from zero still issues an IO now and then
+    pState->lfIOPS = 0;
+    if (phase.GetIOPS().fSet)
+    {
+        pState->lfIOPS = phase.GetValue(phase.GetIOPS(), lfPhaseMilliseconds);
+        if (pState->lfIOPS < 1)
+        {
+            pState->lfIOPS = 1;
+        }
+    }
+
+    pState->fWriteRatio = phase.GetWriteRatio().fSet;
+    pState->ulWriteRatio = 0;
+    if (pState->fWriteRatio)
+    {
+        pState->ulWriteRatio = (UINT32)(phase.GetValue(phase.GetWriteRatio(), lfPhaseMilliseconds) + 0.5);
+    }
+
+    pState->ulQueueDepth = 0;
+    if (phase.GetQueueDepth().fSet)
+    {
+        pState->ulQueueDepth = (UINT32)(phase.GetValue(phase.GetQueueDepth(), lfPhaseMilliseconds) + 0.5);
+        if (pState->ulQueueDepth < 1)
+        {
+            pState->ulQueueDepth = 1;
+        }
+    }
+}
+
+std::vector<double> PhaseSchedule::GetPhaseMilliseconds(double lfMilliseconds) const
+{
+    std::vector<double> vlfMilliseconds(_vPhases.size(), 0);
+
+    // whole passes through the schedule, then the part of the last
+    double lfCycles = floor(lfMilliseconds / _lfCycleMilliseconds);
+    double lfRemaining = lfMilliseconds - lfCycles * _lfCycleMilliseconds;
+
+    for (size_t iPhase = 0; iPhase < _vPhases.size(); iPhase++)
+    {
+        double lfDuration = _vPhases[iPhase].GetDurationInMilliseconds();
+        double lfPartial = lfRemaining < lfDuration ? lfRemaining : lfDuration;
+
+        vlfMilliseconds[iPhase] = lfCycles * lfDuration + lfPartial;
+        lfRemaining -= lfPartial;
+    }
+
+    return vlfMilliseconds;
+}
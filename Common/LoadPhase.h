@@ -0,0 +1,180 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include <vector>
+#include "Platform.h"
+
+//
+// A load phase (-H) of a timespan. For the phase's duration each setting it states - the IOPS of
+// the whole run, the percentage of writes and the outstanding IOs per thread - moves between its
+// from and to values as the phase's shape gives:
+//
+//   Constant: the from value throughout
+//   Ramp:     linearly from the from value to the to value over the phase
+//   Sine:     from the from value to the to value and back again over each period
+//   Square:   the from value, then the to value for the last duty percent of each period
+//
+// A setting the phase does not state is left as the timespan and its targets have it.
+//
+
+enum class PhaseShape
+{
+    Constant,
+    Ramp,
+    Sine,
+    Square
+};
+
+struct PhaseSetting
+{
+    PhaseSetting() :
+        fSet(false),
+        ulFrom(0),
+        ulTo(0)
+    {
+    }
+
+    bool fSet;
+    UINT32 ulFrom;
+    UINT32 ulTo;
+};
+
+class LoadPhase
+{
+public:
+    LoadPhase() :
+        _ulDurationInMilliseconds(0),
+        _shape(PhaseShape::Constant),
+        _ulPeriodInMilliseconds(0),
+        _ulDutyPercent(DefaultDutyPercent)
+    {
+    }
+
+    static const UINT32 DefaultDutyPercent = 50;
+
+    void SetDurationInMilliseconds(UINT32 ulDuration) { _ulDurationInMilliseconds = ulDuration; }
+    UINT32 GetDurationInMilliseconds() const { return _ulDurationInMilliseconds; }
+
+    void SetShape(PhaseShape shape) { _shape = shape; }
+    PhaseShape GetShape() const { return _shape; }
+
+    // sine and square shapes repeat over the period
+    void SetPeriodInMilliseconds(UINT32 ulPeriod) { _ulPeriodInMilliseconds = ulPeriod; }
+    UINT32 GetPeriodInMilliseconds() const { return _ulPeriodInMilliseconds; }
+
+    // square: the part of each period at the to value
+    void SetDutyPercent(UINT32 ulDutyPercent) { _ulDutyPercent = ulDutyPercent; }
+    UINT32 GetDutyPercent() const { return _ulDutyPercent; }
+
+    void SetIOPS(UINT32 ulFrom, UINT32 ulTo) { _SetSetting(_iops, ulFrom, ulTo); }
+    const PhaseSetting& GetIOPS() const { return _iops; }
+
+    void SetWriteRatio(UINT32 ulFrom, UINT32 ulTo) { _SetSetting(_writeRatio, ulFrom, ulTo); }
+    const PhaseSetting& GetWriteRatio() const { return _writeRatio; }
+
+    void SetQueueDepth(UINT32 ulFrom, UINT32 ulTo) { _SetSetting(_queueDepth, ulFrom, ulTo); }
+    const PhaseSetting& GetQueueDepth() const { return _queueDepth; }
+
+    // where the shape is lfMilliseconds into the phase, from 0 (the from values) to 1 (the to values)
+    double GetLevel(double lfMilliseconds) const;
+
+    double GetValue(const PhaseSetting& setting, double lfMilliseconds) const
+    {
+        return setting.ulFrom + ((double)setting.ulTo - setting.ulFrom) * GetLevel(lfMilliseconds);
+    }
+
+    static const char *ShapeToString(PhaseShape shape);
+
+private:
+    static void _SetSetting(PhaseSetting& setting, UINT32 ulFrom, UINT32 ulTo)
+    {
+        setting.fSet = true;
+        setting.ulFrom = ulFrom;
+        setting.ulTo = ulTo;
+    }
+
+    UINT32 _ulDurationInMilliseconds;
+    PhaseShape _shape;
+    UINT32 _ulPeriodInMilliseconds;
+    UINT32 _ulDutyPercent;
+    PhaseSetting _iops;
+    PhaseSetting _writeRatio;
+    PhaseSetting _queueDepth;
+};
+
+//
+// The settings of a schedule of load phases at a point in time, as a thread applies them
+//
+
+struct PhaseState
+{
+    PhaseState() :
+        iPhase(0),
+        lfIOPS(0),
+        fWriteRatio(false),
+        ulWriteRatio(0),
+        ulQueueDepth(0)
+    {
+    }
+
+    size_t iPhase;
+    double lfIOPS;          // IOPS of the whole run; 0 if the phase does not limit it
+    bool fWriteRatio;       // true = the phase states the percentage of writes
+    UINT32 ulWriteRatio;
+    UINT32 ulQueueDepth;    // outstanding IOs per thread; 0 if the phase does not limit them
+};
+
+//
+// A timespan's load phases, one after another from the start of the measured interval. The
+// schedule repeats for as long as the measured interval lasts; warmup runs at its start.
+// Time is stated in milliseconds into the schedule.
+//
+
+class PhaseSchedule
+{
+public:
+    PhaseSchedule(const std::vector<LoadPhase>& vPhases);
+
+    size_t GetPhaseCount() const { return _vPhases.size(); }
+
+    // the phase lfMilliseconds into the schedule, and how far into the phase that is
+    size_t GetPhase(double lfMilliseconds, double *plfPhaseMilliseconds = nullptr) const;
+
+    void GetState(double lfMilliseconds, PhaseState *pState) const;
+
+    // the time spent in each phase over the first lfMilliseconds of the schedule
+    std::vector<double> GetPhaseMilliseconds(double lfMilliseconds) const;
+
+private:
+    std::vector<LoadPhase> _vPhases;
+    double _lfCycleMilliseconds;    // one pass through all the phases
+};
@@ -28,7 +28,7 @@ SOFTWARE.
 */
 
 #pragma once
-#include <Windows.h>
+#include "Platform.h"
 
 //
 // OverlappedQueue is a simple class that implements a queue for OVERLAPPED elements
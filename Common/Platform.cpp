@@ -0,0 +1,955 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Linux implementation of the Win32 subset declared in Platform.h
+
+#ifdef __linux__
+
+#include "Platform.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+
+//
+// Objects behind event and thread handles. Every live object is registered so CloseHandle
+// (and the waits) can tell them apart from file descriptors carried in a HANDLE.
+//
+
+class PlatformObject
+{
+public:
+    virtual ~PlatformObject() {}
+};
+
+class EventObject : public PlatformObject
+{
+public:
+    EventObject(int fd, bool fManualReset) : _fd(fd), _fManualReset(fManualReset) {}
+    ~EventObject() { close(_fd); }
+
+    int _fd;                    // eventfd; readable while the event is signaled
+    bool _fManualReset;
+};
+
+class ThreadObject : public PlatformObject
+{
+public:
+    explicit ThreadObject(pthread_t thread) : _thread(thread) {}
+
+    pthread_t _thread;
+};
+
+struct ThreadStart
+{
+    LPTHREAD_START_ROUTINE pfnStart;
+    LPVOID pParameter;
+};
+
+static std::mutex g_objectLock;
+static std::set<PlatformObject *> g_objects;
+
+static thread_local DWORD g_dwLastError = ERROR_SUCCESS;
+
+// pseudo handle returned by GetCurrentThread, as on Windows
+static const HANDLE CurrentThreadHandle = (HANDLE)(LONG_PTR)-2;
+
+static HANDLE _RegisterObject(PlatformObject *pObject)
+{
+    std::lock_guard<std::mutex> lock(g_objectLock);
+    g_objects.insert(pObject);
+    return (HANDLE)pObject;
+}
+
+template <typename T>
+static T * _LookupObject(HANDLE h)
+{
+    std::lock_guard<std::mutex> lock(g_objectLock);
+    auto i = g_objects.find((PlatformObject *)h);
+    return (i == g_objects.end()) ? nullptr : dynamic_cast<T *>(*i);
+}
+
+static int _HandleToFd(HANDLE h)
+{
+    return (int)(intptr_t)h;
+}
+
+static DWORD _ErrnoToError(int err)
+{
+    switch (err)
+    {
+    case 0:
+        return ERROR_SUCCESS;
+    case ENOENT:
+        return ERROR_FILE_NOT_FOUND;
+    case ENOTDIR:
+        return ERROR_PATH_NOT_FOUND;
+    case EACCES:
+    case EPERM:
+    case EROFS:
+        return ERROR_ACCESS_DENIED;
+    case EBADF:
+        return ERROR_INVALID_HANDLE;
+    case ENOMEM:
+        return ERROR_NOT_ENOUGH_MEMORY;
+    case EEXIST:
+        return ERROR_FILE_EXISTS;
+    case EINVAL:
+        return ERROR_INVALID_PARAMETER;
+    case ENOTSUP:
+    case ENOSYS:
+        return ERROR_NOT_SUPPORTED;
+    case ERANGE:
+    case ENAMETOOLONG:
+        return ERROR_INSUFFICIENT_BUFFER;
+    default:
+        return ERROR_GEN_FAILURE;
+    }
+}
+
+static void _SetLastErrorFromErrno()
+{
+    g_dwLastError = _ErrnoToError(errno);
+}
+
+DWORD GetLastError()
+{
+    return g_dwLastError;
+}
+
+void SetLastError(DWORD dwError)
+{
+    g_dwLastError = dwError;
+}
+
+BOOL CloseHandle(HANDLE h)
+{
+    PlatformObject *pObject = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(g_objectLock);
+        auto i = g_objects.find((PlatformObject *)h);
+        if (i != g_objects.end())
+        {
+            pObject = *i;
+            g_objects.erase(i);
+        }
+    }
+
+    if (pObject != nullptr)
+    {
+        // closing a thread handle does not affect the thread
+        ThreadObject *pThread = dynamic_cast<ThreadObject *>(pObject);
+        if (pThread != nullptr)
+        {
+            pthread_detach(pThread->_thread);
+        }
+        delete pObject;
+        return TRUE;
+    }
+
+    if (h == nullptr || h == INVALID_HANDLE_VALUE || h == CurrentThreadHandle)
+    {
+        g_dwLastError = ERROR_INVALID_HANDLE;
+        return FALSE;
+    }
+
+    if (close(_HandleToFd(h)) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//
+// Events
+//
+
+HANDLE CreateEvent(PVOID pSecurityAttributes, BOOL fManualReset, BOOL fInitialState, LPCSTR pszName)
+{
+    UNREFERENCED_PARAMETER(pSecurityAttributes);
+
+    if (pszName != nullptr && *pszName != '\0')
+    {
+        g_dwLastError = ERROR_NOT_SUPPORTED;
+        return nullptr;
+    }
+
+    int fd = eventfd(fInitialState ? 1 : 0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd < 0)
+    {
+        _SetLastErrorFromErrno();
+        return nullptr;
+    }
+
+    return _RegisterObject(new EventObject(fd, !!fManualReset));
+}
+
+HANDLE OpenEvent(DWORD dwDesiredAccess, BOOL fInheritHandle, LPCSTR pszName)
+{
+    UNREFERENCED_PARAMETER(dwDesiredAccess);
+    UNREFERENCED_PARAMETER(fInheritHandle);
+    UNREFERENCED_PARAMETER(pszName);
+
+    g_dwLastError = ERROR_NOT_SUPPORTED;
+    return nullptr;
+}
+
+BOOL SetEvent(HANDLE hEvent)
+{
+    EventObject *pEvent = _LookupObject<EventObject>(hEvent);
+    if (pEvent == nullptr)
+    {
+        g_dwLastError = ERROR_INVALID_HANDLE;
+        return FALSE;
+    }
+
+    uint64_t ullValue = 1;
+    if (write(pEvent->_fd, &ullValue, sizeof(ullValue)) != sizeof(ullValue) && errno != EAGAIN)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+BOOL ResetEvent(HANDLE hEvent)
+{
+    EventObject *pEvent = _LookupObject<EventObject>(hEvent);
+    if (pEvent == nullptr)
+    {
+        g_dwLastError = ERROR_INVALID_HANDLE;
+        return FALSE;
+    }
+
+    uint64_t ullValue;
+    if (read(pEvent->_fd, &ullValue, sizeof(ullValue)) < 0 && errno != EAGAIN)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+DWORD WaitForSingleObject(HANDLE h, DWORD dwMilliseconds)
+{
+    EventObject *pEvent = _LookupObject<EventObject>(h);
+    if (pEvent == nullptr)
+    {
+        // only events are waitable
+        g_dwLastError = ERROR_INVALID_HANDLE;
+        return WAIT_FAILED;
+    }
+
+    ULONGLONG ullDeadline = GetTickCount64() + dwMilliseconds;
+    for (;;)
+    {
+        int timeout = -1;
+        if (dwMilliseconds != INFINITE)
+        {
+            ULONGLONG ullNow = GetTickCount64();
+            timeout = (ullNow >= ullDeadline) ? 0 : (int)(ullDeadline - ullNow);
+        }
+
+        struct pollfd pfd = { pEvent->_fd, POLLIN, 0 };
+        int r = poll(&pfd, 1, timeout);
+        if (r < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            _SetLastErrorFromErrno();
+            return WAIT_FAILED;
+        }
+        if (r == 0)
+        {
+            return WAIT_TIMEOUT;
+        }
+        if (pEvent->_fManualReset)
+        {
+            return WAIT_OBJECT_0;
+        }
+
+        // auto-reset: only the waiter which consumes the signal is released
+        uint64_t ullValue;
+        if (read(pEvent->_fd, &ullValue, sizeof(ullValue)) == sizeof(ullValue))
+        {
+            return WAIT_OBJECT_0;
+        }
+        if (errno != EAGAIN)
+        {
+            _SetLastErrorFromErrno();
+            return WAIT_FAILED;
+        }
+    }
+}
+
+//
+// Threads
+//
+
+static void * _ThreadStart(void *pv)
+{
+    ThreadStart start = *(ThreadStart *)pv;
+    delete (ThreadStart *)pv;
+
+    return (void *)(uintptr_t)start.pfnStart(start.pParameter);
+}
+
+HANDLE CreateThread(PVOID pSecurityAttributes, SIZE_T cbStack, LPTHREAD_START_ROUTINE pfnStart, LPVOID pParameter, DWORD dwFlags, LPDWORD pdwThreadId)
+{
+    UNREFERENCED_PARAMETER(pSecurityAttributes);
+    UNREFERENCED_PARAMETER(dwFlags);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    // as on Windows the size is a minimum: never go below the default
+    size_t cbDefaultStack;
+    if (pthread_attr_getstacksize(&attr, &cbDefaultStack) == 0 && cbStack > cbDefaultStack)
+    {
+        pthread_attr_setstacksize(&attr, cbStack);
+    }
+
+    ThreadStart *pStart = new ThreadStart;
+    pStart->pfnStart = pfnStart;
+    pStart->pParameter = pParameter;
+
+    pthread_t thread;
+    int err = pthread_create(&thread, &attr, _ThreadStart, pStart);
+    pthread_attr_destroy(&attr);
+    if (err != 0)
+    {
+        delete pStart;
+        g_dwLastError = _ErrnoToError(err);
+        return nullptr;
+    }
+
+    if (pdwThreadId != nullptr)
+    {
+        *pdwThreadId = (DWORD)(uintptr_t)thread;
+    }
+    return _RegisterObject(new ThreadObject(thread));
+}
+
+HANDLE GetCurrentThread()
+{
+    return CurrentThreadHandle;
+}
+
+DWORD GetCurrentProcessId()
+{
+    return (DWORD)getpid();
+}
+
+static bool _GetThread(HANDLE hThread, pthread_t *pThread)
+{
+    if (hThread == CurrentThreadHandle)
+    {
+        *pThread = pthread_self();
+        return true;
+    }
+
+    ThreadObject *pObject = _LookupObject<ThreadObject>(hThread);
+    if (pObject == nullptr)
+    {
+        g_dwLastError = ERROR_INVALID_HANDLE;
+        return false;
+    }
+    *pThread = pObject->_thread;
+    return true;
+}
+
+BOOL TerminateThread(HANDLE hThread, DWORD dwExitCode)
+{
+    UNREFERENCED_PARAMETER(dwExitCode);
+
+    pthread_t thread;
+    if (!_GetThread(hThread, &thread))
+    {
+        return FALSE;
+    }
+
+    int err = pthread_cancel(thread);
+    if (err != 0)
+    {
+        g_dwLastError = _ErrnoToError(err);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// raising thread priority needs CAP_SYS_NICE on Linux; threads run at the default priority
+BOOL SetThreadPriority(HANDLE hThread, int nPriority)
+{
+    UNREFERENCED_PARAMETER(hThread);
+    UNREFERENCED_PARAMETER(nPriority);
+    return TRUE;
+}
+
+BOOL SetThreadGroupAffinity(HANDLE hThread, const GROUP_AFFINITY *pGroupAffinity, PGROUP_AFFINITY pPreviousGroupAffinity)
+{
+    pthread_t thread;
+    if (!_GetThread(hThread, &thread))
+    {
+        return FALSE;
+    }
+
+    if (pPreviousGroupAffinity != nullptr)
+    {
+        memset(pPreviousGroupAffinity, 0, sizeof(*pPreviousGroupAffinity));
+    }
+
+    // processor groups are laid over the Linux CPU numbering in runs of 64
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int i = 0; i < 64; i++)
+    {
+        if (pGroupAffinity->Mask & ((KAFFINITY)1 << i))
+        {
+            CPU_SET(pGroupAffinity->Group * 64 + i, &cpuset);
+        }
+    }
+
+    int err = pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
+    if (err != 0)
+    {
+        g_dwLastError = _ErrnoToError(err);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//
+// Ctrl-C is delivered as SIGINT. It is blocked in every thread (the mask is inherited by threads
+// created later) and picked up by a dedicated thread, so the handler runs in normal thread context
+// as console control handlers do on Windows.
+//
+
+static std::mutex g_ctrlLock;
+static PHANDLER_ROUTINE g_pfnCtrlHandler = nullptr;
+static bool g_fCtrlThreadStarted = false;
+
+static void * _CtrlThread(void *pv)
+{
+    sigset_t *pSigset = (sigset_t *)pv;
+
+    for (;;)
+    {
+        int sig;
+        if (sigwait(pSigset, &sig) != 0)
+        {
+            continue;
+        }
+
+        PHANDLER_ROUTINE pfnHandler;
+        {
+            std::lock_guard<std::mutex> lock(g_ctrlLock);
+            pfnHandler = g_pfnCtrlHandler;
+        }
+
+        if (pfnHandler == nullptr || !pfnHandler(CTRL_C_EVENT))
+        {
+            // unhandled: default action, which terminates the process
+            signal(SIGINT, SIG_DFL);
+            pthread_sigmask(SIG_UNBLOCK, pSigset, nullptr);
+            raise(SIGINT);
+        }
+    }
+    return nullptr;
+}
+
+BOOL SetConsoleCtrlHandler(PHANDLER_ROUTINE pfnHandler, BOOL fAdd)
+{
+    std::lock_guard<std::mutex> lock(g_ctrlLock);
+
+    if (!fAdd)
+    {
+        if (g_pfnCtrlHandler == pfnHandler)
+        {
+            g_pfnCtrlHandler = nullptr;
+        }
+        return TRUE;
+    }
+
+    if (!g_fCtrlThreadStarted)
+    {
+        static sigset_t sigset;
+        sigemptyset(&sigset);
+        sigaddset(&sigset, SIGINT);
+
+        int err = pthread_sigmask(SIG_BLOCK, &sigset, nullptr);
+        if (err == 0)
+        {
+            pthread_t thread;
+            err = pthread_create(&thread, nullptr, _CtrlThread, &sigset);
+            if (err == 0)
+            {
+                pthread_detach(thread);
+            }
+        }
+        if (err != 0)
+        {
+            g_dwLastError = _ErrnoToError(err);
+            return FALSE;
+        }
+        g_fCtrlThreadStarted = true;
+    }
+
+    g_pfnCtrlHandler = pfnHandler;
+    return TRUE;
+}
+
+//
+// Time
+//
+
+void Sleep(DWORD dwMilliseconds)
+{
+    struct timespec ts;
+    ts.tv_sec = dwMilliseconds / 1000;
+    ts.tv_nsec = (long)(dwMilliseconds % 1000) * 1000000;
+
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+    {
+    }
+}
+
+ULONGLONG GetTickCount64()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ULONGLONG)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// the performance counter ticks in nanoseconds
+BOOL QueryPerformanceCounter(LARGE_INTEGER *pCount)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    pCount->QuadPart = (LONGLONG)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER *pFrequency)
+{
+    pFrequency->QuadPart = 1000000000;
+    return TRUE;
+}
+
+static void _FillSystemTime(const struct tm *pTm, long lNanoseconds, LPSYSTEMTIME pSystemTime)
+{
+    pSystemTime->wYear = (WORD)(pTm->tm_year + 1900);
+    pSystemTime->wMonth = (WORD)(pTm->tm_mon + 1);
+    pSystemTime->wDayOfWeek = (WORD)pTm->tm_wday;
+    pSystemTime->wDay = (WORD)pTm->tm_mday;
+    pSystemTime->wHour = (WORD)pTm->tm_hour;
+    pSystemTime->wMinute = (WORD)pTm->tm_min;
+    pSystemTime->wSecond = (WORD)pTm->tm_sec;
+    pSystemTime->wMilliseconds = (WORD)(lNanoseconds / 1000000);
+}
+
+void GetSystemTime(LPSYSTEMTIME pSystemTime)
+{
+    struct timespec ts;
+    struct tm tm;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    gmtime_r(&ts.tv_sec, &tm);
+    _FillSystemTime(&tm, ts.tv_nsec, pSystemTime);
+}
+
+void GetLocalTime(LPSYSTEMTIME pSystemTime)
+{
+    struct timespec ts;
+    struct tm tm;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    localtime_r(&ts.tv_sec, &tm);
+    _FillSystemTime(&tm, ts.tv_nsec, pSystemTime);
+}
+
+//
+// Memory
+//
+// VirtualFree(MEM_RELEASE) is given no size, so the size of each mapping is remembered.
+//
+
+static std::mutex g_allocationLock;
+static std::map<PVOID, SIZE_T> g_allocations;
+
+PVOID VirtualAlloc(PVOID pAddress, SIZE_T cb, DWORD dwAllocationType, DWORD dwProtect)
+{
+    UNREFERENCED_PARAMETER(pAddress);
+
+    int prot = PROT_READ | PROT_WRITE;
+    if (dwProtect == PAGE_EXECUTE_READWRITE)
+    {
+        prot |= PROT_EXEC;
+    }
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (dwAllocationType & MEM_LARGE_PAGES)
+    {
+        flags |= MAP_HUGETLB;
+    }
+
+    PVOID p = mmap(nullptr, cb, prot, flags, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        _SetLastErrorFromErrno();
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(g_allocationLock);
+    g_allocations[p] = cb;
+    return p;
+}
+
+BOOL VirtualFree(PVOID pAddress, SIZE_T cb, DWORD dwFreeType)
+{
+    UNREFERENCED_PARAMETER(cb);
+    UNREFERENCED_PARAMETER(dwFreeType);
+
+    SIZE_T cbMapping;
+    {
+        std::lock_guard<std::mutex> lock(g_allocationLock);
+        auto i = g_allocations.find(pAddress);
+        if (i == g_allocations.end())
+        {
+            g_dwLastError = ERROR_INVALID_PARAMETER;
+            return FALSE;
+        }
+        cbMapping = i->second;
+        g_allocations.erase(i);
+    }
+
+    if (munmap(pAddress, cbMapping) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// default huge page size from /proc/meminfo; 0 if huge pages are not available
+SIZE_T GetLargePageMinimum()
+{
+    FILE *pFile = fopen("/proc/meminfo", "r");
+    if (pFile == nullptr)
+    {
+        return 0;
+    }
+
+    SIZE_T cb = 0;
+    char szLine[256];
+    while (fgets(szLine, sizeof(szLine), pFile) != nullptr)
+    {
+        unsigned long ulKb;
+        if (sscanf(szLine, "Hugepagesize: %lu kB", &ulKb) == 1)
+        {
+            cb = (SIZE_T)ulKb * 1024;
+            break;
+        }
+    }
+
+    fclose(pFile);
+    return cb;
+}
+
+//
+// Files
+//
+// Sharing modes have no equivalent and are ignored. Unbuffered IO maps to O_DIRECT and
+// write-through to O_DSYNC; the caching hints become posix_fadvise advice.
+//
+
+HANDLE CreateFile(LPCSTR pszPath, DWORD dwDesiredAccess, DWORD dwShareMode, PVOID pSecurityAttributes, DWORD dwCreationDisposition, DWORD dwFlagsAndAttributes, HANDLE hTemplateFile)
+{
+    UNREFERENCED_PARAMETER(dwShareMode);
+    UNREFERENCED_PARAMETER(pSecurityAttributes);
+    UNREFERENCED_PARAMETER(hTemplateFile);
+
+    int flags = O_CLOEXEC;
+
+    if ((dwDesiredAccess & GENERIC_READ) && (dwDesiredAccess & GENERIC_WRITE))
+    {
+        flags |= O_RDWR;
+    }
+    else if (dwDesiredAccess & GENERIC_WRITE)
+    {
+        flags |= O_WRONLY;
+    }
+    else
+    {
+        flags |= O_RDONLY;
+    }
+
+    switch (dwCreationDisposition)
+    {
+    case CREATE_NEW:
+        flags |= O_CREAT | O_EXCL;
+        break;
+    case CREATE_ALWAYS:
+        flags |= O_CREAT | O_TRUNC;
+        break;
+    case OPEN_ALWAYS:
+        flags |= O_CREAT;
+        break;
+    case TRUNCATE_EXISTING:
+        flags |= O_TRUNC;
+        break;
+    case OPEN_EXISTING:
+        break;
+    default:
+        g_dwLastError = ERROR_INVALID_PARAMETER;
+        return INVALID_HANDLE_VALUE;
+    }
+
+    if (dwFlagsAndAttributes & FILE_FLAG_NO_BUFFERING)
+    {
+        flags |= O_DIRECT;
+    }
+    if (dwFlagsAndAttributes & FILE_FLAG_WRITE_THROUGH)
+    {
+        flags |= O_DSYNC;
+    }
+
+    int fd = open(pszPath, flags, 0644);
+    if (fd < 0)
+    {
+        _SetLastErrorFromErrno();
+        return INVALID_HANDLE_VALUE;
+    }
+
+    if (dwFlagsAndAttributes & FILE_FLAG_RANDOM_ACCESS)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+    }
+    else if (dwFlagsAndAttributes & FILE_FLAG_SEQUENTIAL_SCAN)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    return (HANDLE)(intptr_t)fd;
+}
+
+// with an OVERLAPPED the transfer is positioned at its offset and completes synchronously
+BOOL ReadFile(HANDLE hFile, PVOID pBuffer, DWORD cbToRead, LPDWORD pcbRead, LPOVERLAPPED pOverlapped)
+{
+    ssize_t cb;
+    do
+    {
+        if (pOverlapped != nullptr)
+        {
+            off_t offset = (off_t)(((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset);
+            cb = pread(_HandleToFd(hFile), pBuffer, cbToRead, offset);
+        }
+        else
+        {
+            cb = read(_HandleToFd(hFile), pBuffer, cbToRead);
+        }
+    } while (cb < 0 && errno == EINTR);
+
+    if (cb < 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+
+    if (pcbRead != nullptr)
+    {
+        *pcbRead = (DWORD)cb;
+    }
+    if (pOverlapped != nullptr)
+    {
+        pOverlapped->Internal = 0;
+        pOverlapped->InternalHigh = (ULONG_PTR)cb;
+    }
+    return TRUE;
+}
+
+BOOL WriteFile(HANDLE hFile, const void *pBuffer, DWORD cbToWrite, LPDWORD pcbWritten, LPOVERLAPPED pOverlapped)
+{
+    ssize_t cb;
+    do
+    {
+        if (pOverlapped != nullptr)
+        {
+            off_t offset = (off_t)(((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset);
+            cb = pwrite(_HandleToFd(hFile), pBuffer, cbToWrite, offset);
+        }
+        else
+        {
+            cb = write(_HandleToFd(hFile), pBuffer, cbToWrite);
+        }
+    } while (cb < 0 && errno == EINTR);
+
+    if (cb < 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+
+    if (pcbWritten != nullptr)
+    {
+        *pcbWritten = (DWORD)cb;
+    }
+    if (pOverlapped != nullptr)
+    {
+        pOverlapped->Internal = 0;
+        pOverlapped->InternalHigh = (ULONG_PTR)cb;
+    }
+    return TRUE;
+}
+
+BOOL GetFileSizeEx(HANDLE hFile, PLARGE_INTEGER pFileSize)
+{
+    struct stat st;
+    if (fstat(_HandleToFd(hFile), &st) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+
+    pFileSize->QuadPart = st.st_size;
+    return TRUE;
+}
+
+DWORD GetFileSize(HANDLE hFile, LPDWORD pdwFileSizeHigh)
+{
+    LARGE_INTEGER li;
+    if (!GetFileSizeEx(hFile, &li))
+    {
+        return INVALID_FILE_SIZE;
+    }
+
+    if (pdwFileSizeHigh != nullptr)
+    {
+        *pdwFileSizeHigh = (DWORD)li.HighPart;
+    }
+    g_dwLastError = NO_ERROR;
+    return li.LowPart;
+}
+
+BOOL SetFilePointerEx(HANDLE hFile, LARGE_INTEGER liDistance, PLARGE_INTEGER pliNewPointer, DWORD dwMoveMethod)
+{
+    int whence = (dwMoveMethod == FILE_END) ? SEEK_END : (dwMoveMethod == FILE_CURRENT) ? SEEK_CUR : SEEK_SET;
+
+    off_t offset = lseek(_HandleToFd(hFile), (off_t)liDistance.QuadPart, whence);
+    if (offset < 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+
+    if (pliNewPointer != nullptr)
+    {
+        pliNewPointer->QuadPart = offset;
+    }
+    return TRUE;
+}
+
+BOOL SetEndOfFile(HANDLE hFile)
+{
+    int fd = _HandleToFd(hFile);
+
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0 || ftruncate(fd, offset) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+BOOL FlushFileBuffers(HANDLE hFile)
+{
+    if (fsync(_HandleToFd(hFile)) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+DWORD GetFileAttributes(LPCSTR pszPath)
+{
+    struct stat st;
+    if (stat(pszPath, &st) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return INVALID_FILE_ATTRIBUTES;
+    }
+
+    return S_ISDIR(st.st_mode) ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL;
+}
+
+BOOL CreateDirectory(LPCSTR pszPath, PVOID pSecurityAttributes)
+{
+    UNREFERENCED_PARAMETER(pSecurityAttributes);
+
+    if (mkdir(pszPath, 0755) != 0)
+    {
+        g_dwLastError = (errno == EEXIST) ? ERROR_ALREADY_EXISTS : _ErrnoToError(errno);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+BOOL DeleteFile(LPCSTR pszPath)
+{
+    if (unlink(pszPath) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+BOOL MoveFile(LPCSTR pszExistingPath, LPCSTR pszNewPath)
+{
+    if (rename(pszExistingPath, pszNewPath) != 0)
+    {
+        _SetLastErrorFromErrno();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+#endif
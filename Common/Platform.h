@@ -0,0 +1,406 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+//
+// Platform abstraction for the portable (non-Windows) build.
+//
+// On Windows this simply pulls in the SDK headers the engine is written against. Elsewhere
+// it supplies the subset of the Win32 types, constants and APIs the engine uses, implemented
+// over POSIX in Platform.cpp. Only what diskspd actually needs is provided; semantics follow
+// the Win32 documentation closely enough for the engine, not in general.
+//
+
+#ifndef __linux__
+
+#include <windows.h>
+#include <powersetting.h>
+#include <powrprof.h>
+#include <VersionHelpers.h>
+#include <TraceLoggingProvider.h>
+#include <TraceLoggingActivity.h>
+#include <evntrace.h>
+#include <Winternl.h>   //ntdll.dll
+
+#else
+
+#include <errno.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+//
+// Basic types
+//
+
+typedef uint8_t             BYTE, UINT8, UCHAR, BOOLEAN, *PUCHAR, *PBYTE;
+typedef char                CHAR, *PCHAR, *LPSTR;
+typedef const char          *LPCSTR;
+typedef wchar_t             WCHAR, *PWCHAR;
+typedef uint16_t            WORD, USHORT, UINT16;
+typedef int32_t             INT, INT32, LONG, BOOL;
+typedef uint32_t            DWORD, ULONG, UINT, UINT32, *PULONG, *LPDWORD, *PDWORD;
+typedef int64_t             INT64, LONGLONG, LONG64, *PLONG64;
+typedef unsigned long long  UINT64, ULONGLONG, DWORD64, ULONG64, *PUINT64;
+typedef uintptr_t           ULONG_PTR, DWORD_PTR, SIZE_T, KAFFINITY;
+typedef intptr_t            LONG_PTR;
+typedef void                VOID, *PVOID, *LPVOID, *HANDLE, *HINSTANCE, *HMODULE;
+typedef int32_t             NTSTATUS;
+typedef uint64_t            TRACEHANDLE;
+
+#define TRUE    1
+#define FALSE   0
+
+#define WINAPI
+#define CALLBACK
+#define __stdcall
+#define __cdecl
+#define UNALIGNED
+#define __int64                     long long
+
+#define C_ASSERT(e)                 static_assert(e, #e)
+#define CONTAINING_RECORD(address, type, field) \
+    ((type *)((PCHAR)(address) - offsetof(type, field)))
+#define UNREFERENCED_PARAMETER(p)   ((void)(p))
+#define __declspec(x)               __declspec_##x
+#define __declspec_align(n)         __attribute__((aligned(n)))
+
+#define MAXBYTE         0xff
+#define MAXWORD         0xffff
+#define MAXDWORD        0xffffffff
+#define MAXUINT32       ((UINT32)~((UINT32)0))
+#define MAXUINT64       ((UINT64)~((UINT64)0))
+#define MAX_PATH        260
+#define INFINITE        0xffffffff
+
+#define INVALID_HANDLE_VALUE        ((HANDLE)(LONG_PTR)-1)
+#define INVALID_FILE_SIZE           ((DWORD)0xffffffff)
+#define INVALID_FILE_ATTRIBUTES     ((DWORD)-1)
+
+typedef union _LARGE_INTEGER {
+    struct {
+        DWORD LowPart;
+        LONG HighPart;
+    };
+    LONGLONG QuadPart;
+} LARGE_INTEGER, *PLARGE_INTEGER;
+
+typedef union _ULARGE_INTEGER {
+    struct {
+        DWORD LowPart;
+        DWORD HighPart;
+    };
+    ULONGLONG QuadPart;
+} ULARGE_INTEGER, *PULARGE_INTEGER;
+
+typedef struct _GUID {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t  Data4[8];
+} GUID;
+
+typedef struct _OVERLAPPED {
+    ULONG_PTR Internal;
+    ULONG_PTR InternalHigh;
+    union {
+        struct {
+            DWORD Offset;
+            DWORD OffsetHigh;
+        };
+        PVOID Pointer;
+    };
+    HANDLE hEvent;
+} OVERLAPPED, *LPOVERLAPPED;
+
+typedef struct _GROUP_AFFINITY {
+    KAFFINITY Mask;
+    WORD Group;
+    WORD Reserved[3];
+} GROUP_AFFINITY, *PGROUP_AFFINITY;
+
+typedef struct _SYSTEMTIME {
+    WORD wYear;
+    WORD wMonth;
+    WORD wDayOfWeek;
+    WORD wDay;
+    WORD wHour;
+    WORD wMinute;
+    WORD wSecond;
+    WORD wMilliseconds;
+} SYSTEMTIME, *LPSYSTEMTIME;
+
+// processor times in 100ns units, as reported for Windows by NtQuerySystemInformation;
+// as there, KernelTime includes IdleTime
+typedef struct _SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION {
+    LARGE_INTEGER IdleTime;
+    LARGE_INTEGER KernelTime;
+    LARGE_INTEGER UserTime;
+    LARGE_INTEGER DpcTime;
+    LARGE_INTEGER InterruptTime;
+    ULONG InterruptCount;
+} SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION;
+
+typedef enum _PRIORITY_HINT {
+    IoPriorityHintVeryLow = 0,
+    IoPriorityHintLow,
+    IoPriorityHintNormal,
+    MaximumIoPriorityHintType
+} PRIORITY_HINT;
+
+typedef DWORD (WINAPI *LPTHREAD_START_ROUTINE)(LPVOID);
+typedef BOOL (WINAPI *PHANDLER_ROUTINE)(DWORD);
+
+//
+// Error codes (GetLastError maps errno onto the few the engine distinguishes)
+//
+
+#define ERROR_SUCCESS               0
+#define NO_ERROR                    0
+#define ERROR_FILE_NOT_FOUND        2
+#define ERROR_PATH_NOT_FOUND        3
+#define ERROR_ACCESS_DENIED         5
+#define ERROR_INVALID_HANDLE        6
+#define ERROR_NOT_ENOUGH_MEMORY     8
+#define ERROR_HANDLE_EOF            38
+#define ERROR_NOT_SUPPORTED         50
+#define ERROR_FILE_EXISTS           80
+#define ERROR_INVALID_PARAMETER     87
+#define ERROR_INSUFFICIENT_BUFFER   122
+#define ERROR_BUSY                  170
+#define ERROR_ALREADY_EXISTS        183
+#define ERROR_IO_PENDING            997
+#define ERROR_GEN_FAILURE           31
+#define ERROR_BUFFER_OVERFLOW       111
+
+#define NT_SUCCESS(status)          (((NTSTATUS)(status)) >= 0)
+
+#define WAIT_OBJECT_0               0
+#define WAIT_ABANDONED              0x80
+#define WAIT_IO_COMPLETION          0xc0
+#define WAIT_TIMEOUT                258
+#define WAIT_FAILED                 ((DWORD)0xffffffff)
+
+#define THREAD_PRIORITY_NORMAL      0
+#define THREAD_PRIORITY_HIGHEST     2
+
+#define CTRL_C_EVENT                0
+
+#define EVENT_MODIFY_STATE          0x0002
+
+//
+// File access, share, disposition and flag values accepted by CreateFile
+//
+
+#define GENERIC_READ                0x80000000
+#define GENERIC_WRITE               0x40000000
+#define FILE_SHARE_READ             0x00000001
+#define FILE_SHARE_WRITE            0x00000002
+#define FILE_SHARE_DELETE           0x00000004
+
+#define CREATE_NEW                  1
+#define CREATE_ALWAYS               2
+#define OPEN_EXISTING               3
+#define OPEN_ALWAYS                 4
+#define TRUNCATE_EXISTING           5
+
+#define FILE_ATTRIBUTE_DIRECTORY    0x00000010
+#define FILE_ATTRIBUTE_NORMAL       0x00000080
+#define FILE_FLAG_WRITE_THROUGH     0x80000000
+#define FILE_FLAG_OVERLAPPED        0x40000000
+#define FILE_FLAG_NO_BUFFERING      0x20000000
+#define FILE_FLAG_RANDOM_ACCESS     0x10000000
+#define FILE_FLAG_SEQUENTIAL_SCAN   0x08000000
+#define FILE_ATTRIBUTE_TEMPORARY    0x00000100
+
+#define FILE_BEGIN                  0
+#define FILE_CURRENT                1
+#define FILE_END                    2
+
+#define MEM_COMMIT                  0x00001000
+#define MEM_RESERVE                 0x00002000
+#define MEM_RELEASE                 0x00008000
+#define MEM_LARGE_PAGES             0x20000000
+#define PAGE_READWRITE              0x04
+#define PAGE_EXECUTE_READWRITE      0x40
+
+//
+// Handles
+//
+// File handles carry the file descriptor, (HANDLE)(intptr_t)fd, so the IO engines can
+// recover it directly. Events and threads are objects owned by the abstraction layer;
+// CloseHandle tells the two apart.
+//
+
+DWORD GetLastError();
+void SetLastError(DWORD dwError);
+BOOL CloseHandle(HANDLE h);
+
+// named (cross-process) events are not supported; a non-empty name fails with ERROR_NOT_SUPPORTED
+HANDLE CreateEvent(PVOID pSecurityAttributes, BOOL fManualReset, BOOL fInitialState, LPCSTR pszName);
+HANDLE OpenEvent(DWORD dwDesiredAccess, BOOL fInheritHandle, LPCSTR pszName);
+BOOL SetEvent(HANDLE hEvent);
+BOOL ResetEvent(HANDLE hEvent);
+DWORD WaitForSingleObject(HANDLE h, DWORD dwMilliseconds);
+
+HANDLE CreateThread(PVOID pSecurityAttributes, SIZE_T cbStack, LPTHREAD_START_ROUTINE pfnStart, LPVOID pParameter, DWORD dwFlags, LPDWORD pdwThreadId);
+HANDLE GetCurrentThread();
+DWORD GetCurrentProcessId();
+BOOL TerminateThread(HANDLE hThread, DWORD dwExitCode);
+BOOL SetThreadPriority(HANDLE hThread, int nPriority);
+BOOL SetThreadGroupAffinity(HANDLE hThread, const GROUP_AFFINITY *pGroupAffinity, PGROUP_AFFINITY pPreviousGroupAffinity);
+BOOL SetConsoleCtrlHandler(PHANDLER_ROUTINE pfnHandler, BOOL fAdd);
+
+void Sleep(DWORD dwMilliseconds);
+ULONGLONG GetTickCount64();
+BOOL QueryPerformanceCounter(LARGE_INTEGER *pCount);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER *pFrequency);
+void GetSystemTime(LPSYSTEMTIME pSystemTime);
+void GetLocalTime(LPSYSTEMTIME pSystemTime);
+
+PVOID VirtualAlloc(PVOID pAddress, SIZE_T cb, DWORD dwAllocationType, DWORD dwProtect);
+BOOL VirtualFree(PVOID pAddress, SIZE_T cb, DWORD dwFreeType);
+SIZE_T GetLargePageMinimum();
+
+HANDLE CreateFile(LPCSTR pszPath, DWORD dwDesiredAccess, DWORD dwShareMode, PVOID pSecurityAttributes, DWORD dwCreationDisposition, DWORD dwFlagsAndAttributes, HANDLE hTemplateFile);
+BOOL ReadFile(HANDLE hFile, PVOID pBuffer, DWORD cbToRead, LPDWORD pcbRead, LPOVERLAPPED pOverlapped);
+BOOL WriteFile(HANDLE hFile, const void *pBuffer, DWORD cbToWrite, LPDWORD pcbWritten, LPOVERLAPPED pOverlapped);
+DWORD GetFileSize(HANDLE hFile, LPDWORD pdwFileSizeHigh);
+BOOL GetFileSizeEx(HANDLE hFile, PLARGE_INTEGER pFileSize);
+BOOL SetFilePointerEx(HANDLE hFile, LARGE_INTEGER liDistance, PLARGE_INTEGER pliNewPointer, DWORD dwMoveMethod);
+BOOL SetEndOfFile(HANDLE hFile);
+BOOL FlushFileBuffers(HANDLE hFile);
+DWORD GetFileAttributes(LPCSTR pszPath);
+BOOL CreateDirectory(LPCSTR pszPath, PVOID pSecurityAttributes);
+BOOL DeleteFile(LPCSTR pszPath);
+BOOL MoveFile(LPCSTR pszExistingPath, LPCSTR pszNewPath);
+
+//
+// Interlocked operations (full barriers, as on Windows)
+//
+
+inline LONG InterlockedIncrement(volatile LONG *p) { return __sync_add_and_fetch(p, 1); }
+inline LONG InterlockedDecrement(volatile LONG *p) { return __sync_sub_and_fetch(p, 1); }
+inline LONG InterlockedExchange(volatile LONG *p, LONG v) { __sync_synchronize(); return __sync_lock_test_and_set(p, v); }
+inline LONG64 InterlockedAdd64(volatile LONG64 *p, LONG64 v) { return __sync_add_and_fetch(p, v); }
+inline LONG64 InterlockedExchangeAdd64(volatile LONG64 *p, LONG64 v) { return __sync_fetch_and_add(p, v); }
+inline LONG64 InterlockedIncrement64(volatile LONG64 *p) { return __sync_add_and_fetch(p, 1); }
+inline LONG64 InterlockedCompareExchange64(volatile LONG64 *p, LONG64 v, LONG64 c) { return __sync_val_compare_and_swap(p, c, v); }
+
+#define MemoryBarrier() __sync_synchronize()
+
+#if defined(__x86_64__) || defined(__i386__)
+#define YieldProcessor() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define YieldProcessor() __asm__ __volatile__("yield")
+#else
+#define YieldProcessor() ((void)0)
+#endif
+
+//
+// CRT
+//
+
+#define _countof(a)     (sizeof(a) / sizeof((a)[0]))
+#define _stricmp        strcasecmp
+#define _strnicmp       strncasecmp
+#define _strdup         strdup
+#define _byteswap_uint64 __builtin_bswap64
+#define _rotl64(v, s)   ((UINT64)(((UINT64)(v) << ((s) & 63)) | ((UINT64)(v) >> ((64 - ((s) & 63)) & 63))))
+#define _rotr64(v, s)   ((UINT64)(((UINT64)(v) >> ((s) & 63)) | ((UINT64)(v) << ((64 - ((s) & 63)) & 63))))
+#define _TRUNCATE       ((size_t)-1)
+
+#define sprintf_s(buf, cb, ...)     snprintf((buf), (cb), __VA_ARGS__)
+#define _snprintf_s(buf, cb, ...)   snprintf((buf), (cb), __VA_ARGS__)
+#define vsprintf_s(buf, cb, fmt, a) vsnprintf((buf), (cb), (fmt), (a))
+
+inline int strcpy_s(char *pszDest, size_t cbDest, const char *pszSrc)
+{
+    if (strlen(pszSrc) >= cbDest)
+    {
+        if (cbDest)
+        {
+            *pszDest = '\0';
+        }
+        return ERANGE;
+    }
+    memcpy(pszDest, pszSrc, strlen(pszSrc) + 1);
+    return 0;
+}
+
+inline int fopen_s(FILE **ppFile, const char *pszPath, const char *pszMode)
+{
+    *ppFile = fopen(pszPath, pszMode);
+    return (*ppFile == nullptr) ? errno : 0;
+}
+
+inline void *_aligned_malloc(size_t cb, size_t alignment)
+{
+    void *p;
+    return (posix_memalign(&p, alignment, cb) == 0) ? p : nullptr;
+}
+
+inline void _aligned_free(void *p)
+{
+    free(p);
+}
+
+//
+// TraceLogging is Windows-only; events compile away.
+//
+
+#define TRACELOGGING_DECLARE_PROVIDER(h)        extern int h
+#define TRACELOGGING_DEFINE_PROVIDER(h, ...)    int h = 0
+#define TraceLoggingRegister(h)                 ((void)(h))
+#define TraceLoggingUnregister(h)               ((void)(h))
+#define TraceLoggingProviderEnabled(h, ...)     ((void)(h), false)
+#define TraceLoggingWrite(...)                  ((void)0)
+#define TraceLoggingWriteActivity(...)          ((void)0)
+#define TraceLoggingWriteStart(a, ...)          ((void)(a))
+#define TraceLoggingWriteStop(a, ...)           ((void)(a))
+
+template <int &Provider, ULONGLONG Keyword, UCHAR Level>
+class TraceLoggingActivity
+{
+};
+
+#define TRACE_LEVEL_NONE        0
+#define TRACE_LEVEL_VERBOSE     5
+
+// ETW sessions are not available; the properties type is only ever passed around as a (null) pointer
+typedef struct _EVENT_TRACE_PROPERTIES EVENT_TRACE_PROPERTIES, *PEVENT_TRACE_PROPERTIES;
+
+#endif
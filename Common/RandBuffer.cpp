@@ -0,0 +1,505 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Common.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define RAND_FILL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RAND_FILL_NEON
+#include <arm_neon.h>
+#endif
+
+//
+// The compiler must be allowed to emit instructions beyond the baseline of the build for
+// the functions which use them; they are only called once the processor is known to have them.
+// MSVC emits any intrinsic it is asked for.
+//
+
+#if defined(RAND_FILL_X86) && !defined(_MSC_VER)
+#define RAND_FILL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RAND_FILL_TARGET(isa)
+#endif
+
+//
+// RandBuffer fills whole cache lines by running Random::LaneCount copies of the Rand64
+// generator side by side, each from its own state. Each step of the lanes fills two cache
+// lines in lane order: the first with the lanes' outputs, the second with a mix of their
+// state - as with the mixing the scalar generator used to do, the second line is not
+// independent of the first, but it halves the work per byte. Every instruction set below
+// generates the same bytes as the scalar form, so a seed gives the same write content
+// whichever the processor supports.
+//
+// Lane state is laid out as ulState[word][lane] so that a vector register holds the same
+// word of adjacent lanes.
+//
+
+typedef UINT64 LaneState[4][Random::LaneCount];
+
+static void fillLanesScalar(LaneState& s, UINT64 *pBuffer64, size_t cLines)
+{
+    for (UINT32 iLane = 0; iLane < Random::LaneCount; iLane++)
+    {
+        UINT64 a = s[0][iLane], b = s[1][iLane], c = s[2][iLane], d = s[3][iLane];
+        UINT64 *pLane = pBuffer64 + iLane;
+
+        for (size_t iLine = 0; iLine < cLines; iLine += 2)
+        {
+            UINT64 e;
+
+            e = a - _rotl64(b, 7);
+            a = b ^ _rotl64(c, 13);
+            b = c + _rotl64(d, 37);
+            c = d + e;
+            d = e + a;
+
+            pLane[iLine * Random::LaneCount] = d;
+            if (iLine + 1 < cLines)
+            {
+                pLane[(iLine + 1) * Random::LaneCount] = c ^ _rotl64(a, 29);
+            }
+        }
+
+        s[0][iLane] = a;
+        s[1][iLane] = b;
+        s[2][iLane] = c;
+        s[3][iLane] = d;
+    }
+}
+
+#ifdef RAND_FILL_X86
+
+// two lanes to a register; SSE2 is the baseline of x64
+#define ROTL_SSE2(v, n) _mm_or_si128(_mm_slli_epi64((v), (n)), _mm_srli_epi64((v), 64 - (n)))
+
+RAND_FILL_TARGET("sse2")
+static void fillLanesSse2(LaneState& s, UINT64 *pBuffer64, size_t cLines)
+{
+    const UINT32 cRegs = Random::LaneCount / 2;
+    __m128i a[cRegs], b[cRegs], c[cRegs], d[cRegs];
+
+    for (UINT32 i = 0; i < cRegs; i++)
+    {
+        a[i] = _mm_loadu_si128((const __m128i *)&s[0][i * 2]);
+        b[i] = _mm_loadu_si128((const __m128i *)&s[1][i * 2]);
+        c[i] = _mm_loadu_si128((const __m128i *)&s[2][i * 2]);
+        d[i] = _mm_loadu_si128((const __m128i *)&s[3][i * 2]);
+    }
+
+    for (size_t iLine = 0; iLine < cLines; iLine += 2)
+    {
+        for (UINT32 i = 0; i < cRegs; i++)
+        {
+            __m128i e = _mm_sub_epi64(a[i], ROTL_SSE2(b[i], 7));
+            a[i] = _mm_xor_si128(b[i], ROTL_SSE2(c[i], 13));
+            b[i] = _mm_add_epi64(c[i], ROTL_SSE2(d[i], 37));
+            c[i] = _mm_add_epi64(d[i], e);
+            d[i] = _mm_add_epi64(e, a[i]);
+
+            _mm_storeu_si128((__m128i *)&pBuffer64[i * 2], d[i]);
+            if (iLine + 1 < cLines)
+            {
+                _mm_storeu_si128((__m128i *)&pBuffer64[Random::LaneCount + i * 2], _mm_xor_si128(c[i], ROTL_SSE2(a[i], 29)));
+            }
+        }
+        pBuffer64 += 2 * Random::LaneCount;
+    }
+
+    for (UINT32 i = 0; i < cRegs; i++)
+    {
+        _mm_storeu_si128((__m128i *)&s[0][i * 2], a[i]);
+        _mm_storeu_si128((__m128i *)&s[1][i * 2], b[i]);
+        _mm_storeu_si128((__m128i *)&s[2][i * 2], c[i]);
+        _mm_storeu_si128((__m128i *)&s[3][i * 2], d[i]);
+    }
+}
+
+#define ROTL_AVX2(v, n) _mm256_or_si256(_mm256_slli_epi64((v), (n)), _mm256_srli_epi64((v), 64 - (n)))
+
+RAND_FILL_TARGET("avx2")
+static void fillLanesAvx2(LaneState& s, UINT64 *pBuffer64, size_t cLines)
+{
+    const UINT32 cRegs = Random::LaneCount / 4;
+    __m256i a[cRegs], b[cRegs], c[cRegs], d[cRegs];
+
+    for (UINT32 i = 0; i < cRegs; i++)
+    {
+        a[i] = _mm256_loadu_si256((const __m256i *)&s[0][i * 4]);
+        b[i] = _mm256_loadu_si256((const __m256i *)&s[1][i * 4]);
+        c[i] = _mm256_loadu_si256((const __m256i *)&s[2][i * 4]);
+        d[i] = _mm256_loadu_si256((const __m256i *)&s[3][i * 4]);
+    }
+
+    for (size_t iLine = 0; iLine < cLines; iLine += 2)
+    {
+        for (UINT32 i = 0; i < cRegs; i++)
+        {
+            __m256i e = _mm256_sub_epi64(a[i], ROTL_AVX2(b[i], 7));
+            a[i] = _mm256_xor_si256(b[i], ROTL_AVX2(c[i], 13));
+            b[i] = _mm256_add_epi64(c[i], ROTL_AVX2(d[i], 37));
+            c[i] = _mm256_add_epi64(d[i], e);
+            d[i] = _mm256_add_epi64(e, a[i]);
+
+            _mm256_storeu_si256((__m256i *)&pBuffer64[i * 4], d[i]);
+            if (iLine + 1 < cLines)
+            {
+                _mm256_storeu_si256((__m256i *)&pBuffer64[Random::LaneCount + i * 4], _mm256_xor_si256(c[i], ROTL_AVX2(a[i], 29)));
+            }
+        }
+        pBuffer64 += 2 * Random::LaneCount;
+    }
+
+    for (UINT32 i = 0; i < cRegs; i++)
+    {
+        _mm256_storeu_si256((__m256i *)&s[0][i * 4], a[i]);
+        _mm256_storeu_si256((__m256i *)&s[1][i * 4], b[i]);
+        _mm256_storeu_si256((__m256i *)&s[2][i * 4], c[i]);
+        _mm256_storeu_si256((__m256i *)&s[3][i * 4], d[i]);
+    }
+}
+
+// all eight lanes in one register, with a native rotate
+RAND_FILL_TARGET("avx512f")
+static void fillLanesAvx512(LaneState& s, UINT64 *pBuffer64, size_t cLines)
+{
+    __m512i a = _mm512_loadu_si512(&s[0][0]);
+    __m512i b = _mm512_loadu_si512(&s[1][0]);
+    __m512i c = _mm512_loadu_si512(&s[2][0]);
+    __m512i d = _mm512_loadu_si512(&s[3][0]);
+
+    for (size_t iLine = 0; iLine < cLines; iLine += 2)
+    {
+        __m512i e = _mm512_sub_epi64(a, _mm512_rol_epi64(b, 7));
+        a = _mm512_xor_si512(b, _mm512_rol_epi64(c, 13));
+        b = _mm512_add_epi64(c, _mm512_rol_epi64(d, 37));
+        c = _mm512_add_epi64(d, e);
+        d = _mm512_add_epi64(e, a);
+
+        _mm512_storeu_si512(pBuffer64, d);
+        if (iLine + 1 < cLines)
+        {
+            _mm512_storeu_si512(pBuffer64 + Random::LaneCount, _mm512_xor_si512(c, _mm512_rol_epi64(a, 29)));
+        }
+        pBuffer64 += 2 * Random::LaneCount;
+    }
+
+    _mm512_storeu_si512(&s[0][0], a);
+    _mm512_storeu_si512(&s[1][0], b);
+    _mm512_storeu_si512(&s[2][0], c);
+    _mm512_storeu_si512(&s[3][0], d);
+}
+
+#endif
+
+#ifdef RAND_FILL_NEON
+
+// shift left, then insert the bits shifted out from the right
+#define ROTL_NEON(v, n) vsriq_n_u64(vshlq_n_u64((v), (n)), (v), 64 - (n))
+
+static void fillLanesNeon(LaneState& s, UINT64 *pBuffer64, size_t cLines)
+{
+    const UINT32 cRegs = Random::LaneCount / 2;
+    uint64x2_t a[cRegs], b[cRegs], c[cRegs], d[cRegs];
+
+    for (UINT32 i = 0; i < cRegs; i++)
+    {
+        a[i] = vld1q_u64(&s[0][i * 2]);
+        b[i] = vld1q_u64(&s[1][i * 2]);
+        c[i] = vld1q_u64(&s[2][i * 2]);
+        d[i] = vld1q_u64(&s[3][i * 2]);
+    }
+
+    for (size_t iLine = 0; iLine < cLines; iLine += 2)
+    {
+        for (UINT32 i = 0; i < cRegs; i++)
+        {
+            uint64x2_t e = vsubq_u64(a[i], ROTL_NEON(b[i], 7));
+            a[i] = veorq_u64(b[i], ROTL_NEON(c[i], 13));
+            b[i] = vaddq_u64(c[i], ROTL_NEON(d[i], 37));
+            c[i] = vaddq_u64(d[i], e);
+            d[i] = vaddq_u64(e, a[i]);
+
+            vst1q_u64(&pBuffer64[i * 2], d[i]);
+            if (iLine + 1 < cLines)
+            {
+                vst1q_u64(&pBuffer64[Random::LaneCount + i * 2], veorq_u64(c[i], ROTL_NEON(a[i], 29)));
+            }
+        }
+        pBuffer64 += 2 * Random::LaneCount;
+    }
+
+    for (UINT32 i = 0; i < cRegs; i++)
+    {
+        vst1q_u64(&s[0][i * 2], a[i]);
+        vst1q_u64(&s[1][i * 2], b[i]);
+        vst1q_u64(&s[2][i * 2], c[i]);
+        vst1q_u64(&s[3][i * 2], d[i]);
+    }
+}
+
+#endif
+
+bool Random::IsFillSupported(RandFill fill)
+{
+    switch (fill)
+    {
+        case RandFill::Scalar:
+        return true;
+
+#ifdef RAND_FILL_X86
+        case RandFill::Sse2:
+#ifdef _MSC_VER
+        return IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) != FALSE;
+#else
+        return __builtin_cpu_supports("sse2") != 0;
+#endif
+
+        case RandFill::Avx2:
+        case RandFill::Avx512:
+#ifdef _MSC_VER
+        {
+            // the processor must have the instructions, and the OS must save the registers they use
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+            __cpuid(info, 1);
+            if ((info[2] & (1 << 27)) == 0)
+            {
+                return false;
+            }
+            UINT64 xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            if (fill == RandFill::Avx2)
+            {
+                return ((xcr0 & 0x06) == 0x06) && (info[1] & (1 << 5));
+            }
+            return ((xcr0 & 0xe6) == 0xe6) && (info[1] & (1 << 16));
+        }
+#else
+        // these check that the OS saves the registers as well
+        return (fill == RandFill::Avx2) ? (__builtin_cpu_supports("avx2") != 0) : (__builtin_cpu_supports("avx512f") != 0);
+#endif
+#endif
+
+#ifdef RAND_FILL_NEON
+        case RandFill::Neon:
+        return true;
+#endif
+
+        default:
+        return false;
+    }
+}
+
+RandFill Random::GetBestFill()
+{
+    static const RandFill fills[] = { RandFill::Avx512, RandFill::Avx2, RandFill::Sse2, RandFill::Neon };
+    static const RandFill best = []() {
+        for (auto fill : fills)
+        {
+            if (IsFillSupported(fill))
+            {
+                return fill;
+            }
+        }
+        return RandFill::Scalar;
+    }();
+
+    return best;
+}
+
+bool Random::SetFill(RandFill fill)
+{
+    if (!IsFillSupported(fill))
+    {
+        return false;
+    }
+
+    _fill = fill;
+    return true;
+}
+
+const char *Random::FillToString(RandFill fill)
+{
+    switch (fill)
+    {
+        case RandFill::Sse2:
+        return "SSE2";
+
+        case RandFill::Avx2:
+        return "AVX2";
+
+        case RandFill::Avx512:
+        return "AVX-512";
+
+        case RandFill::Neon:
+        return "NEON";
+
+        default:
+        return "scalar";
+    }
+}
+
+void Random::_FillLines(UINT64 *pBuffer64, size_t cLines)
+{
+    //
+    // The lanes are seeded from this generator the first time they are needed, and then
+    // run on from where they left off; callers which never ask for a pseudo-random buffer
+    // see the same sequence from Rand64 as before.
+    //
+
+    if (!_fLanesSeeded)
+    {
+        for (UINT32 iWord = 0; iWord < 4; iWord++)
+        {
+            for (UINT32 iLane = 0; iLane < LaneCount; iLane++)
+            {
+                _ulLaneState[iWord][iLane] = Rand64();
+            }
+        }
+        _fLanesSeeded = true;
+    }
+
+    switch (_fill)
+    {
+#ifdef RAND_FILL_X86
+        case RandFill::Sse2:
+        fillLanesSse2(_ulLaneState, pBuffer64, cLines);
+        break;
+
+        case RandFill::Avx2:
+        fillLanesAvx2(_ulLaneState, pBuffer64, cLines);
+        break;
+
+        case RandFill::Avx512:
+        fillLanesAvx512(_ulLaneState, pBuffer64, cLines);
+        break;
+#endif
+
+#ifdef RAND_FILL_NEON
+        case RandFill::Neon:
+        fillLanesNeon(_ulLaneState, pBuffer64, cLines);
+        break;
+#endif
+
+        default:
+        fillLanesScalar(_ulLaneState, pBuffer64, cLines);
+    }
+}
+
+void Random::RandBuffer(BYTE *pBuffer, UINT32 ulLength, bool fPseudoRandomOkay)
+{
+    UINT64 *pBuffer64;
+    UINT32 Remaining = (UINT32)(((ULONG_PTR)pBuffer) & 7);
+    UINT64 r1, r2, r3, r4;
+
+    //
+    // Align to 8 bytes
+    //
+
+    if (Remaining != 0) {
+        r1 = Rand64();
+
+        while (Remaining != 0 && ulLength != 0) {
+            *pBuffer = (BYTE)(r1 & 0xFF);
+            r1 >>= 8;
+            pBuffer++;
+            ulLength--;
+            Remaining--;
+        }
+    }
+
+    pBuffer64 = (UINT64*)pBuffer;
+    Remaining = ulLength / 8;
+    ulLength -= Remaining * 8;
+    pBuffer += Remaining * 8;
+
+    if (fPseudoRandomOkay) {
+
+        //
+        // Fill whole cache lines from the lanes, as wide as the processor allows.
+        // The lanes are independent generators, but the buffer is not a single
+        // stream of Rand64; only do this if the caller is okay with that. The
+        // write buffers of a run are filled this way on every IO, so this needs
+        // to keep up with the storage.
+        //
+
+        size_t cLines = Remaining / LaneCount;
+        if (cLines != 0) {
+            _FillLines(pBuffer64, cLines);
+
+            pBuffer64 += cLines * LaneCount;
+            Remaining -= (UINT32)(cLines * LaneCount);
+        }
+    }
+
+    //
+    // Fill in the tail of the buffer
+    //
+
+    while (Remaining >= 4) {
+        r1 = Rand64();
+        r2 = Rand64();
+        r3 = Rand64();
+        r4 = Rand64();
+
+        pBuffer64[0]  = r1;
+        pBuffer64[1]  = r2;
+        pBuffer64[2]  = r3;
+        pBuffer64[3]  = r4;
+
+        pBuffer64 += 4;
+        Remaining -= 4;
+    }
+
+    while (Remaining != 0) {
+        *pBuffer64 = Rand64();
+        pBuffer64++;
+        Remaining--;
+    }
+
+    if (ulLength != 0) {
+        r1 = Rand64();
+
+        while (ulLength != 0) {
+            *pBuffer = (BYTE)(r1 & 0xFF);
+            r1 >>= 8;
+            pBuffer++;
+            ulLength--;
+        }
+    }
+}
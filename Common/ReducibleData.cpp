@@ -0,0 +1,141 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "Common.h"
+
+ReducibleDataPool::ReducibleDataPool() :
+    _pPool(nullptr),
+    _cbPool(0),
+    _cbChunk(0),
+    _cbRandomPerSegment(0),
+    _cUniqueChunks(0),
+    _ulUniqueThreshold(0),
+    _fAllUnique(true)
+{
+}
+
+ReducibleDataPool::~ReducibleDataPool()
+{
+    if (_pPool != nullptr)
+    {
+        VirtualFree(_pPool, 0, MEM_RELEASE);
+    }
+}
+
+bool ReducibleDataPool::Initialize(double lfCompressionRatio, double lfDedupRatio, UINT32 cbChunk, size_t cbMaxBlock, Random *pRand)
+{
+    assert(_pPool == nullptr);
+    assert(lfCompressionRatio >= 1 && lfDedupRatio >= 1 && cbChunk >= SegmentSize);
+
+    _cbChunk = cbChunk;
+    _cbRandomPerSegment = static_cast<UINT32>(SegmentSize / lfCompressionRatio + 0.5);
+    assert(_cbRandomPerSegment >= sizeof(UINT64));
+
+    _fAllUnique = (lfDedupRatio == 1);
+    _ulUniqueThreshold = static_cast<UINT32>(MAXUINT32 / lfDedupRatio);
+
+    _cUniqueChunks = 2 * Util::QuotientCeiling<size_t>(cbMaxBlock, cbChunk);
+    if (_cUniqueChunks < MinUniqueChunkCount)
+    {
+        _cUniqueChunks = MinUniqueChunkCount;
+    }
+
+    _cbPool = (_cUniqueChunks + DuplicateChunkCount) * cbChunk;
+    _pPool = (BYTE *)VirtualAlloc(nullptr, _cbPool, MEM_COMMIT, PAGE_READWRITE);
+    if (_pPool == nullptr)
+    {
+        return false;
+    }
+
+    for (size_t iChunk = 0; iChunk < _cUniqueChunks + DuplicateChunkCount; iChunk++)
+    {
+        _FillChunk(_pPool + iChunk * cbChunk, pRand);
+    }
+    return true;
+}
+
+void ReducibleDataPool::_FillChunk(BYTE *pChunk, Random *pRand) const
+{
+    memset(pChunk, 0, _cbChunk);
+    for (UINT32 iSegment = 0; iSegment < _cbChunk / SegmentSize; iSegment++)
+    {
+        pRand->RandBuffer(pChunk + iSegment * SegmentSize, _cbRandomPerSegment, false);
+    }
+}
+
+void ReducibleDataPool::Fill(BYTE *pBuffer, size_t cb, Random *pRand) const
+{
+    const BYTE *pUniqueChunks = _pPool;
+    const BYTE *pDuplicateChunks = _pPool + _cUniqueChunks * _cbChunk;
+    size_t iUniqueChunk = pRand->Rand32() % _cUniqueChunks;
+
+    while (cb > 0)
+    {
+        size_t cbChunk = (cb < _cbChunk) ? cb : _cbChunk;
+
+        if (_fAllUnique || (pRand->Rand32() < _ulUniqueThreshold))
+        {
+            _CopyUniqueChunk(pBuffer, pUniqueChunks + iUniqueChunk * _cbChunk, cbChunk, pRand->Rand64());
+            iUniqueChunk = (iUniqueChunk + 1) % _cUniqueChunks;
+        }
+        else
+        {
+            memcpy(pBuffer, pDuplicateChunks + (pRand->Rand32() % DuplicateChunkCount) * _cbChunk, cbChunk);
+        }
+
+        pBuffer += cbChunk;
+        cb -= cbChunk;
+    }
+}
+
+void ReducibleDataPool::_CopyUniqueChunk(BYTE *pBuffer, const BYTE *pChunk, size_t cb, UINT64 ullKey) const
+{
+    // the zeros are left as they are so the chunk compresses as the pool's does
+    for (size_t ib = 0; ib < cb; ib += SegmentSize)
+    {
+        size_t cbSegment = min<size_t>(SegmentSize, cb - ib);
+        size_t cbRandom = min<size_t>(_cbRandomPerSegment, cbSegment);
+        size_t iByte = 0;
+
+        for (; iByte + sizeof(UINT64) <= cbRandom; iByte += sizeof(UINT64))
+        {
+            UINT64 ullWord;
+            memcpy(&ullWord, pChunk + ib + iByte, sizeof(ullWord));
+            ullWord ^= ullKey;
+            memcpy(pBuffer + ib + iByte, &ullWord, sizeof(ullWord));
+        }
+        for (; iByte < cbRandom; iByte++)
+        {
+            pBuffer[ib + iByte] = pChunk[ib + iByte] ^ (BYTE)(ullKey >> (8 * (iByte % sizeof(UINT64))));
+        }
+
+        memset(pBuffer + ib + cbRandom, 0, cbSegment - cbRandom);
+    }
+}
@@ -0,0 +1,86 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include "Platform.h"
+
+class Random;
+
+//
+// Write content which storage reduces by a given compression ratio and dedup ratio (-Zc). The
+// content of each write is built a chunk at a time from a pool generated before the run, so
+// issuing a write only copies from it:
+//
+//   compression: each 512 byte segment of a chunk is random for 1/<ratio> of its length and
+//                zero for the rest, so a compressor reduces it by about the ratio whatever
+//                the size of the unit it compresses
+//   dedup:       each chunk is unique with probability 1/<ratio>; the rest are copies of one
+//                of a few duplicate chunks. Unique chunks are copies of the pool's chunks with
+//                their random bytes xored with a random key, so no two writes repeat one, in
+//                whole or in part.
+//
+// Consecutive unique chunks of a write come from consecutive chunks of the pool.
+//
+
+class ReducibleDataPool
+{
+public:
+    ReducibleDataPool();
+    ~ReducibleDataPool();
+
+    static const UINT32 DefaultChunkSize = 4 * 1024;
+    static const UINT32 SegmentSize = 512;
+    static const UINT32 MaxCompressionRatio = 64;
+    static const UINT32 DuplicateChunkCount = 16;
+    static const UINT32 MinUniqueChunkCount = 1024;
+
+    // the pool holds at least two of the largest writes' worth of unique chunks
+    bool Initialize(double lfCompressionRatio, double lfDedupRatio, UINT32 cbChunk, size_t cbMaxBlock, Random *pRand);
+
+    void Fill(BYTE *pBuffer, size_t cb, Random *pRand) const;
+
+    size_t GetPoolSize() const { return _cbPool; }
+
+private:
+    ReducibleDataPool(const ReducibleDataPool&) = delete;
+    ReducibleDataPool& operator=(const ReducibleDataPool&) = delete;
+
+    void _FillChunk(BYTE *pChunk, Random *pRand) const;
+    void _CopyUniqueChunk(BYTE *pBuffer, const BYTE *pChunk, size_t cb, UINT64 ullKey) const;
+
+    BYTE *_pPool;               // unique chunks, then the duplicate chunks
+    size_t _cbPool;
+    UINT32 _cbChunk;
+    UINT32 _cbRandomPerSegment;
+    size_t _cUniqueChunks;
+    UINT32 _ulUniqueThreshold;  // a chunk is unique if a 32 bit random number is below this
+    bool _fAllUnique;
+};
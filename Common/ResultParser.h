@@ -49,19 +49,27 @@ private:
     void _PrintProfile(const Profile& profile);
     void _PrintSystemInfo(const SystemInformation& system);
     void _PrintCpuUtilization(const Results& results, const SystemInformation& system);
-    enum class _SectionEnum {TOTAL, READ, WRITE};
+    enum class _SectionEnum {TOTAL, READ, WRITE, FLUSH, TRIM, FUA_WRITE};
     void _PrintSectionFieldNames(const TimeSpan& timeSpan);
     void _PrintSectionBorderLine(const TimeSpan& timeSpan);
     void _PrintSection(_SectionEnum, const TimeSpan&, const Results&);
     void _PrintLatencyPercentiles(const Results&);
     void _PrintLatencyChart(const Histogram<float>& readLatencyHistogram,
         const Histogram<float>& writeLatencyHistogram,
+        const Histogram<float>& flushLatencyHistogram,
+        const Histogram<float>& trimLatencyHistogram,
+        const Histogram<float>& fuaWriteLatencyHistogram,
         const Histogram<float>& totalLatencyHistogram);
     void _PrintTimeSpan(const TimeSpan &timeSpan);
-    void _PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines);
-    void _PrintDistribution(DistributionType dT, const vector<DistributionRange>& v, char* spc);
+    void _PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines, IoEngine ioEngine = IoEngine::Default);
+    void _PrintDistribution(DistributionType dT, const vector<DistributionRange>& v, double skew, bool fScatter, const char* spc);
     void _PrintEffectiveDistributions(const Results& results);
+    void _PrintBlockSizeBreakdown(const Results& results, double fTime, bool fMeasureLatency);
+    void _PrintMetadataBreakdown(const Results& results, double fTime, bool fMeasureLatency);
+    void _PrintPhaseBreakdown(const TimeSpan& timeSpan, const Results& results, double fTime, bool fMeasureLatency);
+    void _PrintVerification(const TimeSpan& timeSpan, const Results& results);
     void _PrintWaitStats(const Results& result);
+    void _PrintTimeSpanSummary(const Profile& profile, const vector<Results>& vResults);
 
     string _sResult;
 
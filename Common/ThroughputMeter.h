@@ -28,34 +28,125 @@ SOFTWARE.
 */
 
 #pragma once
-#include <Windows.h>
+#include "Platform.h"
+
+class Random;
+
+// SharedRateLimit meters a rate across all the threads it is shared by: the aggregate
+// limit of a target, or of the whole timespan. It is a virtual scheduling (GCRA) bucket
+// whose theoretical time is advanced by compare-exchange, so no lock is taken. Threads
+// draw grants of several IOs at a time into their ThroughputMeter, so that at high
+// rates the shared state is touched once per grant rather than once per IO.
+// The rate is in bytes, or with fIOPS in IOs, per millisecond. It may be changed while
+// threads draw from the limit, as load phases do; a rate of 0 does not limit.
+class SharedRateLimit
+{
+public:
+    SharedRateLimit(double lfUnitsPerMillisecond, bool fIOPS, DWORD dwSpinMicroseconds);
+
+    bool IsIOPS(void) const { return _fIOPS; }
+    double GetGrantSize(void) const { return _lfGrantSize; }
+    void SetRate(double lfUnitsPerMillisecond);
+
+    // takes lfUnits at time ullNow; returns 0 if they were granted, else the
+    // time until they can be (perf timer units)
+    UINT64 TryAcquire(double lfUnits, UINT64 ullNow);
+
+    // time over which a grant accrues (microseconds): long enough to make grants rare
+    // at high rates, short enough that a grant is one IO at the low rates QoS tests use
+    static const DWORD GrantMicroseconds = 100;
+
+private:
+    SharedRateLimit(const SharedRateLimit&);
+    SharedRateLimit& operator=(const SharedRateLimit&);
+
+    static const size_t CacheLineSize = 64;
+
+    // aligned 8 byte stores and loads are not torn, so the rate can be changed under readers
+    volatile double _lfTicksPerUnit;    // 0 if not limited
+    volatile double _lfGrantSize;
+    UINT64 _ullTolerance;           // how far the theoretical time may run ahead of now (perf timer units)
+    bool _fIOPS;
+
+    BYTE _abPad[CacheLineSize];
+    volatile LONG64 _llTheoreticalTime;    // when the units granted so far will have accrued (perf timer units)
+    BYTE _abTrailingPad[CacheLineSize];
+};
 
 // ThroughputMeter class assists in metering out throughput over
 // time.  The meter is started by calling Start() with the throughput
-// to be simulated.  GetSleepTime() returns 0 when the next IO can be issued.
+// to be simulated, which is paced by a token bucket on the perf timer: bytes
+// accrue at the rate up to the bucket depth, and the next IO can be issued once a
+// block's worth is available.  IsReady() reports whether it can, and the time to
+// sleep if not; a zero sleep with the IO not ready means the caller should poll, as
+// it does for the part of a wait within the spin time.
 // Adjust() is called to notify the ThroughputMeter about how many bytes were read/written.
+//
+// Alternatively, StartArrivals() runs the meter open-loop: IOs arrive on a fixed or
+// Poisson schedule at the given rate regardless of when earlier IOs complete. IsReady()
+// reports whether the next arrival is due and GetArrivalTime() its scheduled time, from
+// which latency is measured so that IOs delayed by a busy device are not under-reported.
+// StartTrace() runs the same schedule with each arrival stated by ScheduleArrival(), relative
+// to the start of the schedule, as when replaying the timestamps of a trace.
+// AddSharedLimit(), after Start(), also holds each IO to a limit shared with other threads.
+// Grants taken from it are kept in the meter and spent by Adjust().
 class ThroughputMeter
 {
 public:
     ThroughputMeter(void);
 
+    // coarsest timer resolution a sleep is expected to overshoot by (Windows default 15.6ms)
+    static const DWORD SleepResolutionMilliseconds = 16;
+
     bool IsRunning(void) const;
-    void Start(DWORD cBytesPerMillisecond, DWORD dwBlockSize, DWORD dwThinkTime, DWORD dwBurstSize);
-    DWORD GetSleepTime(void) const;
+    void Start(double lfBytesPerMillisecond, DWORD dwBlockSize, DWORD dwThinkTime, DWORD dwBurstSize, DWORD dwSpinMicroseconds);
+    bool AddSharedLimit(SharedRateLimit *pLimit);
+    void StartArrivals(DWORD dwIOPS, bool fPoisson, Random *pRand);
+    void StartTrace(void);
+    void ResetArrivals(void);
+    void ScheduleArrival(UINT64 ullArrival);
+    bool IsReady(DWORD *pdwSleepTime);
+    bool IsArrivalSchedule(void) const;
+    UINT64 GetArrivalTime(void) const;
     void Adjust(size_t cb);
 
 private:
-    DWORD _GetThrottleTime(void) const;
+    UINT64 _GetWaitTime(void) const;
+    UINT64 _GetThrottleWaitTime(UINT64 ullNow) const;
+    double _GetTokens(UINT64 ullNow) const;
+    UINT64 _AcquireShared(void);
+    DWORD _WaitToSleepTime(UINT64 ullWait) const;
+    DWORD _GetArrivalSleepTime(void) const;
+    double _NextArrivalInterval(void);
 
     bool _fRunning;                 // true = throughput monitoring is on
     bool _fThrottle;                // true = throttling is on
     bool _fThink;                   // true = think time is enabled
     ULONGLONG _cbCompleted;         // completed IO
     DWORD _cbBlockSize;
-    DWORD _cBytesPerMillisecond;    // rate of throttling
-    ULONGLONG _ullStartTimestamp;
-    ULONGLONG _ullDelayUntil;       // timestamp at which the next IO can be executed
+    double _lfBytesPerTick;         // rate of throttling (bytes per perf timer unit)
+    double _lfBucketDepth;          // most bytes the bucket holds
+    double _lfTokens;               // bytes available as of _ullTokensTimestamp, negative if overdrawn by a large IO
+    UINT64 _ullTokensTimestamp;
+    UINT64 _ullSpinTime;            // waits up to this long are polled rather than slept (perf timer units)
+    UINT64 _ullDelayUntil;          // timestamp at which the next IO can be executed (perf timer units)
     DWORD _thinkTime;               // time to sleep between burst of IOs
     DWORD _burstSize;               // number of IOs in a burst. meaningless if think time is zero
     DWORD _cIO;                     // count of IOs in the current burst
+
+    static const UINT32 MaxSharedLimits = 3;    // the target's, the timespan's and its load phases'
+    struct SharedGrant
+    {
+        SharedRateLimit *pLimit;
+        double lfUnits;             // granted but not yet spent, negative if overdrawn by a large IO
+    };
+    SharedGrant _aSharedGrants[MaxSharedLimits];
+    UINT32 _cSharedGrants;
+
+    bool _fArrivals;                // true = open-loop arrival schedule is on
+    bool _fPoisson;                 // true = exponentially distributed inter-arrival times
+    double _lfArrivalInterval;      // mean time between arrivals (perf timer units)
+    double _lfNextArrival;          // scheduled time of the next arrival (perf timer units)
+    UINT64 _ullArrivalStart;        // time the arrival schedule started (perf timer units)
+    Random *_pRand;                 // source for Poisson inter-arrival times
 };
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+#include "Platform.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+//
+// TraceReader streams the IO records of a captured trace for replay (-Q). Supported formats
+// are detected from the content of the trace:
+//
+//  * CSV: <timestamp (us)>,<R|W>,<offset>,<length> with an optional header line
+//  * fio iolog, version 2 (untimed) or 3 (<timestamp (ms)> <file> <read|write> <offset> <length>)
+//  * blkparse default text output; queue (Q) events are replayed, or issue (D) events if
+//      the trace has no queue events
+//
+// Open() makes a validating pass over the trace, and then a reader thread parses the trace
+// into batches of records ahead of the threads consuming them. Only a bounded number of batches
+// is held in memory, so traces need not fit in RAM. The trace repeats until the reader is closed;
+// each repetition follows the last at the mean interval between records.
+//
+
+enum class TraceFormat
+{
+    Unknown,
+    Csv,
+    FioIolog,
+    Blkparse
+};
+
+struct TraceRecord
+{
+    UINT64 ullTime;     // nanoseconds since the first record of the trace
+    UINT64 ullOffset;   // bytes
+    DWORD dwLength;     // bytes
+    bool fWrite;
+};
+
+class TraceReader
+{
+public:
+    TraceReader();
+    ~TraceReader();
+
+    bool Open(const std::string& sPath);
+    void Close();
+
+    // Replaces the batch with the next batch of records; blocks while the reader catches up.
+    // Returns false only once the reader is closed.
+    bool NextBatch(std::vector<TraceRecord>& vBatch);
+
+    TraceFormat GetFormat() const { return _format; }
+    UINT64 GetRecordCount() const { return _cRecords; }
+    DWORD GetMaxLength() const { return _dwMaxLength; }
+    UINT64 GetDuration() const { return _ullDuration; }
+
+    //
+    // Parses one line of a trace. Returns false if the line is malformed; otherwise fRecord
+    // states whether it is an IO record or is skipped (comments, headers, other operations).
+    // The record time is in nanoseconds, absolute as stated by the trace.
+    //
+
+    static TraceFormat DetectFormat(const char *pszLine);
+    static bool ParseLine(TraceFormat format, char chBlkAction, const char *pszLine, TraceRecord& record, bool& fRecord);
+
+    static const size_t BatchRecords = 256;     // records per batch
+    static const size_t MaxBatches = 64;        // batches read ahead of the consumers
+
+private:
+    TraceReader(const TraceReader&);
+    TraceReader& operator=(const TraceReader&);
+
+    bool _Scan();
+    void _ReadAhead();
+
+    std::string _sPath;
+    FILE *_pFile;
+    TraceFormat _format;
+    char _chBlkAction;          // blkparse: event replayed, Q or D
+    UINT64 _cRecords;
+    DWORD _dwMaxLength;
+    UINT64 _ullFirstTime;       // absolute time of the first record
+    UINT64 _ullDuration;        // time of the last record relative to the first
+    UINT64 _ullRepeatInterval;  // time from the start of one repetition of the trace to the next
+
+    std::thread _reader;
+    std::mutex _lock;
+    std::condition_variable _cvReady;   // signals consumers: a batch is ready, or the reader closed
+    std::condition_variable _cvSpace;   // signals the reader: a batch was consumed, or the reader closed
+    std::deque<std::vector<TraceRecord>> _qBatches;
+    bool _fClosing;
+};
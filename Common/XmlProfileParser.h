@@ -43,18 +43,27 @@ private:
     HRESULT _ParseTargets(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan, vector<pair<string, bool>>& vSubsts);
     HRESULT _ParseRandomDataSource(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _ParseWriteBufferContent(IXMLDOMNode *pXmlNode, Target *pTarget);
+    HRESULT _ParseDataReduction(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _ParseThreadTargets(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _ParseThroughput(IXMLDOMNode *pXmlNode, Target *pTarget);
+    HRESULT _GetTotalThroughput(IXMLDOMNode *pXmlNode, DWORD *pdwValue, bool *pfIOPS);
+    HRESULT _ParseArrivalRate(IXMLDOMNode *pXmlNode, Target *pTarget);
+    HRESULT _ParseTrace(IXMLDOMNode *pXmlNode, Target *pTarget);
+    HRESULT _ParseReportInterval(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan);
+    HRESULT _ParseSweep(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan);
+    HRESULT _ParsePhases(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan);
     HRESULT _ParseThreadTarget(IXMLDOMNode *pXmlNode, ThreadTarget *pThreadTarget);
     HRESULT _ParseAffinityAssignment(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan);
     HRESULT _ParseAffinityGroupAssignment(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan);
     HRESULT _ParseDistribution(IXMLDOMNode *pXmlNode, Target *pTarget);
+    HRESULT _ParseBlockSizeMix(IXMLDOMNode *pXmlNode, Target *pTarget);
     HRESULT _SubstTarget(Target *pTarget, vector<pair<string, bool>>& vSubsts);
 
     HRESULT _GetString(IXMLDOMNode *pXmlNode, const char *pszQuery, string *psValue) const;
     HRESULT _GetUINT32(IXMLDOMNode *pXmlNode, const char *pszQuery, UINT32 *pulValue) const;
     HRESULT _GetUINT64(IXMLDOMNode *pXmlNode, const char *pszQuery, UINT64 *pullValue) const;
+    HRESULT _GetDouble(IXMLDOMNode *pXmlNode, const char *pszQuery, double *plfValue) const;
     HRESULT _GetDWORD(IXMLDOMNode *pXmlNode, const char *pszQuery, DWORD *pdwValue) const;
     HRESULT _GetBool(IXMLDOMNode *pXmlNode, const char *pszQuery, bool *pfValue) const;
 
@@ -30,6 +30,7 @@ SOFTWARE.
 #pragma once
 
 
+#ifndef __linux__
 #include <windows.h>
 #include <Wmistr.h>		///WNODE_HEADER
 #define INITGUID		//Include this #define to use SystemTraceControlGuid in Evntrace.h.
@@ -38,4 +39,12 @@ SOFTWARE.
 
 BOOL TraceEvents();
 TRACEHANDLE StartETWSession(const Profile& profile);
-PEVENT_TRACE_PROPERTIES StopETWSession(TRACEHANDLE hTraceSession);
\ No newline at end of file
+PEVENT_TRACE_PROPERTIES StopETWSession(TRACEHANDLE hTraceSession);
+#else
+#include "Common.h"
+
+// there is no ETW on Linux; -e is rejected during profile validation so these are never reached
+inline BOOL TraceEvents() { return FALSE; }
+inline TRACEHANDLE StartETWSession(const Profile& profile) { UNREFERENCED_PARAMETER(profile); return 0; }
+inline PEVENT_TRACE_PROPERTIES StopETWSession(TRACEHANDLE hTraceSession) { UNREFERENCED_PARAMETER(hTraceSession); return nullptr; }
+#endif
\ No newline at end of file
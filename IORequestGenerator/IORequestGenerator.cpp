@@ -34,27 +34,46 @@ SOFTWARE.
 #define _WIN32_WINNT 0x0601
 #endif
 
-#include "common.h"
+#include "Common.h"
 #include "IORequestGenerator.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#ifndef __linux__
 #include <Winioctl.h>   //DISK_GEOMETRY
 #include <windows.h>
+#endif
 #include <stddef.h>
 
+#ifndef __linux__
 #include <Wmistr.h>     //WNODE_HEADER
+#endif
 
 #include "etw.h"
 #include <assert.h>
+#include <atomic>
+#include <thread>
 #include "ThroughputMeter.h"
 #include "OverlappedQueue.h"
+#include "IntervalReporter.h"
+#include "LatencySloSearch.h"
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/fs.h>   //BLKGETSIZE64, BLKDISCARD
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>    //pwritev2
+#include "IoUring.h"
+#include "LinuxAio.h"
+#endif
 
 // Flags for RtlFlushNonVolatileMemory
 #ifndef FLUSH_NV_MEMORY_IN_FLAG_NO_DRAIN
 #define FLUSH_NV_MEMORY_IN_FLAG_NO_DRAIN    (0x00000001)
 #endif
 
+#ifndef __linux__
 /*****************************************************************************/
 // gets size of a dynamic volume, return zero on failure
 //
@@ -403,6 +422,33 @@ Return Value:
 
     return Status;
 }
+#else
+/*****************************************************************************/
+// gets size of a block device, return zero on failure
+//
+UINT64 GetPhysicalDriveSize(HANDLE hFile)
+{
+    assert(NULL != hFile && INVALID_HANDLE_VALUE != hFile);
+
+    UINT64 size = 0;
+
+    if (ioctl((int)(intptr_t)hFile, BLKGETSIZE64, &size) != 0)
+    {
+        PrintError("ERROR: Could not obtain block device size (error code: %u)\n", errno);
+        return 0;
+    }
+
+    return size;
+}
+
+/*****************************************************************************/
+// partitions are block devices in their own right
+//
+UINT64 GetPartitionSize(HANDLE hFile)
+{
+    return GetPhysicalDriveSize(hFile);
+}
+#endif
 
 /*****************************************************************************/
 // structures and global variables
@@ -414,8 +460,10 @@ __declspec(align(4)) static LONG volatile g_lRunningThreadsCount = 0;   //must b
 
 static BOOL volatile g_bRun;                    //used for letting threads know that they should stop working
 
+#ifndef __linux__
 typedef NTSTATUS (__stdcall *NtQuerySysInfo)(SYSTEM_INFORMATION_CLASS, PVOID, ULONG, PULONG);
 static NtQuerySysInfo g_pfnNtQuerySysInfo;
+#endif
 
 typedef VOID (__stdcall *RtlCopyMemNonTemporal)(VOID UNALIGNED *, VOID UNALIGNED *, SIZE_T);
 static RtlCopyMemNonTemporal g_pfnRtlCopyMemoryNonTemporal;
@@ -539,6 +587,10 @@ DWORD WINAPI etwThreadFunc(LPVOID cookie)
 /*****************************************************************************/
 bool IORequestGenerator::_LoadDLLs()
 {
+#ifdef __linux__
+    // nothing to resolve; the ntdll extensions (non-temporal copy, NV flush) are Windows-only
+    return true;
+#else
     _hNTDLL = LoadLibraryExW(L"ntdll.dll", nullptr, 0);
     if( nullptr == _hNTDLL )
     {
@@ -557,9 +609,87 @@ bool IORequestGenerator::_LoadDLLs()
     g_pfnRtlFreeNonVolatileToken = (RtlFreeNvToken)GetProcAddress(_hNTDLL, "RtlFreeNonVolatileToken");
 
     return true;
+#endif
 }
 
 /*****************************************************************************/
+#ifdef __linux__
+bool IORequestGenerator::_GetSystemPerfInfo(vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION>& vSPPI, bool fVerbose) const
+{
+    //
+    // Per-CPU times come from /proc/stat in clock ticks. They are converted to the 100ns units
+    // and Windows conventions the results expect: kernel time includes idle time, and iowait
+    // is counted as idle. Entries are ordered by active processor, as on Windows.
+    //
+
+    const ULONGLONG ullTicksPerSecond = sysconf(_SC_CLK_TCK);
+    vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> vCpus;
+    char szLine[512];
+    FILE *pFile;
+
+    pFile = fopen("/proc/stat", "r");
+    if (pFile == nullptr)
+    {
+        PrintError("get system perf info: unable to open /proc/stat (error code: %u)\n", errno);
+        return false;
+    }
+
+    while (fgets(szLine, sizeof(szLine), pFile) != nullptr)
+    {
+        unsigned int cpu;
+        ULONGLONG user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+
+        if (sscanf(szLine, "cpu%u %llu %llu %llu %llu %llu %llu %llu %llu",
+                   &cpu, &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal) < 5)
+        {
+            continue;
+        }
+
+        if (cpu >= vCpus.size())
+        {
+            vCpus.resize(cpu + 1);
+        }
+
+        SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION& sppi = vCpus[cpu];
+        sppi.IdleTime.QuadPart = (idle + iowait) * 10000000 / ullTicksPerSecond;
+        sppi.UserTime.QuadPart = (user + nice) * 10000000 / ullTicksPerSecond;
+        sppi.DpcTime.QuadPart = softirq * 10000000 / ullTicksPerSecond;
+        sppi.InterruptTime.QuadPart = irq * 10000000 / ullTicksPerSecond;
+        sppi.KernelTime.QuadPart = (system + irq + softirq + steal) * 10000000 / ullTicksPerSecond + sppi.IdleTime.QuadPart;
+    }
+
+    fclose(pFile);
+
+    size_t iCpu = 0;
+    for (const auto& group : g_SystemInformation.processorTopology._vProcessorGroupInformation)
+    {
+        for (BYTE bProc = 0; bProc < group._maximumProcessorCount; bProc++)
+        {
+            if (!group.IsProcessorActive(bProc))
+            {
+                continue;
+            }
+
+            if (iCpu >= vSPPI.size())
+            {
+                assert(false);
+                return false;
+            }
+
+            size_t cpu = (size_t)group._groupNumber * 64 + bProc;
+            if (cpu < vCpus.size())
+            {
+                vSPPI[iCpu] = vCpus[cpu];
+            }
+            iCpu++;
+        }
+    }
+
+    PrintVerbose(fVerbose, "get system perf info: queried %u CPUs\n", (unsigned int)iCpu);
+
+    return true;
+}
+#else
 bool IORequestGenerator::_GetSystemPerfInfo(vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION>& vSPPI, bool fVerbose) const
 {
     NTSTATUS Status;
@@ -635,273 +765,1702 @@ bool IORequestGenerator::_GetSystemPerfInfo(vector<SYSTEM_PROCESSOR_PERFORMANCE_
 
     return true;
 }
+#endif
 
+#ifndef __linux__
 VOID CALLBACK fileIOCompletionRoutine(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED pOverlapped);
+#endif
 
-static bool issueNextIO(ThreadParameters *p, IORequest *pIORequest, DWORD *pdwBytesTransferred, bool useCompletionRoutines)
+//
+// Returns the time latency of the next IO to a target is measured from. Under an open-loop
+// arrival schedule this is when the IO was scheduled to arrive, so that time it spent waiting
+// for an idle request - behind a device which cannot keep up - counts toward its latency.
+//
+static UINT64 issueTime(ThreadParameters *p, size_t iTarget)
 {
-    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
-    Target *pTarget = pIORequest->GetCurrentTarget();
-    size_t iTarget = pIORequest->GetCurrentTargetIndex();
-    UINT32 iRequest = pIORequest->GetRequestIndex();
-    LARGE_INTEGER li;
-    BOOL rslt = true;
-
-    //
-    // Compute next IO
-    //
+    if (p->vThroughputMeters.size() != 0 && p->vThroughputMeters[iTarget].IsArrivalSchedule())
+    {
+        return p->vThroughputMeters[iTarget].GetArrivalTime();
+    }
 
-    p->vTargetStates[iTarget].NextIORequest(*pIORequest);
+    return PerfTimer::GetTime();
+}
 
-    li.LowPart = pIORequest->GetOverlapped()->Offset;
-    li.HighPart = pIORequest->GetOverlapped()->OffsetHigh;
+//
+// When replaying a trace by its timestamps, the next arrival is the time of the next record the
+// thread will issue to the target.
+//
+static void scheduleTraceArrival(ThreadParameters *p, size_t iTarget)
+{
+    UINT64 ullArrival;
 
-    if (TraceLoggingProviderEnabled(g_hEtwProvider,
-                                    TRACE_LEVEL_VERBOSE,
-                                    DISKSPD_TRACE_IO))
+    // an ended trace has no next arrival; the request fails as it takes its next IO
+    if (p->vTargets[iTarget].GetIOMode() == IOMode::Trace && p->vThroughputMeters[iTarget].IsArrivalSchedule() &&
+        p->vTargetStates[iTarget].NextTraceArrival(ullArrival))
     {
-        GUID ActivityId = p->NextActivityId();
-        pIORequest->SetActivityId(ActivityId);
-
-        TraceLoggingWriteActivity(g_hEtwProvider,
-                                  "DiskSpd IO",
-                                  &ActivityId,
-                                  NULL,
-                                  TraceLoggingKeyword(DISKSPD_TRACE_IO),
-                                  TraceLoggingOpcode(EVENT_TRACE_TYPE_START),
-                                  TraceLoggingLevel(TRACE_LEVEL_VERBOSE),
-                                  TraceLoggingUInt32(p->ulThreadNo, "Thread"),
-                                  TraceLoggingString(pIORequest->GetIoType() == IOOperation::ReadIO ? "Read" : "Write", "IO Type"),
-                                  TraceLoggingUInt64(iTarget, "Target"),
-                                  TraceLoggingInt32(pTarget->GetBlockSizeInBytes(), "Block Size"),
-                                  TraceLoggingInt64(li.QuadPart, "Offset"));
+        p->vThroughputMeters[iTarget].ScheduleArrival(ullArrival);
     }
+}
 
-#if 0
-    PrintError("t[%u:%u] issuing %u %s @ %I64u)\n", p->ulThreadNo, iTarget,
-            pTarget->GetBlockSizeInBytes(),
-            (pIORequest->GetIoType() == IOOperation::ReadIO ? "read" : "write"),
-            li.QuadPart);
-#endif
+//
+// Moves the thread to the current point of the timespan's load phase schedule (-H). The run's
+// rate is applied to the limit the threads share once it moves by more than 1/1024 of the rate
+// last applied, so that a rate varying continuously is not written by every IO of every thread.
+//
+static void updatePhase(ThreadParameters *p)
+{
+    UINT64 ullNow = PerfTimer::GetTime();
+    UINT64 ullStartTime = *(p->pullStartTime);
+    double lfMilliseconds = 0;
 
-    if (p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev())
+    // the schedule starts with the measured interval; warmup runs at its start
+    if (ullStartTime != 0 && ullNow > ullStartTime)
     {
-        pIORequest->SetStartTime(PerfTimer::GetTime());
+        lfMilliseconds = PerfTimer::PerfTimeToMilliseconds(ullNow - ullStartTime);
     }
 
-    if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    double lfLastIOPS = p->phaseState.lfIOPS;
+    p->pPhaseSchedule->GetState(lfMilliseconds, &p->phaseState);
+
+    if (p->pPhaseRateLimit != nullptr)
     {
-        if (pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+        double lfIOPS = p->phaseState.lfIOPS;
+
+        if ((lfIOPS == 0) != (lfLastIOPS == 0) || fabs(lfIOPS - lfLastIOPS) * 1024 > lfLastIOPS)
         {
-            if (pTarget->GetWriteThroughMode() == WriteThroughMode::On )
-            {
-                g_pfnRtlCopyMemoryNonTemporal(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes());
-            }
-            else
-            {
-                memcpy(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes());
-            }
-            *pdwBytesTransferred = pTarget->GetBlockSizeInBytes();
+            p->pPhaseRateLimit->SetRate(lfIOPS / 1000);
         }
         else
         {
-            if (useCompletionRoutines)
-            {
-                rslt = ReadFileEx(p->vhTargets[iTarget], p->GetReadBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pOverlapped, fileIOCompletionRoutine);
-            }
-            else
-            {
-                rslt = ReadFile(p->vhTargets[iTarget], p->GetReadBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pdwBytesTransferred, pOverlapped);
-            }
+            p->phaseState.lfIOPS = lfLastIOPS;
         }
     }
-    else
+}
+
+//
+// Whether the request's next IO can be issued now: the current load phase (-H) leaves room for it
+// under the phase's outstanding IOs, given cInFlight of the thread's other requests are, and its
+// target's throughput meter is ready. If not, the sleep time is how long until it can be; INFINITE
+// if only a completion can make room.
+//
+static bool isReadyToIssue(ThreadParameters *p, IORequest *pIORequest, size_t cInFlight, DWORD *pdwSleepTime)
+{
+    if (p->pPhaseSchedule != nullptr)
     {
-        if (pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
-        {
-            if (pTarget->GetWriteThroughMode() == WriteThroughMode::On)
-            {
-                g_pfnRtlCopyMemoryNonTemporal(pTarget->GetMappedView() + li.QuadPart, p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes());
-            }
-            else
-            {
-                memcpy(pTarget->GetMappedView() + li.QuadPart, p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes());
+        updatePhase(p);
 
-                switch (pTarget->GetMemoryMappedIoFlushMode())
-                {
-                    case MemoryMappedIoFlushMode::ViewOfFile:
-                        FlushViewOfFile(pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes());
-                        break;
-                    case MemoryMappedIoFlushMode::NonVolatileMemory:
-                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes(), 0);
-                        break;
-                    case MemoryMappedIoFlushMode::NonVolatileMemoryNoDrain:
-                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, pTarget->GetBlockSizeInBytes(), FLUSH_NV_MEMORY_IN_FLAG_NO_DRAIN);
-                        break;
-                }
-            }
-            *pdwBytesTransferred = pTarget->GetBlockSizeInBytes();
-        }
-        else
+        if (p->phaseState.ulQueueDepth != 0 && cInFlight >= p->phaseState.ulQueueDepth)
         {
-            if (useCompletionRoutines)
-            {
-                rslt = WriteFileEx(p->vhTargets[iTarget], p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pOverlapped, fileIOCompletionRoutine);
-            }
-            else
-            {
-                rslt = WriteFile(p->vhTargets[iTarget], p->GetWriteBuffer(iTarget, iRequest), pTarget->GetBlockSizeInBytes(), pdwBytesTransferred, pOverlapped);
-            }
+            *pdwSleepTime = INFINITE;
+            return false;
         }
     }
 
-    if (p->vThroughputMeters.size() != 0 && p->vThroughputMeters[iTarget].IsRunning())
+    if (p->vThroughputMeters.size() != 0)
     {
-        p->vThroughputMeters[iTarget].Adjust(pTarget->GetBlockSizeInBytes());
+        ThroughputMeter *pThroughputMeter = &p->vThroughputMeters[pIORequest->GetCurrentTargetIndex()];
+
+        if (pThroughputMeter->IsRunning() && !pThroughputMeter->IsReady(pdwSleepTime))
+        {
+            return false;
+        }
     }
 
-    return (rslt) ? true : false;
+    return true;
 }
 
-
-void completeIOat(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytesTransferred, UINT64 ullCompletionTime)
+//
+// Sleeps while all of the thread's requests are throttled. Statistics the thread has not yet
+// published for interval reporting (-U) are published first, rather than held back for the sleep.
+//
+static void throttleSleep(ThreadParameters *p, DWORD dwMilliseconds)
 {
-    if (*p->pfAccountingOn)
+    if (p->pTimeSpan->GetReportIntervalInMilliseconds())
     {
-        p->pResults->vTargetResults[pIORequest->GetCurrentTargetIndex()].Add(
-            dwBytesTransferred,
-            pIORequest->GetIoType(),
-            pIORequest->GetStartTime(),
-            ullCompletionTime,
-            *(p->pullStartTime),
-            p->pTimeSpan->GetMeasureLatency(),
-            p->pTimeSpan->GetCalculateIopsStdDev());
+        p->pResults->threadStatistics.PublishPending();
     }
 
-    if (TraceLoggingProviderEnabled(g_hEtwProvider,
-                                    TRACE_LEVEL_VERBOSE,
-                                    DISKSPD_TRACE_IO))
-    {
-        GUID ActivityId = pIORequest->GetActivityId();
+    p->pResults->WaitStats.ThrottleSleep += 1;
+    Sleep(dwMilliseconds);
+}
 
-        TraceLoggingWriteActivity(g_hEtwProvider,
-                                  "DiskSpd IO",
-                                  &ActivityId,
-                                  NULL,
-                                  TraceLoggingKeyword(DISKSPD_TRACE_IO),
-                                  TraceLoggingOpcode(EVENT_TRACE_TYPE_STOP),
-                                  TraceLoggingLevel(TRACE_LEVEL_VERBOSE));
+static const char *ioTypeName(IOOperation type)
+{
+    switch (type)
+    {
+    case IOOperation::ReadIO:
+        return "read";
+    case IOOperation::WriteIO:
+        return "write";
+    case IOOperation::FlushIO:
+        return "flush";
+    case IOOperation::TrimIO:
+        return "trim";
+    case IOOperation::MetadataIO:
+        return "metadata";
+    default:
+        return "unknown";
     }
+}
 
-    Target *pTarget = pIORequest->GetCurrentTarget();
+//
+// File sets (-m) direct each IO to one of the target's files. The files are held open for the
+// run, unless they are opened per IO (-mo): the open before the IO and the close after it are
+// then accounted as metadata operations, and are outside the IO's own latency.
+//
+static HANDLE ioHandle(const ThreadParameters *p, IORequest *pIORequest)
+{
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
 
-    //check if I/O transferred all of the requested bytes
-    if (dwBytesTransferred != pTarget->GetBlockSizeInBytes())
+    if (pIORequest->GetFileHandle() != INVALID_HANDLE_VALUE)
     {
-        PrintError("Warning: thread %u transferred %u bytes instead of %u bytes\n",
-            p->ulThreadNo,
-            dwBytesTransferred,
-            pTarget->GetBlockSizeInBytes());
+        return pIORequest->GetFileHandle();
     }
 
-    // check if we should print a progress dot
-    if (p->pProfile->GetProgress() != 0)
+    if (!p->vFileSets[iTarget].vhFiles.empty())
     {
-        DWORD dwIOCnt = ++p->dwIOCnt;
-        if (dwIOCnt % p->pProfile->GetProgress() == 0)
-        {
-            printf(".");
-        }
+        return p->vFileSets[iTarget].vhFiles[pIORequest->GetFileIndex()];
     }
+
+    return p->vhTargets[iTarget];
 }
 
-void completeIO(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytesTransferred)
+static void accountMetadataOp(ThreadParameters *p, size_t iTarget, MetadataOp op, UINT64 ullStartTime)
 {
-    if (p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev())
+    if (*p->pfAccountingOn)
     {
-        completeIOat(p, pIORequest, dwBytesTransferred, PerfTimer::GetTime());
+        bool fMeasureLatency = p->pTimeSpan->GetMeasureLatency();
+
+        p->pResults->vTargetResults[iTarget].AddMetadata(op, ullStartTime, fMeasureLatency ? PerfTimer::GetTime() : 0, fMeasureLatency);
     }
-    else
+}
+
+static bool openFileForIO(ThreadParameters *p, IORequest *pIORequest)
+{
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+    const FileSetState& fileSet = p->vFileSets[iTarget];
+    UINT64 ullStartTime = p->pTimeSpan->GetMeasureLatency() ? PerfTimer::GetTime() : 0;
+
+    HANDLE hFile = CreateFile(p->vTargets[iTarget].GetFileSetFilePath(pIORequest->GetFileIndex()).c_str(),
+        fileSet.dwDesiredAccess,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,        //security
+        OPEN_EXISTING,
+        fileSet.dwFlags,
+        nullptr);       //template file
+    if (INVALID_HANDLE_VALUE == hFile)
     {
-        completeIOat(p, pIORequest, dwBytesTransferred, 0);
+        return false;
+    }
+
+#ifndef __linux__
+    if (p->hCompletionPort != nullptr && CreateIoCompletionPort(hFile, p->hCompletionPort, 0, 1) == nullptr)
+    {
+        DWORD dwError = GetLastError();
+        CloseHandle(hFile);
+        SetLastError(dwError);
+        return false;
+    }
+#endif
+
+    pIORequest->SetFileHandle(hFile);
+    accountMetadataOp(p, iTarget, MetadataOp::Open, ullStartTime);
+
+    return true;
+}
+
+static void closeFileForIO(ThreadParameters *p, IORequest *pIORequest)
+{
+    UINT64 ullStartTime = p->pTimeSpan->GetMeasureLatency() ? PerfTimer::GetTime() : 0;
+
+    CloseHandle(pIORequest->GetFileHandle());
+    pIORequest->SetFileHandle(INVALID_HANDLE_VALUE);
+    accountMetadataOp(p, pIORequest->GetCurrentTargetIndex(), MetadataOp::Close, ullStartTime);
+}
+
+// closes the file opened for an IO which then failed to issue, keeping the IO's error
+static void abandonFileForIO(ThreadParameters *p, IORequest *pIORequest)
+{
+    if (pIORequest->GetFileHandle() != INVALID_HANDLE_VALUE)
+    {
+        DWORD dwError = GetLastError();
+        closeFileForIO(p, pIORequest);
+        SetLastError(dwError);
     }
 }
 
-/*****************************************************************************/
-// function called from worker thread
-// performs synch I/O
 //
-static bool doWorkUsingSynchronousIO(ThreadParameters *p)
+// Metadata operations (-mm) are issued synchronously by all engines. Stats are of the files of
+// the set; creates, renames and unlinks act on scratch files of the thread's own in the set's
+// directory, so that the set itself is left as it is. Their names are unique to the process,
+// thread and target, so that neither other runs in the same directory nor scratch files left by
+// a run which did not finish get in the way. A rename or unlink with no scratch file to act on is
+// made a create.
+//
+static BOOL issueMetadataIO(ThreadParameters *p, IORequest *pIORequest)
 {
-    BOOL fOk = true;
-    BOOL rslt = FALSE;
-    DWORD dwBytesTransferred;
-    size_t cIORequests = p->vIORequest.size();
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+    const Target& target = p->vTargets[iTarget];
+    FileSetState& fileSet = p->vFileSets[iTarget];
+    BOOL rslt = TRUE;
+
+    if (fileSet.dqScratchFiles.empty() &&
+        (pIORequest->GetMetadataOp() == MetadataOp::Unlink || pIORequest->GetMetadataOp() == MetadataOp::Rename))
+    {
+        pIORequest->SetMetadataOp(MetadataOp::Create);
+    }
+
+    string sScratchFile;
+    if (pIORequest->GetMetadataOp() == MetadataOp::Create || pIORequest->GetMetadataOp() == MetadataOp::Rename)
+    {
+        char szName[96];
+
+        sprintf_s(szName, _countof(szName), "scratch-%u-%u-%zu-%llu.tmp", GetCurrentProcessId(), p->ulThreadNo, iTarget, fileSet.ullNextScratchFile++);
+        sScratchFile = target.GetFileSetFilePath(szName);
+    }
+
+    switch (pIORequest->GetMetadataOp())
+    {
+    case MetadataOp::Create:
+    {
+        HANDLE hFile = CreateFile(sScratchFile.c_str(),
+            GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr,        //security
+            CREATE_NEW,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);       //template file
+        rslt = (INVALID_HANDLE_VALUE != hFile);
+        if (rslt)
+        {
+            CloseHandle(hFile);
+            fileSet.dqScratchFiles.push_back(sScratchFile);
+        }
+        break;
+    }
+    case MetadataOp::Stat:
+        rslt = (GetFileAttributes(target.GetFileSetFilePath(pIORequest->GetFileIndex()).c_str()) != INVALID_FILE_ATTRIBUTES);
+        break;
+    case MetadataOp::Unlink:
+        rslt = DeleteFile(fileSet.dqScratchFiles.front().c_str());
+        if (rslt)
+        {
+            fileSet.dqScratchFiles.pop_front();
+        }
+        break;
+    case MetadataOp::Rename:
+        rslt = MoveFile(fileSet.dqScratchFiles.front().c_str(), sScratchFile.c_str());
+        if (rslt)
+        {
+            fileSet.dqScratchFiles.pop_front();
+            fileSet.dqScratchFiles.push_back(sScratchFile);
+        }
+        break;
+    default:
+        assert(false);
+        break;
+    }
+
+    return rslt;
+}
+
+//
+// Trims (-wt) discard the request's range of the target. They carry no data, so the range is
+// accounted as the bytes trimmed.
+//
+#ifdef __linux__
+// Neither Linux AIO nor io_uring has a discard operation for disks, and Linux AIO has none for
+// files either, so those trims are issued synchronously and complete as they return. io_uring
+// punches holes in files asynchronously instead (see prepareNextIoUringIO).
+static BOOL issueTrimIO(ThreadParameters *p, IORequest *pIORequest)
+{
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    int fd = (int)(intptr_t)ioHandle(p, pIORequest);
+    UINT64 ullOffset = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+    int ret;
+
+    if (p->vfDeviceTargets[iTarget])
+    {
+        UINT64 range[2] = { ullOffset, pIORequest->GetBlockSize() };
+        ret = ioctl(fd, BLKDISCARD, range);
+    }
+    else
+    {
+        ret = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, ullOffset, pIORequest->GetBlockSize());
+    }
+
+    if (ret != 0)
+    {
+        SetLastError(errno);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+#else
+// Trims complete through the completion port as other IO does: disks and partitions take a
+// storage trim, files a file level trim. Both requests are buffered, so the input need only
+// last for the call.
+static BOOL issueTrimIO(ThreadParameters *p, IORequest *pIORequest, DWORD *pdwBytesTransferred)
+{
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    UINT64 ullOffset = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+
+    if (p->vfDeviceTargets[iTarget])
+    {
+        struct
+        {
+            DEVICE_MANAGE_DATA_SET_ATTRIBUTES attributes;
+            DEVICE_DATA_SET_RANGE range;
+        } trim = {};
+
+        trim.attributes.Size = sizeof(trim.attributes);
+        trim.attributes.Action = DeviceDsmAction_Trim;
+        trim.attributes.DataSetRangesOffset = offsetof(decltype(trim), range);
+        trim.attributes.DataSetRangesLength = sizeof(trim.range);
+        trim.range.StartingOffset = ullOffset;
+        trim.range.LengthInBytes = pIORequest->GetBlockSize();
+
+        return DeviceIoControl(ioHandle(p, pIORequest), IOCTL_STORAGE_MANAGE_DATA_SET_ATTRIBUTES, &trim, sizeof(trim), nullptr, 0, pdwBytesTransferred, pOverlapped);
+    }
+
+    FILE_LEVEL_TRIM trim = {};
+    trim.NumRanges = 1;
+    trim.Ranges[0].Offset = ullOffset;
+    trim.Ranges[0].Length = pIORequest->GetBlockSize();
+
+    return DeviceIoControl(ioHandle(p, pIORequest), FSCTL_FILE_LEVEL_TRIM, &trim, sizeof(trim), nullptr, 0, pdwBytesTransferred, pOverlapped);
+}
+#endif
+
+//
+// Data verification (-Zv): a write stamps the units of its buffer, and a read notes the state of
+// the units it covers, as the IO is issued. Both are accounted to the target's generation map as
+// the IO completes, at which point the read checks what it found.
+//
+static void beginVerify(IORequest *pIORequest, BYTE *pWriteBuffer)
+{
+    DataVerifier *pVerifier = pIORequest->GetCurrentTarget()->GetVerifier();
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    UINT64 ullOffset = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+
+    if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        pVerifier->BeginRead(ullOffset, pIORequest->GetBlockSize(), pIORequest->GetVerifySnapshot());
+    }
+    else
+    {
+        pVerifier->BeginWrite(pWriteBuffer, ullOffset, pIORequest->GetBlockSize());
+    }
+}
+
+static void endVerify(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytesTransferred)
+{
+    DataVerifier *pVerifier = pIORequest->GetCurrentTarget()->GetVerifier();
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    UINT64 ullOffset = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+
+    if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        TargetResults& targetResults = p->pResults->vTargetResults[iTarget];
+
+        targetResults.ullVerifyErrorCount += pVerifier->EndRead(p->GetReadBuffer(iTarget, pIORequest->GetRequestIndex()),
+                                                                ullOffset,
+                                                                dwBytesTransferred,
+                                                                pIORequest->GetVerifySnapshot(),
+                                                                &targetResults.ullVerifiedCount);
+    }
+    else
+    {
+        pVerifier->EndWrite(ullOffset, pIORequest->GetBlockSize());
+    }
+}
+
+static bool issueNextIO(ThreadParameters *p, IORequest *pIORequest, DWORD *pdwBytesTransferred, bool useCompletionRoutines)
+{
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    Target *pTarget = pIORequest->GetCurrentTarget();
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+    UINT32 iRequest = pIORequest->GetRequestIndex();
+    LARGE_INTEGER li;
+    BOOL rslt = true;
+
+    //
+    // Compute next IO
+    //
+
+    if (!p->vTargetStates[iTarget].NextIORequest(*pIORequest))
+    {
+        SetLastError(ERROR_HANDLE_EOF);
+        return false;
+    }
+
+    li.LowPart = pIORequest->GetOverlapped()->Offset;
+    li.HighPart = pIORequest->GetOverlapped()->OffsetHigh;
+
+    if (TraceLoggingProviderEnabled(g_hEtwProvider,
+                                    TRACE_LEVEL_VERBOSE,
+                                    DISKSPD_TRACE_IO))
+    {
+        GUID ActivityId = p->NextActivityId();
+        pIORequest->SetActivityId(ActivityId);
+
+        TraceLoggingWriteActivity(g_hEtwProvider,
+                                  "DiskSpd IO",
+                                  &ActivityId,
+                                  NULL,
+                                  TraceLoggingKeyword(DISKSPD_TRACE_IO),
+                                  TraceLoggingOpcode(EVENT_TRACE_TYPE_START),
+                                  TraceLoggingLevel(TRACE_LEVEL_VERBOSE),
+                                  TraceLoggingUInt32(p->ulThreadNo, "Thread"),
+                                  TraceLoggingString(ioTypeName(pIORequest->GetIoType()), "IO Type"),
+                                  TraceLoggingUInt64(iTarget, "Target"),
+                                  TraceLoggingInt32(pIORequest->GetBlockSize(), "Block Size"),
+                                  TraceLoggingInt64(li.QuadPart, "Offset"));
+    }
+
+#if 0
+    PrintError("t[%u:%u] issuing %u %s @ %llu)\n", p->ulThreadNo, iTarget,
+            pIORequest->GetBlockSize(),
+            ioTypeName(pIORequest->GetIoType()),
+            li.QuadPart);
+#endif
+
+    // a file opened per IO is opened before the IO's start time is taken
+    if (pTarget->GetOpenPerIO() && pIORequest->GetIoType() != IOOperation::MetadataIO)
+    {
+        if (!openFileForIO(p, pIORequest))
+        {
+            return false;
+        }
+    }
+
+    HANDLE hFile = ioHandle(p, pIORequest);
+
+    // the write buffer is filled as it is taken, so it is taken once
+    BYTE *pWriteBuffer = nullptr;
+    if (pIORequest->GetIoType() == IOOperation::WriteIO)
+    {
+        pWriteBuffer = p->GetWriteBuffer(iTarget, iRequest);
+    }
+
+    // flushes carry no data to verify
+    if (pTarget->GetVerifier() != nullptr && pIORequest->GetIoType() != IOOperation::FlushIO)
+    {
+        beginVerify(pIORequest, pWriteBuffer);
+    }
+
+    if (p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev())
+    {
+        pIORequest->SetStartTime(issueTime(p, iTarget));
+    }
+
+#ifdef __linux__
+    // memory mapped IO and completion routines are rejected during validation
+    UNREFERENCED_PARAMETER(useCompletionRoutines);
+
+    if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        rslt = ReadFile(hFile, p->GetReadBuffer(iTarget, iRequest), pIORequest->GetBlockSize(), pdwBytesTransferred, pOverlapped);
+    }
+    else if (pIORequest->GetIoType() == IOOperation::MetadataIO)
+    {
+        rslt = issueMetadataIO(p, pIORequest);
+        *pdwBytesTransferred = 0;
+    }
+    else if (pIORequest->GetIoType() == IOOperation::TrimIO)
+    {
+        rslt = issueTrimIO(p, pIORequest);
+        *pdwBytesTransferred = 0;
+    }
+    else if (pIORequest->GetIoType() == IOOperation::FlushIO)
+    {
+        // a flush need not write back file metadata which a later read does not depend on
+        rslt = (fdatasync((int)(intptr_t)hFile) == 0);
+        if (!rslt)
+        {
+            SetLastError(errno);
+        }
+        *pdwBytesTransferred = 0;
+    }
+    else if (pIORequest->GetFua())
+    {
+        struct iovec iov = { pWriteBuffer, pIORequest->GetBlockSize() };
+        ssize_t cb = pwritev2((int)(intptr_t)hFile, &iov, 1, ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset, RWF_DSYNC);
+        rslt = (cb >= 0);
+        if (!rslt)
+        {
+            SetLastError(errno);
+        }
+        *pdwBytesTransferred = rslt ? (DWORD)cb : 0;
+    }
+    else
+    {
+        rslt = WriteFile(hFile, pWriteBuffer, pIORequest->GetBlockSize(), pdwBytesTransferred, pOverlapped);
+    }
+#else
+    if (pIORequest->GetIoType() == IOOperation::MetadataIO)
+    {
+        // metadata operations are rejected with completion routines during validation, and complete synchronously
+        rslt = issueMetadataIO(p, pIORequest);
+        *pdwBytesTransferred = 0;
+    }
+    else if (pIORequest->GetIoType() == IOOperation::FlushIO)
+    {
+        // flushes are rejected with memory mapped IO and completion routines during validation, and complete synchronously
+        rslt = FlushFileBuffers(hFile);
+        *pdwBytesTransferred = 0;
+    }
+    else if (pIORequest->GetIoType() == IOOperation::TrimIO)
+    {
+        // trims are rejected with memory mapped IO and completion routines during validation
+        rslt = issueTrimIO(p, pIORequest, pdwBytesTransferred);
+    }
+    else if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        if (pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+        {
+            if (pTarget->GetWriteThroughMode() == WriteThroughMode::On )
+            {
+                g_pfnRtlCopyMemoryNonTemporal(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, pIORequest->GetBlockSize());
+            }
+            else
+            {
+                memcpy(p->GetReadBuffer(iTarget, iRequest), pTarget->GetMappedView() + li.QuadPart, pIORequest->GetBlockSize());
+            }
+            *pdwBytesTransferred = pIORequest->GetBlockSize();
+        }
+        else
+        {
+            if (useCompletionRoutines)
+            {
+                rslt = ReadFileEx(hFile, p->GetReadBuffer(iTarget, iRequest), pIORequest->GetBlockSize(), pOverlapped, fileIOCompletionRoutine);
+            }
+            else
+            {
+                rslt = ReadFile(hFile, p->GetReadBuffer(iTarget, iRequest), pIORequest->GetBlockSize(), pdwBytesTransferred, pOverlapped);
+            }
+        }
+    }
+    else
+    {
+        if (pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+        {
+            if (pTarget->GetWriteThroughMode() == WriteThroughMode::On)
+            {
+                g_pfnRtlCopyMemoryNonTemporal(pTarget->GetMappedView() + li.QuadPart, pWriteBuffer, pIORequest->GetBlockSize());
+            }
+            else
+            {
+                memcpy(pTarget->GetMappedView() + li.QuadPart, pWriteBuffer, pIORequest->GetBlockSize());
+
+                switch (pTarget->GetMemoryMappedIoFlushMode())
+                {
+                    case MemoryMappedIoFlushMode::ViewOfFile:
+                        FlushViewOfFile(pTarget->GetMappedView() + li.QuadPart, pIORequest->GetBlockSize());
+                        break;
+                    case MemoryMappedIoFlushMode::NonVolatileMemory:
+                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, pIORequest->GetBlockSize(), 0);
+                        break;
+                    case MemoryMappedIoFlushMode::NonVolatileMemoryNoDrain:
+                        g_pfnRtlFlushNonVolatileMemory(pTarget->GetMemoryMappedIoNvToken(), pTarget->GetMappedView() + li.QuadPart, pIORequest->GetBlockSize(), FLUSH_NV_MEMORY_IN_FLAG_NO_DRAIN);
+                        break;
+                }
+            }
+            *pdwBytesTransferred = pIORequest->GetBlockSize();
+        }
+        else
+        {
+            if (useCompletionRoutines)
+            {
+                rslt = WriteFileEx(hFile, pWriteBuffer, pIORequest->GetBlockSize(), pOverlapped, fileIOCompletionRoutine);
+            }
+            else
+            {
+                rslt = WriteFile(hFile, pWriteBuffer, pIORequest->GetBlockSize(), pdwBytesTransferred, pOverlapped);
+            }
+        }
+    }
+#endif
+
+    if (p->vThroughputMeters.size() != 0 && p->vThroughputMeters[iTarget].IsRunning())
+    {
+        p->vThroughputMeters[iTarget].Adjust(pIORequest->GetIoType() == IOOperation::TrimIO ? 0 : pIORequest->GetBlockSize());
+        scheduleTraceArrival(p, iTarget);
+    }
+
+#ifdef __linux__
+    if (!rslt)
+#else
+    if (!rslt && GetLastError() != ERROR_IO_PENDING)
+#endif
+    {
+        abandonFileForIO(p, pIORequest);
+    }
+
+    return (rslt) ? true : false;
+}
+
+
+void completeIOat(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytesTransferred, UINT64 ullCompletionTime)
+{
+    // trims transfer nothing; they are accounted the range they discarded
+    if (pIORequest->GetIoType() == IOOperation::TrimIO)
+    {
+        dwBytesTransferred = pIORequest->GetBlockSize();
+    }
+
+    if (pIORequest->GetCurrentTarget()->GetVerifier() != nullptr && pIORequest->GetIoType() != IOOperation::FlushIO)
+    {
+        endVerify(p, pIORequest, dwBytesTransferred);
+    }
+
+    if (*p->pfAccountingOn)
+    {
+        // IO is accounted to the load phase it completed in
+        size_t iPhase = 0;
+        if (p->pPhaseSchedule != nullptr)
+        {
+            UINT64 ullTime = ullCompletionTime ? ullCompletionTime : PerfTimer::GetTime();
+            iPhase = p->pPhaseSchedule->GetPhase(ullTime > *(p->pullStartTime) ? PerfTimer::PerfTimeToMilliseconds(ullTime - *(p->pullStartTime)) : 0);
+        }
+
+        if (pIORequest->GetIoType() == IOOperation::MetadataIO)
+        {
+            p->pResults->vTargetResults[pIORequest->GetCurrentTargetIndex()].AddMetadata(
+                pIORequest->GetMetadataOp(),
+                pIORequest->GetStartTime(),
+                ullCompletionTime,
+                p->pTimeSpan->GetMeasureLatency());
+        }
+        else
+        {
+            p->pResults->vTargetResults[pIORequest->GetCurrentTargetIndex()].Add(
+                dwBytesTransferred,
+                pIORequest->GetIoType(),
+                pIORequest->GetStartTime(),
+                ullCompletionTime,
+                *(p->pullStartTime),
+                p->pTimeSpan->GetMeasureLatency(),
+                p->pTimeSpan->GetCalculateIopsStdDev(),
+                pIORequest->GetBlockSizeIndex(),
+                iPhase,
+                pIORequest->GetFua());
+        }
+
+        if (p->pIoTraceRing != nullptr)
+        {
+            IoTraceRecord record;
+            record.llIssueTime = static_cast<INT64>(pIORequest->GetStartTime() - *(p->pullStartTime));
+            record.llCompletionTime = static_cast<INT64>(ullCompletionTime - *(p->pullStartTime));
+            record.ullOffset = (static_cast<UINT64>(pIORequest->GetOverlapped()->OffsetHigh) << 32) | pIORequest->GetOverlapped()->Offset;
+            record.ulLength = dwBytesTransferred;
+            record.ulThread = p->ulThreadNo;
+            record.ulTarget = static_cast<UINT32>(pIORequest->GetCurrentTargetIndex());
+            record.ulIoType = static_cast<UINT32>(pIORequest->GetIoType());
+
+            p->pIoTraceRing->Push(record);
+        }
+
+        if (p->pTimeSpan->GetReportIntervalInMilliseconds())
+        {
+            UINT64 ullLatencyNs = 0;
+            if (p->pTimeSpan->GetMeasureLatency())
+            {
+                ullLatencyNs = static_cast<UINT64>(PerfTimer::PerfTimeToMicroseconds(ullCompletionTime - pIORequest->GetStartTime()) * 1000);
+            }
+
+            p->pResults->threadStatistics.Add(pIORequest->GetIoType(), dwBytesTransferred, ullLatencyNs, p->pTimeSpan->GetMeasureLatency());
+        }
+    }
+
+    if (TraceLoggingProviderEnabled(g_hEtwProvider,
+                                    TRACE_LEVEL_VERBOSE,
+                                    DISKSPD_TRACE_IO))
+    {
+        GUID ActivityId = pIORequest->GetActivityId();
+
+        TraceLoggingWriteActivity(g_hEtwProvider,
+                                  "DiskSpd IO",
+                                  &ActivityId,
+                                  NULL,
+                                  TraceLoggingKeyword(DISKSPD_TRACE_IO),
+                                  TraceLoggingOpcode(EVENT_TRACE_TYPE_STOP),
+                                  TraceLoggingLevel(TRACE_LEVEL_VERBOSE));
+    }
+
+    //check if I/O transferred all of the requested bytes
+    if (dwBytesTransferred != pIORequest->GetBlockSize())
+    {
+        PrintError("Warning: thread %u transferred %u bytes instead of %u bytes\n",
+            p->ulThreadNo,
+            dwBytesTransferred,
+            pIORequest->GetBlockSize());
+    }
+
+    if (pIORequest->GetFileHandle() != INVALID_HANDLE_VALUE)
+    {
+        closeFileForIO(p, pIORequest);
+    }
+
+    // check if we should print a progress dot
+    if (p->pProfile->GetProgress() != 0)
+    {
+        DWORD dwIOCnt = ++p->dwIOCnt;
+        if (dwIOCnt % p->pProfile->GetProgress() == 0)
+        {
+            printf(".");
+        }
+    }
+}
+
+//
+// Timestamps a completion from an asynchronous engine's completion queue with the time it was first
+// seen (ullSeen). The IO may have finished at any point since the queue was last polled without it
+// (ullLastPoll), or since it was issued if that is later. That interval bounds the error of the
+// timestamp and is accumulated in the wait statistics.
+//
+// io_uring completions are seen individually as the completion ring is polled. Completion ports and
+// Linux AIO return completions in batches, and every completion of a batch is seen when the batch
+// is reaped.
+//
+UINT64 timestampCompletion(ThreadParameters *p, IORequest *pIORequest, UINT64 ullLastPoll, UINT64 ullSeen)
+{
+    UINT64 ullCompletionTime = ullSeen;
+    UINT64 ullEarliest = max(pIORequest->GetStartTime(), ullLastPoll);
+    WAIT_STATS *pWaitStats = &p->pResults->WaitStats;
+
+    if (ullCompletionTime > ullEarliest)
+    {
+        UINT64 ullError = ullCompletionTime - ullEarliest;
+
+        pWaitStats->CompletionTimeError += ullError;
+        if (ullError > pWaitStats->CompletionTimeErrorMax)
+        {
+            pWaitStats->CompletionTimeErrorMax = ullError;
+        }
+    }
+    pWaitStats->CompletionTimeCount += 1;
+
+    return ullCompletionTime;
+}
+
+void completeIO(ThreadParameters *p, IORequest *pIORequest, DWORD dwBytesTransferred)
+{
+    if (p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev())
+    {
+        completeIOat(p, pIORequest, dwBytesTransferred, PerfTimer::GetTime());
+    }
+    else
+    {
+        completeIOat(p, pIORequest, dwBytesTransferred, 0);
+    }
+}
+
+/*****************************************************************************/
+// function called from worker thread
+// performs synch I/O
+//
+static bool doWorkUsingSynchronousIO(ThreadParameters *p)
+{
+    BOOL fOk = true;
+    BOOL rslt = FALSE;
+    DWORD dwBytesTransferred;
+    size_t cIORequests = p->vIORequest.size();
+    bool fThrottle = (p->vThroughputMeters.size() != 0 || p->pPhaseSchedule != nullptr);
+
+    while(g_bRun && !g_bThreadError)
+    {
+        DWORD nIssued = 0;
+        DWORD dwMinSleepTime = INFINITE;
+        for (size_t i = 0; i < cIORequests; i++)
+        {
+            IORequest *pIORequest = &p->vIORequest[i];
+            (void) pIORequest->GetNextTarget();
+
+            // synchronous IO has none in flight while the next is considered
+            DWORD dwSleepTime;
+            if (fThrottle && !isReadyToIssue(p, pIORequest, 0, &dwSleepTime))
+            {
+                dwMinSleepTime = min(dwMinSleepTime, dwSleepTime);
+                continue;
+            }
+
+            nIssued += 1;
+            rslt = issueNextIO(p, pIORequest, &dwBytesTransferred, false);
+
+            if (!rslt)
+            {
+                PrintError("t[%u] error during %s error code: %u)\n", (UINT32)i, ioTypeName(pIORequest->GetIoType()), GetLastError());
+                fOk = false;
+                goto cleanup;
+            }
+
+            completeIO(p, pIORequest, dwBytesTransferred);
+        }
+
+        // if no IOs were issued, wait for the next scheduling time
+        if (!nIssued && dwMinSleepTime != INFINITE && dwMinSleepTime != 0)
+        {
+            throttleSleep(p, dwMinSleepTime);
+        }
+
+        assert(!g_bError);  // at this point we shouldn't be seeing initialization error
+    }
+
+cleanup:
+    return fOk;
+}
+
+#ifndef __linux__
+/*****************************************************************************/
+// function called from worker thread
+// performs asynch I/O using IO Completion Ports
+//
+static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletionPort)
+{
+    assert(nullptr != p);
+    assert(nullptr != hCompletionPort);
+
+    BOOL fOk = true;
+    BOOL rslt = FALSE;
+    DWORD dwBytesTransferred;
+    OverlappedQueue overlappedQueue;
+    size_t cIORequests = p->vIORequest.size();
+    BOOL fLatencyStats = p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev();
+    UINT64 ullLastPoll = 0;     // when the completion queue was polled before the current poll
+    UINT64 ullThisPoll = 0;
+
+    for (size_t i = 0; i < cIORequests; i++)
+    {
+        overlappedQueue.Add(p->vIORequest[i].GetOverlapped());
+    }
+
+    //
+    // perform work
+    //
+    DWORD dwMinSleepTime = INFINITE;
+    DWORD dwWaitTime;
+
+    OVERLAPPED_ENTRY ovlEntry[16];
+    const ULONG cOvlEntryMax = _countof(ovlEntry) < (ULONG)cIORequests ? _countof(ovlEntry) : (ULONG)cIORequests;
+    ULONG cCompleted;
+    size_t cUntilThrottle = cIORequests;
+    bool fThrottle = (p->vThroughputMeters.size() != 0 || p->pPhaseSchedule != nullptr);
+
+    while(g_bRun && !g_bThreadError)
+    {
+        OVERLAPPED *pReadyOverlapped = overlappedQueue.Remove();
+        IORequest *pIORequest = IORequest::OverlappedToIORequest(pReadyOverlapped);
+        (void) pIORequest->GetNextTarget();
+
+        // check throttles
+        if (fThrottle)
+        {
+            cUntilThrottle -= 1;
+
+            // the requests not in the queue, less this one, are in flight
+            DWORD dwSleepTime;
+            if (!isReadyToIssue(p, pIORequest, cIORequests - overlappedQueue.GetCount() - 1, &dwSleepTime))
+            {
+                dwMinSleepTime = min(dwMinSleepTime, dwSleepTime);
+                overlappedQueue.Add(pReadyOverlapped);
+
+                // continue if throttle not hit
+                if (cUntilThrottle)
+                {
+                    continue;
+                }
+
+                // at throttle, no IO to dispatch
+                pIORequest = NULL;
+            }
+        }
+
+        // dispatch IO - skipped iff at throttle
+        if (pIORequest)
+        {
+            rslt = issueNextIO(p, pIORequest, &dwBytesTransferred, false);
+
+            if (!rslt && GetLastError() != ERROR_IO_PENDING)
+            {
+                UINT32 iIORequest = (UINT32)(pIORequest - &p->vIORequest[0]);
+                PrintError("t[%u] error during %s error code: %u)\n", iIORequest, ioTypeName(pIORequest->GetIoType()), GetLastError());
+                fOk = false;
+                goto cleanup;
+            }
+
+            // memory mapped IO, flushes and metadata operations complete synchronously, without a completion packet
+            if (rslt && (pIORequest->GetCurrentTarget()->GetMemoryMappedIoMode() == MemoryMappedIoMode::On ||
+                         pIORequest->GetIoType() == IOOperation::FlushIO ||
+                         pIORequest->GetIoType() == IOOperation::MetadataIO))
+            {
+                completeIO(p, pIORequest, dwBytesTransferred);
+                overlappedQueue.Add(pReadyOverlapped);
+
+                // a completed memory mapped IO resets the throttle so that we traverse
+                // back to it in fair-order before considering throttle again.
+                // note this will drop through to lookside for completions, not wait
+                dwMinSleepTime = INFINITE;
+                cUntilThrottle = overlappedQueue.GetCount();
+            }
+        }
+
+        // look for IO completion
+        // queue is fully dispatched: set wait, reset throttle wait
+        if (!overlappedQueue.GetCount())
+        {
+            assert(!cUntilThrottle);
+            dwWaitTime = dwMinSleepTime = INFINITE;
+            p->pResults->WaitStats.Wait += 1;
+        }
+
+        // queue is not fully dispatched ...
+        // if at the throttle, wait throttle time and reset
+        else if (!cUntilThrottle)
+        {
+            dwWaitTime = dwMinSleepTime;
+            dwMinSleepTime = INFINITE;
+            cUntilThrottle = overlappedQueue.GetCount();
+
+            if (cIORequests == cUntilThrottle)
+            {
+                // all throttled, none dispatched - just sleep
+                throttleSleep(p, dwWaitTime);
+                continue;
+            }
+            else
+            {
+                // throttled, but some dispatched - wait for completions
+                p->pResults->WaitStats.ThrottleWait += 1;
+            }
+        }
+
+        // queue is not fully dispatched ...
+        // if this run is not for latency stats, optimize for dispatch and
+        // skip completion lookasides
+        else if (!fLatencyStats)
+        {
+            continue;
+        }
+
+        // else lookaside
+        else
+        {
+            dwWaitTime = 0;
+            p->pResults->WaitStats.Lookaside += 1;
+        }
+
+        ullLastPoll = ullThisPoll;
+        if (fLatencyStats)
+        {
+            ullThisPoll = PerfTimer::GetTime();
+        }
+
+        if (GetQueuedCompletionStatusEx(hCompletionPort, ovlEntry, cOvlEntryMax, &cCompleted, dwWaitTime, FALSE) != 0)
+        {
+            UINT64 ullReapTime = fLatencyStats ? PerfTimer::GetTime() : 0;
+
+            for (ULONG i = 0; i < cCompleted; i++)
+            {
+                IORequest *pIORequest = IORequest::OverlappedToIORequest(ovlEntry[i].lpOverlapped);
+                UINT64 ullCompletionTime = fLatencyStats ? timestampCompletion(p, pIORequest, ullLastPoll, ullReapTime) : 0;
+
+                completeIOat(p, pIORequest, ovlEntry[i].dwNumberOfBytesTransferred, ullCompletionTime);
+                overlappedQueue.Add(ovlEntry[i].lpOverlapped);
+            }
+
+            // must reevaluate queue in fair order before next throttle
+            cUntilThrottle = overlappedQueue.GetCount();
+        }
+        else
+        {
+            DWORD err = GetLastError();
+            if (err != WAIT_TIMEOUT)
+            {
+                PrintError("error during overlapped IO operation (error code: %u)\n", err);
+                fOk = false;
+                goto cleanup;
+            }
+        }
+
+        // stats for lookaside waits
+        if (dwWaitTime == 0)
+        {
+            p->pResults->WaitStats.LookasideCompletion[cCompleted < _countof(p->pResults->WaitStats.LookasideCompletion) ? cCompleted : _countof(p->pResults->WaitStats.LookasideCompletion) - 1] += 1;
+        }
+    } // end work loop
+
+cleanup:
+    return fOk;
+}
+
+#else
+/*****************************************************************************/
+// indices of a target's buffers registered with an io_uring
+// writes sourced from a -Z<size> random data buffer do not use a registered buffer
+//
+struct IoUringTargetBuffers
+{
+    UINT16 usReadBuffer;
+    UINT16 usWriteBuffer;
+    bool fFixedWrite;
+};
+
+/*****************************************************************************/
+// when a completion ring entry was first seen, and when the ring was last polled
+// without it: the IO completed in between
+//
+struct IoUringCqeStamp
+{
+    UINT64 ullLastPoll;
+    UINT64 ullSeen;
+};
+
+/*****************************************************************************/
+// registers the thread's data buffers and target files with the ring so that
+// IOs can be issued with the fixed buffer/file forms of the opcodes
+//
+static bool registerIoUringResources(ThreadParameters *p, IoUring *pRing, vector<IoUringTargetBuffers> *pvBuffers)
+{
+    vector<struct iovec> vIovecs;
+    vector<int> vFds;
+
+    // the kernel limits a single registered buffer to 1GiB
+    const size_t cbMaxRegisteredBuffer = 1ULL << 30;
+
+    for (size_t iTarget = 0; iTarget < p->vTargets.size(); iTarget++)
+    {
+        const Target& target(p->vTargets[iTarget]);
+        struct iovec iov;
+        IoUringTargetBuffers buffers;
+
+        // the read and write halves of the target's data buffer are one region
+        iov.iov_base = p->vpDataBuffers[iTarget];
+        iov.iov_len = p->vulReadBufferSize[iTarget] * 2;
+
+        if (iov.iov_len > cbMaxRegisteredBuffer)
+        {
+            PrintError("ERROR: data buffer for target '%s' is too large to register with io_uring (%zu bytes, limit is %zu)\n",
+                target.GetPath().c_str(),
+                iov.iov_len,
+                cbMaxRegisteredBuffer);
+            return false;
+        }
+
+        buffers.usReadBuffer = (UINT16)vIovecs.size();
+        buffers.usWriteBuffer = buffers.usReadBuffer;
+        buffers.fFixedWrite = (target.GetRandomDataWriteBufferSize() == 0);
+
+        vIovecs.push_back(iov);
+        pvBuffers->push_back(buffers);
+
+        vFds.push_back((int)(intptr_t)p->vhTargets[iTarget]);
+    }
+
+    if (!pRing->RegisterBuffers(&vIovecs[0], (unsigned int)vIovecs.size()))
+    {
+        PrintError("ERROR: unable to register buffers with io_uring (error code: %u)\n", errno);
+        return false;
+    }
+
+    if (!pRing->RegisterFiles(&vFds[0], (unsigned int)vFds.size()))
+    {
+        PrintError("ERROR: unable to register files with io_uring (error code: %u)\n", errno);
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+// samples the CPU time of the io_uring submission queue pollers serving the
+// worker threads; threads without a poller get zero
+//
+static void getSqPollTimes(const vector<ThreadResults>& vThreadResults, vector<UINT64>& vTimes)
+{
+    vTimes.assign(vThreadResults.size(), 0);
+
+    for (size_t i = 0; i < vThreadResults.size(); i++)
+    {
+        unsigned long long ullTime;
+        if (vThreadResults[i].ulSqPollThreadId != 0 &&
+            IoUring::GetThreadCpuTime(vThreadResults[i].ulSqPollThreadId, &ullTime))
+        {
+            vTimes[i] = ullTime;
+        }
+    }
+}
+
+/*****************************************************************************/
+// prepares the next IO of the request as an io_uring submission entry
+// the entry is not visible to the kernel until the ring is entered
+// if buffers and files are registered, pvBuffers provides the buffer indices and the
+// target index is the registered file index, except for file sets (-m)
+// a trim of a disk or a metadata operation is issued synchronously instead (see
+// issueTrimIO and issueMetadataIO), leaving *pfPrepared false;
+// the return is false only if it failed
+//
+static BOOL prepareNextIoUringIO(ThreadParameters *p, IORequest *pIORequest, IoUring *pRing, const vector<IoUringTargetBuffers> *pvBuffers, bool *pfPrepared)
+{
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    Target *pTarget = pIORequest->GetCurrentTarget();
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+    UINT32 iRequest = pIORequest->GetRequestIndex();
+
+    //
+    // Compute next IO
+    //
+
+    if (!p->vTargetStates[iTarget].NextIORequest(*pIORequest))
+    {
+        SetLastError(ERROR_HANDLE_EOF);
+        *pfPrepared = false;
+        return FALSE;
+    }
+
+    if (pTarget->GetOpenPerIO() && pIORequest->GetIoType() != IOOperation::MetadataIO)
+    {
+        if (!openFileForIO(p, pIORequest))
+        {
+            *pfPrepared = false;
+            return FALSE;
+        }
+    }
+
+    if (p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev())
+    {
+        pIORequest->SetStartTime(issueTime(p, iTarget));
+    }
+
+    if (pIORequest->GetIoType() == IOOperation::TrimIO && p->vfDeviceTargets[iTarget])
+    {
+        *pfPrepared = false;
+        if (!issueTrimIO(p, pIORequest))
+        {
+            abandonFileForIO(p, pIORequest);
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    if (pIORequest->GetIoType() == IOOperation::MetadataIO)
+    {
+        *pfPrepared = false;
+        return issueMetadataIO(p, pIORequest);
+    }
+
+    // the ring has an entry for every request and one for a throttle timeout, so an entry
+    // is free unless the kernel pushed back on a submission: then submit to make room
+    struct io_uring_sqe *pSqe = pRing->GetSqe();
+    if (nullptr == pSqe)
+    {
+        (void) pRing->Enter(0);
+        pSqe = pRing->GetSqe();
+        if (nullptr == pSqe)
+        {
+            SetLastError(ERROR_BUSY);
+            abandonFileForIO(p, pIORequest);
+            *pfPrepared = false;
+            return FALSE;
+        }
+    }
+    *pfPrepared = true;
+
+    if (pIORequest->GetIoType() == IOOperation::FlushIO)
+    {
+        // the entry was cleared as it was taken: no buffer, and a zero length syncs the whole file
+        pSqe->opcode = IORING_OP_FSYNC;
+        pSqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    }
+    else if (pIORequest->GetIoType() == IOOperation::TrimIO)
+    {
+        // a file trim punches a hole: fallocate takes its length in addr, and its mode in len
+        pSqe->opcode = IORING_OP_FALLOCATE;
+        pSqe->addr = pIORequest->GetBlockSize();
+    }
+    else if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        pSqe->addr = (__u64)(ULONG_PTR)p->GetReadBuffer(iTarget, iRequest);
+        if (pvBuffers)
+        {
+            pSqe->opcode = IORING_OP_READ_FIXED;
+            pSqe->buf_index = (*pvBuffers)[iTarget].usReadBuffer;
+        }
+        else
+        {
+            pSqe->opcode = IORING_OP_READ;
+        }
+    }
+    else
+    {
+        pSqe->addr = (__u64)(ULONG_PTR)p->GetWriteBuffer(iTarget, iRequest);
+        if (pvBuffers && (*pvBuffers)[iTarget].fFixedWrite)
+        {
+            pSqe->opcode = IORING_OP_WRITE_FIXED;
+            pSqe->buf_index = (*pvBuffers)[iTarget].usWriteBuffer;
+        }
+        else
+        {
+            pSqe->opcode = IORING_OP_WRITE;
+        }
+
+        if (pIORequest->GetFua())
+        {
+            pSqe->rw_flags = RWF_DSYNC;
+        }
+    }
+
+    // trims are rejected with data verification during validation
+    if (pTarget->GetVerifier() != nullptr && pIORequest->GetIoType() != IOOperation::FlushIO)
+    {
+        beginVerify(pIORequest, (BYTE *)(ULONG_PTR)pSqe->addr);
+    }
+
+    // only the first file of a file set is registered
+    if (pvBuffers && pTarget->GetFileSetCount() == 0)
+    {
+        pSqe->fd = (int)iTarget;
+        pSqe->flags |= IOSQE_FIXED_FILE;
+    }
+    else
+    {
+        pSqe->fd = (int)(intptr_t)ioHandle(p, pIORequest);
+    }
+    if (pIORequest->GetIoType() == IOOperation::TrimIO)
+    {
+        pSqe->len = FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE;
+        pSqe->off = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+    }
+    else if (pIORequest->GetIoType() != IOOperation::FlushIO)
+    {
+        pSqe->len = pIORequest->GetBlockSize();
+        pSqe->off = ((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset;
+    }
+    pSqe->user_data = (__u64)(ULONG_PTR)pOverlapped;
+
+    if (p->vThroughputMeters.size() != 0 && p->vThroughputMeters[iTarget].IsRunning())
+    {
+        p->vThroughputMeters[iTarget].Adjust(pIORequest->GetIoType() == IOOperation::TrimIO ? 0 : pIORequest->GetBlockSize());
+        scheduleTraceArrival(p, iTarget);
+    }
+
+    return TRUE;
+}
+
+/*****************************************************************************/
+// function called from worker thread
+// performs asynch I/O using an io_uring submission/completion ring pair
+//
+// This follows the dispatch/throttle/wait structure of doWorkUsingIOCompletionPorts,
+// with the difference that dispatch only prepares submission entries. Prepared entries
+// are submitted in a single system call when the loop would otherwise wait for
+// completions (the queue is fully dispatched, or the throttle is reached), and the
+// wait for completions is part of the same call. Lookasides consume the completion
+// ring directly and do not need a system call.
+//
+// pvBuffers is non-null if the thread's buffers and files are registered with the ring
+//
+static bool doWorkUsingIoUring(ThreadParameters *p, IoUring *pRing, const vector<IoUringTargetBuffers> *pvBuffers)
+{
+    assert(nullptr != p);
+    assert(nullptr != pRing);
+
+    bool fOk = true;
+    OverlappedQueue overlappedQueue;
+    size_t cIORequests = p->vIORequest.size();
+    BOOL fLatencyStats = p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev();
+    UINT64 ullLastPoll = 0;     // when the completion ring was last polled
+    vector<IoUringCqeStamp> vStamps;
+    int ret;
+
+    // stamps of the completion ring entries being processed, by their position in the ring
+    vStamps.reserve(cIORequests + 1);
+
+    for (size_t i = 0; i < cIORequests; i++)
+    {
+        overlappedQueue.Add(p->vIORequest[i].GetOverlapped());
+    }
+
+    //
+    // perform work
+    //
+    DWORD dwMinSleepTime = INFINITE;
+    DWORD dwWaitTime;
+
+    ULONG cCompleted;
+    size_t cUntilThrottle = cIORequests;
+    bool fThrottle = (p->vThroughputMeters.size() != 0 || p->pPhaseSchedule != nullptr);
+
+    while(g_bRun && !g_bThreadError)
+    {
+        OVERLAPPED *pReadyOverlapped = overlappedQueue.Remove();
+        IORequest *pIORequest = IORequest::OverlappedToIORequest(pReadyOverlapped);
+        (void) pIORequest->GetNextTarget();
+        bool fSubmit = false;   // submit prepared IO even though the wait is zero
+
+        // check throttles
+        if (fThrottle)
+        {
+            cUntilThrottle -= 1;
+
+            // the requests not in the queue, less this one, are in flight
+            DWORD dwSleepTime;
+            if (!isReadyToIssue(p, pIORequest, cIORequests - overlappedQueue.GetCount() - 1, &dwSleepTime))
+            {
+                dwMinSleepTime = min(dwMinSleepTime, dwSleepTime);
+                overlappedQueue.Add(pReadyOverlapped);
+
+                // continue if throttle not hit
+                if (cUntilThrottle)
+                {
+                    continue;
+                }
+
+                // at throttle, no IO to dispatch
+                pIORequest = NULL;
+            }
+        }
+
+        // dispatch IO - skipped iff at throttle
+        if (pIORequest)
+        {
+            bool fPrepared;
+            if (!prepareNextIoUringIO(p, pIORequest, pRing, pvBuffers, &fPrepared))
+            {
+                PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, pIORequest->GetCurrentTargetIndex(), ioTypeName(pIORequest->GetIoType()), GetLastError());
+                overlappedQueue.Add(pReadyOverlapped);
+                fOk = false;
+                goto cleanup;
+            }
+
+            if (!fPrepared)
+            {
+                // a trim completed synchronously resets the throttle, as a completed memory
+                // mapped IO does for completion ports
+                completeIO(p, pIORequest, 0);
+                overlappedQueue.Add(pReadyOverlapped);
+                dwMinSleepTime = INFINITE;
+                cUntilThrottle = overlappedQueue.GetCount();
+            }
+
+            // with a submission queue poller, publish immediately: this is not a system call
+            // unless the poller went idle
+            else if (pRing->IsSqPoll())
+            {
+                ret = pRing->Enter(0);
+                if (ret < 0)
+                {
+                    PrintError("error during io_uring submission (error code: %d)\n", -ret);
+                    fOk = false;
+                    goto cleanup;
+                }
+            }
+        }
+
+        // look for IO completion
+        // queue is fully dispatched: set wait, reset throttle wait
+        if (!overlappedQueue.GetCount())
+        {
+            assert(!cUntilThrottle);
+            dwWaitTime = dwMinSleepTime = INFINITE;
+            p->pResults->WaitStats.Wait += 1;
+        }
+
+        // queue is not fully dispatched ...
+        // if at the throttle, wait throttle time and reset
+        else if (!cUntilThrottle)
+        {
+            dwWaitTime = dwMinSleepTime;
+            dwMinSleepTime = INFINITE;
+            cUntilThrottle = overlappedQueue.GetCount();
+
+            if (cIORequests == cUntilThrottle)
+            {
+                // all throttled, none dispatched - just sleep
+                throttleSleep(p, dwWaitTime);
+                continue;
+            }
+            else
+            {
+                // throttled, but some dispatched - wait for completions
+                // the timeout bounds the wait to the throttle time; an arrival due within
+                // the millisecond is a zero wait, which submits and polls. A load phase's
+                // outstanding IO limit waits for a completion alone.
+                p->pResults->WaitStats.ThrottleWait += 1;
+                if (dwWaitTime != 0 && dwWaitTime != INFINITE)
+                {
+                    // with no entry free, the wait is for a completion alone
+                    (void) pRing->PrepareTimeout(dwWaitTime);
+                }
+                fSubmit = true;
+            }
+        }
+
+        // queue is not fully dispatched ...
+        // if this run is not for latency stats, optimize for dispatch and
+        // skip completion lookasides
+        else if (!fLatencyStats)
+        {
+            continue;
+        }
+
+        // else lookaside
+        else
+        {
+            dwWaitTime = 0;
+            p->pResults->WaitStats.Lookaside += 1;
+        }
+
+        // submit the batch prepared so far and wait for completions, unless this is a
+        // lookaside: pending entries then stay prepared to be submitted with the rest
+        if (dwWaitTime != 0 || fSubmit)
+        {
+            ret = pRing->Enter(dwWaitTime != 0 ? 1 : 0);
+
+            // EAGAIN/EBUSY indicate the kernel could not accept more submissions until
+            // completions are consumed, which happens next
+            if (ret < 0 && ret != -EAGAIN && ret != -EBUSY)
+            {
+                PrintError("error during io_uring submission (error code: %d)\n", -ret);
+                fOk = false;
+                goto cleanup;
+            }
+        }
+
+        cCompleted = 0;
+        {
+            UINT32 cCqes = 0;
+            UINT32 i;
+
+            for (i = 0; ; i++)
+            {
+                // when measuring latency, the ring is polled again before each entry is
+                // processed, so that entries which arrive meanwhile are stamped when they
+                // become visible rather than when the batch ahead of them is done
+                if (i == 0 || fLatencyStats)
+                {
+                    UINT32 cVisible = pRing->GetCqeCount();
+
+                    if (fLatencyStats)
+                    {
+                        UINT64 ullPoll = PerfTimer::GetTime();
+                        IoUringCqeStamp stamp = { ullLastPoll, ullPoll };
+
+                        vStamps.resize(cVisible, stamp);
+                        ullLastPoll = ullPoll;
+                    }
+                    cCqes = cVisible;
+                }
+
+                if (i == cCqes)
+                {
+                    break;
+                }
+
+                const struct io_uring_cqe *pCqe = pRing->GetCqe(i);
+
+                // throttle wait timeouts carry no request
+                if (pCqe->user_data == IoUring::ReservedUserData)
+                {
+                    continue;
+                }
+
+                OVERLAPPED *pOverlapped = (OVERLAPPED *)(ULONG_PTR)pCqe->user_data;
+
+                if (pCqe->res < 0)
+                {
+                    PrintError("error during overlapped IO operation (error code: %d)\n", -pCqe->res);
+                    overlappedQueue.Add(pOverlapped);
+                    pRing->AdvanceCq(i + 1);
+                    fOk = false;
+                    goto cleanup;
+                }
+
+                IORequest *pIORequest = IORequest::OverlappedToIORequest(pOverlapped);
+                UINT64 ullCompletionTime = fLatencyStats ? timestampCompletion(p, pIORequest, vStamps[i].ullLastPoll, vStamps[i].ullSeen) : 0;
+
+                completeIOat(p, pIORequest, (DWORD)pCqe->res, ullCompletionTime);
+                overlappedQueue.Add(pOverlapped);
+                cCompleted++;
+            }
+
+            pRing->AdvanceCq(cCqes);
+            vStamps.clear();
+
+            // must reevaluate queue in fair order before next throttle
+            if (cCompleted)
+            {
+                cUntilThrottle = overlappedQueue.GetCount();
+            }
+        }
+
+        // stats for lookaside waits
+        if (dwWaitTime == 0)
+        {
+            p->pResults->WaitStats.LookasideCompletion[cCompleted < _countof(p->pResults->WaitStats.LookasideCompletion) ? cCompleted : _countof(p->pResults->WaitStats.LookasideCompletion) - 1] += 1;
+        }
+    } // end work loop
+
+cleanup:
+    //
+    // drain IO still in flight so that buffers are not released under the kernel
+    // completions are no longer accounted
+    // a request whose IO failed was put back in the queue, so those missing from it are in flight
+    //
+    while (overlappedQueue.GetCount() < cIORequests)
+    {
+        ret = pRing->Enter(1);
+        if (ret < 0 && ret != -EAGAIN && ret != -EBUSY)
+        {
+            PrintError("error during io_uring submission (error code: %d)\n", -ret);
+            fOk = false;
+            break;
+        }
+
+        UINT32 cCqes = pRing->GetCqeCount();
+        for (UINT32 i = 0; i < cCqes; i++)
+        {
+            const struct io_uring_cqe *pCqe = pRing->GetCqe(i);
+            if (pCqe->user_data != IoUring::ReservedUserData)
+            {
+                overlappedQueue.Add((OVERLAPPED *)(ULONG_PTR)pCqe->user_data);
+            }
+        }
+        pRing->AdvanceCq(cCqes);
+    }
+
+    return fOk;
+}
+
+/*****************************************************************************/
+// prepares the next IO of the request in its Linux AIO control block
+// the control block is queued for the next submission
+// a trim or metadata operation is issued synchronously instead (see issueTrimIO and
+// issueMetadataIO), leaving *pfPrepared false;
+// the return is false only if it failed
+//
+static BOOL prepareNextLinuxAioIO(ThreadParameters *p, IORequest *pIORequest, LinuxAio *pAio, bool *pfPrepared)
+{
+    OVERLAPPED *pOverlapped = pIORequest->GetOverlapped();
+    Target *pTarget = pIORequest->GetCurrentTarget();
+    size_t iTarget = pIORequest->GetCurrentTargetIndex();
+    UINT32 iRequest = pIORequest->GetRequestIndex();
+
+    //
+    // Compute next IO
+    //
 
-    while(g_bRun && !g_bThreadError)
+    if (!p->vTargetStates[iTarget].NextIORequest(*pIORequest))
     {
-        DWORD nIssued = 0;
-        DWORD dwMinSleepTime = INFINITE;
-        for (size_t i = 0; i < cIORequests; i++)
-        {
-            IORequest *pIORequest = &p->vIORequest[i];
-            Target *pTarget = pIORequest->GetNextTarget();
+        SetLastError(ERROR_HANDLE_EOF);
+        *pfPrepared = false;
+        return FALSE;
+    }
 
-            if (p->vThroughputMeters.size() != 0)
-            {
-                size_t iTarget = pTarget - &p->vTargets[0];
-                ThroughputMeter *pThroughputMeter = &p->vThroughputMeters[iTarget];
+    if (pTarget->GetOpenPerIO() && pIORequest->GetIoType() != IOOperation::MetadataIO)
+    {
+        if (!openFileForIO(p, pIORequest))
+        {
+            *pfPrepared = false;
+            return FALSE;
+        }
+    }
 
-                DWORD dwSleepTime = pThroughputMeter->GetSleepTime();
-                dwMinSleepTime = min(dwMinSleepTime, dwSleepTime);
-                if (pThroughputMeter->IsRunning() && dwSleepTime > 0)
-                {
-                    continue;
-                }
-            }
+    if (p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev())
+    {
+        pIORequest->SetStartTime(issueTime(p, iTarget));
+    }
 
-            nIssued += 1;
-            rslt = issueNextIO(p, pIORequest, &dwBytesTransferred, false);
+    if (pIORequest->GetIoType() == IOOperation::TrimIO)
+    {
+        *pfPrepared = false;
+        if (!issueTrimIO(p, pIORequest))
+        {
+            abandonFileForIO(p, pIORequest);
+            return FALSE;
+        }
+        return TRUE;
+    }
 
-            if (!rslt)
-            {
-                PrintError("t[%u] error during %s error code: %u)\n", (UINT32)i, (pIORequest->GetIoType() == IOOperation::ReadIO ? "read" : "write"), GetLastError());
-                fOk = false;
-                goto cleanup;
-            }
+    if (pIORequest->GetIoType() == IOOperation::MetadataIO)
+    {
+        *pfPrepared = false;
+        return issueMetadataIO(p, pIORequest);
+    }
 
-            completeIO(p, pIORequest, dwBytesTransferred);
-        }
+    struct iocb *pIocb = pAio->GetIocb((UINT32)(pIORequest - &p->vIORequest[0]));
+    *pfPrepared = true;
 
-        // if no IOs were issued, wait for the next scheduling time
-        if (!nIssued && dwMinSleepTime != INFINITE && dwMinSleepTime != 0)
+    if (pIORequest->GetIoType() == IOOperation::FlushIO)
+    {
+        // the control block was cleared as it was taken: a sync takes no buffer, length or offset
+        pIocb->aio_lio_opcode = IOCB_CMD_FDSYNC;
+    }
+    else if (pIORequest->GetIoType() == IOOperation::ReadIO)
+    {
+        pIocb->aio_lio_opcode = IOCB_CMD_PREAD;
+        pIocb->aio_buf = (__u64)(ULONG_PTR)p->GetReadBuffer(iTarget, iRequest);
+    }
+    else
+    {
+        pIocb->aio_lio_opcode = IOCB_CMD_PWRITE;
+        pIocb->aio_buf = (__u64)(ULONG_PTR)p->GetWriteBuffer(iTarget, iRequest);
+        if (pIORequest->GetFua())
         {
-            p->pResults->WaitStats.ThrottleSleep += 1;
-            Sleep(dwMinSleepTime);
+            pIocb->aio_rw_flags = RWF_DSYNC;
         }
+    }
 
-        assert(!g_bError);  // at this point we shouldn't be seeing initialization error
+    if (pTarget->GetVerifier() != nullptr && pIORequest->GetIoType() != IOOperation::FlushIO)
+    {
+        beginVerify(pIORequest, (BYTE *)(ULONG_PTR)pIocb->aio_buf);
     }
 
-cleanup:
-    return fOk;
+    pIocb->aio_fildes = (__u32)(intptr_t)ioHandle(p, pIORequest);
+    if (pIORequest->GetIoType() != IOOperation::FlushIO)
+    {
+        pIocb->aio_nbytes = pIORequest->GetBlockSize();
+        pIocb->aio_offset = (__s64)(((UINT64)pOverlapped->OffsetHigh << 32) | pOverlapped->Offset);
+    }
+    pIocb->aio_data = (__u64)(ULONG_PTR)pOverlapped;
+
+    if (p->vThroughputMeters.size() != 0 && p->vThroughputMeters[iTarget].IsRunning())
+    {
+        p->vThroughputMeters[iTarget].Adjust(pIORequest->GetIoType() == IOOperation::TrimIO ? 0 : pIORequest->GetBlockSize());
+        scheduleTraceArrival(p, iTarget);
+    }
+
+    return TRUE;
 }
 
 /*****************************************************************************/
 // function called from worker thread
-// performs asynch I/O using IO Completion Ports
+// performs asynch I/O using a Linux native AIO context
 //
-static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletionPort)
+// This follows the structure of doWorkUsingIoUring: dispatch only prepares control
+// blocks, which are submitted in a single io_submit when the loop would otherwise wait
+// for completions. Completions are then reaped in a batch once at least the timespan's
+// minimum are available (bounded by the IOs in flight), or the throttle time expires.
+// Lookasides reap whatever is available without submitting or waiting.
+//
+static bool doWorkUsingLinuxAio(ThreadParameters *p, LinuxAio *pAio)
 {
     assert(nullptr != p);
-    assert(nullptr != hCompletionPort);
+    assert(nullptr != pAio);
 
-    BOOL fOk = true;
-    BOOL rslt = FALSE;
-    DWORD dwBytesTransferred;
+    bool fOk = true;
     OverlappedQueue overlappedQueue;
     size_t cIORequests = p->vIORequest.size();
     BOOL fLatencyStats = p->pTimeSpan->GetMeasureLatency() || p->pTimeSpan->GetCalculateIopsStdDev();
+    UINT64 ullLastPoll = 0;     // when the completion queue was polled before the current poll
+    UINT64 ullThisPoll = 0;
+    UINT32 cMinEvents = p->pTimeSpan->GetAioMinEvents();
+    UINT32 cInFlight = 0;
+    int ret;
 
     for (size_t i = 0; i < cIORequests; i++)
     {
@@ -914,26 +2473,25 @@ static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletion
     DWORD dwMinSleepTime = INFINITE;
     DWORD dwWaitTime;
 
-    OVERLAPPED_ENTRY ovlEntry[16];
-    const ULONG cOvlEntryMax = _countof(ovlEntry) < (ULONG)cIORequests ? _countof(ovlEntry) : (ULONG)cIORequests;
     ULONG cCompleted;
     size_t cUntilThrottle = cIORequests;
+    bool fThrottle = (p->vThroughputMeters.size() != 0 || p->pPhaseSchedule != nullptr);
 
     while(g_bRun && !g_bThreadError)
     {
         OVERLAPPED *pReadyOverlapped = overlappedQueue.Remove();
         IORequest *pIORequest = IORequest::OverlappedToIORequest(pReadyOverlapped);
         (void) pIORequest->GetNextTarget();
+        bool fSubmit = false;   // submit prepared IO even though the wait is zero
 
         // check throttles
-        if (p->vThroughputMeters.size() != 0)
+        if (fThrottle)
         {
-            ThroughputMeter *pThroughputMeter = &p->vThroughputMeters[pIORequest->GetCurrentTargetIndex()];
-
             cUntilThrottle -= 1;
 
-            DWORD dwSleepTime = pThroughputMeter->GetSleepTime();
-            if (pThroughputMeter->IsRunning() && dwSleepTime > 0)
+            // the requests not in the queue, less this one, are in flight
+            DWORD dwSleepTime;
+            if (!isReadyToIssue(p, pIORequest, cIORequests - overlappedQueue.GetCount() - 1, &dwSleepTime))
             {
                 dwMinSleepTime = min(dwMinSleepTime, dwSleepTime);
                 overlappedQueue.Add(pReadyOverlapped);
@@ -952,24 +2510,20 @@ static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletion
         // dispatch IO - skipped iff at throttle
         if (pIORequest)
         {
-            rslt = issueNextIO(p, pIORequest, &dwBytesTransferred, false);
-
-            if (!rslt && GetLastError() != ERROR_IO_PENDING)
+            bool fPrepared;
+            if (!prepareNextLinuxAioIO(p, pIORequest, pAio, &fPrepared))
             {
-                UINT32 iIORequest = (UINT32)(pIORequest - &p->vIORequest[0]);
-                PrintError("t[%u] error during %s error code: %u)\n", iIORequest, (pIORequest->GetIoType()== IOOperation::ReadIO ? "read" : "write"), GetLastError());
+                PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, pIORequest->GetCurrentTargetIndex(), ioTypeName(pIORequest->GetIoType()), GetLastError());
                 fOk = false;
                 goto cleanup;
             }
 
-            if (rslt && pIORequest->GetCurrentTarget()->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+            if (!fPrepared)
             {
-                completeIO(p, pIORequest, dwBytesTransferred);
+                // a trim completed synchronously resets the throttle, as a completed memory
+                // mapped IO does for completion ports
+                completeIO(p, pIORequest, 0);
                 overlappedQueue.Add(pReadyOverlapped);
-
-                // a completed memory mapped IO resets the throttle so that we traverse
-                // back to it in fair-order before considering throttle again.
-                // note this will drop through to lookside for completions, not wait
                 dwMinSleepTime = INFINITE;
                 cUntilThrottle = overlappedQueue.GetCount();
             }
@@ -995,14 +2549,15 @@ static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletion
             if (cIORequests == cUntilThrottle)
             {
                 // all throttled, none dispatched - just sleep
-                p->pResults->WaitStats.ThrottleSleep += 1;
-                Sleep(dwWaitTime);
+                throttleSleep(p, dwWaitTime);
                 continue;
             }
             else
             {
                 // throttled, but some dispatched - wait for completions
+                // an arrival due within the millisecond is a zero wait, which submits and polls
                 p->pResults->WaitStats.ThrottleWait += 1;
+                fSubmit = true;
             }
         }
 
@@ -1021,34 +2576,72 @@ static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletion
             p->pResults->WaitStats.Lookaside += 1;
         }
 
-        if (GetQueuedCompletionStatusEx(hCompletionPort, ovlEntry, cOvlEntryMax, &cCompleted, dwWaitTime, FALSE) != 0)
+        // submit the batch prepared so far, unless this is a lookaside: pending
+        // control blocks then stay queued to be submitted with the rest
+        if (dwWaitTime != 0 || fSubmit)
         {
-            UINT64 ullCompletionTime = 0;
+            ret = pAio->Submit();
 
-            if (fLatencyStats)
+            // EAGAIN indicates the context could not accept more submissions until
+            // completions are consumed, which happens next
+            if (ret < 0 && ret != -EAGAIN)
             {
-                // single completion time estimate for all completions
-                ullCompletionTime = PerfTimer::GetTime();
+                PrintError("error during Linux AIO submission (error code: %d)\n", -ret);
+                fOk = false;
+                goto cleanup;
             }
 
-            for (ULONG i = 0; i < cCompleted; i++)
+            if (ret > 0)
             {
-                completeIOat(p, IORequest::OverlappedToIORequest(ovlEntry[i].lpOverlapped), ovlEntry[i].dwNumberOfBytesTransferred, ullCompletionTime);
-                overlappedQueue.Add(ovlEntry[i].lpOverlapped);
+                cInFlight += ret;
             }
+        }
 
-            // must reevaluate queue in fair order before next throttle
-            cUntilThrottle = overlappedQueue.GetCount();
+        ullLastPoll = ullThisPoll;
+        if (fLatencyStats)
+        {
+            ullThisPoll = PerfTimer::GetTime();
         }
-        else
+
+        ret = pAio->GetEvents(dwWaitTime == 0 ? 0 : min(cMinEvents, cInFlight),
+                              dwWaitTime == INFINITE ? LinuxAio::Infinite : dwWaitTime);
+        if (ret < 0)
         {
-            DWORD err = GetLastError();
-            if (err != WAIT_TIMEOUT)
+            PrintError("error during Linux AIO completion (error code: %d)\n", -ret);
+            fOk = false;
+            goto cleanup;
+        }
+
+        cCompleted = 0;
+        if (ret > 0)
+        {
+            // the whole batch is reaped, whether or not all of it is accounted below
+            cInFlight -= ret;
+
+            UINT64 ullReapTime = fLatencyStats ? PerfTimer::GetTime() : 0;
+
+            for (int i = 0; i < ret; i++)
             {
-                PrintError("error during overlapped IO operation (error code: %u)\n", err);
-                fOk = false;
-                goto cleanup;
+                const struct io_event *pEvent = pAio->GetEvent(i);
+                OVERLAPPED *pOverlapped = (OVERLAPPED *)(ULONG_PTR)pEvent->data;
+
+                if (pEvent->res < 0)
+                {
+                    PrintError("error during overlapped IO operation (error code: %d)\n", (int)-pEvent->res);
+                    fOk = false;
+                    goto cleanup;
+                }
+
+                IORequest *pIORequest = IORequest::OverlappedToIORequest(pOverlapped);
+                UINT64 ullCompletionTime = fLatencyStats ? timestampCompletion(p, pIORequest, ullLastPoll, ullReapTime) : 0;
+
+                completeIOat(p, pIORequest, (DWORD)pEvent->res, ullCompletionTime);
+                overlappedQueue.Add(pOverlapped);
+                cCompleted++;
             }
+
+            // must reevaluate queue in fair order before next throttle
+            cUntilThrottle = overlappedQueue.GetCount();
         }
 
         // stats for lookaside waits
@@ -1059,9 +2652,27 @@ static bool doWorkUsingIOCompletionPorts(ThreadParameters *p, HANDLE hCompletion
     } // end work loop
 
 cleanup:
+    //
+    // drain IO still in flight so that buffers are not released under the kernel
+    // completions are no longer accounted
+    //
+    while (cInFlight > 0)
+    {
+        ret = pAio->GetEvents(cInFlight, LinuxAio::Infinite);
+        if (ret < 0)
+        {
+            PrintError("error during Linux AIO completion (error code: %d)\n", -ret);
+            fOk = false;
+            break;
+        }
+        cInFlight -= ret;
+    }
+
     return fOk;
 }
+#endif
 
+#ifndef __linux__
 /*****************************************************************************/
 // I/O completion routine. used by ReadFileEx and WriteFileEx
 //
@@ -1094,7 +2705,7 @@ VOID CALLBACK fileIOCompletionRoutine(DWORD dwErrorCode, DWORD dwBytesTransferre
 
         if (!rslt)
         {
-            PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, pIORequest->GetCurrentTargetIndex(), (pIORequest->GetIoType() == IOOperation::ReadIO ? "read" : "write"), GetLastError());
+            PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, pIORequest->GetCurrentTargetIndex(), ioTypeName(pIORequest->GetIoType()), GetLastError());
             goto cleanup;
         }
     }
@@ -1125,7 +2736,7 @@ static bool doWorkUsingCompletionRoutines(ThreadParameters *p)
 
         if (!rslt)
         {
-            PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, pIORequest->GetCurrentTargetIndex(), (pIORequest->GetIoType() == IOOperation::ReadIO ? "read" : "write"), GetLastError());
+            PrintError("t[%u:%u] error during %s error code: %u)\n", p->ulThreadNo, pIORequest->GetCurrentTargetIndex(), ioTypeName(pIORequest->GetIoType()), GetLastError());
             fOk = false;
             goto cleanup;
         }
@@ -1149,50 +2760,7 @@ static bool doWorkUsingCompletionRoutines(ThreadParameters *p)
 cleanup:
     return fOk;
 }
-
-struct UniqueTarget {
-    string path;
-    TargetCacheMode caching;
-    PRIORITY_HINT priority;
-    DWORD dwDesiredAccess;
-    DWORD dwFlags;
-
-    bool operator < (const struct UniqueTarget &ut) const {
-        if (path < ut.path) {
-            return true;
-        }
-        else if (ut.path < path) {
-            return false;
-        }
-
-        if (caching < ut.caching) {
-            return true;
-        }
-        else if (ut.caching < caching) {
-            return false;
-        }
-
-        if (priority < ut.priority) {
-            return true;
-        }
-        else if (ut.priority < priority) {
-            return false;
-        }
-
-        if (dwDesiredAccess < ut.dwDesiredAccess) {
-            return true;
-        }
-        else if (ut.dwDesiredAccess < dwDesiredAccess) {
-            return false;
-        }
-
-        if (dwFlags < ut.dwFlags) {
-            return true;
-        }
-
-        return false;
-    }
-};
+#endif
 
 /*****************************************************************************/
 // worker thread function
@@ -1204,6 +2772,18 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     bool fAllMappedIo = true;
     ThreadParameters *p = reinterpret_cast<ThreadParameters *>(cookie);
     HANDLE hCompletionPort = nullptr;
+    IoEngine ioEngine = p->pTimeSpan->GetIoEngine();
+#ifdef __linux__
+    IoUring ioUring;
+    vector<IoUringTargetBuffers> vIoUringBuffers;
+    LinuxAio linuxAio;
+
+    // io_uring is the default engine, falling back to Linux AIO on kernels without it
+    if (ioEngine == IoEngine::Default)
+    {
+        ioEngine = IoUring::IsSupported() ? IoEngine::IoUring : IoEngine::LinuxAio;
+    }
+#endif
 
     //
     // A single file can be specified in multiple targets, so only open one
@@ -1211,6 +2791,8 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     //
 
     vector<HANDLE> vhUniqueHandles;
+    vector<UniqueTarget> vUniqueTargets;
+    vector<bool> vfPooledHandles;
     map<UniqueTarget, UINT32> mHandleMap;
 
     bool fCalculateIopsStdDev = p->pTimeSpan->GetCalculateIopsStdDev();
@@ -1223,6 +2805,20 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         expectedNumberOfBuckets = Util::QuotientCeiling(p->pTimeSpan->GetDuration() * 1000, ioBucketDurationInMilliseconds);
     }
 
+    UINT32 cIORequests = p->GetTotalRequestCount();
+    size_t iTarget = 0;
+
+#ifndef __linux__
+    // a handle stays bound to the completion port it was associated with, so only
+    // threads doing synchronous IO keep their files and buffers for the next timespan
+    if (cIORequests != 1)
+    {
+        p->pResourcePool = nullptr;
+    }
+#endif
+    size_t cTargets = p->vTargets.size();
+    bool fUseThrougputMeter = false;
+
     // apply affinity. The specific assignment is provided in the thread profile up front.
     if (!p->pTimeSpan->GetDisableAffinity())
     {
@@ -1240,6 +2836,7 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         }
     }
 
+#ifndef __linux__
     // adjust thread token if large pages are needed
     for (auto pTarget = p->vTargets.begin(); pTarget != p->vTargets.end(); pTarget++)
     {
@@ -1253,28 +2850,45 @@ DWORD WINAPI threadFunc(LPVOID cookie)
             break;
         }
     }
+#endif
 
-    UINT32 cIORequests = p->GetTotalRequestCount();
+    p->vFileSets.clear();
+    p->vFileSets.resize(p->vTargets.size());
 
-    size_t iTarget = 0;
     for (auto pTarget = p->vTargets.begin(); pTarget != p->vTargets.end(); pTarget++)
     {
         bool fPhysical = false;
         bool fPartition = false;
 
-        string sPath(pTarget->GetPath());
+        // a file set (-m) is opened, and sized, as its first file; the rest are opened below
+        string sPath(pTarget->GetFileSetCount() != 0 ? pTarget->GetFileSetFilePath(static_cast<DWORD>(0)) : pTarget->GetPath());
         const char *filename = sPath.c_str();
 
         const char *fname = nullptr;    //filename (can point to physFN)
         char physFN[32];                //disk/partition name
 
-        if (NULL == filename || NULL == *(filename))
+        if (NULL == filename || '\0' == *(filename))
         {
             PrintError("FATAL ERROR: invalid filename\n");
             fOk = false;
             goto cleanup;
         }
 
+#ifdef __linux__
+        //check if it is a block device (disk or partition); there are no #<n> or <letter>: shorthands
+        struct stat st;
+        if (stat(filename, &st) == 0 && S_ISBLK(st.st_mode))
+        {
+            if (pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
+            {
+                PrintError("Memory mapped I/O is not supported on physical drives\n");
+                fOk = false;
+                goto cleanup;
+            }
+            fPhysical = true;
+            fname = filename;
+        }
+#else
         //check if it is a physical drive
         if ('#' == *filename && NULL != *(filename + 1))
         {
@@ -1304,6 +2918,7 @@ DWORD WINAPI threadFunc(LPVOID cookie)
             sprintf_s(physFN, 32, "\\\\.\\%c:", filename[0]);
             fname = physFN;
         }
+#endif
 
         //check if it is a regular file
         if (!fPhysical && !fPartition)
@@ -1327,6 +2942,18 @@ DWORD WINAPI threadFunc(LPVOID cookie)
             dwDesiredAccess = GENERIC_READ | GENERIC_WRITE;
         }
 
+        // a replayed trace states its own mix of reads and writes, as load phases may
+        if (!pTarget->GetTracePath().empty() || p->pTimeSpan->GetPhasesSetWriteRatio())
+        {
+            dwDesiredAccess = GENERIC_READ | GENERIC_WRITE;
+        }
+
+        // flushes and trims modify the target whatever the write ratio
+        if (pTarget->GetFlushRatio() != 0 || pTarget->GetTrimRatio() != 0)
+        {
+            dwDesiredAccess |= GENERIC_WRITE;
+        }
+
         if (pTarget->GetMemoryMappedIoMode() == MemoryMappedIoMode::On)
         {
             dwDesiredAccess = GENERIC_READ | GENERIC_WRITE;
@@ -1346,53 +2973,113 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         ut.dwFlags = dwFlags;
 
         if (mHandleMap.find(ut) == mHandleMap.end()) {
-            hFile = CreateFile(fname,
-                dwDesiredAccess,
-                FILE_SHARE_READ | FILE_SHARE_WRITE,
-                nullptr,        //security
-                OPEN_EXISTING,
-                dwFlags,        //flags
-                nullptr);       //template file
-            if (INVALID_HANDLE_VALUE == hFile)
+            // mapped views are made over the handle, so it is not kept across timespans
+            bool fPooled = (p->pResourcePool != nullptr && pTarget->GetMemoryMappedIoMode() != MemoryMappedIoMode::On);
+
+            hFile = INVALID_HANDLE_VALUE;
+            if (fPooled)
             {
-                // TODO: error out
-                PrintError("Error opening file: %s [%u]\n", sPath.c_str(), GetLastError());
-                fOk = false;
-                goto cleanup;
+                hFile = p->pResourcePool->AcquireHandle(ut);
             }
 
-            if (pTarget->GetCacheMode() == TargetCacheMode::DisableLocalCache)
+            if (INVALID_HANDLE_VALUE != hFile)
+            {
+                PrintVerbose(p->pProfile->GetVerbose(), "thread %u: reusing handle for %s\n", p->ulThreadNo, sPath.c_str());
+            }
+            else
             {
-                DWORD Status = DisableLocalCache(hFile);
-                if (Status != ERROR_SUCCESS)
+                hFile = CreateFile(fname,
+                    dwDesiredAccess,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE,
+                    nullptr,        //security
+                    OPEN_EXISTING,
+                    dwFlags,        //flags
+                    nullptr);       //template file
+                if (INVALID_HANDLE_VALUE == hFile)
                 {
-                    PrintError("Failed to disable local caching (error %u). NOTE: only supported on remote filesystems with Windows 8 or newer.\n", Status);
+                    // TODO: error out
+                    PrintError("Error opening file: %s [%u]\n", sPath.c_str(), GetLastError());
                     fOk = false;
                     goto cleanup;
                 }
-            }
 
-            //set IO priority
-            if (pTarget->GetIOPriorityHint() != IoPriorityHintNormal)
-            {
-                _declspec(align(8)) FILE_IO_PRIORITY_HINT_INFO hintInfo;
-                hintInfo.PriorityHint = pTarget->GetIOPriorityHint();
-                if (!SetFileInformationByHandle(hFile, FileIoPriorityHintInfo, &hintInfo, sizeof(hintInfo)))
+#ifndef __linux__
+                if (pTarget->GetCacheMode() == TargetCacheMode::DisableLocalCache)
                 {
-                    PrintError("Error setting IO priority for file: %s [%u]\n", sPath.c_str(), GetLastError());
-                    fOk = false;
-                    goto cleanup;
+                    DWORD Status = DisableLocalCache(hFile);
+                    if (Status != ERROR_SUCCESS)
+                    {
+                        PrintError("Failed to disable local caching (error %u). NOTE: only supported on remote filesystems with Windows 8 or newer.\n", Status);
+                        fOk = false;
+                        goto cleanup;
+                    }
+                }
+
+                //set IO priority
+                if (pTarget->GetIOPriorityHint() != IoPriorityHintNormal)
+                {
+                    _declspec(align(8)) FILE_IO_PRIORITY_HINT_INFO hintInfo;
+                    hintInfo.PriorityHint = pTarget->GetIOPriorityHint();
+                    if (!SetFileInformationByHandle(hFile, FileIoPriorityHintInfo, &hintInfo, sizeof(hintInfo)))
+                    {
+                        PrintError("Error setting IO priority for file: %s [%u]\n", sPath.c_str(), GetLastError());
+                        fOk = false;
+                        goto cleanup;
+                    }
                 }
+#endif
             }
 
             mHandleMap[ut] = (UINT32)vhUniqueHandles.size();
             vhUniqueHandles.push_back(hFile);
+            vUniqueTargets.push_back(ut);
+            vfPooledHandles.push_back(fPooled);
         }
         else {
             hFile = vhUniqueHandles[mHandleMap[ut]];
         }
 
         p->vhTargets.push_back(hFile);
+        p->vfDeviceTargets.push_back(fPhysical || fPartition);
+
+        if (pTarget->GetFileSetCount() != 0)
+        {
+            FileSetState& fileSet = p->vFileSets[iTarget];
+            fileSet.dwDesiredAccess = dwDesiredAccess;
+            fileSet.dwFlags = dwFlags;
+
+            // the files are held open for the run unless they are opened per IO; they are closed
+            // with the thread's other handles, but not kept for the next timespan
+            if (!pTarget->GetOpenPerIO())
+            {
+                fileSet.vhFiles.push_back(hFile);
+
+                for (DWORD iFile = 1; iFile < pTarget->GetFileSetCount(); iFile++)
+                {
+                    UniqueTarget utFile = ut;
+                    utFile.path = pTarget->GetFileSetFilePath(iFile);
+
+                    HANDLE hSetFile = CreateFile(utFile.path.c_str(),
+                        dwDesiredAccess,
+                        FILE_SHARE_READ | FILE_SHARE_WRITE,
+                        nullptr,        //security
+                        OPEN_EXISTING,
+                        dwFlags,        //flags
+                        nullptr);       //template file
+                    if (INVALID_HANDLE_VALUE == hSetFile)
+                    {
+                        PrintError("Error opening file: %s [%u]\n", utFile.path.c_str(), GetLastError());
+                        fOk = false;
+                        goto cleanup;
+                    }
+
+                    vhUniqueHandles.push_back(hSetFile);
+                    vUniqueTargets.push_back(utFile);
+                    vfPooledHandles.push_back(false);
+                    fileSet.vhFiles.push_back(hSetFile);
+                }
+            }
+        }
 
         // obtain file/disk/partition size
         {
@@ -1437,7 +3124,7 @@ DWORD WINAPI threadFunc(LPVOID cookie)
 
             if (fsize < pTarget->GetMaxFileSize())
             {
-                PrintError("WARNING: file size %I64u is less than MaxFileSize %I64u\n", fsize, pTarget->GetMaxFileSize());
+                PrintError("WARNING: file size %llu is less than MaxFileSize %llu\n", fsize, pTarget->GetMaxFileSize());
             }
 
             //
@@ -1455,7 +3142,7 @@ DWORD WINAPI threadFunc(LPVOID cookie)
 
             if (!p->vTargetStates[iTarget].CanStart())
             {
-                PrintError("The file is too small. File: '%s' relative thread %u: file size: %I64u, base offset: %I64u, thread stride: %I64u, block size: %u\n",
+                PrintError("The file is too small. File: '%s' relative thread %u: file size: %llu, base offset: %llu, thread stride: %llu, block size: %u\n",
                     pTarget->GetPath().c_str(),
                     p->ulRelativeThreadNo,
                     fsize,
@@ -1465,6 +3152,13 @@ DWORD WINAPI threadFunc(LPVOID cookie)
                 fOk = false;
                 goto cleanup;
             }
+
+            if (pTarget->GetVerifier() != nullptr && !pTarget->GetVerifier()->Attach(fsize))
+            {
+                PrintError("ERROR: unable to allocate the data verification map for target '%s'\n", pTarget->GetPath().c_str());
+                fOk = false;
+                goto cleanup;
+            }
         }
 
         PrintVerbose(p->pProfile->GetVerbose(), "thread %u: file '%s' relative thread %u (random seed: %u)\n",
@@ -1563,6 +3257,32 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         //
 
         p->pResults->vTargetResults[i].vDistributionRange = p->vTargetStates[i]._vDistributionRange;
+
+        //
+        // One result bucket per size class of the block size mix (may be empty)
+        //
+
+        for (const auto& b : p->vTargets[i].GetBlockSizeMix())
+        {
+            p->pResults->vTargetResults[i].vBlockSizeResults.emplace_back(b.dwBlockSize);
+        }
+
+        //
+        // One result bucket per load phase (may be empty)
+        //
+
+        p->pResults->vTargetResults[i].vPhaseResults.resize(p->pTimeSpan->GetPhases().size());
+
+        //
+        // One result bucket per kind of metadata operation, for file sets
+        //
+
+        if (p->vTargets[i].GetFileSetCount() != 0)
+        {
+            p->pResults->vTargetResults[i].vMetadataResults.resize(static_cast<size_t>(MetadataOp::Count));
+        }
+
+        p->pResults->vTargetResults[i].SetLatencySignificantDigits(p->pTimeSpan->GetLatencySignificantDigits());
     }
 
     //
@@ -1633,11 +3353,30 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         }
     }
 
+    //
+    // reads under data verification (-Zv) note the state of each unit they cover
+    //
+    {
+        size_t cVerifyUnits = 0;
+        for (const auto& target : p->vTargets)
+        {
+            if (target.GetVerifyData())
+            {
+                cVerifyUnits = max<size_t>(cVerifyUnits, target.GetBlockSizeInBytes() / target.GetVerifyUnitSize());
+            }
+        }
+        if (cVerifyUnits > 0)
+        {
+            for (auto& ioRequest : p->vIORequest)
+            {
+                ioRequest.SetVerifySnapshotSize(cVerifyUnits);
+            }
+        }
+    }
+
     //
     // fill the throughput meter structures
     //
-    size_t cTargets = p->vTargets.size();
-    bool fUseThrougputMeter = false;
     for (size_t i = 0; i < cTargets; i++)
     {
         ThroughputMeter throughputMeter;
@@ -1654,15 +3393,39 @@ DWORD WINAPI threadFunc(LPVOID cookie)
                 dwBurstSize /= (DWORD)pTarget->GetThreadTargets().size();
             }
         }
-        else
+        else
+        {
+            dwBurstSize /= pTarget->GetThreadsPerFile();
+        }
+
+        if (pTarget->GetArrivalRate() > 0)
+        {
+            fUseThrougputMeter = true;
+            throughputMeter.StartArrivals(pTarget->GetArrivalRate(), pTarget->GetPoissonArrivals(), p->pRand);
+        }
+        else if (!pTarget->GetTracePath().empty() && pTarget->GetTraceTimestamps())
         {
-            dwBurstSize /= pTarget->GetThreadsPerFile();
+            fUseThrougputMeter = true;
+            throughputMeter.StartTrace();
         }
-
-        if (pTarget->GetThroughputInBytesPerMillisecond() > 0 || pTarget->GetThinkTime() > 0)
+        else if (pTarget->GetThroughputInBytesPerMillisecond() > 0 || pTarget->GetThinkTime() > 0 ||
+                 p->ppTargetRateLimits[i] != nullptr || p->pRunRateLimit != nullptr || p->pPhaseRateLimit != nullptr)
         {
             fUseThrougputMeter = true;
-            throughputMeter.Start(pTarget->GetThroughputInBytesPerMillisecond(), pTarget->GetBlockSizeInBytes(), pTarget->GetThinkTime(), dwBurstSize);
+            throughputMeter.Start(pTarget->GetThroughputInBytesPerMillisecondExact(), pTarget->GetMeanBlockSizeInBytes(), pTarget->GetThinkTime(), dwBurstSize, pTarget->GetThrottleSpinMicroseconds());
+
+            if (p->ppTargetRateLimits[i] != nullptr)
+            {
+                throughputMeter.AddSharedLimit(p->ppTargetRateLimits[i]);
+            }
+            if (p->pRunRateLimit != nullptr)
+            {
+                throughputMeter.AddSharedLimit(p->pRunRateLimit);
+            }
+            if (p->pPhaseRateLimit != nullptr)
+            {
+                throughputMeter.AddSharedLimit(p->pPhaseRateLimit);
+            }
         }
 
         p->vThroughputMeters.push_back(throughputMeter);
@@ -1673,11 +3436,62 @@ DWORD WINAPI threadFunc(LPVOID cookie)
         p->vThroughputMeters.clear();
     }
 
+    // warmup runs at the start of the load phases; the phase rate limit was created at its rate
+    if (p->pPhaseSchedule != nullptr)
+    {
+        p->pPhaseSchedule->GetState(0, &p->phaseState);
+    }
+
     //FUTURE EXTENSION: enable asynchronous I/O even if only 1 outstanding I/O per file (requires another parameter)
     if (cIORequests == 1 || fAllMappedIo)
     {
         //synchronous IO - no setup needed
     }
+#ifdef __linux__
+    else if (ioEngine == IoEngine::IoUring)
+    {
+        //
+        // create the io_uring; one entry per request plus one for the throttle timeout
+        // a submission queue poller shares the thread's CPU, unless affinity is disabled
+        //
+        const bool fSqPollAffinity = !p->pTimeSpan->GetDisableAffinity();
+        if (!ioUring.Initialize(cIORequests + 1,
+                                p->pTimeSpan->GetSqPoll(),
+                                fSqPollAffinity ? (p->wGroupNum * 64 + p->bProcNum) : -1))
+        {
+            PrintError("unable to create io_uring (error code: %u)\n", errno);
+            fOk = false;
+            goto cleanup;
+        }
+
+        if (ioUring.IsSqPoll())
+        {
+            p->pResults->ulSqPollThreadId = ioUring.GetSqPollThreadId();
+            p->pResults->fSqPollAffinity = fSqPollAffinity;
+            p->pResults->wSqPollGroup = p->wGroupNum;
+            p->pResults->bSqPollProc = p->bProcNum;
+            PrintVerbose(p->pProfile->GetVerbose(), "thread %u: io_uring submission queue poller is thread %u\n", p->ulThreadNo, p->pResults->ulSqPollThreadId);
+        }
+
+        if (p->pTimeSpan->GetRegisteredIo() && !registerIoUringResources(p, &ioUring, &vIoUringBuffers))
+        {
+            fOk = false;
+            goto cleanup;
+        }
+    }
+    else if (ioEngine == IoEngine::LinuxAio)
+    {
+        //
+        // create the AIO context, able to hold all of the thread's requests in flight
+        //
+        if (!linuxAio.Initialize(cIORequests))
+        {
+            PrintError("unable to create Linux AIO context (error code: %u)\n", errno);
+            fOk = false;
+            goto cleanup;
+        }
+    }
+#else
     else if (p->pTimeSpan->GetCompletionRoutines() && !fAnyMappedIo)
     {
         //in case of completion routines hEvent field is not used,
@@ -1704,7 +3518,11 @@ DWORD WINAPI threadFunc(LPVOID cookie)
                 goto cleanup;
             }
         }
+
+        // files opened per IO (-mo) are associated as they are opened
+        p->hCompletionPort = hCompletionPort;
     }
+#endif
 
     //
     // wait for a signal to start
@@ -1718,6 +3536,16 @@ DWORD WINAPI threadFunc(LPVOID cookie)
     }
     PrintVerbose(p->pProfile->GetVerbose(), "thread %u: received signal to start\n", p->ulThreadNo);
 
+    // arrival schedules begin with the run, not when the thread was set up
+    for (size_t iTarget = 0; iTarget < p->vThroughputMeters.size(); iTarget++)
+    {
+        if (p->vThroughputMeters[iTarget].IsArrivalSchedule())
+        {
+            p->vThroughputMeters[iTarget].ResetArrivals();
+            scheduleTraceArrival(p, iTarget);
+        }
+    }
+
     //check if everything is ok
     if (g_bError)
     {
@@ -1735,6 +3563,26 @@ DWORD WINAPI threadFunc(LPVOID cookie)
             goto cleanup;
         }
     }
+#ifdef __linux__
+    else if (ioEngine == IoEngine::IoUring)
+    {
+        // use io_uring (the ring is closed during cleanup)
+        if (!doWorkUsingIoUring(p, &ioUring, p->pTimeSpan->GetRegisteredIo() ? &vIoUringBuffers : nullptr))
+        {
+            fOk = false;
+            goto cleanup;
+        }
+    }
+    else if (ioEngine == IoEngine::LinuxAio)
+    {
+        // use Linux AIO (the context is closed during cleanup)
+        if (!doWorkUsingLinuxAio(p, &linuxAio))
+        {
+            fOk = false;
+            goto cleanup;
+        }
+    }
+#else
     else if (!p->pTimeSpan->GetCompletionRoutines() || fAnyMappedIo)
     {
         // use IO Completion Ports (it will also close the I/O completion port)
@@ -1753,10 +3601,16 @@ DWORD WINAPI threadFunc(LPVOID cookie)
             goto cleanup;
         }
     }
+#endif
 
     assert(!g_bError);  // at this point we shouldn't be seeing initialization error
 
     // save results
+    if (p->pTimeSpan->GetReportIntervalInMilliseconds())
+    {
+        // publish the last of the statistics for the final interval report
+        p->pResults->threadStatistics.Publish(PerfTimer::GetTime());
+    }
 
 cleanup:
     if (!fOk)
@@ -1764,13 +3618,44 @@ cleanup:
         g_bThreadError = TRUE;
     }
 
-    // free memory allocated with VirtualAlloc
+#ifdef __linux__
+    // close the ring/context before their buffers are released
+    ioUring.Close();
+    linuxAio.Close();
+#endif
+
+    // close files opened for IO still in flight (-mo), and remove what is left of the scratch files (-mm)
+    for (auto& ioRequest : p->vIORequest)
+    {
+        if (ioRequest.GetFileHandle() != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(ioRequest.GetFileHandle());
+            ioRequest.SetFileHandle(INVALID_HANDLE_VALUE);
+        }
+    }
+
+    for (const auto& fileSet : p->vFileSets)
+    {
+        for (const auto& sScratchFile : fileSet.dqScratchFiles)
+        {
+            DeleteFile(sScratchFile.c_str());
+        }
+    }
+
+    // free memory allocated with VirtualAlloc, or leave it for the next timespan
     for (auto i = p->vpDataBuffers.begin(); i != p->vpDataBuffers.end(); i++)
     {
         if (nullptr != *i)
         {
+            if (p->pResourcePool != nullptr)
+            {
+                p->pResourcePool->ReleaseBuffer(*i);
+            }
+            else
+            {
 #pragma prefast(suppress:6001, "Prefast does not understand this vector will only contain validly allocated buffer pointers")
-            VirtualFree(*i, 0, MEM_RELEASE);
+                VirtualFree(*i, 0, MEM_RELEASE);
+            }
         }
     }
 
@@ -1784,10 +3669,17 @@ cleanup:
         }
     }
 
-    // close files
-    for (auto i = vhUniqueHandles.begin(); i != vhUniqueHandles.end(); i++)
+    // close files, or leave them open for the next timespan
+    for (size_t i = 0; i < vhUniqueHandles.size(); i++)
     {
-        CloseHandle(*i);
+        if (vfPooledHandles[i])
+        {
+            p->pResourcePool->ReleaseHandle(vUniqueTargets[i], vhUniqueHandles[i]);
+        }
+        else
+        {
+            CloseHandle(vhUniqueHandles[i]);
+        }
     }
 
     // close completion ports
@@ -1809,6 +3701,9 @@ cleanup:
 struct ETWSessionInfo IORequestGenerator::_GetResultETWSession(const EVENT_TRACE_PROPERTIES *pTraceProperties) const
 {
     struct ETWSessionInfo session = {};
+#ifdef __linux__
+    UNREFERENCED_PARAMETER(pTraceProperties);
+#else
     if (nullptr != pTraceProperties)
     {
         session.lAgeLimit = pTraceProperties->AgeLimit;
@@ -1823,6 +3718,7 @@ struct ETWSessionInfo IORequestGenerator::_GetResultETWSession(const EVENT_TRACE
         session.ulNumberOfBuffers = pTraceProperties->NumberOfBuffers;
         session.ulRealTimeBuffersLost = pTraceProperties->RealTimeBuffersLost;
     }
+#endif
     return session;
 }
 
@@ -1875,14 +3771,20 @@ DWORD IORequestGenerator::_CreateDirectoryPath(const char *pszPath) const
 bool IORequestGenerator::_CreateFile(UINT64 ullFileSize, const char *pszFilename, bool fZeroBuffers, bool fVerbose) const
 {
     bool fSlowWrites = false;
-    PrintVerbose(fVerbose, "Creating file '%s' of size %I64u.\n", pszFilename, ullFileSize);
+    PrintVerbose(fVerbose, "Creating file '%s' of size %llu.\n", pszFilename, ullFileSize);
 
+#ifdef __linux__
+    //there is no equivalent of setting the valid data length; extents which were only
+    //reserved read back as zeroes without touching the device, so always write the file
+    fSlowWrites = true;
+#else
     //enable SE_MANAGE_VOLUME_NAME privilege, required to set valid size of a file
     if (!SetPrivilege(SE_MANAGE_VOLUME_NAME, "WARNING:"))
     {
         PrintError("WARNING: Could not set privileges for setting valid file size; will use a slower method of preparing the file\n", GetLastError());
         fSlowWrites = true;
     }
+#endif
 
     // there are various forms of paths we do not support creating subdir hierarchies
     // for - relative and unc paths specifically. this is fine, and not neccesary to
@@ -1934,6 +3836,7 @@ bool IORequestGenerator::_CreateFile(UINT64 ullFileSize, const char *pszFilename
             CloseHandle(hFile);
             return false;
         }
+#ifndef __linux__
         //try setting valid size of the file (privileges for that are enabled before CreateFile)
         if (!fSlowWrites && !SetFileValidData(hFile, ullFileSize))
         {
@@ -1942,6 +3845,7 @@ bool IORequestGenerator::_CreateFile(UINT64 ullFileSize, const char *pszFilename
                        GetLastError());
             fSlowWrites = true;
         }
+#endif
 
         //if setting valid size couldn't be performed, fill in the file by simply writing to it (slower)
         if (fSlowWrites)
@@ -2017,6 +3921,64 @@ bool IORequestGenerator::_CreateFile(UINT64 ullFileSize, const char *pszFilename
     return true;
 }
 
+/*****************************************************************************/
+// create the files of a file set (-m), each of the given size, in the set's
+// directory; the files are created in parallel, by as many threads as there
+// are processors, each taking the next file until none are left
+//
+bool IORequestGenerator::_CreateFileSet(UINT64 ullFileSize, const char *pszDirectory, DWORD dwFileCount, bool fZeroBuffers, bool fVerbose) const
+{
+    Target fileSet;
+    fileSet.SetPath(pszDirectory);
+    fileSet.SetFileSetCount(dwFileCount);
+
+    PrintVerbose(fVerbose, "Creating %u files of size %llu in '%s'.\n", dwFileCount, ullFileSize, pszDirectory);
+
+    // the directory is created with its parents for the forms of path _CreateDirectoryPath
+    // supports, else on its own
+    if (GetFileAttributes(pszDirectory) == INVALID_FILE_ATTRIBUTES)
+    {
+        DWORD dwError = _CreateDirectoryPath(fileSet.GetFileSetFilePath(static_cast<DWORD>(0)).c_str());
+        if (dwError == ERROR_NOT_SUPPORTED)
+        {
+            dwError = CreateDirectory(pszDirectory, nullptr) ? ERROR_SUCCESS : GetLastError();
+        }
+
+        if (dwError != ERROR_SUCCESS && dwError != ERROR_ALREADY_EXISTS)
+        {
+            PrintError("Could not create the directory '%s' (error code: %u)\n", pszDirectory, dwError);
+            return false;
+        }
+    }
+
+    DWORD cThreads = min(dwFileCount, max(1u, thread::hardware_concurrency()));
+    atomic<DWORD> iNextFile(0);
+    atomic<bool> fFailed(false);
+    vector<thread> vThreads;
+
+    for (DWORD i = 0; i < cThreads; i++)
+    {
+        vThreads.emplace_back([&]()
+        {
+            DWORD iFile;
+            while (!fFailed && (iFile = iNextFile++) < dwFileCount)
+            {
+                if (!_CreateFile(ullFileSize, fileSet.GetFileSetFilePath(iFile).c_str(), fZeroBuffers, false))
+                {
+                    fFailed = true;
+                }
+            }
+        });
+    }
+
+    for (auto& t : vThreads)
+    {
+        t.join();
+    }
+
+    return !fFailed;
+}
+
 /*****************************************************************************/
 void IORequestGenerator::_TerminateWorkerThreads(vector<HANDLE>& vhThreads) const
 {
@@ -2103,7 +4065,14 @@ bool IORequestGenerator::_PrecreateFiles(Profile& profile) const
         vector<string> vCreatedFiles;
         for (auto file : vFilesToCreate)
         {
-            fOk = _CreateFile(file.ullFileSize, file.sPath.c_str(), file.fZeroWriteBuffers, profile.GetVerbose());
+            if (file.dwFileSetCount != 0)
+            {
+                fOk = _CreateFileSet(file.ullFileSize, file.sPath.c_str(), file.dwFileSetCount, file.fZeroWriteBuffers, profile.GetVerbose());
+            }
+            else
+            {
+                fOk = _CreateFile(file.ullFileSize, file.sPath.c_str(), file.fZeroWriteBuffers, profile.GetVerbose());
+            }
             if (!fOk)
             {
                 break;
@@ -2120,17 +4089,130 @@ bool IORequestGenerator::_PrecreateFiles(Profile& profile) const
     return fOk;
 }
 
+bool IORequestGenerator::_SearchLatencySlo(const Profile& profile, const TimeSpan& timeSpan, TimeSpan& kneeTimeSpan, Results& kneeResults, struct Synchronization *pSynch)
+{
+    const double lfPercentile = timeSpan.GetLatencySloPercentile();
+    LatencySloSearch search(timeSpan.GetLatencySloMilliseconds(), timeSpan.GetLatencySloMaxRequestCount());
+
+    // the curve precedes the results; keep it out of XML results
+    FILE *pOut = (profile.GetResultsFormat() == ResultsFormat::Xml) ? stderr : stdout;
+
+    char szPercentile[32];
+    sprintf_s(szPercentile, _countof(szPercentile), "p%g (ms)", lfPercentile);
+
+    fprintf(pOut, "\nLatency SLO search: p%g <= %.3fms, 1 to %u outstanding IOs per target per thread\n\n",
+        lfPercentile,
+        timeSpan.GetLatencySloMilliseconds(),
+        timeSpan.GetLatencySloMaxRequestCount());
+    fprintf(pOut, " outstanding |         IOPS |      MiB/s |   p50 (ms) | %12s | SLO\n", szPercentile);
+    fprintf(pOut, "------------------------------------------------------------------------\n");
+    fflush(pOut);
+
+    for (DWORD dwRequestCount = search.GetNextRequestCount(); dwRequestCount != 0; dwRequestCount = search.GetNextRequestCount())
+    {
+        // -O sets the outstanding IO count of the timespan's threads, -o of each target
+        TimeSpan stepTimeSpan(timeSpan);
+        if (timeSpan.GetRequestCount() != 0)
+        {
+            stepTimeSpan.SetRequestCount(dwRequestCount);
+        }
+        else
+        {
+            stepTimeSpan.ClearTargets();
+            for (auto target : timeSpan.GetTargets())
+            {
+                target.SetRequestCount(dwRequestCount);
+                stepTimeSpan.AddTarget(target);
+            }
+        }
+
+        PrintVerbose(profile.GetVerbose(), "latency SLO search: running with %u outstanding IOs\n", dwRequestCount);
+
+        Results results;
+        if (!_GenerateRequestsForTimeSpan(profile, stepTimeSpan, results, pSynch))
+        {
+            return false;
+        }
+
+        LatencySloSearch::Step step = LatencySloSearch::Measure(results, lfPercentile);
+        step.dwRequestCount = dwRequestCount;
+        search.AddStep(step);
+
+        const LatencySloSearch::Step& added = search.GetSteps().back();
+        fprintf(pOut, "%12u | %12.2f | %10.2f | %10.3f | %12.3f | %s\n",
+            added.dwRequestCount,
+            added.lfIops,
+            added.lfBytesPerSecond / (1024 * 1024),
+            added.lfMedianMilliseconds,
+            added.lfLatencyMilliseconds,
+            added.fMetSlo ? "met" : "missed");
+        fflush(pOut);
+
+        // keep the run at the knee; until there is one, the first run
+        if (search.GetKnee() == static_cast<int>(search.GetSteps().size() - 1) || search.GetSteps().size() == 1)
+        {
+            kneeTimeSpan = stepTimeSpan;
+            kneeResults = move(results);
+        }
+
+        // an early stop (e.g., ctrl+c) ends the search
+        if (pSynch != nullptr && pSynch->hStopEvent != NULL && WaitForSingleObject(pSynch->hStopEvent, 0) == WAIT_OBJECT_0)
+        {
+            PrintVerbose(profile.GetVerbose(), "latency SLO search: stopped\n");
+            break;
+        }
+    }
+
+    int iKnee = search.GetKnee();
+    if (iKnee >= 0)
+    {
+        const LatencySloSearch::Step& knee = search.GetSteps()[iKnee];
+        fprintf(pOut, "\nknee: %u outstanding IOs, %.2f IOPS, %.2f MiB/s, p%g %.3fms\n",
+            knee.dwRequestCount,
+            knee.lfIops,
+            knee.lfBytesPerSecond / (1024 * 1024),
+            lfPercentile,
+            knee.lfLatencyMilliseconds);
+    }
+    else
+    {
+        fprintf(pOut, "\nknee: none, no run met the SLO; the results are of the run with 1 outstanding IO\n");
+    }
+    fflush(pOut);
+
+    return true;
+}
+
 bool IORequestGenerator::GenerateRequests(Profile& profile, IResultParser& resultParser, struct Synchronization *pSynch)
 {
     bool fOk = _PrecreateFiles(profile);
     if (fOk)
     {
-        const vector<TimeSpan>& vTimeSpans = profile.GetTimeSpans();
+        const vector<TimeSpan> vTimeSpans = profile.GetTimeSpans();
         vector<Results> vResults(vTimeSpans.size());
+        vector<TimeSpan> vRunTimeSpans(vTimeSpans);
+
         for (size_t i = 0; fOk && (i < vTimeSpans.size()); i++)
         {
             PrintVerbose(profile.GetVerbose(), "Generating requests for timespan %u.\n", i + 1);
-            fOk = _GenerateRequestsForTimeSpan(profile, vTimeSpans[i], vResults[i], pSynch);
+
+            if (vTimeSpans[i].GetLatencySloPercentile() > 0)
+            {
+                fOk = _SearchLatencySlo(profile, vTimeSpans[i], vRunTimeSpans[i], vResults[i], pSynch);
+            }
+            else
+            {
+                fOk = _GenerateRequestsForTimeSpan(profile, vTimeSpans[i], vResults[i], pSynch);
+            }
+        }
+
+        _vpThreadResourcePools.clear();
+
+        // a latency SLO search reports the results of its timespan as run at the knee
+        profile.ClearTimeSpans();
+        for (const auto& timeSpan : vRunTimeSpans)
+        {
+            profile.AddTimeSpan(timeSpan);
         }
 
         // TODO: show results only for timespans that succeeded
@@ -2189,6 +4271,16 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         {
             return false;
         }
+        if (i->GetReducibleWriteData() && !i->AllocateDataPool(&r))
+        {
+            PrintError("ERROR: unable to allocate the write data pool for target '%s'\n", i->GetPath().c_str());
+            return false;
+        }
+        if (i->GetVerifyData())
+        {
+            // the seed in each header identifies the run that wrote it
+            i->AllocateVerifier(static_cast<UINT32>(i - vTargets.begin()), static_cast<UINT32>(PerfTimer::GetTime()));
+        }
     }
 
     // check if user wanted to create a file
@@ -2209,14 +4301,101 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
                 continue;
             }
 
-            //create only regular files
-            if (!_CreateFile(i->GetFileSize(), str.c_str(), i->GetZeroWriteBuffers(), profile.GetVerbose()))
+            //create only regular files, or the files of a file set
+            if (i->GetFileSetCount() != 0)
+            {
+                if (!_CreateFileSet(i->GetFileSize(), str.c_str(), i->GetFileSetCount(), i->GetZeroWriteBuffers(), profile.GetVerbose()))
+                {
+                    return false;
+                }
+            }
+            else if (!_CreateFile(i->GetFileSize(), str.c_str(), i->GetZeroWriteBuffers(), profile.GetVerbose()))
             {
                 return false;
             }
         }
     }
 
+    // open the traces to replay; each reader is shared by the threads replaying its target
+    vector<unique_ptr<TraceReader>> vTraceReaders(vTargets.size());
+    vector<TraceReader *> vpTraceReaders(vTargets.size(), nullptr);
+    for (size_t iTarget = 0; iTarget < vTargets.size(); iTarget++)
+    {
+        Target& target = vTargets[iTarget];
+
+        if (target.GetTracePath().empty())
+        {
+            continue;
+        }
+
+        vTraceReaders[iTarget].reset(new TraceReader());
+        if (!vTraceReaders[iTarget]->Open(target.GetTracePath()))
+        {
+            return false;
+        }
+        vpTraceReaders[iTarget] = vTraceReaders[iTarget].get();
+
+        PrintVerbose(profile.GetVerbose(), "replaying trace '%s' to '%s': %llu IOs over %.3fs, largest IO %u bytes\n",
+            target.GetTracePath().c_str(),
+            target.GetPath().c_str(),
+            vTraceReaders[iTarget]->GetRecordCount(),
+            vTraceReaders[iTarget]->GetDuration() / 1e9,
+            vTraceReaders[iTarget]->GetMaxLength());
+
+        // buffers must hold the largest IO of the trace
+        if (vTraceReaders[iTarget]->GetMaxLength() > target.GetBlockSizeInBytes())
+        {
+            target.SetBlockSizeInBytes(vTraceReaders[iTarget]->GetMaxLength());
+        }
+    }
+
+    // throughput limits shared by the threads on each target, and by all threads
+    vector<unique_ptr<SharedRateLimit>> vTargetRateLimits(vTargets.size());
+    vector<SharedRateLimit *> vpTargetRateLimits(vTargets.size(), nullptr);
+    DWORD dwRunSpinMicroseconds = MAXDWORD;
+    for (size_t iTarget = 0; iTarget < vTargets.size(); iTarget++)
+    {
+        const Target& target = vTargets[iTarget];
+
+        if (target.GetTotalThroughputIOPS() > 0)
+        {
+            vTargetRateLimits[iTarget].reset(new SharedRateLimit(target.GetTotalThroughputIOPS() / 1000.0, true, target.GetThrottleSpinMicroseconds()));
+        }
+        else if (target.GetTotalThroughputInBytesPerMillisecond() > 0)
+        {
+            vTargetRateLimits[iTarget].reset(new SharedRateLimit(target.GetTotalThroughputInBytesPerMillisecond(), false, target.GetThrottleSpinMicroseconds()));
+        }
+        vpTargetRateLimits[iTarget] = vTargetRateLimits[iTarget].get();
+
+        // the run's limit only spins if every target does
+        dwRunSpinMicroseconds = min(dwRunSpinMicroseconds, target.GetThrottleSpinMicroseconds());
+    }
+
+    unique_ptr<SharedRateLimit> pRunRateLimit;
+    if (timeSpan.GetTotalThroughputIOPS() > 0)
+    {
+        pRunRateLimit.reset(new SharedRateLimit(timeSpan.GetTotalThroughputIOPS() / 1000.0, true, dwRunSpinMicroseconds));
+    }
+    else if (timeSpan.GetTotalThroughputInBytesPerMillisecond() > 0)
+    {
+        pRunRateLimit.reset(new SharedRateLimit(timeSpan.GetTotalThroughputInBytesPerMillisecond(), false, dwRunSpinMicroseconds));
+    }
+
+    // load phases, and the limit their rates are applied through
+    unique_ptr<PhaseSchedule> pPhaseSchedule;
+    unique_ptr<SharedRateLimit> pPhaseRateLimit;
+    if (timeSpan.GetPhases().size() > 0)
+    {
+        pPhaseSchedule.reset(new PhaseSchedule(timeSpan.GetPhases()));
+
+        if (any_of(timeSpan.GetPhases().begin(), timeSpan.GetPhases().end(), [](const LoadPhase& phase) { return phase.GetIOPS().fSet; }))
+        {
+            PhaseState state;
+            pPhaseSchedule->GetState(0, &state);
+            pPhaseRateLimit.reset(new SharedRateLimit(state.lfIOPS / 1000, true, dwRunSpinMicroseconds));
+        }
+    }
+
     // get thread count
     UINT32 cThreads = timeSpan.GetThreadCount();
     if (cThreads < 1)
@@ -2227,15 +4406,31 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         }
     }
 
+    // start capturing the IO trace, if requested
+    IoTraceWriter ioTraceWriter;
+    if (!timeSpan.GetIoTracePath().empty() && !ioTraceWriter.Start(timeSpan.GetIoTracePath(), cThreads))
+    {
+        return false;
+    }
+
     // allocate memory for thread handles
     vector<HANDLE> vhThreads(cThreads);
 
+    while (_vpThreadResourcePools.size() < cThreads)
+    {
+        _vpThreadResourcePools.push_back(unique_ptr<ThreadResourcePool>(new ThreadResourcePool()));
+    }
+
     //
     // allocate memory for performance counters
     //
     vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> vPerfInit(g_SystemInformation.processorTopology._ulProcessorCount);
     vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> vPerfDone(g_SystemInformation.processorTopology._ulProcessorCount);
     vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> vPerfDiff(g_SystemInformation.processorTopology._ulProcessorCount);
+#ifdef __linux__
+    vector<UINT64> vSqPollInit;
+    vector<UINT64> vSqPollDone;
+#endif
 
     //
     // create start event
@@ -2280,12 +4475,24 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
     g_SystemInformation.processorTopology.GetActiveGroupProcessor(wGroupCtr, bProcCtr, false);
 
     volatile bool fAccountingOn = false;
-    UINT64 ullStartTime;    //start time
+    UINT64 ullStartTime = 0;    //start time
     UINT64 ullTimeDiff;  //elapsed test time (in units returned by QueryPerformanceCounter)
     vector<UINT64> vullSharedSequentialOffsets(vTargets.size(), 0);
 
     results.vThreadResults.clear();
     results.vThreadResults.resize(cThreads);
+    if (timeSpan.GetReportIntervalInMilliseconds())
+    {
+        // threads publish their statistics often enough for the reporter to see each interval
+        // closely, but no more than every 10ms
+        UINT64 ullPublishInterval = PerfTimer::MillisecondsToPerfTime(min<UINT32>(10, timeSpan.GetReportIntervalInMilliseconds() / 10));
+        for (auto& threadResults : results.vThreadResults)
+        {
+            threadResults.threadStatistics.Initialize(timeSpan.GetMeasureLatency(), ullPublishInterval);
+        }
+    }
+    IntervalReporter intervalReporter;
+
     for (UINT32 iThread = 0; iThread < cThreads; ++iThread)
     {
         PrintVerbose(profile.GetVerbose(), "creating thread %u\n", iThread);
@@ -2315,6 +4522,8 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
             // and receive the entire seq index array.
             // relative thread number is the same as thread number.
             cookie->pullSharedSequentialOffsets = &vullSharedSequentialOffsets[0];
+            cookie->ppTraceReaders = &vpTraceReaders[0];
+            cookie->ppTargetRateLimits = &vpTargetRateLimits[0];
             ulRelativeThreadNo = iThread;
             for (auto i = vTargets.begin();
                  i != vTargets.end();
@@ -2347,9 +4556,11 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
             size_t cAssignedThreads = 0;
             size_t cBaseThread = 0;
             auto psi = vullSharedSequentialOffsets.begin();
+            auto pti = vpTraceReaders.begin();
+            auto pri = vpTargetRateLimits.begin();
             for (auto i = vTargets.begin();
                  i != vTargets.end();
-                 i++, psi++)
+                 i++, psi++, pti++, pri++)
             {
                 // per-file thread mode: groups of threads operate on individual files
                 // and receive the specific seq index for their file (note: singular).
@@ -2369,6 +4580,8 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
                     // confirm copy constructor?
                     cookie->vTargets.push_back(*i);
                     cookie->pullSharedSequentialOffsets = &(*psi);
+                    cookie->ppTraceReaders = &(*pti);
+                    cookie->ppTargetRateLimits = &(*pri);
                     ulRelativeThreadNo = (iThread - cBaseThread) % i->GetThreadsPerFile();
 
                     PrintVerbose(profile.GetVerbose(), "thread %u is relative thread %u for %s\n", iThread, ulRelativeThreadNo, i->GetPath().c_str());
@@ -2386,8 +4599,13 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         cookie->ulRelativeThreadNo = ulRelativeThreadNo;
         cookie->pfAccountingOn = &fAccountingOn;
         cookie->pullStartTime = &ullStartTime;
+        cookie->pIoTraceRing = timeSpan.GetIoTracePath().empty() ? nullptr : ioTraceWriter.GetRing(iThread);
         cookie->ulRandSeed = timeSpan.GetRandSeed() + iThread;  // each thread has a different random seed
         cookie->pRand = pRand;
+        cookie->pRunRateLimit = pRunRateLimit.get();
+        cookie->pPhaseSchedule = pPhaseSchedule.get();
+        cookie->pPhaseRateLimit = pPhaseRateLimit.get();
+        cookie->pResourcePool = _vpThreadResourcePools[iThread].get();
 
         //Set thread group and proc affinity
 
@@ -2500,12 +4718,12 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         //
         // start etw session
         //
-        TRACEHANDLE hTraceSession = NULL;
+        TRACEHANDLE hTraceSession = 0;
         if (fUseETW)
         {
             PrintVerbose(profile.GetVerbose(), "starting trace session\n");
             hTraceSession = StartETWSession(profile);
-            if (NULL == hTraceSession)
+            if (0 == hTraceSession)
             {
                 PrintError("Could not start ETW session\n");
                 _TerminateWorkerThreads(vhThreads);
@@ -2540,6 +4758,9 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
             _TerminateWorkerThreads(vhThreads);
             return false;
         }
+#ifdef __linux__
+        getSqPollTimes(results.vThreadResults, vSqPollInit);
+#endif
 
         TraceLoggingActivity<g_hEtwProvider, DISKSPD_TRACE_INFO, TRACE_LEVEL_NONE> RunActivity;
         TraceLoggingWriteStart(RunActivity, "Run Time");
@@ -2550,6 +4771,11 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         ullStartTime = PerfTimer::GetTime();
         fAccountingOn = true;
 
+        if (timeSpan.GetReportIntervalInMilliseconds())
+        {
+            intervalReporter.Start(timeSpan, results.vThreadResults, ullStartTime);
+        }
+
         assert(timeSpan.GetDuration() > 0);
         if (bSynchStop)
         {
@@ -2572,6 +4798,7 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         //get cycle count and perf counters
         fAccountingOn = false;
         ullTimeDiff = PerfTimer::GetTime() - ullStartTime;
+        intervalReporter.Stop();
         PrintVerbose(profile.GetVerbose(), "stopped measurements, total measured time %.2lfs...\n", PerfTimer::PerfTimeToSeconds(ullTimeDiff));
 
         TraceLoggingWriteStop(RunActivity, "Run Time");
@@ -2583,6 +4810,9 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
             _TerminateWorkerThreads(vhThreads);
             return false;
         }
+#ifdef __linux__
+        getSqPollTimes(results.vThreadResults, vSqPollDone);
+#endif
 
         //
         // notify the front-end that the test has just finished;
@@ -2672,6 +4902,33 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
         return false;
     }
 
+    //
+    // finish the IO trace
+    //
+    if (!timeSpan.GetIoTracePath().empty())
+    {
+        if (!ioTraceWriter.Stop())
+        {
+            return false;
+        }
+
+        PrintVerbose(profile.GetVerbose(), "captured %llu IOs to trace '%s'\n", ioTraceWriter.GetRecordCount(), timeSpan.GetIoTracePath().c_str());
+        if (ioTraceWriter.GetDroppedCount() > 0)
+        {
+            PrintError("WARNING: IO trace '%s' dropped %llu IOs completed faster than they could be written\n",
+                timeSpan.GetIoTracePath().c_str(),
+                ioTraceWriter.GetDroppedCount());
+        }
+    }
+
+    //
+    // report the final interval from the statistics the threads published as they exited
+    //
+    if (timeSpan.GetReportIntervalInMilliseconds() && ullTimeDiff)
+    {
+        intervalReporter.ReportFinal(ullStartTime + ullTimeDiff);
+    }
+
     //
     // close events' handles
     //
@@ -2743,6 +5000,14 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
     results.vSystemProcessorPerfInfo = vPerfDiff;
     results.ullTimeCount = ullTimeDiff;
 
+#ifdef __linux__
+    // get io_uring submission queue poller times, if any were sampled
+    for (size_t i = 0; i < vSqPollDone.size() && i < vSqPollInit.size(); i++)
+    {
+        results.vThreadResults[i].ullSqPollTime = (vSqPollDone[i] > vSqPollInit[i]) ? (vSqPollDone[i] - vSqPollInit[i]) : 0;
+    }
+#endif
+
     //
     // create structure containing etw results and properties
     //
@@ -2773,11 +5038,27 @@ bool IORequestGenerator::_GenerateRequestsForTimeSpan(const Profile& profile, co
     for (auto i = vTargets.begin(); i != vTargets.end(); i++)
     {
         i->FreeRandomDataWriteBuffer();
+        i->FreeDataPool();
+        i->FreeVerifier();
+    }
+
+    // data verification failures fail the run, after its results are reported
+    UINT64 cVerifyErrors = 0;
+    for (const auto& threadResults : results.vThreadResults)
+    {
+        for (const auto& targetResults : threadResults.vTargetResults)
+        {
+            cVerifyErrors += targetResults.ullVerifyErrorCount;
+        }
+    }
+    if (cVerifyErrors > 0)
+    {
+        PrintError("ERROR: data verification (-Zv) failed for %llu units\n", cVerifyErrors);
     }
 
     // TODO: this won't catch error cases, which exit early
     InterlockedExchange(&g_lGeneratorRunning, 0);
-    return true;
+    return (cVerifyErrors == 0);
 }
 
 vector<struct IORequestGenerator::CreateFileParameters> IORequestGenerator::_GetFilesToPrecreate(const Profile& profile) const
@@ -2794,6 +5075,7 @@ vector<struct IORequestGenerator::CreateFileParameters> IORequestGenerator::_Get
             createFileParameters.sPath = target.GetPath();
             createFileParameters.ullFileSize = target.GetFileSize();
             createFileParameters.fZeroWriteBuffers = target.GetZeroWriteBuffers();
+            createFileParameters.dwFileSetCount = target.GetFileSetCount();
 
             filesMap[createFileParameters.sPath].push_back(createFileParameters);
         }
@@ -2806,6 +5088,7 @@ vector<struct IORequestGenerator::CreateFileParameters> IORequestGenerator::_Get
         {
             UINT64 ullLastNonZeroSize = fileMapEntry.second[0].ullFileSize;
             UINT64 ullMaxSize = fileMapEntry.second[0].ullFileSize;
+            DWORD dwMaxFileSetCount = fileMapEntry.second[0].dwFileSetCount;
             bool fLastZeroWriteBuffers = fileMapEntry.second[0].fZeroWriteBuffers;
             bool fHasZeroSizes = false;
             bool fConstantSize = true;
@@ -2813,6 +5096,7 @@ vector<struct IORequestGenerator::CreateFileParameters> IORequestGenerator::_Get
             for (auto file : fileMapEntry.second)
             {
                 ullMaxSize = max(ullMaxSize, file.ullFileSize);
+                dwMaxFileSetCount = max(dwMaxFileSetCount, file.dwFileSetCount);
                 if (ullLastNonZeroSize == 0)
                 {
                     ullLastNonZeroSize = file.ullFileSize;
@@ -2840,6 +5124,7 @@ vector<struct IORequestGenerator::CreateFileParameters> IORequestGenerator::_Get
             {
                 struct CreateFileParameters file = fileMapEntry.second[0];
                 file.ullFileSize = ullMaxSize;
+                file.dwFileSetCount = dwMaxFileSetCount;
                 if (filter == PrecreateFiles::UseMaxSize)
                 {
                     vFilesToCreate.push_back(file);
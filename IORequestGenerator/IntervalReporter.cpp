@@ -0,0 +1,289 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "IntervalReporter.h"
+
+static const double Percentiles[] = { 50, 90, 99, 99.9 };
+
+IntervalReporter::IntervalReporter() :
+    _pvThreadResults(nullptr),
+    _ullStartTime(0),
+    _ullInterval(0),
+    _fJson(false),
+    _fLatency(false),
+    _fStopping(false)
+{
+}
+
+IntervalReporter::~IntervalReporter()
+{
+    if (_reporter.joinable())
+    {
+        {
+            unique_lock<mutex> lock(_lock);
+            _fStopping = true;
+        }
+        _cvStop.notify_all();
+        _reporter.join();
+    }
+}
+
+void IntervalReporter::Start(const TimeSpan& timeSpan, const vector<ThreadResults>& vThreadResults, UINT64 ullStartTime)
+{
+    _pvThreadResults = &vThreadResults;
+    _ullStartTime = ullStartTime;
+    _ullInterval = PerfTimer::MillisecondsToPerfTime(timeSpan.GetReportIntervalInMilliseconds());
+    _fJson = timeSpan.GetReportIntervalJson();
+    _fLatency = timeSpan.GetMeasureLatency();
+
+    // IO may have completed during warm up; the first interval starts from here
+    _TakeSnapshot(_last);
+    _last.ullTime = ullStartTime;
+
+    _fStopping = false;
+    _reporter = thread(&IntervalReporter::_Run, this);
+}
+
+void IntervalReporter::Stop()
+{
+    if (!_reporter.joinable())
+    {
+        return;
+    }
+
+    {
+        unique_lock<mutex> lock(_lock);
+        _fStopping = true;
+    }
+    _cvStop.notify_all();
+    _reporter.join();
+}
+
+void IntervalReporter::ReportFinal(UINT64 ullEndTime)
+{
+    if (_pvThreadResults == nullptr)
+    {
+        return;
+    }
+
+    // skip a sliver of an interval left over when the run ends just after a report
+    _TakeSnapshot(_current);
+    _current.ullTime = ullEndTime;
+    if (_current.ullTime > _last.ullTime &&
+        _current.ullTime - _last.ullTime >= _ullInterval / 10)
+    {
+        _Report();
+    }
+}
+
+UINT64 IntervalReporter::GetLatencyPercentile(const IntervalCounters::LatencyCounts& vLatencyCounts, UINT64 cLatencies, double lfPercentile)
+{
+    // smallest latency with at least the percentile of the latencies at or below it
+    UINT64 cTarget = static_cast<UINT64>(ceil(cLatencies * lfPercentile / 100));
+    UINT64 cSeen = 0;
+
+    if (cTarget == 0)
+    {
+        cTarget = 1;
+    }
+
+    for (size_t i = 0; i < vLatencyCounts.size(); i++)
+    {
+        cSeen += vLatencyCounts[i];
+        if (cSeen >= cTarget)
+        {
+            return IntervalCounters::LatencyBucketValue(i);
+        }
+    }
+
+    return 0;
+}
+
+void IntervalReporter::_TakeSnapshot(Snapshot& snapshot) const
+{
+    snapshot.ullTime = PerfTimer::GetTime();
+    snapshot.ullReadIOCount = 0;
+    snapshot.ullReadBytesCount = 0;
+    snapshot.ullWriteIOCount = 0;
+    snapshot.ullWriteBytesCount = 0;
+    snapshot.ullFlushIOCount = 0;
+    snapshot.ullTrimIOCount = 0;
+    snapshot.ullMetadataIOCount = 0;
+    snapshot.vLatencyCounts.assign(_fLatency ? IntervalCounters::LatencyBucketCount : 0, 0);
+
+    IntervalCounters counters;
+    if (_fLatency)
+    {
+        counters.Initialize();
+    }
+
+    for (const auto& threadResults : *_pvThreadResults)
+    {
+        threadResults.threadStatistics.Read(counters);
+
+        snapshot.ullReadIOCount += counters.ullReadIOCount;
+        snapshot.ullReadBytesCount += counters.ullReadBytesCount;
+        snapshot.ullWriteIOCount += counters.ullWriteIOCount;
+        snapshot.ullWriteBytesCount += counters.ullWriteBytesCount;
+        snapshot.ullFlushIOCount += counters.ullFlushIOCount;
+        snapshot.ullTrimIOCount += counters.ullTrimIOCount;
+        snapshot.ullMetadataIOCount += counters.ullMetadataIOCount;
+
+        for (size_t i = 0; i < counters.cLatencyBuckets; i++)
+        {
+            snapshot.vLatencyCounts[i] += counters.vLatencyCounts[i];
+        }
+    }
+}
+
+void IntervalReporter::_Report()
+{
+    const double lfStart = PerfTimer::PerfTimeToSeconds(_last.ullTime - _ullStartTime);
+    const double lfEnd = PerfTimer::PerfTimeToSeconds(_current.ullTime - _ullStartTime);
+    const double lfInterval = lfEnd - lfStart;
+
+    const UINT64 cReadIOs = _current.ullReadIOCount - _last.ullReadIOCount;
+    const UINT64 cWriteIOs = _current.ullWriteIOCount - _last.ullWriteIOCount;
+    const UINT64 cFlushIOs = _current.ullFlushIOCount - _last.ullFlushIOCount;
+    const double lfReadIops = cReadIOs / lfInterval;
+    const double lfWriteIops = cWriteIOs / lfInterval;
+    const UINT64 cTrimIOs = _current.ullTrimIOCount - _last.ullTrimIOCount;
+    const UINT64 cMetadataIOs = _current.ullMetadataIOCount - _last.ullMetadataIOCount;
+    const double lfFlushIops = cFlushIOs / lfInterval;
+    const double lfTrimIops = cTrimIOs / lfInterval;
+    const double lfMetadataIops = cMetadataIOs / lfInterval;
+    const double lfReadMBps = (_current.ullReadBytesCount - _last.ullReadBytesCount) / lfInterval / (1024 * 1024);
+    const double lfWriteMBps = (_current.ullWriteBytesCount - _last.ullWriteBytesCount) / lfInterval / (1024 * 1024);
+
+    char szLine[1024];
+    int cch = 0;
+
+    if (_fJson)
+    {
+        cch += sprintf_s(szLine + cch, _countof(szLine) - cch,
+            "{\"start\":%.3f,\"end\":%.3f,\"iops\":%.2f,\"mibps\":%.2f,\"read_iops\":%.2f,\"read_mibps\":%.2f,\"write_iops\":%.2f,\"write_mibps\":%.2f",
+            lfStart, lfEnd,
+            lfReadIops + lfWriteIops + lfFlushIops + lfTrimIops + lfMetadataIops, lfReadMBps + lfWriteMBps,
+            lfReadIops, lfReadMBps,
+            lfWriteIops, lfWriteMBps);
+    }
+    else
+    {
+        cch += sprintf_s(szLine + cch, _countof(szLine) - cch,
+            "%8.3fs-%8.3fs: total %12.2f IOPS %10.2f MiB/s | read %12.2f IOPS %10.2f MiB/s | write %12.2f IOPS %10.2f MiB/s",
+            lfStart, lfEnd,
+            lfReadIops + lfWriteIops + lfFlushIops + lfTrimIops + lfMetadataIops, lfReadMBps + lfWriteMBps,
+            lfReadIops, lfReadMBps,
+            lfWriteIops, lfWriteMBps);
+    }
+
+    // flushes, trims and metadata operations are only shown when the mix has them
+    if (_current.ullFlushIOCount)
+    {
+        cch += sprintf_s(szLine + cch, _countof(szLine) - cch, _fJson ? ",\"flush_iops\":%.2f" : " | flush %12.2f IOPS", lfFlushIops);
+    }
+
+    if (_current.ullTrimIOCount)
+    {
+        cch += sprintf_s(szLine + cch, _countof(szLine) - cch, _fJson ? ",\"trim_iops\":%.2f" : " | trim %12.2f IOPS", lfTrimIops);
+    }
+
+    if (_current.ullMetadataIOCount)
+    {
+        cch += sprintf_s(szLine + cch, _countof(szLine) - cch, _fJson ? ",\"metadata_iops\":%.2f" : " | metadata %12.2f IOPS", lfMetadataIops);
+    }
+
+    if (_fLatency)
+    {
+        IntervalCounters::LatencyCounts vLatencyCounts(_current.vLatencyCounts.size());
+        UINT64 cLatencies = 0;
+        size_t iMax = 0;
+
+        for (size_t i = 0; i < vLatencyCounts.size(); i++)
+        {
+            vLatencyCounts[i] = _current.vLatencyCounts[i] - _last.vLatencyCounts[i];
+            cLatencies += vLatencyCounts[i];
+            if (vLatencyCounts[i])
+            {
+                iMax = i;
+            }
+        }
+
+        if (cLatencies)
+        {
+            cch += sprintf_s(szLine + cch, _countof(szLine) - cch, _fJson ? ",\"latency_ms\":{" : " | latency (ms)");
+
+            for (size_t i = 0; i < _countof(Percentiles); i++)
+            {
+                double lfLatency = GetLatencyPercentile(vLatencyCounts, cLatencies, Percentiles[i]) / 1e6;
+                cch += sprintf_s(szLine + cch, _countof(szLine) - cch, _fJson ? "%s\"p%g\":%.3f" : "%s p%g %.3f",
+                    (_fJson && i > 0) ? "," : "",
+                    Percentiles[i],
+                    lfLatency);
+            }
+
+            cch += sprintf_s(szLine + cch, _countof(szLine) - cch, _fJson ? ",\"max\":%.3f}" : " max %.3f",
+                IntervalCounters::LatencyBucketValue(iMax) / 1e6);
+        }
+    }
+
+    fprintf(stderr, "%s%s\n", szLine, _fJson ? "}" : "");
+    fflush(stderr);
+
+    swap(_last, _current);
+}
+
+void IntervalReporter::_Run()
+{
+    unique_lock<mutex> lock(_lock);
+    UINT64 ullNextTime = _ullStartTime + _ullInterval;
+
+    while (!_fStopping)
+    {
+        // intervals are scheduled from the start of the run, so that reports do not drift
+        UINT64 ullNow = PerfTimer::GetTime();
+        if (ullNow < ullNextTime)
+        {
+            _cvStop.wait_for(lock,
+                chrono::microseconds(static_cast<INT64>(PerfTimer::PerfTimeToMicroseconds(ullNextTime - ullNow)) + 1),
+                [this] { return _fStopping; });
+            continue;
+        }
+
+        lock.unlock();
+        _TakeSnapshot(_current);
+        _Report();
+        lock.lock();
+
+        while (ullNextTime <= ullNow)
+        {
+            ullNextTime += _ullInterval;
+        }
+    }
+}
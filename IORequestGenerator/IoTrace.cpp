@@ -0,0 +1,211 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Common.h"
+#include "IORequestGenerator.h"
+#include "IoTrace.h"
+
+IoTraceRing::IoTraceRing(size_t cRecords) :
+    _vRecords(cRecords),
+    _ullHead(0),
+    _cDropped(0),
+    _ullTail(0)
+{
+}
+
+bool IoTraceRing::Push(const IoTraceRecord& record)
+{
+    UINT64 ullHead = _ullHead.load(memory_order_relaxed);
+
+    if (ullHead - _ullTail.load(memory_order_acquire) == _vRecords.size())
+    {
+        _cDropped++;
+        return false;
+    }
+
+    _vRecords[ullHead % _vRecords.size()] = record;
+    _ullHead.store(ullHead + 1, memory_order_release);
+    return true;
+}
+
+bool IoTraceRing::Drain(FILE *pFile, UINT64& cRecords)
+{
+    UINT64 ullTail = _ullTail.load(memory_order_relaxed);
+    UINT64 ullHead = _ullHead.load(memory_order_acquire);
+    bool fOk = true;
+
+    // published records may wrap the end of the ring; write them in at most two runs
+    while (ullTail != ullHead)
+    {
+        size_t iRecord = static_cast<size_t>(ullTail % _vRecords.size());
+        size_t cRun = static_cast<size_t>(min(ullHead - ullTail, static_cast<UINT64>(_vRecords.size() - iRecord)));
+
+        if (fwrite(&_vRecords[iRecord], sizeof(IoTraceRecord), cRun, pFile) != cRun)
+        {
+            fOk = false;
+            break;
+        }
+
+        ullTail += cRun;
+        cRecords += cRun;
+    }
+
+    _ullTail.store(ullTail, memory_order_release);
+    return fOk;
+}
+
+IoTraceWriter::IoTraceWriter() :
+    _pFile(nullptr),
+    _cRecords(0),
+    _fError(false),
+    _fStopping(false)
+{
+}
+
+IoTraceWriter::~IoTraceWriter()
+{
+    Stop();
+}
+
+bool IoTraceWriter::Start(const string& sPath, UINT32 cThreads)
+{
+    _sPath = sPath;
+
+    if (fopen_s(&_pFile, _sPath.c_str(), "wb") != 0 || _pFile == nullptr)
+    {
+        PrintError("ERROR: could not create IO trace file '%s'\n", _sPath.c_str());
+        _pFile = nullptr;
+        return false;
+    }
+
+    IoTraceFileHeader header = {};
+    memcpy(header.szMagic, "DSPDIOTR", sizeof(header.szMagic));
+    header.ulVersion = 1;
+    header.cbRecord = sizeof(IoTraceRecord);
+    header.ullTimerFrequency = PerfTimer::SecondsToPerfTime(1);
+    header.cThreads = cThreads;
+
+    if (fwrite(&header, sizeof(header), 1, _pFile) != 1)
+    {
+        PrintError("ERROR: could not write IO trace file '%s'\n", _sPath.c_str());
+        fclose(_pFile);
+        _pFile = nullptr;
+        return false;
+    }
+
+    _vRings.clear();
+    for (UINT32 iThread = 0; iThread < cThreads; iThread++)
+    {
+        _vRings.emplace_back(new IoTraceRing(RingRecords));
+    }
+
+    _fStopping = false;
+    _writer = thread(&IoTraceWriter::_Write, this);
+
+    return true;
+}
+
+bool IoTraceWriter::Stop()
+{
+    if (_pFile == nullptr)
+    {
+        return !_fError;
+    }
+
+    {
+        unique_lock<mutex> lock(_lock);
+        _fStopping = true;
+    }
+    _cvStop.notify_all();
+
+    if (_writer.joinable())
+    {
+        _writer.join();
+    }
+
+    // the IO threads have finished; pick up what they completed since the last drain
+    _DrainAll();
+
+    if (fclose(_pFile) != 0)
+    {
+        _fError = true;
+    }
+    _pFile = nullptr;
+
+    if (_fError)
+    {
+        PrintError("ERROR: could not write IO trace file '%s'\n", _sPath.c_str());
+    }
+
+    return !_fError;
+}
+
+UINT64 IoTraceWriter::GetDroppedCount() const
+{
+    UINT64 cDropped = 0;
+
+    for (const auto& pRing : _vRings)
+    {
+        cDropped += pRing->GetDroppedCount();
+    }
+
+    return cDropped;
+}
+
+bool IoTraceWriter::_DrainAll()
+{
+    for (auto& pRing : _vRings)
+    {
+        if (_fError)
+        {
+            break;
+        }
+
+        if (!pRing->Drain(_pFile, _cRecords))
+        {
+            _fError = true;
+        }
+    }
+
+    return !_fError;
+}
+
+void IoTraceWriter::_Write()
+{
+    unique_lock<mutex> lock(_lock);
+
+    while (!_fStopping)
+    {
+        lock.unlock();
+        _DrainAll();
+        lock.lock();
+
+        _cvStop.wait_for(lock, chrono::milliseconds(FlushIntervalMs), [this] { return _fStopping; });
+    }
+}
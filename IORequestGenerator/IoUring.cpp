@@ -0,0 +1,539 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "IoUring.h"
+
+#include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int sys_io_uring_setup(unsigned int cEntries, struct io_uring_params *pParams)
+{
+    return (int)syscall(__NR_io_uring_setup, cEntries, pParams);
+}
+
+static int sys_io_uring_enter(int fd, unsigned int cSubmit, unsigned int cMinComplete, unsigned int ulFlags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, cSubmit, cMinComplete, ulFlags, nullptr, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned int ulOpcode, const void *pArg, unsigned int cArgs)
+{
+    return (int)syscall(__NR_io_uring_register, fd, ulOpcode, pArg, cArgs);
+}
+
+IoUring::IoUring(void) :
+    _fd(-1),
+    _cEntries(0),
+    _fSqPoll(false),
+    _creatorTid(0),
+    _pSqRing(MAP_FAILED),
+    _cbSqRing(0),
+    _pCqRing(MAP_FAILED),
+    _cbCqRing(0),
+    _pSqes((struct io_uring_sqe *)MAP_FAILED),
+    _cbSqes(0),
+    _pSqHead(nullptr),
+    _pSqTail(nullptr),
+    _pSqFlags(nullptr),
+    _ulSqMask(0),
+    _ulSqTail(0),
+    _cPending(0),
+    _ulTimeoutSqTail(0),
+    _pCqHead(nullptr),
+    _pCqTail(nullptr),
+    _ulCqMask(0),
+    _pCqes(nullptr),
+    _pTimeouts(nullptr)
+{
+}
+
+IoUring::~IoUring(void)
+{
+    Close();
+}
+
+//
+// Sets up a ring able to hold cEntries submissions. With fSqPoll, submissions are consumed by
+// a kernel polling thread which is bound to iSqPollCpu if that is not negative. On failure,
+// errno describes the error.
+//
+bool IoUring::Initialize(unsigned int cEntries, bool fSqPoll, int iSqPollCpu)
+{
+    struct io_uring_params params;
+    int err;
+
+    assert(_fd == -1);
+    memset(&params, 0, sizeof(params));
+
+    if (fSqPoll)
+    {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = 1000;   // ms before an idle poller sleeps
+
+        if (iSqPollCpu >= 0)
+        {
+            params.flags |= IORING_SETUP_SQ_AFF;
+            params.sq_thread_cpu = (__u32)iSqPollCpu;
+        }
+    }
+
+    _fd = sys_io_uring_setup(cEntries, &params);
+    if (_fd < 0)
+    {
+        return false;
+    }
+
+    _cEntries = params.sq_entries;
+    _fSqPoll = fSqPoll;
+    _creatorTid = (int)syscall(SYS_gettid);
+    _cbSqRing = params.sq_off.array + params.sq_entries * sizeof(__u32);
+    _cbCqRing = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // newer kernels map both rings with a single mapping
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (_cbCqRing > _cbSqRing)
+        {
+            _cbSqRing = _cbCqRing;
+        }
+        _cbCqRing = _cbSqRing;
+    }
+
+    _pSqRing = mmap(nullptr, _cbSqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_pSqRing == MAP_FAILED)
+    {
+        goto error;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        _pCqRing = _pSqRing;
+    }
+    else
+    {
+        _pCqRing = mmap(nullptr, _cbCqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        if (_pCqRing == MAP_FAILED)
+        {
+            goto error;
+        }
+    }
+
+    _cbSqes = params.sq_entries * sizeof(struct io_uring_sqe);
+    _pSqes = (struct io_uring_sqe *)mmap(nullptr, _cbSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (_pSqes == MAP_FAILED)
+    {
+        goto error;
+    }
+
+    _pSqHead = (__u32 *)((char *)_pSqRing + params.sq_off.head);
+    _pSqTail = (__u32 *)((char *)_pSqRing + params.sq_off.tail);
+    _pSqFlags = (__u32 *)((char *)_pSqRing + params.sq_off.flags);
+    _ulSqMask = *(__u32 *)((char *)_pSqRing + params.sq_off.ring_mask);
+    _ulSqTail = *_pSqTail;
+    _cPending = 0;
+    _ulTimeoutSqTail = _ulSqTail;
+
+    // submission entries are always used in ring order, so the indirection array is the identity
+    {
+        __u32 *pSqArray = (__u32 *)((char *)_pSqRing + params.sq_off.array);
+        for (__u32 i = 0; i < params.sq_entries; i++)
+        {
+            pSqArray[i] = i;
+        }
+    }
+
+    _pCqHead = (__u32 *)((char *)_pCqRing + params.cq_off.head);
+    _pCqTail = (__u32 *)((char *)_pCqRing + params.cq_off.tail);
+    _ulCqMask = *(__u32 *)((char *)_pCqRing + params.cq_off.ring_mask);
+    _pCqes = (struct io_uring_cqe *)((char *)_pCqRing + params.cq_off.cqes);
+
+    _pTimeouts = new struct __kernel_timespec[params.sq_entries]();
+
+    return true;
+
+error:
+    err = errno;
+    Close();
+    errno = err;
+    return false;
+}
+
+void IoUring::Close(void)
+{
+    if (_pSqes != MAP_FAILED)
+    {
+        munmap(_pSqes, _cbSqes);
+        _pSqes = (struct io_uring_sqe *)MAP_FAILED;
+    }
+
+    if (_pCqRing != MAP_FAILED && _pCqRing != _pSqRing)
+    {
+        munmap(_pCqRing, _cbCqRing);
+    }
+    _pCqRing = MAP_FAILED;
+
+    if (_pSqRing != MAP_FAILED)
+    {
+        munmap(_pSqRing, _cbSqRing);
+        _pSqRing = MAP_FAILED;
+    }
+
+    if (_fd != -1)
+    {
+        close(_fd);
+        _fd = -1;
+    }
+
+    delete[] _pTimeouts;
+    _pTimeouts = nullptr;
+
+    _cEntries = 0;
+    _cPending = 0;
+    _fSqPoll = false;
+}
+
+bool IoUring::IsInitialized(void) const
+{
+    return (_fd != -1);
+}
+
+bool IoUring::IsSqPoll(void) const
+{
+    return _fSqPoll;
+}
+
+//
+// Returns the thread id of the ring's SQPOLL kernel thread, or 0 if it cannot be found. The
+// poller is a thread of this process named iou-sqp-<id of the thread which set up the ring>.
+//
+int IoUring::GetSqPollThreadId(void) const
+{
+    char szPollerName[32];
+    int tid = 0;
+
+    if (!_fSqPoll)
+    {
+        return 0;
+    }
+
+    snprintf(szPollerName, sizeof(szPollerName), "iou-sqp-%d\n", _creatorTid);
+
+    DIR *pDir = opendir("/proc/self/task");
+    if (pDir == nullptr)
+    {
+        return 0;
+    }
+
+    struct dirent *pEntry;
+    while (tid == 0 && (pEntry = readdir(pDir)) != nullptr)
+    {
+        char szPath[300];
+        char szName[32];
+
+        if (pEntry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        snprintf(szPath, sizeof(szPath), "/proc/self/task/%s/comm", pEntry->d_name);
+        FILE *pFile = fopen(szPath, "r");
+        if (pFile != nullptr)
+        {
+            if (fgets(szName, sizeof(szName), pFile) != nullptr && strcmp(szName, szPollerName) == 0)
+            {
+                tid = atoi(pEntry->d_name);
+            }
+            fclose(pFile);
+        }
+    }
+
+    closedir(pDir);
+    return tid;
+}
+
+//
+// Probes whether the running kernel allows io_uring (it may be missing, or disabled
+// through kernel.io_uring_disabled / seccomp) by setting up and tearing down a minimal ring.
+//
+bool IoUring::IsSupported(void)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = sys_io_uring_setup(1, &params);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+//
+// Returns the CPU time consumed by a thread of this process, in 100ns units. Scheduler
+// statistics are used if available (ns resolution), otherwise user+system clock ticks.
+//
+bool IoUring::GetThreadCpuTime(int tid, unsigned long long *pullTime)
+{
+    char szPath[64];
+    FILE *pFile;
+    bool fOk = false;
+
+    snprintf(szPath, sizeof(szPath), "/proc/self/task/%d/schedstat", tid);
+    pFile = fopen(szPath, "r");
+    if (pFile != nullptr)
+    {
+        unsigned long long ullRunTime;
+        if (fscanf(pFile, "%llu", &ullRunTime) == 1)
+        {
+            *pullTime = ullRunTime / 100;
+            fOk = true;
+        }
+        fclose(pFile);
+    }
+
+    if (!fOk)
+    {
+        char szStat[1024];
+
+        snprintf(szPath, sizeof(szPath), "/proc/self/task/%d/stat", tid);
+        pFile = fopen(szPath, "r");
+        if (pFile == nullptr)
+        {
+            return false;
+        }
+
+        if (fgets(szStat, sizeof(szStat), pFile) != nullptr)
+        {
+            // utime and stime are the 12th and 13th fields following the parenthesized name
+            unsigned long long ullUserTicks, ullSystemTicks;
+            const char *pszFields = strrchr(szStat, ')');
+            if (pszFields != nullptr &&
+                sscanf(pszFields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &ullUserTicks, &ullSystemTicks) == 2)
+            {
+                *pullTime = (ullUserTicks + ullSystemTicks) * 10000000ULL / sysconf(_SC_CLK_TCK);
+                fOk = true;
+            }
+        }
+        fclose(pFile);
+    }
+
+    return fOk;
+}
+
+//
+// Registers buffers for use with IORING_OP_READ_FIXED/WRITE_FIXED; the index of a buffer
+// in the array is its buf_index. On failure, errno describes the error.
+//
+bool IoUring::RegisterBuffers(const struct iovec *pIovecs, unsigned int cIovecs)
+{
+    assert(_fd != -1);
+
+    return (sys_io_uring_register(_fd, IORING_REGISTER_BUFFERS, pIovecs, cIovecs) == 0);
+}
+
+//
+// Registers files for use with IOSQE_FIXED_FILE; the index of a file descriptor in the
+// array is used in place of the descriptor. On failure, errno describes the error.
+//
+bool IoUring::RegisterFiles(const int *pFds, unsigned int cFds)
+{
+    assert(_fd != -1);
+
+    return (sys_io_uring_register(_fd, IORING_REGISTER_FILES, pFds, cFds) == 0);
+}
+
+//
+// Returns the next free submission entry, zeroed, or nullptr if the submission queue is full.
+//
+struct io_uring_sqe * IoUring::GetSqe(void)
+{
+    __u32 ulHead = __atomic_load_n(_pSqHead, __ATOMIC_ACQUIRE);
+
+    // entries are only held briefly by the poller: wait for it to consume one
+    if (_fSqPoll && (_ulSqTail - ulHead >= _cEntries))
+    {
+        int ret;
+        do
+        {
+            ret = sys_io_uring_enter(_fd, 0, 0, IORING_ENTER_SQ_WAKEUP | IORING_ENTER_SQ_WAIT);
+        } while (ret < 0 && errno == EINTR);
+
+        ulHead = __atomic_load_n(_pSqHead, __ATOMIC_ACQUIRE);
+    }
+
+    if (_ulSqTail - ulHead >= _cEntries)
+    {
+        return nullptr;
+    }
+
+    struct io_uring_sqe *pSqe = &_pSqes[_ulSqTail & _ulSqMask];
+    memset(pSqe, 0, sizeof(*pSqe));
+    _ulSqTail++;
+    _cPending++;
+
+    return pSqe;
+}
+
+//
+// Queues a timeout which completes after the given interval or as soon as any other
+// request completes, whichever is first. Used to bound the wait for completions while
+// throttled. The timeout completes with ReservedUserData.
+//
+// A timeout which is still pending, because the kernel pushed back on its submission,
+// bounds the next wait in place of a new one: this keeps it from taking a second entry.
+// Returns false if no timeout is queued because the submission queue is full.
+//
+bool IoUring::PrepareTimeout(unsigned int ulMilliseconds)
+{
+    if (_ulSqTail - _ulTimeoutSqTail < _cPending)
+    {
+        return true;
+    }
+
+    struct io_uring_sqe *pSqe = GetSqe();
+    if (pSqe == nullptr)
+    {
+        return false;
+    }
+    _ulTimeoutSqTail = _ulSqTail;
+
+    struct __kernel_timespec *pTimeout = &_pTimeouts[pSqe - _pSqes];
+    pTimeout->tv_sec = ulMilliseconds / 1000;
+    pTimeout->tv_nsec = (long long)(ulMilliseconds % 1000) * 1000 * 1000;
+
+    pSqe->opcode = IORING_OP_TIMEOUT;
+    pSqe->fd = -1;
+    pSqe->addr = (__u64)(uintptr_t)pTimeout;
+    pSqe->len = 1;
+    pSqe->off = 1;
+    pSqe->user_data = ReservedUserData;
+
+    return true;
+}
+
+unsigned int IoUring::GetPendingCount(void) const
+{
+    return _cPending;
+}
+
+//
+// Submits all pending entries and, if cMinComplete is non-zero, waits for at least that many
+// completions. Returns the number of entries submitted or a negative errno. No system call is
+// made if there is nothing to submit or wait for.
+//
+// With SQPOLL, pending entries are published to the polling thread, and a system call is only
+// made to wait or if the poller has gone idle and must be woken.
+//
+int IoUring::Enter(unsigned int cMinComplete)
+{
+    int ret;
+
+    if (_cPending == 0 && cMinComplete == 0)
+    {
+        return 0;
+    }
+
+    __atomic_store_n(_pSqTail, _ulSqTail, __ATOMIC_RELEASE);
+
+    if (_fSqPoll)
+    {
+        unsigned int cPublished = _cPending;
+        unsigned int ulFlags = 0;
+
+        _cPending = 0;
+
+        // the poller's idle flag must be read after the tail is published
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(_pSqFlags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+        {
+            ulFlags |= IORING_ENTER_SQ_WAKEUP;
+        }
+        if (cMinComplete)
+        {
+            ulFlags |= IORING_ENTER_GETEVENTS;
+        }
+
+        if (ulFlags)
+        {
+            do
+            {
+                ret = sys_io_uring_enter(_fd, 0, cMinComplete, ulFlags);
+            } while (ret < 0 && errno == EINTR);
+
+            if (ret < 0)
+            {
+                return -errno;
+            }
+        }
+
+        return (int)cPublished;
+    }
+
+    do
+    {
+        ret = sys_io_uring_enter(_fd, _cPending, cMinComplete, cMinComplete ? IORING_ENTER_GETEVENTS : 0);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 0)
+    {
+        return -errno;
+    }
+
+    assert((unsigned int)ret <= _cPending);
+    _cPending -= ret;
+
+    return ret;
+}
+
+unsigned int IoUring::GetCqeCount(void) const
+{
+    __u32 ulTail = __atomic_load_n(_pCqTail, __ATOMIC_ACQUIRE);
+
+    return ulTail - *_pCqHead;
+}
+
+const struct io_uring_cqe * IoUring::GetCqe(unsigned int iCqe) const
+{
+    return &_pCqes[(*_pCqHead + iCqe) & _ulCqMask];
+}
+
+void IoUring::AdvanceCq(unsigned int cCqes)
+{
+    __atomic_store_n(_pCqHead, *_pCqHead + cCqes, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,135 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "LatencySloSearch.h"
+
+LatencySloSearch::LatencySloSearch(double lfMilliseconds, DWORD dwMaxRequestCount) :
+    _lfMilliseconds(lfMilliseconds),
+    _dwMaxRequestCount(dwMaxRequestCount),
+    _dwNextRequestCount(1),
+    _dwMetRequestCount(0),
+    _dwMissedRequestCount(0)
+{
+}
+
+void LatencySloSearch::AddStep(const Step& step)
+{
+    const bool fDoubling = (_dwMissedRequestCount == 0);
+
+    _vSteps.push_back(step);
+    Step& added = _vSteps.back();
+
+    // a run which completed no IO has no latency to meet the SLO with
+    added.fMetSlo = (added.lfIops > 0) && (added.lfLatencyMilliseconds <= _lfMilliseconds);
+
+    if (added.fMetSlo)
+    {
+        const bool fSaturated = (_vSteps.size() > 1) && (added.lfIops < _vSteps[_vSteps.size() - 2].lfIops * SaturationGain);
+
+        _dwMetRequestCount = max(_dwMetRequestCount, added.dwRequestCount);
+
+        if (fDoubling)
+        {
+            if (fSaturated || added.dwRequestCount >= _dwMaxRequestCount)
+            {
+                _dwNextRequestCount = 0;
+            }
+            else
+            {
+                _dwNextRequestCount = min(added.dwRequestCount * 2, _dwMaxRequestCount);
+            }
+            return;
+        }
+    }
+    else if (_dwMissedRequestCount == 0 || added.dwRequestCount < _dwMissedRequestCount)
+    {
+        _dwMissedRequestCount = added.dwRequestCount;
+    }
+
+    // bisect between the counts which met and missed the SLO
+    if (_dwMetRequestCount == 0 ||
+        _dwMissedRequestCount - _dwMetRequestCount <= max<DWORD>(1, _dwMetRequestCount / 8))
+    {
+        _dwNextRequestCount = 0;
+    }
+    else
+    {
+        _dwNextRequestCount = _dwMetRequestCount + (_dwMissedRequestCount - _dwMetRequestCount) / 2;
+    }
+}
+
+int LatencySloSearch::GetKnee() const
+{
+    int iKnee = -1;
+
+    for (size_t i = 0; i < _vSteps.size(); i++)
+    {
+        if (_vSteps[i].fMetSlo && (iKnee < 0 || _vSteps[i].lfIops > _vSteps[iKnee].lfIops))
+        {
+            iKnee = static_cast<int>(i);
+        }
+    }
+
+    return iKnee;
+}
+
+LatencySloSearch::Step LatencySloSearch::Measure(const Results& results, double lfPercentile)
+{
+    Step step = {};
+    Histogram<float> latencyHistogram;
+    UINT64 ullIOCount = 0;
+    UINT64 ullBytesCount = 0;
+
+    for (const auto& threadResults : results.vThreadResults)
+    {
+        for (const auto& targetResults : threadResults.vTargetResults)
+        {
+            ullIOCount += targetResults.ullIOCount;
+            ullBytesCount += targetResults.ullBytesCount;
+            latencyHistogram.Merge(targetResults.readLatencyHistogram);
+            latencyHistogram.Merge(targetResults.writeLatencyHistogram);
+        }
+    }
+
+    double lfSeconds = PerfTimer::PerfTimeToSeconds(results.ullTimeCount);
+    if (lfSeconds > 0)
+    {
+        step.lfIops = ullIOCount / lfSeconds;
+        step.lfBytesPerSecond = ullBytesCount / lfSeconds;
+    }
+
+    // histograms are in microseconds
+    if (latencyHistogram.GetSampleSize() > 0)
+    {
+        step.lfMedianMilliseconds = latencyHistogram.GetPercentile(0.5) / 1000;
+        step.lfLatencyMilliseconds = latencyHistogram.GetPercentile(lfPercentile / 100) / 1000;
+    }
+
+    return step;
+}
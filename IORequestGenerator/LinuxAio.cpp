@@ -0,0 +1,210 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "LinuxAio.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static int sys_io_setup(unsigned int cEvents, aio_context_t *pCtx)
+{
+    return (int)syscall(__NR_io_setup, cEvents, pCtx);
+}
+
+static int sys_io_destroy(aio_context_t ctx)
+{
+    return (int)syscall(__NR_io_destroy, ctx);
+}
+
+static int sys_io_submit(aio_context_t ctx, long cIocbs, struct iocb **ppIocbs)
+{
+    return (int)syscall(__NR_io_submit, ctx, cIocbs, ppIocbs);
+}
+
+static int sys_io_getevents(aio_context_t ctx, long cMinEvents, long cMaxEvents, struct io_event *pEvents, struct timespec *pTimeout)
+{
+    return (int)syscall(__NR_io_getevents, ctx, cMinEvents, cMaxEvents, pEvents, pTimeout);
+}
+
+LinuxAio::LinuxAio(void) :
+    _ctx(0),
+    _cRequests(0),
+    _pIocbs(nullptr),
+    _ppPending(nullptr),
+    _cPending(0),
+    _pEvents(nullptr)
+{
+}
+
+LinuxAio::~LinuxAio(void)
+{
+    Close();
+}
+
+//
+// Sets up a context able to hold cRequests IOs in flight. On failure, errno describes the error.
+//
+bool LinuxAio::Initialize(unsigned int cRequests)
+{
+    assert(_ctx == 0);
+
+    if (sys_io_setup(cRequests, &_ctx) < 0)
+    {
+        _ctx = 0;
+        return false;
+    }
+
+    _cRequests = cRequests;
+    _pIocbs = new struct iocb[cRequests]();
+    _ppPending = new struct iocb *[cRequests]();
+    _pEvents = new struct io_event[cRequests]();
+    _cPending = 0;
+
+    return true;
+}
+
+void LinuxAio::Close(void)
+{
+    if (_ctx != 0)
+    {
+        sys_io_destroy(_ctx);
+        _ctx = 0;
+    }
+
+    delete[] _pIocbs;
+    delete[] _ppPending;
+    delete[] _pEvents;
+    _pIocbs = nullptr;
+    _ppPending = nullptr;
+    _pEvents = nullptr;
+
+    _cRequests = 0;
+    _cPending = 0;
+}
+
+bool LinuxAio::IsInitialized(void) const
+{
+    return (_ctx != 0);
+}
+
+//
+// Returns the request's control block, zeroed and queued for the next Submit(). A request
+// may only have one IO in flight.
+//
+struct iocb * LinuxAio::GetIocb(unsigned int iRequest)
+{
+    assert(iRequest < _cRequests);
+    assert(_cPending < _cRequests);
+
+    struct iocb *pIocb = &_pIocbs[iRequest];
+    memset(pIocb, 0, sizeof(*pIocb));
+    _ppPending[_cPending++] = pIocb;
+
+    return pIocb;
+}
+
+unsigned int LinuxAio::GetPendingCount(void) const
+{
+    return _cPending;
+}
+
+//
+// Submits all queued control blocks. Returns the number submitted or a negative errno; if the
+// kernel accepts only part of the batch, the rest stay queued for the next call.
+//
+int LinuxAio::Submit(void)
+{
+    int ret;
+
+    if (_cPending == 0)
+    {
+        return 0;
+    }
+
+    do
+    {
+        ret = sys_io_submit(_ctx, _cPending, _ppPending);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 0)
+    {
+        return -errno;
+    }
+
+    assert((unsigned int)ret <= _cPending);
+    if ((unsigned int)ret < _cPending)
+    {
+        memmove(_ppPending, _ppPending + ret, (_cPending - ret) * sizeof(*_ppPending));
+    }
+    _cPending -= ret;
+
+    return ret;
+}
+
+//
+// Reaps available completions, waiting until at least cMinEvents are available or the timeout
+// (Infinite for none) expires. Returns the number reaped, accessible with GetEvent(), or a
+// negative errno.
+//
+int LinuxAio::GetEvents(unsigned int cMinEvents, unsigned int ulTimeoutMilliseconds)
+{
+    struct timespec timeout;
+    struct timespec *pTimeout = nullptr;
+    int ret;
+
+    assert(cMinEvents <= _cRequests);
+
+    if (ulTimeoutMilliseconds != Infinite)
+    {
+        timeout.tv_sec = ulTimeoutMilliseconds / 1000;
+        timeout.tv_nsec = (long)(ulTimeoutMilliseconds % 1000) * 1000 * 1000;
+        pTimeout = &timeout;
+    }
+
+    do
+    {
+        ret = sys_io_getevents(_ctx, cMinEvents, _cRequests, _pEvents, pTimeout);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 0)
+    {
+        return -errno;
+    }
+
+    return ret;
+}
+
+const struct io_event * LinuxAio::GetEvent(unsigned int iEvent) const
+{
+    return &_pEvents[iEvent];
+}
@@ -39,7 +39,7 @@ OverlappedQueue::OverlappedQueue(void) :
 
 void OverlappedQueue::Add(OVERLAPPED *pOverlapped)
 {
-    pOverlapped->Internal = NULL;
+    pOverlapped->Internal = 0;
     if (_pHead == nullptr)
     {
         assert(_pTail == nullptr);
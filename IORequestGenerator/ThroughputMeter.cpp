@@ -29,9 +29,71 @@ SOFTWARE.
 
 #include "Common.h"
 #include "ThroughputMeter.h"
+#include <cmath>
+
+SharedRateLimit::SharedRateLimit(double lfUnitsPerMillisecond, bool fIOPS, DWORD dwSpinMicroseconds) :
+    _fIOPS(fIOPS),
+    _llTheoreticalTime(0)
+{
+    SetRate(lfUnitsPerMillisecond);
+
+    // as for a thread's own throttle, the bucket holds the slack of one wait
+    _ullTolerance = dwSpinMicroseconds ?
+        PerfTimer::MicrosecondsToPerfTime(dwSpinMicroseconds) :
+        PerfTimer::MillisecondsToPerfTime(ThroughputMeter::SleepResolutionMilliseconds);
+}
+
+void SharedRateLimit::SetRate(double lfUnitsPerMillisecond)
+{
+    assert(lfUnitsPerMillisecond >= 0);
+
+    if (lfUnitsPerMillisecond > 0)
+    {
+        _lfTicksPerUnit = PerfTimer::MillisecondsToPerfTime(1) / lfUnitsPerMillisecond;
+        _lfGrantSize = lfUnitsPerMillisecond * GrantMicroseconds / 1000;
+    }
+    else
+    {
+        _lfTicksPerUnit = 0;
+        _lfGrantSize = 0;
+    }
+}
+
+UINT64 SharedRateLimit::TryAcquire(double lfUnits, UINT64 ullNow)
+{
+    double lfTicksPerUnit = _lfTicksPerUnit;
+    if (lfTicksPerUnit == 0)
+    {
+        return 0;
+    }
+
+    LONG64 llNow = (LONG64)ullNow;
+    LONG64 llIncrement = (LONG64)(lfUnits * lfTicksPerUnit);
+
+    for (;;)
+    {
+        LONG64 llTheoreticalTime = _llTheoreticalTime;
+
+        if (llTheoreticalTime > llNow + (LONG64)_ullTolerance)
+        {
+            return (UINT64)(llTheoreticalTime - llNow - (LONG64)_ullTolerance);
+        }
+
+        LONG64 llNext = max(llTheoreticalTime, llNow) + llIncrement;
+        if (InterlockedCompareExchange64(&_llTheoreticalTime, llNext, llTheoreticalTime) == llTheoreticalTime)
+        {
+            return 0;
+        }
+    }
+}
 
 ThroughputMeter::ThroughputMeter(void) :
-    _fRunning(false)
+    _fRunning(false),
+    _fThrottle(false),
+    _fThink(false),
+    _ullSpinTime(0),
+    _cSharedGrants(0),
+    _fArrivals(false)
 {
 }
 
@@ -40,7 +102,7 @@ bool ThroughputMeter::IsRunning(void) const
     return _fRunning;
 }
 
-void ThroughputMeter::Start(DWORD cBytesPerMillisecond, DWORD dwBlockSize, DWORD dwThinkTime, DWORD dwBurstSize)
+void ThroughputMeter::Start(double lfBytesPerMillisecond, DWORD dwBlockSize, DWORD dwThinkTime, DWORD dwBurstSize, DWORD dwSpinMicroseconds)
 {
     // Initialization
     _cbCompleted = 0;
@@ -48,19 +110,36 @@ void ThroughputMeter::Start(DWORD cBytesPerMillisecond, DWORD dwBlockSize, DWORD
     _cbBlockSize = dwBlockSize;
 
     _fThrottle = false;
-    _cBytesPerMillisecond = 0;
+    _lfBytesPerTick = 0;
     _fThink = false;
     _ullDelayUntil = 0;
     _thinkTime = 0;
     _burstSize = 0;
     _fRunning = false;
+    _fArrivals = false;
+    _cSharedGrants = 0;
 
-    _ullStartTimestamp = GetTickCount64();
+    _ullSpinTime = PerfTimer::MicrosecondsToPerfTime(dwSpinMicroseconds);
 
-    if (0 != cBytesPerMillisecond)
+    if (lfBytesPerMillisecond > 0)
     {
         _fThrottle = true;
-        _cBytesPerMillisecond = cBytesPerMillisecond;
+        _lfBytesPerTick = lfBytesPerMillisecond / PerfTimer::MillisecondsToPerfTime(1);
+
+        // Beyond the block the next IO waits for, the bucket holds what accrues over the
+        // slack in issuing it - up to the timer resolution a sleep may overshoot by, or
+        // the spin time when spinning - so that the slack is recovered rather than lost
+        // to the rate, while a stall does not bank a burst larger than that.
+        double lfSlackMilliseconds = SleepResolutionMilliseconds;
+        if (_ullSpinTime != 0)
+        {
+            lfSlackMilliseconds = dwSpinMicroseconds / 1000.0;
+        }
+        _lfBucketDepth = dwBlockSize + lfBytesPerMillisecond * lfSlackMilliseconds;
+
+        // the first IO can be issued immediately
+        _lfTokens = dwBlockSize;
+        _ullTokensTimestamp = PerfTimer::GetTime();
         _fRunning = true;
     }
     else if (0 != dwThinkTime)
@@ -72,72 +151,237 @@ void ThroughputMeter::Start(DWORD cBytesPerMillisecond, DWORD dwBlockSize, DWORD
     }
 }
 
-DWORD ThroughputMeter::GetSleepTime(void) const
+bool ThroughputMeter::AddSharedLimit(SharedRateLimit *pLimit)
 {
-    if (_fThink)
+    if (_cSharedGrants == MaxSharedLimits)
     {
-        ULONGLONG ullTimestamp = GetTickCount64();
-        if (ullTimestamp < _ullDelayUntil)
-        {
-            return (DWORD)(_ullDelayUntil - ullTimestamp);
-        }
-        else
-        {
-            return (_fThrottle) ? _GetThrottleTime() : 0;
-        }
+        return false;
     }
-    else
+
+    _aSharedGrants[_cSharedGrants].pLimit = pLimit;
+    _aSharedGrants[_cSharedGrants].lfUnits = 0;
+    _cSharedGrants++;
+    _fRunning = true;
+
+    return true;
+}
+
+void ThroughputMeter::StartArrivals(DWORD dwIOPS, bool fPoisson, Random *pRand)
+{
+    assert(dwIOPS > 0);
+    assert(!fPoisson || pRand != nullptr);
+
+    _fThrottle = false;
+    _fThink = false;
+    _cbCompleted = 0;
+    _cIO = 0;
+
+    _fArrivals = true;
+    _fPoisson = fPoisson;
+    _pRand = pRand;
+    _lfArrivalInterval = (double)PerfTimer::SecondsToPerfTime(1.0) / dwIOPS;
+    _fRunning = true;
+
+    ResetArrivals();
+}
+
+void ThroughputMeter::StartTrace(void)
+{
+    _fThrottle = false;
+    _fThink = false;
+    _cbCompleted = 0;
+    _cIO = 0;
+
+    // a zero interval leaves the schedule where it is until the next ScheduleArrival()
+    _fArrivals = true;
+    _fPoisson = false;
+    _pRand = nullptr;
+    _lfArrivalInterval = 0;
+    _fRunning = true;
+
+    ResetArrivals();
+}
+
+// Restarts the arrival schedule at the current time; the first arrival is due immediately.
+void ThroughputMeter::ResetArrivals(void)
+{
+    _ullArrivalStart = PerfTimer::GetTime();
+    _lfNextArrival = (double)_ullArrivalStart;
+}
+
+// Sets the next arrival, stated relative to the start of the schedule (perf timer units).
+void ThroughputMeter::ScheduleArrival(UINT64 ullArrival)
+{
+    _lfNextArrival = (double)(_ullArrivalStart + ullArrival);
+}
+
+bool ThroughputMeter::IsArrivalSchedule(void) const
+{
+    return _fArrivals;
+}
+
+UINT64 ThroughputMeter::GetArrivalTime(void) const
+{
+    return (UINT64)_lfNextArrival;
+}
+
+bool ThroughputMeter::IsReady(DWORD *pdwSleepTime)
+{
+    if (_fArrivals)
+    {
+        *pdwSleepTime = _GetArrivalSleepTime();
+        return PerfTimer::GetTime() >= GetArrivalTime();
+    }
+
+    // grants are only drawn once this thread's own pace allows the IO, so that
+    // a thread waiting on its own throttle does not hold them from others
+    UINT64 ullWait = _GetWaitTime();
+    if (ullWait == 0)
+    {
+        ullWait = _AcquireShared();
+    }
+
+    *pdwSleepTime = _WaitToSleepTime(ullWait);
+    return ullWait == 0;
+}
+
+UINT64 ThroughputMeter::_AcquireShared(void)
+{
+    UINT64 ullNow = 0;
+
+    for (UINT32 i = 0; i < _cSharedGrants; i++)
     {
-        if (_fThrottle) // think time has not been specified only check for throttling
+        SharedGrant& grant = _aSharedGrants[i];
+        double lfCost = grant.pLimit->IsIOPS() ? 1 : _cbBlockSize;
+
+        if (grant.lfUnits >= lfCost)
         {
-            return _GetThrottleTime();
+            continue;
         }
-        else
+
+        if (ullNow == 0)
         {
-            return 0;
+            ullNow = PerfTimer::GetTime();
+        }
+
+        double lfUnits = max(lfCost - grant.lfUnits, grant.pLimit->GetGrantSize());
+        UINT64 ullWait = grant.pLimit->TryAcquire(lfUnits, ullNow);
+        if (ullWait != 0)
+        {
+            return ullWait;
         }
+
+        grant.lfUnits += lfUnits;
     }
+
+    return 0;
 }
 
-DWORD ThroughputMeter::_GetThrottleTime(void) const
+DWORD ThroughputMeter::_GetArrivalSleepTime(void) const
 {
-    if ((g_ExperimentFlags & EXPERIMENT_TPUT_CALC) == 0)
+    // the wait is rounded down to whole milliseconds: an arrival due in less than
+    // a millisecond yields a zero wait, and the caller polls rather than oversleeps
+    UINT64 ullNow = PerfTimer::GetTime();
+    UINT64 ullArrival = GetArrivalTime();
+
+    if (ullNow >= ullArrival)
     {
-        ULONGLONG cbExpected = (GetTickCount64() - _ullStartTimestamp) * _cBytesPerMillisecond;
-        return cbExpected >= (_cbCompleted + _cbBlockSize) ? 0 : 1;
+        return 0;
     }
-    else
+
+    return (DWORD)PerfTimer::PerfTimeToMilliseconds(ullArrival - ullNow);
+}
+
+double ThroughputMeter::_NextArrivalInterval(void)
+{
+    if (!_fPoisson)
     {
-        // prototype to calculate an actual sleep time
-        // under higher loads the ideal delay is likely in the microsecond range, but the minimum sleep is 1 ms
-        // however, at low rates it may be reasonable to calculate the delay and use it if > 1ms
+        return _lfArrivalInterval;
+    }
 
-        ULONGLONG elapsed = GetTickCount64() - _ullStartTimestamp;
-        ULONGLONG bytesNext = _cbCompleted + _cbBlockSize;
+    // exponentially distributed interval by inversion of a uniform draw in [0, 1)
+    return -log(1.0 - _pRand->RandDouble()) * _lfArrivalInterval;
+}
 
-        if (elapsed * _cBytesPerMillisecond > bytesNext)
-        {
-            // below rate - no sleep
-            return 0;
-        }
+UINT64 ThroughputMeter::_GetWaitTime(void) const
+{
+    UINT64 ullNow = PerfTimer::GetTime();
+    UINT64 ullWait = 0;
+
+    if (_fThink && ullNow < _ullDelayUntil)
+    {
+        ullWait = _ullDelayUntil - ullNow;
+    }
+    else if (_fThrottle)
+    {
+        ullWait = _GetThrottleWaitTime(ullNow);
+    }
+
+    return ullWait;
+}
+
+double ThroughputMeter::_GetTokens(UINT64 ullNow) const
+{
+    double lfTokens = _lfTokens + (ullNow - _ullTokensTimestamp) * _lfBytesPerTick;
+    return min(lfTokens, _lfBucketDepth);
+}
+
+UINT64 ThroughputMeter::_GetThrottleWaitTime(UINT64 ullNow) const
+{
+    double lfTokens = _GetTokens(ullNow);
+    if (lfTokens >= _cbBlockSize)
+    {
+        return 0;
+    }
+
+    // round up so that the IO is ready once the wait has passed
+    return (UINT64)ceil((_cbBlockSize - lfTokens) / _lfBytesPerTick);
+}
+
+DWORD ThroughputMeter::_WaitToSleepTime(UINT64 ullWait) const
+{
+    // the caller polls through the part of the wait within the spin time
+    if (ullWait <= _ullSpinTime)
+    {
+        return 0;
+    }
 
-        // above rate - sleep at least 1 ms
-        ULONGLONG sleepTarget = (bytesNext / _cBytesPerMillisecond) - elapsed;
+    DWORD dwSleepTime = (DWORD)PerfTimer::PerfTimeToMilliseconds(ullWait - _ullSpinTime);
 
-        return max((DWORD)sleepTarget, 1);
+    // when not spinning a wait shorter than a millisecond sleeps the minimum, and the
+    // bucket depth covers the oversleep
+    if (dwSleepTime == 0 && _ullSpinTime == 0)
+    {
+        dwSleepTime = 1;
     }
+
+    return dwSleepTime;
 }
 
 void ThroughputMeter::Adjust(size_t cb)
 {
     _cbCompleted += cb;
     _cIO++;
+    if (_fThrottle)
+    {
+        UINT64 ullNow = PerfTimer::GetTime();
+        _lfTokens = _GetTokens(ullNow) - cb;
+        _ullTokensTimestamp = ullNow;
+    }
+    for (UINT32 i = 0; i < _cSharedGrants; i++)
+    {
+        _aSharedGrants[i].lfUnits -= _aSharedGrants[i].pLimit->IsIOPS() ? 1 : (double)cb;
+    }
+    if (_fArrivals)
+    {
+        _lfNextArrival += _NextArrivalInterval();
+    }
     if (_fThink)
     {
         if (_cIO >= _burstSize)
         {
             _cIO = 0;
-            _ullDelayUntil = GetTickCount64() + _thinkTime;
+            _ullDelayUntil = PerfTimer::GetTime() + PerfTimer::MillisecondsToPerfTime(_thinkTime);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,508 @@
+/*
+
+DISKSPD
+
+Copyright(c) Microsoft Corporation
+All rights reserved.
+
+MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Common.h"
+#include "IORequestGenerator.h"
+#include "TraceReader.h"
+
+static const size_t MaxTraceLine = 4096;
+static const size_t MaxTraceTokens = 12;
+
+//
+// Splits a line into whitespace (or, for CSV, comma) delimited tokens.
+//
+
+static size_t tokenize(const char *pszLine, char chDelimiter, string vTokens[MaxTraceTokens])
+{
+    size_t cTokens = 0;
+    const char *p = pszLine;
+
+    while (*p != '\0' && *p != '\r' && *p != '\n')
+    {
+        // blanks around a token are not part of it
+        while (*p == ' ' || *p == '\t')
+        {
+            p++;
+        }
+        if (chDelimiter == ' ' && (*p == '\0' || *p == '\r' || *p == '\n'))
+        {
+            break;
+        }
+
+        const char *pEnd = p;
+        while (*pEnd != '\0' && *pEnd != '\r' && *pEnd != '\n' && *pEnd != chDelimiter &&
+               !(chDelimiter == ' ' && *pEnd == '\t'))
+        {
+            pEnd++;
+        }
+
+        if (cTokens == MaxTraceTokens)
+        {
+            break;
+        }
+
+        const char *pLast = pEnd;
+        while (pLast > p && (*(pLast - 1) == ' ' || *(pLast - 1) == '\t'))
+        {
+            pLast--;
+        }
+        vTokens[cTokens++].assign(p, pLast - p);
+
+        p = pEnd;
+        if (chDelimiter != ' ' && *p == chDelimiter)
+        {
+            p++;
+        }
+    }
+
+    return cTokens;
+}
+
+static bool parseUInt(const string& s, UINT64& ullValue)
+{
+    const char *pszRest = nullptr;
+    return Util::ParseUInt(s.c_str(), ullValue, pszRest) && *pszRest == '\0';
+}
+
+static bool parseDouble(const string& s, double& lfValue)
+{
+    char *pszRest = nullptr;
+    lfValue = strtod(s.c_str(), &pszRest);
+    return pszRest != s.c_str() && *pszRest == '\0' && lfValue >= 0;
+}
+
+// blkparse leads with the device as <major>,<minor>
+static bool isBlkparseDevice(const string& s)
+{
+    size_t iComma = s.find(',');
+    UINT64 ullMajor, ullMinor;
+
+    return iComma != string::npos &&
+           parseUInt(s.substr(0, iComma), ullMajor) &&
+           parseUInt(s.substr(iComma + 1), ullMinor);
+}
+
+static bool isSkipped(const char *pszLine)
+{
+    while (*pszLine == ' ' || *pszLine == '\t')
+    {
+        pszLine++;
+    }
+
+    return *pszLine == '\0' || *pszLine == '\r' || *pszLine == '\n' || *pszLine == '#';
+}
+
+TraceFormat TraceReader::DetectFormat(const char *pszLine)
+{
+    string vTokens[MaxTraceTokens];
+    size_t cTokens = tokenize(pszLine, ' ', vTokens);
+
+    if (cTokens == 0)
+    {
+        return TraceFormat::Unknown;
+    }
+
+    if (_strnicmp(vTokens[0].c_str(), "fio", 3) == 0)
+    {
+        return TraceFormat::FioIolog;
+    }
+
+    if (cTokens >= 7 && isBlkparseDevice(vTokens[0]))
+    {
+        return TraceFormat::Blkparse;
+    }
+
+    return TraceFormat::Csv;
+}
+
+bool TraceReader::ParseLine(TraceFormat format, char chBlkAction, const char *pszLine, TraceRecord& record, bool& fRecord)
+{
+    string vTokens[MaxTraceTokens];
+    size_t cTokens;
+    double lfTime;
+    UINT64 ullLength = 0;
+
+    fRecord = false;
+
+    if (isSkipped(pszLine))
+    {
+        return true;
+    }
+
+    switch (format)
+    {
+        case TraceFormat::Csv:
+        {
+            cTokens = tokenize(pszLine, ',', vTokens);
+
+            // header line
+            if (cTokens && !parseDouble(vTokens[0], lfTime) && !isdigit((unsigned char)vTokens[0][0]))
+            {
+                return true;
+            }
+
+            if (cTokens != 4 ||
+                !parseDouble(vTokens[0], lfTime) ||
+                !parseUInt(vTokens[2], record.ullOffset) ||
+                !parseUInt(vTokens[3], ullLength))
+            {
+                return false;
+            }
+
+            char chOp = static_cast<char>(toupper(vTokens[1].size() ? vTokens[1][0] : '\0'));
+            if (chOp != 'R' && chOp != 'W')
+            {
+                return false;
+            }
+
+            record.ullTime = static_cast<UINT64>(lfTime * 1000 + 0.5);    // us -> ns
+            record.fWrite = (chOp == 'W');
+            break;
+        }
+
+        case TraceFormat::FioIolog:
+        {
+            cTokens = tokenize(pszLine, ' ', vTokens);
+
+            if (_strnicmp(vTokens[0].c_str(), "fio", 3) == 0)
+            {
+                return true;
+            }
+
+            // version 2: <file> <action> <offset> <length>
+            // version 3: <timestamp (ms)> <file> <action> <offset> <length>
+            // file actions (add, open, close) and other IO (sync, trim, wait) are not replayed
+            size_t iAction;
+            if (cTokens == 4)
+            {
+                iAction = 1;
+                record.ullTime = 0;
+            }
+            else if (cTokens == 5)
+            {
+                UINT64 ullTime;
+                if (!parseUInt(vTokens[0], ullTime))
+                {
+                    return false;
+                }
+                iAction = 2;
+                record.ullTime = ullTime * 1000 * 1000;                  // ms -> ns
+            }
+            else
+            {
+                return cTokens >= 2 && cTokens <= 3;
+            }
+
+            if (vTokens[iAction] != "read" && vTokens[iAction] != "write")
+            {
+                return true;
+            }
+
+            if (!parseUInt(vTokens[iAction + 1], record.ullOffset) ||
+                !parseUInt(vTokens[iAction + 2], ullLength))
+            {
+                return false;
+            }
+
+            record.fWrite = (vTokens[iAction] == "write");
+            break;
+        }
+
+        case TraceFormat::Blkparse:
+        {
+            // <dev> <cpu> <seq> <time (s)> <pid> <action> <rwbs> <sector> + <sectors> [<process>]
+            // per-cpu and total summaries follow the events and are skipped, as are events
+            // which are not of the replayed action or are not reads or writes (e.g. flush)
+            cTokens = tokenize(pszLine, ' ', vTokens);
+
+            if (cTokens < 10 ||
+                !isBlkparseDevice(vTokens[0]) ||
+                vTokens[5].size() != 1 || vTokens[5][0] != chBlkAction ||
+                vTokens[8] != "+")
+            {
+                return true;
+            }
+
+            const string& sRwbs = vTokens[6];
+            if (sRwbs.find('D') != string::npos ||
+                (sRwbs.find('R') == string::npos && sRwbs.find('W') == string::npos))
+            {
+                return true;
+            }
+
+            UINT64 ullSector;
+            if (!parseDouble(vTokens[3], lfTime) ||
+                !parseUInt(vTokens[7], ullSector) ||
+                !parseUInt(vTokens[9], ullLength) ||
+                ullSector > MAXUINT64 / 512)
+            {
+                return false;
+            }
+
+            record.ullTime = static_cast<UINT64>(lfTime * 1000 * 1000 * 1000 + 0.5);    // s -> ns
+            record.ullOffset = ullSector * 512;
+            ullLength *= 512;
+            record.fWrite = (sRwbs.find('W') != string::npos);
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    if (ullLength == 0 || ullLength > MAXDWORD)
+    {
+        return false;
+    }
+
+    record.dwLength = static_cast<DWORD>(ullLength);
+    fRecord = true;
+    return true;
+}
+
+TraceReader::TraceReader() :
+    _pFile(nullptr),
+    _format(TraceFormat::Unknown),
+    _chBlkAction('Q'),
+    _cRecords(0),
+    _dwMaxLength(0),
+    _ullFirstTime(0),
+    _ullDuration(0),
+    _ullRepeatInterval(0),
+    _fClosing(false)
+{
+}
+
+TraceReader::~TraceReader()
+{
+    Close();
+}
+
+bool TraceReader::Open(const string& sPath)
+{
+    _sPath = sPath;
+
+    if (fopen_s(&_pFile, _sPath.c_str(), "r") != 0 || _pFile == nullptr)
+    {
+        PrintError("ERROR: could not open trace file '%s'\n", _sPath.c_str());
+        return false;
+    }
+
+    if (!_Scan())
+    {
+        return false;
+    }
+
+    // blkparse traces without queue events are replayed from their issue events
+    if (_format == TraceFormat::Blkparse && _cRecords == 0)
+    {
+        _chBlkAction = 'D';
+        if (!_Scan())
+        {
+            return false;
+        }
+    }
+
+    if (_cRecords == 0)
+    {
+        PrintError("ERROR: trace file '%s' has no read or write records\n", _sPath.c_str());
+        return false;
+    }
+
+    _ullRepeatInterval = _ullDuration + ((_cRecords > 1) ? _ullDuration / (_cRecords - 1) : 0);
+
+    rewind(_pFile);
+    _fClosing = false;
+    _reader = thread(&TraceReader::_ReadAhead, this);
+
+    return true;
+}
+
+void TraceReader::Close()
+{
+    {
+        lock_guard<mutex> lock(_lock);
+        _fClosing = true;
+    }
+    _cvReady.notify_all();
+    _cvSpace.notify_all();
+
+    if (_reader.joinable())
+    {
+        _reader.join();
+    }
+
+    if (_pFile != nullptr)
+    {
+        fclose(_pFile);
+        _pFile = nullptr;
+    }
+
+    _qBatches.clear();
+}
+
+//
+// Validating pass over the trace: detects the format and finds the number of records, the
+// largest IO and the span of time the trace covers.
+//
+
+bool TraceReader::_Scan()
+{
+    char szLine[MaxTraceLine];
+    UINT64 ullLine = 0;
+    UINT64 ullLastTime = 0;
+
+    rewind(_pFile);
+    _cRecords = 0;
+    _dwMaxLength = 0;
+
+    while (fgets(szLine, sizeof(szLine), _pFile) != nullptr)
+    {
+        TraceRecord record;
+        bool fRecord;
+
+        ullLine++;
+
+        if (_format == TraceFormat::Unknown)
+        {
+            if (isSkipped(szLine))
+            {
+                continue;
+            }
+            _format = DetectFormat(szLine);
+        }
+
+        if (!ParseLine(_format, _chBlkAction, szLine, record, fRecord))
+        {
+            PrintError("ERROR: trace file '%s' line %llu is not a valid %s record\n",
+                _sPath.c_str(),
+                ullLine,
+                _format == TraceFormat::Csv ? "CSV" : (_format == TraceFormat::FioIolog ? "fio iolog" : "blkparse"));
+            return false;
+        }
+
+        if (!fRecord)
+        {
+            continue;
+        }
+
+        if (_cRecords++ == 0)
+        {
+            _ullFirstTime = record.ullTime;
+        }
+
+        ullLastTime = max(ullLastTime, record.ullTime);
+        _dwMaxLength = max(_dwMaxLength, record.dwLength);
+    }
+
+    if (ferror(_pFile))
+    {
+        PrintError("ERROR: could not read trace file '%s'\n", _sPath.c_str());
+        return false;
+    }
+
+    _ullDuration = (_cRecords && ullLastTime > _ullFirstTime) ? ullLastTime - _ullFirstTime : 0;
+    return true;
+}
+
+//
+// Reader thread: parses the trace into batches, staying up to MaxBatches ahead of the consumers.
+// Record times are made relative to the first record and monotonic - traces merged from several
+// CPUs may be slightly out of order - and repetitions of the trace follow one another in time.
+//
+
+void TraceReader::_ReadAhead()
+{
+    char szLine[MaxTraceLine];
+    UINT64 ullRepeatBase = 0;
+    UINT64 ullLastTime = 0;
+    vector<TraceRecord> vBatch;
+
+    vBatch.reserve(BatchRecords);
+
+    for (;;)
+    {
+        TraceRecord record;
+        bool fRecord;
+
+        if (fgets(szLine, sizeof(szLine), _pFile) == nullptr)
+        {
+            rewind(_pFile);
+            ullRepeatBase += _ullRepeatInterval;
+            ullLastTime = ullRepeatBase;
+            continue;
+        }
+
+        if (!ParseLine(_format, _chBlkAction, szLine, record, fRecord) || !fRecord)
+        {
+            continue;
+        }
+
+        record.ullTime = (record.ullTime > _ullFirstTime ? record.ullTime - _ullFirstTime : 0) + ullRepeatBase;
+        record.ullTime = max(record.ullTime, ullLastTime);
+        ullLastTime = record.ullTime;
+
+        vBatch.push_back(record);
+
+        if (vBatch.size() == BatchRecords)
+        {
+            unique_lock<mutex> lock(_lock);
+            _cvSpace.wait(lock, [this] { return _fClosing || _qBatches.size() < MaxBatches; });
+            if (_fClosing)
+            {
+                return;
+            }
+
+            _qBatches.push_back(move(vBatch));
+            lock.unlock();
+            _cvReady.notify_one();
+
+            vBatch.clear();
+            vBatch.reserve(BatchRecords);
+        }
+    }
+}
+
+bool TraceReader::NextBatch(vector<TraceRecord>& vBatch)
+{
+    unique_lock<mutex> lock(_lock);
+    _cvReady.wait(lock, [this] { return _fClosing || !_qBatches.empty(); });
+
+    if (_qBatches.empty())
+    {
+        return false;
+    }
+
+    vBatch.swap(_qBatches.front());
+    _qBatches.pop_front();
+    lock.unlock();
+    _cvSpace.notify_one();
+
+    return true;
+}
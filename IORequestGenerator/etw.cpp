@@ -28,7 +28,7 @@ SOFTWARE.
 */
 
 #include "etw.h"
-#include "common.h"
+#include "Common.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -31,15 +31,17 @@ SOFTWARE.
 //
 #include "ResultParser.h"
 
-#include "common.h"
+#include "Common.h"
 #include <functional>
 
 #include <stdio.h>
 #include <stdlib.h>
+#ifndef __linux__
 #include <Winternl.h>   //ntdll.dll
 
 #include <Wmistr.h>     //WNODE_HEADER
 #include <Evntrace.h>
+#endif
 
 #include <assert.h>
 
@@ -64,7 +66,7 @@ void ResultParser::_Print(const char *format, ...)
 
 struct {
     UINT32 sizeShift;
-    PCHAR name;
+    const char *name;
 } sizeUnits[] = {
     { 40, "TiB" },
     { 30, "GiB" },
@@ -118,7 +120,7 @@ void ResultParser::_DisplayFileSize(UINT64 fsize, UINT32 align)
         }
     }
 
-    _Print("%I64u", fsize);
+    _Print("%llu", fsize);
 }
 
 /*****************************************************************************/
@@ -162,101 +164,101 @@ void ResultParser::_DisplayETW(struct ETWMask ETWMask, struct ETWEventCounters E
     {
         _Print("\tDisk I/O\n");
 
-        _Print("\t\tRead: %I64u\n", EtwEventCounters.ullIORead);
-        _Print("\t\tWrite: %I64u\n", EtwEventCounters.ullIOWrite);
+        _Print("\t\tRead: %llu\n", EtwEventCounters.ullIORead);
+        _Print("\t\tWrite: %llu\n", EtwEventCounters.ullIOWrite);
     }
     if (ETWMask.bImageLoad)
     {
         _Print("\tLoad Image\n");
 
-        _Print("\t\tLoad Image: %I64u\n", EtwEventCounters.ullImageLoad);
+        _Print("\t\tLoad Image: %llu\n", EtwEventCounters.ullImageLoad);
     }
     if (ETWMask.bMemoryPageFaults)
     {
         _Print("\tMemory Page Faults\n");
 
-        _Print("\t\tCopy on Write: %I64u\n", EtwEventCounters.ullMMCopyOnWrite);
-        _Print("\t\tDemand Zero fault: %I64u\n", EtwEventCounters.ullMMDemandZeroFault);
-        _Print("\t\tGuard Page fault: %I64u\n", EtwEventCounters.ullMMGuardPageFault);
-        _Print("\t\tHard page fault: %I64u\n", EtwEventCounters.ullMMHardPageFault);
-        _Print("\t\tTransition fault: %I64u\n", EtwEventCounters.ullMMTransitionFault);
+        _Print("\t\tCopy on Write: %llu\n", EtwEventCounters.ullMMCopyOnWrite);
+        _Print("\t\tDemand Zero fault: %llu\n", EtwEventCounters.ullMMDemandZeroFault);
+        _Print("\t\tGuard Page fault: %llu\n", EtwEventCounters.ullMMGuardPageFault);
+        _Print("\t\tHard page fault: %llu\n", EtwEventCounters.ullMMHardPageFault);
+        _Print("\t\tTransition fault: %llu\n", EtwEventCounters.ullMMTransitionFault);
     }
     if (ETWMask.bMemoryHardFaults && !ETWMask.bMemoryPageFaults )
     {
         _Print("\tMemory Hard Faults\n");
-        _Print("\t\tHard page fault: %I64u\n", EtwEventCounters.ullMMHardPageFault);
+        _Print("\t\tHard page fault: %llu\n", EtwEventCounters.ullMMHardPageFault);
     }
     if (ETWMask.bNetwork)
     {
         _Print("\tNetwork\n");
 
-        _Print("\t\tAccept: %I64u\n", EtwEventCounters.ullNetAccept);
-        _Print("\t\tConnect: %I64u\n", EtwEventCounters.ullNetConnect);
-        _Print("\t\tDisconnect: %I64u\n", EtwEventCounters.ullNetDisconnect);
-        _Print("\t\tReconnect: %I64u\n", EtwEventCounters.ullNetReconnect);
-        _Print("\t\tRetransmit: %I64u\n", EtwEventCounters.ullNetRetransmit);
-        _Print("\t\tTCP/IP Send: %I64u\n", EtwEventCounters.ullNetTcpSend);
-        _Print("\t\tTCP/IP Receive: %I64u\n", EtwEventCounters.ullNetTcpReceive);
-        _Print("\t\tUDP/IP Send: %I64u\n", EtwEventCounters.ullNetUdpSend);
-        _Print("\t\tUDP/IP Receive: %I64u\n", EtwEventCounters.ullNetUdpReceive);
+        _Print("\t\tAccept: %llu\n", EtwEventCounters.ullNetAccept);
+        _Print("\t\tConnect: %llu\n", EtwEventCounters.ullNetConnect);
+        _Print("\t\tDisconnect: %llu\n", EtwEventCounters.ullNetDisconnect);
+        _Print("\t\tReconnect: %llu\n", EtwEventCounters.ullNetReconnect);
+        _Print("\t\tRetransmit: %llu\n", EtwEventCounters.ullNetRetransmit);
+        _Print("\t\tTCP/IP Send: %llu\n", EtwEventCounters.ullNetTcpSend);
+        _Print("\t\tTCP/IP Receive: %llu\n", EtwEventCounters.ullNetTcpReceive);
+        _Print("\t\tUDP/IP Send: %llu\n", EtwEventCounters.ullNetUdpSend);
+        _Print("\t\tUDP/IP Receive: %llu\n", EtwEventCounters.ullNetUdpReceive);
     }
     if (ETWMask.bProcess)
     {
         _Print("\tProcess\n");
 
-        _Print("\t\tStart: %I64u\n", EtwEventCounters.ullProcessStart);
-        _Print("\t\tEnd: %I64u\n", EtwEventCounters.ullProcessEnd);
+        _Print("\t\tStart: %llu\n", EtwEventCounters.ullProcessStart);
+        _Print("\t\tEnd: %llu\n", EtwEventCounters.ullProcessEnd);
     }
     if (ETWMask.bRegistry)
     {
         _Print("\tRegistry\n");
 
-        _Print("\t\tNtCreateKey: %I64u\n",
+        _Print("\t\tNtCreateKey: %llu\n",
             EtwEventCounters.ullRegCreate);
 
-        _Print("\t\tNtDeleteKey: %I64u\n",
+        _Print("\t\tNtDeleteKey: %llu\n",
             EtwEventCounters.ullRegDelete);
 
-        _Print("\t\tNtDeleteValueKey: %I64u\n",
+        _Print("\t\tNtDeleteValueKey: %llu\n",
             EtwEventCounters.ullRegDeleteValue);
 
-        _Print("\t\tNtEnumerateKey: %I64u\n",
+        _Print("\t\tNtEnumerateKey: %llu\n",
             EtwEventCounters.ullRegEnumerateKey);
 
-        _Print("\t\tNtEnumerateValueKey: %I64u\n",
+        _Print("\t\tNtEnumerateValueKey: %llu\n",
             EtwEventCounters.ullRegEnumerateValueKey);
 
-        _Print("\t\tNtFlushKey: %I64u\n",
+        _Print("\t\tNtFlushKey: %llu\n",
             EtwEventCounters.ullRegFlush);
 
-        _Print("\t\tNtOpenKey: %I64u\n",
+        _Print("\t\tNtOpenKey: %llu\n",
             EtwEventCounters.ullRegOpen);
 
-        _Print("\t\tNtQueryKey: %I64u\n",
+        _Print("\t\tNtQueryKey: %llu\n",
             EtwEventCounters.ullRegQuery);
 
-        _Print("\t\tNtQueryMultipleValueKey: %I64u\n",
+        _Print("\t\tNtQueryMultipleValueKey: %llu\n",
             EtwEventCounters.ullRegQueryMultipleValue);
 
-        _Print("\t\tNtQueryValueKey: %I64u\n",
+        _Print("\t\tNtQueryValueKey: %llu\n",
             EtwEventCounters.ullRegQueryValue);
 
-        _Print("\t\tNtSetInformationKey: %I64u\n",
+        _Print("\t\tNtSetInformationKey: %llu\n",
             EtwEventCounters.ullRegSetInformation);
 
-        _Print("\t\tNtSetValueKey: %I64u\n",
+        _Print("\t\tNtSetValueKey: %llu\n",
             EtwEventCounters.ullRegSetValue);
     }
     if (ETWMask.bThread)
     {
         _Print("\tThread\n");
 
-        _Print("\t\tStart: %I64u\n", EtwEventCounters.ullThreadStart);
-        _Print("\t\tEnd: %I64u\n", EtwEventCounters.ullThreadEnd);
+        _Print("\t\tStart: %llu\n", EtwEventCounters.ullThreadStart);
+        _Print("\t\tEnd: %llu\n", EtwEventCounters.ullThreadEnd);
     }
 }
 
-void ResultParser::_PrintDistribution(DistributionType dT, const vector<DistributionRange>& v, char* spc)
+void ResultParser::_PrintDistribution(DistributionType dT, const vector<DistributionRange>& v, double skew, bool fScatter, const char* spc)
 {
     if (dT == DistributionType::None)
     {
@@ -269,7 +271,7 @@ void ResultParser::_PrintDistribution(DistributionType dT, const vector<Distribu
         for (const auto &r : v)
         {
             _Print(spc);
-            _Print("   %3u%% of IO => [%2I64u%% - %3I64u%%) of target\n",
+            _Print("   %3u%% of IO => [%2llu%% - %3llu%%) of target\n",
                     r._span,
                     r._dst.first,
                     r._dst.first + r._dst.second
@@ -321,6 +323,23 @@ void ResultParser::_PrintDistribution(DistributionType dT, const vector<Distribu
             }
         }
         break;
+
+        case DistributionType::Zipf:
+        _Print(spc);
+        _Print("   Zipf, theta %g%s\n", skew, fScatter ? ", scattered across target" : "");
+        break;
+
+        case DistributionType::Pareto:
+        _Print(spc);
+        if (fScatter)
+        {
+            _Print("   Pareto, %g%% of IO => %g%% of target (recursively), scattered across target\n", 100 * (1 - skew), 100 * skew);
+        }
+        else
+        {
+            _Print("   Pareto, %g%% of IO => first %g%% of target (recursively)\n", 100 * (1 - skew), 100 * skew);
+        }
+        break;
     }
 }
 
@@ -408,11 +427,11 @@ void ResultParser::_PrintEffectiveDistributions(const Results& results)
         {
             _Print("target: %s [thread:", tgt.first.c_str());
 
-            UINT32 lastTh = MAXUINT, runLen = 0;
+            UINT32 lastTh = MAXUINT32, runLen = 0;
 
             for (auto& th : tgt.second)
             {
-                if (lastTh != MAXUINT)
+                if (lastTh != MAXUINT32)
                 {
                     // accumulate run?
                     if (lastTh + 1 == th) {
@@ -448,11 +467,11 @@ void ResultParser::_PrintEffectiveDistributions(const Results& results)
 
             _Print("]\n");
         }
-        _PrintDistribution(DistributionType::Absolute, *r.first, "");
+        _PrintDistribution(DistributionType::Absolute, *r.first, 0, false, "");
     }
 }
 
-void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines)
+void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, bool fUseRequestsPerFile, bool fCompletionRoutines, IoEngine ioEngine)
 {
     if (target.GetPath().c_str()[0] == TEMPLATE_TARGET_PREFIX)
     {
@@ -522,6 +541,19 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
         _Print("\t\tzeroing write buffers\n");
     }
 
+    if (target.GetReducibleWriteData())
+    {
+        _Print("\t\twrite data: compressible %.2f:1, dedupable %.2f:1 in %u byte chunks\n",
+            target.GetCompressionRatio(),
+            target.GetDedupRatio(),
+            target.GetDedupChunkSize());
+    }
+
+    if (target.GetVerifyData())
+    {
+        _Print("\t\tverifying data in %u byte units\n", target.GetVerifyUnitSize());
+    }
+
     if (target.GetRandomDataWriteBufferSize() > 0)
     {
         _Print("\t\twrite buffer size: ");
@@ -544,7 +576,13 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
         _Print("\t\tusing parallel async I/O\n");
     }
 
-    if (target.GetWriteRatio() == 0)
+    if (!target.GetTracePath().empty())
+    {
+        _Print("\t\treplaying trace: %s (%s)\n",
+            target.GetTracePath().c_str(),
+            target.GetTraceTimestamps() ? "at trace timestamps, latency measured from scheduled arrival" : "as fast as possible");
+    }
+    else if (target.GetWriteRatio() == 0)
     {
         _Print("\t\tperforming read test\n");
     }
@@ -557,27 +595,94 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
         _Print("\t\tperforming mix test (read/write ratio: %d/%d)\n", 100 - target.GetWriteRatio(), target.GetWriteRatio());
     }
 
-    _Print("\t\tblock size: ");
-    _DisplayFileSize(target.GetBlockSizeInBytes());
-    _Print("\n");
+    if (target.GetFlushRatio() != 0)
+    {
+        _Print("\t\tflushes: %u%% of IOs\n", target.GetFlushRatio());
+    }
 
-    if (target.GetRandomRatio() == 100)
+    if (target.GetTrimRatio() != 0)
     {
-        _Print("\t\tusing random I/O (alignment: ");
+        _Print("\t\ttrims: %u%% of IOs", target.GetTrimRatio());
+        if (target.GetTrimSize() != 0)
+        {
+            _Print(" of ");
+            _DisplayFileSize(target.GetTrimSize());
+        }
+        _Print("\n");
     }
-    else
+
+    if (target.GetFuaWriteRatio() != 0)
+    {
+        _Print("\t\tforced unit access: %u%% of writes\n", target.GetFuaWriteRatio());
+    }
+
+    if (target.GetFileSetCount() != 0)
+    {
+        _Print("\t\tfile set: %u files", target.GetFileSetCount());
+        if (target.GetFileSetSkew() != 0)
+        {
+            _Print(", Zipf skew %g", target.GetFileSetSkew());
+        }
+        if (target.GetOpenPerIO())
+        {
+            _Print(", opened per IO");
+        }
+        _Print("\n");
+
+        if (target.GetMetadataRatio() != 0)
+        {
+            _Print("\t\tmetadata operations: %u%% of IOs (", target.GetMetadataRatio());
+            const char *pszSeparator = "";
+            for (UINT32 i = 0; i < static_cast<UINT32>(MetadataOp::Open); i++)
+            {
+                if (target.GetMetadataOps() & MetadataOpMask(static_cast<MetadataOp>(i)))
+                {
+                    _Print("%s%s", pszSeparator, MetadataOpName(static_cast<MetadataOp>(i)));
+                    pszSeparator = ", ";
+                }
+            }
+            _Print(")\n");
+        }
+    }
+
+    if (target.GetTracePath().empty())
     {
-        if (target.GetRandomRatio() > 0)
+        if (target.GetBlockSizeMix().size())
         {
-            _Print("\t\tusing mixed random/sequential I/O (%u%% random) (alignment/stride: ", target.GetRandomRatio());
+            _Print("\t\tblock size mix:");
+            for (const auto& b : target.GetBlockSizeMix())
+            {
+                _Print(" ");
+                _DisplayFileSize(b.dwBlockSize);
+                _Print(":%u", b.ulWeight);
+            }
+            _Print("\n");
         }
         else
         {
-            _Print("\t\tusing%s sequential I/O (stride: ", target.GetUseInterlockedSequential() ? " interlocked":"");
+            _Print("\t\tblock size: ");
+            _DisplayFileSize(target.GetBlockSizeInBytes());
+            _Print("\n");
+        }
+
+        if (target.GetRandomRatio() == 100)
+        {
+            _Print("\t\tusing random I/O (alignment: ");
         }
+        else
+        {
+            if (target.GetRandomRatio() > 0)
+            {
+                _Print("\t\tusing mixed random/sequential I/O (%u%% random) (alignment/stride: ", target.GetRandomRatio());
+            }
+            else
+            {
+                _Print("\t\tusing%s sequential I/O (stride: ", target.GetUseInterlockedSequential() ? " interlocked":"");
+            }
+        }
+        _DisplayFileSize(target.GetBlockAlignmentInBytes());
+        _Print(")\n");
     }
-    _DisplayFileSize(target.GetBlockAlignmentInBytes());
-    _Print(")\n");
 
     if (fUseRequestsPerFile)
     {
@@ -634,9 +739,21 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
         {
             _Print("\t\tusing completion routines (ReadFileEx/WriteFileEx)\n");
         }
+        else if (ioEngine == IoEngine::IoUring)
+        {
+            _Print("\t\tusing io_uring submission/completion rings\n");
+        }
+        else if (ioEngine == IoEngine::LinuxAio)
+        {
+            _Print("\t\tusing Linux AIO (io_submit/io_getevents)\n");
+        }
         else
         {
+#ifdef __linux__
+            _Print("\t\tusing io_uring, or Linux AIO where io_uring is unavailable\n");
+#else
             _Print("\t\tusing I/O Completion Ports\n");
+#endif
         }
     }
 
@@ -666,10 +783,31 @@ void ResultParser::_PrintTarget(const Target &target, bool fUseThreadsPerFile, b
         _Print("\t\tthroughput rate-limited to %u B/ms\n", target.GetThroughputInBytesPerMillisecond());
     }
 
-    if (target.GetDistributionRange().size())
+    if (target.GetTotalThroughputIOPS())
+    {
+        _Print("\t\tthroughput of all threads rate-limited to %u IOPS\n", target.GetTotalThroughputIOPS());
+    }
+    else if (target.GetTotalThroughputInBytesPerMillisecond())
+    {
+        _Print("\t\tthroughput of all threads rate-limited to %u B/ms\n", target.GetTotalThroughputInBytesPerMillisecond());
+    }
+
+    if (target.GetThrottleSpinMicroseconds())
+    {
+        _Print("\t\tthrottle waits spun for their last %uus\n", target.GetThrottleSpinMicroseconds());
+    }
+
+    if (target.GetArrivalRate())
+    {
+        _Print("\t\topen-loop arrivals at %u IOPS (%s), latency measured from scheduled arrival\n",
+            target.GetArrivalRate(),
+            target.GetPoissonArrivals() ? "Poisson" : "fixed interval");
+    }
+
+    if (target.GetDistributionType() != DistributionType::None)
     {
         _Print("\t\tIO Distribution:\n");
-        _PrintDistribution(target.GetDistributionType(), target.GetDistributionRange(), "\t\t");
+        _PrintDistribution(target.GetDistributionType(), target.GetDistributionRange(), target.GetDistributionSkew(), target.GetDistributionScatter(), "\t\t");
     }
 }
 
@@ -684,12 +822,89 @@ void ResultParser::_PrintTimeSpan(const TimeSpan& timeSpan)
     }
     if (timeSpan.GetMeasureLatency())
     {
-        _Print("\tmeasuring latency\n");
+        if (timeSpan.GetLatencySignificantDigits() != Histogram<float>::DefaultSignificantDigits)
+        {
+            _Print("\tmeasuring latency, to %u significant digits\n", timeSpan.GetLatencySignificantDigits());
+        }
+        else
+        {
+            _Print("\tmeasuring latency\n");
+        }
+    }
+    if (timeSpan.GetLatencySloPercentile() > 0)
+    {
+        _Print("\tlatency SLO search: p%g <= %.3fms, up to %u outstanding IOs; results are of the run at the knee\n",
+            timeSpan.GetLatencySloPercentile(),
+            timeSpan.GetLatencySloMilliseconds(),
+            timeSpan.GetLatencySloMaxRequestCount());
+    }
+    if (timeSpan.GetTotalThroughputIOPS())
+    {
+        _Print("\tthroughput of all targets and threads rate-limited to %u IOPS\n", timeSpan.GetTotalThroughputIOPS());
+    }
+    else if (timeSpan.GetTotalThroughputInBytesPerMillisecond())
+    {
+        _Print("\tthroughput of all targets and threads rate-limited to %u B/ms\n", timeSpan.GetTotalThroughputInBytesPerMillisecond());
+    }
+    if (timeSpan.GetPhases().size() > 0)
+    {
+        _Print("\tload phases, repeating over the measured interval:\n");
+        for (size_t iPhase = 0; iPhase < timeSpan.GetPhases().size(); iPhase++)
+        {
+            const LoadPhase& phase = timeSpan.GetPhases()[iPhase];
+
+            _Print("\t\t%u: %.3fs %s", (UINT32)iPhase + 1, phase.GetDurationInMilliseconds() / 1000.0, LoadPhase::ShapeToString(phase.GetShape()));
+            if (phase.GetShape() == PhaseShape::Sine || phase.GetShape() == PhaseShape::Square)
+            {
+                _Print(" of period %.3fs", phase.GetPeriodInMilliseconds() / 1000.0);
+            }
+            if (phase.GetShape() == PhaseShape::Square)
+            {
+                _Print(", %u%% duty", phase.GetDutyPercent());
+            }
+
+            const struct { const PhaseSetting& setting; const char *pszUnit; } aSettings[] = {
+                { phase.GetIOPS(), " IOPS" },
+                { phase.GetWriteRatio(), "% writes" },
+                { phase.GetQueueDepth(), " outstanding IOs per thread" } };
+            const char *pszSeparator = ": ";
+
+            for (const auto& named : aSettings)
+            {
+                if (!named.setting.fSet)
+                {
+                    continue;
+                }
+
+                if (named.setting.ulFrom == named.setting.ulTo)
+                {
+                    _Print("%s%u%s", pszSeparator, named.setting.ulFrom, named.pszUnit);
+                }
+                else
+                {
+                    _Print("%s%u to %u%s", pszSeparator, named.setting.ulFrom, named.setting.ulTo, named.pszUnit);
+                }
+                pszSeparator = ", ";
+            }
+            _Print("\n");
+        }
     }
     if (timeSpan.GetCalculateIopsStdDev())
     {
         _Print("\tgathering IOPS at intervals of %ums\n", timeSpan.GetIoBucketDurationInMilliseconds());
     }
+    if (timeSpan.GetRegisteredIo())
+    {
+        _Print("\tusing io_uring registered buffers and files\n");
+    }
+    if (timeSpan.GetSqPoll())
+    {
+        _Print("\tusing io_uring kernel submission queue polling\n");
+    }
+    if (timeSpan.GetAioMinEvents() != 1)
+    {
+        _Print("\tLinux AIO waiting for at least %u completions before reaping\n", timeSpan.GetAioMinEvents());
+    }
     _Print("\trandom seed: %u\n", timeSpan.GetRandSeed());
     if (timeSpan.GetThreadCount() != 0)
     {
@@ -714,7 +929,7 @@ void ResultParser::_PrintTimeSpan(const TimeSpan& timeSpan)
 
     if (timeSpan.GetRandomWriteData())
     {
-        _Print("\tgenerating random data for each write IO\n");
+        _Print("\tgenerating random data for each write IO (%s)\n", Random::FillToString(Random::GetBestFill()));
         _Print("\t  WARNING: this increases the CPU cost of issuing writes and should only\n");
         _Print("\t           be compared to other results using the -Zr flag\n");
     }
@@ -722,7 +937,7 @@ void ResultParser::_PrintTimeSpan(const TimeSpan& timeSpan)
     vector<Target> vTargets(timeSpan.GetTargets());
     for (auto i = vTargets.begin(); i != vTargets.end(); i++)
     {
-        _PrintTarget(*i, (timeSpan.GetThreadCount() == 0), (timeSpan.GetThreadCount() == 0 || timeSpan.GetRequestCount() == 0), timeSpan.GetCompletionRoutines());
+        _PrintTarget(*i, (timeSpan.GetThreadCount() == 0), (timeSpan.GetThreadCount() == 0 || timeSpan.GetRequestCount() == 0), timeSpan.GetCompletionRoutines(), timeSpan.GetIoEngine());
     }
 }
 
@@ -867,6 +1082,45 @@ void ResultParser::_PrintCpuUtilization(const Results& results, const SystemInfo
         totalUserTime / procCount,
         (totalKrnlTime - totalIdleTime) / procCount,
         totalIdleTime / procCount);
+
+    //
+    // io_uring submission queue pollers are kernel threads outside the workers: show their
+    // share of one CPU over the measured interval. This time is included in the Kernel column above.
+    //
+
+    bool fSqPoll = false;
+    for (const auto& threadResults : results.vThreadResults)
+    {
+        fSqPoll = fSqPoll || (threadResults.ulSqPollThreadId != 0);
+    }
+
+    if (fSqPoll)
+    {
+        double fTime = PerfTimer::PerfTimeToSeconds(results.ullTimeCount);
+
+        _Print("\nio_uring submission queue pollers (included in Kernel above):\n");
+        _Print("thread | poller |  Group | CPU |  Usage\n");
+        _Print("----------------------------------------\n");
+        for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
+        {
+            const ThreadResults& threadResults = results.vThreadResults[iThread];
+            if (threadResults.ulSqPollThreadId == 0)
+            {
+                continue;
+            }
+
+            double usedTime = (fTime > 0) ? (100.0 * threadResults.ullSqPollTime / 10000000.0 / fTime) : 0;
+
+            if (threadResults.fSqPollAffinity)
+            {
+                _Print("%6u | %6u | %6u| %4u| %6.2lf%%\n", iThread, threadResults.ulSqPollThreadId, threadResults.wSqPollGroup, threadResults.bSqPollProc, usedTime);
+            }
+            else
+            {
+                _Print("%6u | %6u |      -|    -| %6.2lf%%\n", iThread, threadResults.ulSqPollThreadId, usedTime);
+            }
+        }
+    }
 }
 
 void ResultParser::_PrintSectionFieldNames(const TimeSpan& timeSpan)
@@ -947,6 +1201,80 @@ void ResultParser::_PrintSection(_SectionEnum section, const TimeSpan& timeSpan,
                 }
             }
 
+            if ((section == _SectionEnum::FLUSH) || (section == _SectionEnum::TOTAL))
+            {
+                ullIOCount += targetResults.ullFlushIOCount;
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    latencyHistogram.Merge(targetResults.flushLatencyHistogram);
+                    totalLatencyHistogram.Merge(targetResults.flushLatencyHistogram);
+                }
+
+                if (timeSpan.GetCalculateIopsStdDev())
+                {
+                    ioBucketizer.Merge(targetResults.flushBucketizer);
+                    totalIoBucketizer.Merge(targetResults.flushBucketizer);
+                }
+            }
+
+            // trimmed bytes are not transferred, so only shown for the trims themselves
+            if ((section == _SectionEnum::TRIM) || (section == _SectionEnum::TOTAL))
+            {
+                if (section == _SectionEnum::TRIM)
+                {
+                    ullBytesCount += targetResults.ullTrimBytesCount;
+                }
+                ullIOCount += targetResults.ullTrimIOCount;
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    latencyHistogram.Merge(targetResults.trimLatencyHistogram);
+                    totalLatencyHistogram.Merge(targetResults.trimLatencyHistogram);
+                }
+
+                if (timeSpan.GetCalculateIopsStdDev())
+                {
+                    ioBucketizer.Merge(targetResults.trimBucketizer);
+                    totalIoBucketizer.Merge(targetResults.trimBucketizer);
+                }
+            }
+
+            // metadata operations (-mm) are also broken down by kind; the opens and closes around IO
+            // with files opened per IO (-mo) are not IOs of their own, so not part of the total
+            if (section == _SectionEnum::TOTAL)
+            {
+                ullIOCount += targetResults.ullMetadataIOCount;
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    for (size_t iOp = 0; iOp < targetResults.vMetadataResults.size() && iOp < static_cast<size_t>(MetadataOp::Open); iOp++)
+                    {
+                        latencyHistogram.Merge(targetResults.vMetadataResults[iOp].latencyHistogram);
+                        totalLatencyHistogram.Merge(targetResults.vMetadataResults[iOp].latencyHistogram);
+                    }
+                }
+            }
+
+            // forced unit access writes are a subset of the writes, so not part of the total
+            if (section == _SectionEnum::FUA_WRITE)
+            {
+                ullBytesCount += targetResults.ullFuaWriteBytesCount;
+                ullIOCount += targetResults.ullFuaWriteIOCount;
+
+                if (timeSpan.GetMeasureLatency())
+                {
+                    latencyHistogram.Merge(targetResults.fuaWriteLatencyHistogram);
+                    totalLatencyHistogram.Merge(targetResults.fuaWriteLatencyHistogram);
+                }
+
+                if (timeSpan.GetCalculateIopsStdDev())
+                {
+                    ioBucketizer.Merge(targetResults.fuaWriteBucketizer);
+                    totalIoBucketizer.Merge(targetResults.fuaWriteBucketizer);
+                }
+            }
+
             _Print("%6u | %15llu | %12llu | %10.2f | %10.2f",
                    iThread,
                    ullBytesCount,
@@ -1028,6 +1356,9 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
     //Print one chart for each target IF more than one target
     unordered_map<std::string, Histogram<float>> perTargetReadHistogram;
     unordered_map<std::string, Histogram<float>> perTargetWriteHistogram;
+    unordered_map<std::string, Histogram<float>> perTargetFlushHistogram;
+    unordered_map<std::string, Histogram<float>> perTargetTrimHistogram;
+    unordered_map<std::string, Histogram<float>> perTargetFuaWriteHistogram;
     unordered_map<std::string, Histogram<float>> perTargetTotalHistogram;
 
     for (const auto& thread : results.vThreadResults)
@@ -1040,8 +1371,20 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
 
             perTargetWriteHistogram[path].Merge(target.writeLatencyHistogram);
 
+            perTargetFlushHistogram[path].Merge(target.flushLatencyHistogram);
+
+            perTargetTrimHistogram[path].Merge(target.trimLatencyHistogram);
+
+            perTargetFuaWriteHistogram[path].Merge(target.fuaWriteLatencyHistogram);
+
             perTargetTotalHistogram[path].Merge(target.readLatencyHistogram);
             perTargetTotalHistogram[path].Merge(target.writeLatencyHistogram);
+            perTargetTotalHistogram[path].Merge(target.flushLatencyHistogram);
+            perTargetTotalHistogram[path].Merge(target.trimLatencyHistogram);
+            for (size_t iOp = 0; iOp < target.vMetadataResults.size() && iOp < static_cast<size_t>(MetadataOp::Open); iOp++)
+            {
+                perTargetTotalHistogram[path].Merge(target.vMetadataResults[iOp].latencyHistogram);
+            }
         }
     }
 
@@ -1053,6 +1396,9 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
             _Print("\nLatency distribution: %s\n", path.c_str());
             _PrintLatencyChart(perTargetReadHistogram[path],
                 perTargetWriteHistogram[path],
+                perTargetFlushHistogram[path],
+                perTargetTrimHistogram[path],
+                perTargetFuaWriteHistogram[path],
                 perTargetTotalHistogram[path]);
         }
     }
@@ -1060,6 +1406,9 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
     //Print one chart for the latencies aggregated across all targets
     Histogram<float> readLatencyHistogram;
     Histogram<float> writeLatencyHistogram;
+    Histogram<float> flushLatencyHistogram;
+    Histogram<float> trimLatencyHistogram;
+    Histogram<float> fuaWriteLatencyHistogram;
     Histogram<float> totalLatencyHistogram;
 
     for (const auto& thread : results.vThreadResults)
@@ -1070,24 +1419,55 @@ void ResultParser::_PrintLatencyPercentiles(const Results& results)
 
             writeLatencyHistogram.Merge(target.writeLatencyHistogram);
 
+            flushLatencyHistogram.Merge(target.flushLatencyHistogram);
+
+            trimLatencyHistogram.Merge(target.trimLatencyHistogram);
+
+            fuaWriteLatencyHistogram.Merge(target.fuaWriteLatencyHistogram);
+
             totalLatencyHistogram.Merge(target.writeLatencyHistogram);
             totalLatencyHistogram.Merge(target.readLatencyHistogram);
+            totalLatencyHistogram.Merge(target.flushLatencyHistogram);
+            totalLatencyHistogram.Merge(target.trimLatencyHistogram);
+            for (size_t iOp = 0; iOp < target.vMetadataResults.size() && iOp < static_cast<size_t>(MetadataOp::Open); iOp++)
+            {
+                totalLatencyHistogram.Merge(target.vMetadataResults[iOp].latencyHistogram);
+            }
         }
     }
 
     _Print("\nTotal latency distribution:\n");
-    _PrintLatencyChart(readLatencyHistogram, writeLatencyHistogram, totalLatencyHistogram);
+    _PrintLatencyChart(readLatencyHistogram, writeLatencyHistogram, flushLatencyHistogram, trimLatencyHistogram, fuaWriteLatencyHistogram, totalLatencyHistogram);
 }
 
 void ResultParser::_PrintLatencyChart(const Histogram<float>& readLatencyHistogram,
     const Histogram<float>& writeLatencyHistogram,
+    const Histogram<float>& flushLatencyHistogram,
+    const Histogram<float>& trimLatencyHistogram,
+    const Histogram<float>& fuaWriteLatencyHistogram,
     const Histogram<float>& totalLatencyHistogram)
 {
     bool fHasReads = readLatencyHistogram.GetSampleSize() > 0;
     bool fHasWrites = writeLatencyHistogram.GetSampleSize() > 0;
 
-    _Print("  %%-ile |  Read (ms) | Write (ms) | Total (ms)\n");
-    _Print("----------------------------------------------\n");
+    // flush, trim and forced unit access write columns are only shown when the mix has them
+    vector<const Histogram<float> *> vpExtraHistograms;
+    string sExtraNames;
+    string sExtraBorder;
+    for (auto column : { make_pair(&flushLatencyHistogram,    " | Flush (ms)"),
+                         make_pair(&trimLatencyHistogram,     " |  Trim (ms)"),
+                         make_pair(&fuaWriteLatencyHistogram, " |   FUA (ms)") })
+    {
+        if (column.first->GetSampleSize() > 0)
+        {
+            vpExtraHistograms.push_back(column.first);
+            sExtraNames += column.second;
+            sExtraBorder += "-------------";
+        }
+    }
+
+    _Print("  %%-ile |  Read (ms) | Write (ms)%s | Total (ms)\n", sExtraNames.c_str());
+    _Print("----------------------------------------------%s\n", sExtraBorder.c_str());
 
     string readMin =
         fHasReads ?
@@ -1099,8 +1479,12 @@ void ResultParser::_PrintLatencyChart(const Histogram<float>& readLatencyHistogr
         Util::DoubleToStringHelper(writeLatencyHistogram.GetMin() / 1000) :
         "N/A";
 
-    _Print("    min | %10s | %10s | %10.3lf\n",
-           readMin.c_str(), writeMin.c_str(), totalLatencyHistogram.GetMin()/1000);
+    _Print("    min | %10s | %10s", readMin.c_str(), writeMin.c_str());
+    for (auto pHistogram : vpExtraHistograms)
+    {
+        _Print(" | %10s", Util::DoubleToStringHelper(pHistogram->GetMin() / 1000).c_str());
+    }
+    _Print(" | %10.3lf\n", totalLatencyHistogram.GetMin()/1000);
 
     PercentileDescriptor percentiles[] =
     {
@@ -1131,20 +1515,28 @@ void ResultParser::_PrintLatencyChart(const Histogram<float>& readLatencyHistogr
             Util::DoubleToStringHelper(writeLatencyHistogram.GetPercentile(p.Percentile) / 1000) :
             "N/A";
 
-        _Print("%7s | %10s | %10s | %10.3lf\n",
+        _Print("%7s | %10s | %10s",
                p.Name.c_str(),
                readPercentile.c_str(),
-               writePercentile.c_str(),
-               totalLatencyHistogram.GetPercentile(p.Percentile)/1000);
+               writePercentile.c_str());
+        for (auto pHistogram : vpExtraHistograms)
+        {
+            _Print(" | %10s", Util::DoubleToStringHelper(pHistogram->GetPercentile(p.Percentile) / 1000).c_str());
+        }
+        _Print(" | %10.3lf\n", totalLatencyHistogram.GetPercentile(p.Percentile)/1000);
     }
 
     string readMax = Util::DoubleToStringHelper(readLatencyHistogram.GetMax() / 1000);
     string writeMax = Util::DoubleToStringHelper(writeLatencyHistogram.GetMax() / 1000);
 
-    _Print("    max | %10s | %10s | %10.3lf\n",
+    _Print("    max | %10s | %10s",
            fHasReads ? readMax.c_str() : "N/A",
-           fHasWrites ? writeMax.c_str() : "N/A",
-           totalLatencyHistogram.GetMax()/1000);
+           fHasWrites ? writeMax.c_str() : "N/A");
+    for (auto pHistogram : vpExtraHistograms)
+    {
+        _Print(" | %10s", Util::DoubleToStringHelper(pHistogram->GetMax() / 1000).c_str());
+    }
+    _Print(" | %10.3lf\n", totalLatencyHistogram.GetMax()/1000);
 }
 
 string ResultParser::ParseProfile(const Profile& profile)
@@ -1154,6 +1546,285 @@ string ResultParser::ParseProfile(const Profile& profile)
     return _sResult;
 }
 
+void ResultParser::_PrintBlockSizeBreakdown(const Results& results, double fTime, bool fMeasureLatency)
+{
+    //
+    // Aggregate each target's size classes across threads, in order of first appearance.
+    //
+
+    vector<pair<string, vector<BlockSizeResults>>> vTargets;
+
+    for (const auto& thread : results.vThreadResults)
+    {
+        for (const auto& target : thread.vTargetResults)
+        {
+            if (!target.vBlockSizeResults.size())
+            {
+                continue;
+            }
+
+            auto it = find_if(vTargets.begin(), vTargets.end(),
+                [&target](const pair<string, vector<BlockSizeResults>>& t) { return t.first == target.sPath; });
+            if (it == vTargets.end())
+            {
+                vTargets.emplace_back(target.sPath, vector<BlockSizeResults>());
+                it = vTargets.end() - 1;
+                for (const auto& b : target.vBlockSizeResults)
+                {
+                    it->second.emplace_back(b.dwBlockSize);
+                }
+            }
+
+            for (size_t i = 0; i < target.vBlockSizeResults.size() && i < it->second.size(); i++)
+            {
+                const BlockSizeResults& b = target.vBlockSizeResults[i];
+                it->second[i].ullReadIOCount += b.ullReadIOCount;
+                it->second[i].ullWriteIOCount += b.ullWriteIOCount;
+                it->second[i].readLatencyHistogram.Merge(b.readLatencyHistogram);
+                it->second[i].writeLatencyHistogram.Merge(b.writeLatencyHistogram);
+            }
+        }
+    }
+
+    for (const auto& t : vTargets)
+    {
+        _Print("\nBlock size breakdown: %s\n", t.first.c_str());
+        _Print("      size |   read I/Os  |  write I/Os  |    MiB/s   |  I/O per s");
+        if (fMeasureLatency)
+        {
+            _Print(" | read avg/99th (ms) | write avg/99th (ms)");
+        }
+        _Print("\n");
+        _Print("------------------------------------------------------------------");
+        if (fMeasureLatency)
+        {
+            _Print("------------------------------------------");
+        }
+        _Print("\n");
+
+        for (const auto& b : t.second)
+        {
+            UINT64 cIO = b.ullReadIOCount + b.ullWriteIOCount;
+
+            _DisplayFileSize(b.dwBlockSize, 7);
+            _Print(" | %12llu | %12llu | %10.2f | %10.2f",
+                b.ullReadIOCount,
+                b.ullWriteIOCount,
+                (double)cIO * b.dwBlockSize / fTime / (1024 * 1024),
+                (double)cIO / fTime);
+
+            if (fMeasureLatency)
+            {
+                const Histogram<float>& r = b.readLatencyHistogram;
+                const Histogram<float>& w = b.writeLatencyHistogram;
+
+                _Print(" | %8.3f / %8.3f | %8.3f / %8.3f",
+                    r.GetSampleSize() ? r.GetAvg() / 1000 : 0.0,
+                    r.GetSampleSize() ? r.GetPercentile(0.99) / 1000 : 0.0,
+                    w.GetSampleSize() ? w.GetAvg() / 1000 : 0.0,
+                    w.GetSampleSize() ? w.GetPercentile(0.99) / 1000 : 0.0);
+            }
+            _Print("\n");
+        }
+    }
+}
+
+void ResultParser::_PrintMetadataBreakdown(const Results& results, double fTime, bool fMeasureLatency)
+{
+    //
+    // Aggregate each file set target's metadata operations across threads, in order of first appearance.
+    //
+
+    vector<pair<string, vector<MetadataResults>>> vTargets;
+
+    for (const auto& thread : results.vThreadResults)
+    {
+        for (const auto& target : thread.vTargetResults)
+        {
+            if (!target.vMetadataResults.size())
+            {
+                continue;
+            }
+
+            auto it = find_if(vTargets.begin(), vTargets.end(),
+                [&target](const pair<string, vector<MetadataResults>>& t) { return t.first == target.sPath; });
+            if (it == vTargets.end())
+            {
+                vTargets.emplace_back(target.sPath, vector<MetadataResults>(target.vMetadataResults.size()));
+                it = vTargets.end() - 1;
+            }
+
+            for (size_t i = 0; i < target.vMetadataResults.size() && i < it->second.size(); i++)
+            {
+                it->second[i].ullCount += target.vMetadataResults[i].ullCount;
+                it->second[i].latencyHistogram.Merge(target.vMetadataResults[i].latencyHistogram);
+            }
+        }
+    }
+
+    for (const auto& t : vTargets)
+    {
+        // a file set with neither metadata operations nor opens per IO has nothing to show
+        if (none_of(t.second.begin(), t.second.end(), [](const MetadataResults& m) { return m.ullCount != 0; }))
+        {
+            continue;
+        }
+
+        _Print("\nMetadata operations: %s\n", t.first.c_str());
+        _Print(" operation |    count     |  ops per s");
+        if (fMeasureLatency)
+        {
+            _Print(" | avg/99th (ms)");
+        }
+        _Print("\n");
+        _Print("---------------------------------------");
+        if (fMeasureLatency)
+        {
+            _Print("------------------------");
+        }
+        _Print("\n");
+
+        for (size_t i = 0; i < t.second.size(); i++)
+        {
+            const MetadataResults& m = t.second[i];
+
+            if (!m.ullCount)
+            {
+                continue;
+            }
+
+            _Print("%10s | %12llu | %10.2f",
+                MetadataOpName(static_cast<MetadataOp>(i)),
+                m.ullCount,
+                (double)m.ullCount / fTime);
+
+            if (fMeasureLatency)
+            {
+                const Histogram<float>& h = m.latencyHistogram;
+
+                _Print(" | %8.3f / %8.3f",
+                    h.GetSampleSize() ? h.GetAvg() / 1000 : 0.0,
+                    h.GetSampleSize() ? h.GetPercentile(0.99) / 1000 : 0.0);
+            }
+            _Print("\n");
+        }
+    }
+}
+
+void ResultParser::_PrintPhaseBreakdown(const TimeSpan& timeSpan, const Results& results, double fTime, bool fMeasureLatency)
+{
+    if (timeSpan.GetPhases().size() == 0)
+    {
+        return;
+    }
+
+    //
+    // Aggregate the phases across threads and targets, and rate them over the time each ran.
+    //
+
+    vector<PhaseResults> vPhases(timeSpan.GetPhases().size());
+
+    for (const auto& thread : results.vThreadResults)
+    {
+        for (const auto& target : thread.vTargetResults)
+        {
+            for (size_t i = 0; i < target.vPhaseResults.size() && i < vPhases.size(); i++)
+            {
+                const PhaseResults& phase = target.vPhaseResults[i];
+                vPhases[i].ullReadBytesCount += phase.ullReadBytesCount;
+                vPhases[i].ullReadIOCount += phase.ullReadIOCount;
+                vPhases[i].ullWriteBytesCount += phase.ullWriteBytesCount;
+                vPhases[i].ullWriteIOCount += phase.ullWriteIOCount;
+                vPhases[i].readLatencyHistogram.Merge(phase.readLatencyHistogram);
+                vPhases[i].writeLatencyHistogram.Merge(phase.writeLatencyHistogram);
+            }
+        }
+    }
+
+    vector<double> vlfMilliseconds = PhaseSchedule(timeSpan.GetPhases()).GetPhaseMilliseconds(fTime * 1000);
+
+    _Print("\nLoad phase breakdown:\n");
+    _Print(" phase |  time (s)  |   read I/Os  |  write I/Os  |    MiB/s   |  I/O per s");
+    if (fMeasureLatency)
+    {
+        _Print(" | read avg/99th (ms) | write avg/99th (ms)");
+    }
+    _Print("\n");
+    _Print("-------------------------------------------------------------------------------");
+    if (fMeasureLatency)
+    {
+        _Print("------------------------------------------");
+    }
+    _Print("\n");
+
+    for (size_t i = 0; i < vPhases.size(); i++)
+    {
+        const PhaseResults& phase = vPhases[i];
+        double lfSeconds = vlfMilliseconds[i] / 1000;
+        UINT64 cb = phase.ullReadBytesCount + phase.ullWriteBytesCount;
+        UINT64 cIO = phase.ullReadIOCount + phase.ullWriteIOCount;
+
+        _Print("%6u | %10.3f | %12llu | %12llu | %10.2f | %10.2f",
+            (UINT32)i + 1,
+            lfSeconds,
+            phase.ullReadIOCount,
+            phase.ullWriteIOCount,
+            lfSeconds > 0 ? (double)cb / lfSeconds / (1024 * 1024) : 0.0,
+            lfSeconds > 0 ? (double)cIO / lfSeconds : 0.0);
+
+        if (fMeasureLatency)
+        {
+            const Histogram<float>& r = phase.readLatencyHistogram;
+            const Histogram<float>& w = phase.writeLatencyHistogram;
+
+            _Print(" | %8.3f / %8.3f | %8.3f / %8.3f",
+                r.GetSampleSize() ? r.GetAvg() / 1000 : 0.0,
+                r.GetSampleSize() ? r.GetPercentile(0.99) / 1000 : 0.0,
+                w.GetSampleSize() ? w.GetAvg() / 1000 : 0.0,
+                w.GetSampleSize() ? w.GetPercentile(0.99) / 1000 : 0.0);
+        }
+        _Print("\n");
+    }
+}
+
+void ResultParser::_PrintVerification(const TimeSpan& timeSpan, const Results& results)
+{
+    bool fVerify = false;
+    for (const auto& target : timeSpan.GetTargets())
+    {
+        fVerify = fVerify || target.GetVerifyData();
+    }
+
+    if (!fVerify)
+    {
+        return;
+    }
+
+    // counted over the whole run, including warmup and cooldown
+    _Print("\nData verification\n");
+    _Print("thread |  units checked |   failures | file\n");
+    _Print("-----------------------------------------------\n");
+
+    UINT64 cTotalChecked = 0;
+    UINT64 cTotalErrors = 0;
+    for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
+    {
+        for (const auto& targetResults : results.vThreadResults[iThread].vTargetResults)
+        {
+            _Print("%6u | %14llu | %10llu | %s\n",
+                iThread,
+                targetResults.ullVerifiedCount,
+                targetResults.ullVerifyErrorCount,
+                targetResults.sPath.c_str());
+
+            cTotalChecked += targetResults.ullVerifiedCount;
+            cTotalErrors += targetResults.ullVerifyErrorCount;
+        }
+    }
+    _Print("-----------------------------------------------\n");
+    _Print("total: | %14llu | %10llu\n", cTotalChecked, cTotalErrors);
+}
+
 void ResultParser::_PrintWaitStats(const Results &results)
 {
     _Print("Wait Statistics\n");
@@ -1178,6 +1849,37 @@ void ResultParser::_PrintWaitStats(const Results &results)
             threadResults.WaitStats.LookasideCompletion[6],
             threadResults.WaitStats.LookasideCompletion[7]);
     }
+
+    // completions are harvested in batches; each timestamp may trail the actual completion by up
+    // to the time since the completion queue was previously polled
+    bool fTimed = false;
+    for (const auto& threadResults : results.vThreadResults)
+    {
+        fTimed = fTimed || (threadResults.WaitStats.CompletionTimeCount > 0);
+    }
+
+    if (fTimed)
+    {
+        _Print("\nCompletion timestamp error bound\n");
+        _Print("thread |  completions |  avg (us) |  max (us)\n");
+        _Print("---------------------------------------------\n");
+        for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
+        {
+            const WAIT_STATS& waitStats = results.vThreadResults[iThread].WaitStats;
+            double avg = 0;
+
+            if (waitStats.CompletionTimeCount > 0)
+            {
+                avg = PerfTimer::PerfTimeToMicroseconds(waitStats.CompletionTimeError) / waitStats.CompletionTimeCount;
+            }
+
+            _Print("%6u | %12llu | %9.3f | %9.3f\n",
+                iThread,
+                waitStats.CompletionTimeCount,
+                avg,
+                PerfTimer::PerfTimeToMicroseconds(waitStats.CompletionTimeErrorMax));
+        }
+    }
 }
 
 string ResultParser::ParseResults(const Profile& profile, const SystemInformation& system, vector<Results> vResults)
@@ -1232,6 +1934,43 @@ string ResultParser::ParseResults(const Profile& profile, const SystemInformatio
             _Print("\nWrite IO\n");
             _PrintSection(_SectionEnum::WRITE, timeSpan, results);
 
+            // flushes, trims and forced unit access writes are only shown when the mix has them
+            UINT64 cFlushIO = 0;
+            UINT64 cTrimIO = 0;
+            UINT64 cFuaWriteIO = 0;
+            for (const auto& threadResults : results.vThreadResults)
+            {
+                for (const auto& targetResults : threadResults.vTargetResults)
+                {
+                    cFlushIO += targetResults.ullFlushIOCount;
+                    cTrimIO += targetResults.ullTrimIOCount;
+                    cFuaWriteIO += targetResults.ullFuaWriteIOCount;
+                }
+            }
+
+            if (cFlushIO)
+            {
+                _Print("\nFlush IO\n");
+                _PrintSection(_SectionEnum::FLUSH, timeSpan, results);
+            }
+
+            if (cTrimIO)
+            {
+                _Print("\nTrim IO\n");
+                _PrintSection(_SectionEnum::TRIM, timeSpan, results);
+            }
+
+            if (cFuaWriteIO)
+            {
+                _Print("\nFUA Write IO\n");
+                _PrintSection(_SectionEnum::FUA_WRITE, timeSpan, results);
+            }
+
+            _PrintBlockSizeBreakdown(results, fTime, timeSpan.GetMeasureLatency());
+            _PrintMetadataBreakdown(results, fTime, timeSpan.GetMeasureLatency());
+            _PrintPhaseBreakdown(timeSpan, results, fTime, timeSpan.GetMeasureLatency());
+            _PrintVerification(timeSpan, results);
+
             if (timeSpan.GetMeasureLatency())
             {
                 _PrintLatencyPercentiles(results);
@@ -1265,6 +2004,10 @@ string ResultParser::ParseResults(const Profile& profile, const SystemInformatio
         UINT64 cbTotalRead = 0;
         UINT64 cTotalWriteIO = 0;
         UINT64 cTotalReadIO = 0;
+        UINT64 cTotalFlushIO = 0;
+        UINT64 cbTotalTrimmed = 0;
+        UINT64 cTotalTrimIO = 0;
+        UINT64 cTotalMetadataIO = 0;
         UINT64 cTotalTicks = 0;
         for (auto pResults = vResults.begin(); pResults != vResults.end(); pResults++)
         {
@@ -1281,6 +2024,10 @@ string ResultParser::ParseResults(const Profile& profile, const SystemInformatio
                         cbTotalWritten += pTargetResults->ullWriteBytesCount;
                         cTotalReadIO += pTargetResults->ullReadIOCount;
                         cTotalWriteIO += pTargetResults->ullWriteIOCount;
+                        cTotalFlushIO += pTargetResults->ullFlushIOCount;
+                        cbTotalTrimmed += pTargetResults->ullTrimBytesCount;
+                        cTotalTrimIO += pTargetResults->ullTrimIOCount;
+                        cTotalMetadataIO += pTargetResults->ullMetadataIOCount;
                     }
                 }
             }
@@ -1288,26 +2035,135 @@ string ResultParser::ParseResults(const Profile& profile, const SystemInformatio
 
         double totalTime = PerfTimer::PerfTimeToSeconds(cTotalTicks);
 
-        _Print("write  | %15I64u | %12I64u | %10.2lf | %10.2lf\n",
+        _Print("write  | %15llu | %12llu | %10.2lf | %10.2lf\n",
                cbTotalWritten,
                cTotalWriteIO,
                (double)cbTotalWritten / 1024 / 1024 / totalTime,
                (double)cTotalWriteIO / totalTime);
 
-        _Print("read   | %15I64u | %12I64u | %10.2lf | %10.2lf\n",
+        _Print("read   | %15llu | %12llu | %10.2lf | %10.2lf\n",
                cbTotalRead,
                cTotalReadIO,
                (double)cbTotalRead / 1024 / 1024 / totalTime,
                (double)cTotalReadIO / totalTime);
+
+        if (cTotalFlushIO)
+        {
+            _Print("flush  | %15llu | %12llu | %10.2lf | %10.2lf\n",
+                   0ULL,
+                   cTotalFlushIO,
+                   0.0,
+                   (double)cTotalFlushIO / totalTime);
+        }
+
+        // trimmed bytes are not transferred, so not part of the total
+        if (cTotalTrimIO)
+        {
+            _Print("trim   | %15llu | %12llu | %10.2lf | %10.2lf\n",
+                   cbTotalTrimmed,
+                   cTotalTrimIO,
+                   (double)cbTotalTrimmed / 1024 / 1024 / totalTime,
+                   (double)cTotalTrimIO / totalTime);
+        }
+
+        if (cTotalMetadataIO)
+        {
+            _Print("metadata | %13llu | %12llu | %10.2lf | %10.2lf\n",
+                   0ULL,
+                   cTotalMetadataIO,
+                   0.0,
+                   (double)cTotalMetadataIO / totalTime);
+        }
         _Print("-------------------------------------------------------------------------------\n");
-        _Print("total  | %15I64u | %12I64u | %10.2lf | %10.2lf\n\n",
+        _Print("total  | %15llu | %12llu | %10.2lf | %10.2lf\n\n",
                cbTotalRead + cbTotalWritten,
-               cTotalReadIO + cTotalWriteIO,
+               cTotalReadIO + cTotalWriteIO + cTotalFlushIO + cTotalTrimIO + cTotalMetadataIO,
                (double)(cbTotalRead + cbTotalWritten) / 1024 / 1024 / totalTime,
-               (double)(cTotalReadIO + cTotalWriteIO) / totalTime);
+               (double)(cTotalReadIO + cTotalWriteIO + cTotalFlushIO + cTotalTrimIO + cTotalMetadataIO) / totalTime);
 
         _Print("total test time:\t%.2lfs\n", totalTime);
+
+        _PrintTimeSpanSummary(profile, vResults);
     }
 
     return _sResult;
 }
+
+void ResultParser::_PrintTimeSpanSummary(const Profile& profile, const vector<Results>& vResults)
+{
+    //
+    // One line per timespan, so that a sweep reads as a single table.
+    //
+
+    bool fMeasureLatency = false;
+    for (const auto& timeSpan : profile.GetTimeSpans())
+    {
+        fMeasureLatency = fMeasureLatency || timeSpan.GetMeasureLatency();
+    }
+
+    _Print("\nTimespan summary:\n");
+    _Print("  timespan |  threads | outstanding | block size |    MiB/s   |  I/O per s");
+    if (fMeasureLatency)
+    {
+        _Print(" | AvgLat (ms) |   50th (ms) |   99th (ms)");
+    }
+    _Print("\n");
+    _Print("----------------------------------------------------------------------------");
+    if (fMeasureLatency)
+    {
+        _Print("--------------------------------------------");
+    }
+    _Print("\n");
+
+    for (size_t iResult = 0; iResult < vResults.size(); iResult++)
+    {
+        const Results& results = vResults[iResult];
+        const TimeSpan& timeSpan = profile.GetTimeSpans()[iResult];
+        const vector<Target>& vTargets = timeSpan.GetTargets();
+
+        double fTime = PerfTimer::PerfTimeToSeconds(results.ullTimeCount);
+        if (fTime < 0.0000001 || vTargets.empty())
+        {
+            continue;
+        }
+
+        size_t cThreads = (timeSpan.GetThreadCount() > 0) ? timeSpan.GetThreadCount() : results.vThreadResults.size();
+        DWORD cOutstanding = (timeSpan.GetThreadCount() > 0 && timeSpan.GetRequestCount() > 0) ? timeSpan.GetRequestCount() : vTargets[0].GetRequestCount();
+
+        UINT64 cbTotal = 0;
+        UINT64 cTotalIO = 0;
+        Histogram<float> totalLatencyHistogram;
+        for (const auto& thread : results.vThreadResults)
+        {
+            for (const auto& target : thread.vTargetResults)
+            {
+                cbTotal += target.ullBytesCount;
+                cTotalIO += target.ullIOCount;
+                totalLatencyHistogram.Merge(target.readLatencyHistogram);
+                totalLatencyHistogram.Merge(target.writeLatencyHistogram);
+            }
+        }
+
+        _Print("%10llu | %8llu | %11u | ", (UINT64)iResult + 1, (UINT64)cThreads, cOutstanding);
+        _DisplayFileSize(vTargets[0].GetBlockSizeInBytes(), 7);
+        _Print(" | %10.2f | %10.2f",
+            (double)cbTotal / fTime / (1024 * 1024),
+            (double)cTotalIO / fTime);
+
+        if (fMeasureLatency)
+        {
+            if (timeSpan.GetMeasureLatency() && totalLatencyHistogram.GetSampleSize() > 0)
+            {
+                _Print(" | %11.3f | %11.3f | %11.3f",
+                    totalLatencyHistogram.GetAvg() / 1000,
+                    totalLatencyHistogram.GetPercentile(0.5) / 1000,
+                    totalLatencyHistogram.GetPercentile(0.99) / 1000);
+            }
+            else
+            {
+                _Print(" |         N/A |         N/A |         N/A");
+            }
+        }
+        _Print("\n");
+    }
+}
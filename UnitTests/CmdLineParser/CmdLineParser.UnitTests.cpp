@@ -654,6 +654,65 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
+    void CmdLineParserUnitTests::TestParseCmdLineBlockSizeMix()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-b4K:60,64K:30,1M:10", "-r", "-B2b", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            const auto& vMix(t.GetBlockSizeMix());
+            VERIFY_ARE_EQUAL(vMix.size(), (size_t)3);
+            VERIFY_ARE_EQUAL(vMix[0].dwBlockSize, (DWORD)4 * 1024);
+            VERIFY_ARE_EQUAL(vMix[0].ulWeight, (UINT32)60);
+            VERIFY_ARE_EQUAL(vMix[1].dwBlockSize, (DWORD)64 * 1024);
+            VERIFY_ARE_EQUAL(vMix[1].ulWeight, (UINT32)30);
+            VERIFY_ARE_EQUAL(vMix[2].dwBlockSize, (DWORD)1024 * 1024);
+            VERIFY_ARE_EQUAL(vMix[2].ulWeight, (UINT32)10);
+
+            // buffers sized for the largest; block unit and alignment are the smallest
+            VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)1024 * 1024);
+            VERIFY_ARE_EQUAL(t.GetMinBlockSizeInBytes(), (DWORD)4 * 1024);
+            VERIFY_ARE_EQUAL(t.GetMeanBlockSizeInBytes(), (DWORD)((4 * 1024 * 60 + 64 * 1024 * 30 + 1024 * 1024 * 10) / 100));
+            VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), (UINT64)4 * 1024);
+            VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), (UINT64)8 * 1024);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-b8K:1,16K:1", "-s", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetBlockSizeMix().size(), (size_t)2);
+            VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), (UINT64)8 * 1024);
+        }
+
+        // Invalid cases: missing weight, zero weight, zero size, trailing garbage
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-b4K:60,64K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-b4K:0,64K:10", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-b0:10", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-b4K:10x", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
     void CmdLineParserUnitTests::TestParseCmdLineBaseMaxTarget()
     {
         CmdLineParser p;
@@ -2409,6 +2468,80 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)567);
     }
 
+    void CmdLineParserUnitTests::TestParseCmdLinePhases()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-H60:ramp:i1000-20000", "-H0.5:sine10:i5000-20000:w10-50", "-H30:square10/20:o1-8", "-H5:w30", "-o8", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            const vector<LoadPhase>& vPhases(ts.GetPhases());
+            VERIFY_ARE_EQUAL(vPhases.size(), (size_t)4);
+            VERIFY_IS_TRUE(ts.GetPhasesSetWriteRatio());
+
+            VERIFY_ARE_EQUAL(vPhases[0].GetDurationInMilliseconds(), (UINT32)60000);
+            VERIFY_IS_TRUE(vPhases[0].GetShape() == PhaseShape::Ramp);
+            VERIFY_IS_TRUE(vPhases[0].GetIOPS().fSet);
+            VERIFY_ARE_EQUAL(vPhases[0].GetIOPS().ulFrom, (UINT32)1000);
+            VERIFY_ARE_EQUAL(vPhases[0].GetIOPS().ulTo, (UINT32)20000);
+            VERIFY_IS_FALSE(vPhases[0].GetWriteRatio().fSet);
+            VERIFY_IS_FALSE(vPhases[0].GetQueueDepth().fSet);
+
+            VERIFY_ARE_EQUAL(vPhases[1].GetDurationInMilliseconds(), (UINT32)500);
+            VERIFY_IS_TRUE(vPhases[1].GetShape() == PhaseShape::Sine);
+            VERIFY_ARE_EQUAL(vPhases[1].GetPeriodInMilliseconds(), (UINT32)10000);
+            VERIFY_ARE_EQUAL(vPhases[1].GetWriteRatio().ulFrom, (UINT32)10);
+            VERIFY_ARE_EQUAL(vPhases[1].GetWriteRatio().ulTo, (UINT32)50);
+
+            VERIFY_IS_TRUE(vPhases[2].GetShape() == PhaseShape::Square);
+            VERIFY_ARE_EQUAL(vPhases[2].GetPeriodInMilliseconds(), (UINT32)10000);
+            VERIFY_ARE_EQUAL(vPhases[2].GetDutyPercent(), (UINT32)20);
+            VERIFY_ARE_EQUAL(vPhases[2].GetQueueDepth().ulFrom, (UINT32)1);
+            VERIFY_ARE_EQUAL(vPhases[2].GetQueueDepth().ulTo, (UINT32)8);
+
+            // constant is the default shape; a single value is both ends
+            VERIFY_IS_TRUE(vPhases[3].GetShape() == PhaseShape::Constant);
+            VERIFY_ARE_EQUAL(vPhases[3].GetWriteRatio().ulFrom, (UINT32)30);
+            VERIFY_ARE_EQUAL(vPhases[3].GetWriteRatio().ulTo, (UINT32)30);
+        }
+        {
+            // the duty defaults to half the period
+            Profile profile;
+            const char *argv[] = { "foo", "-H10:square2:i100-200", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetPhases()[0].GetDutyPercent(), LoadPhase::DefaultDutyPercent);
+            VERIFY_IS_FALSE(ts.GetPhasesSetWriteRatio());
+        }
+
+        // Invalid cases: no or zero duration; unknown shape or setting; missing period; bad duty;
+        // a range in a constant phase; write ratio above 100; zero queue depth
+
+        const char *ppszInvalid[] = { "-H", "-H0", "-H:ramp", "-H10:saw", "-H10:x5", "-H10:sine:i10-20",
+                                      "-H10:square5/0:i10-20", "-H10:square5/100:i10-20", "-H10:i10-20",
+                                      "-H10:constant:w10-20", "-H10:w101", "-H10:ramp:o0-4", "-H10:i", "-H10:ramp:i10-" };
+        for (auto pszInvalid : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", pszInvalid, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            // phase IOPS can not be combined with open-loop arrivals
+            Profile profile;
+            const char *argv[] = { "foo", "-ga1000", "-H10:i1000", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-x", "-H10:i1000", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
     void CmdLineParserUnitTests::TestParseCmdLineRandomIOAlignment()
     {
         CmdLineParser p;
@@ -2557,6 +2690,70 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
+    void CmdLineParserUnitTests::TestParseCmdLineSweep()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            // block sizes vary slowest and outstanding IOs fastest
+            Profile profile;
+            const char *argv[] = { "foo", "-Yb4K,8K", "-Yo1-4", "-Yt1,3", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const vector<TimeSpan>& vTimeSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vTimeSpans.size(), (size_t)12);
+
+            const DWORD pdwBlockSizes[] = { 4096, 8192 };
+            const DWORD pdwThreads[] = { 1, 3 };
+            const DWORD pdwRequests[] = { 1, 2, 4 };
+            size_t iTimeSpan = 0;
+            for (auto dwBlockSize : pdwBlockSizes)
+            {
+                for (auto dwThreads : pdwThreads)
+                {
+                    for (auto dwRequests : pdwRequests)
+                    {
+                        const TimeSpan& ts(vTimeSpans[iTimeSpan++]);
+                        VERIFY_IS_FALSE(ts.HasSweep());
+                        VERIFY_ARE_EQUAL(ts.GetTargets().size(), (size_t)1);
+                        const Target& t(ts.GetTargets()[0]);
+                        VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), dwBlockSize);
+                        VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), dwThreads);
+                        VERIFY_ARE_EQUAL(t.GetRequestCount(), dwRequests);
+                    }
+                }
+            }
+        }
+        {
+            // with -F and -O the sweep applies to the timespan's totals
+            Profile profile;
+            const char *argv[] = { "foo", "-F2", "-O8", "-Yo2,16-32", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const vector<TimeSpan>& vTimeSpans(profile.GetTimeSpans());
+            VERIFY_ARE_EQUAL(vTimeSpans.size(), (size_t)3);
+            VERIFY_ARE_EQUAL(vTimeSpans[0].GetRequestCount(), (DWORD)2);
+            VERIFY_ARE_EQUAL(vTimeSpans[1].GetRequestCount(), (DWORD)16);
+            VERIFY_ARE_EQUAL(vTimeSpans[2].GetRequestCount(), (DWORD)32);
+            VERIFY_ARE_EQUAL(vTimeSpans[2].GetThreadCount(), (DWORD)2);
+        }
+
+        // Invalid cases: unknown dimension, empty/zero/descending points, trailing garbage;
+        // an SLO search already chooses the outstanding IO count
+
+        const char *ppszInvalid[] = { "-Y", "-Yx1", "-Yo", "-Yo0", "-Yo4-2", "-Yo1,", "-Yo1,,2", "-Yo1x", "-Ybk" };
+        for (auto pszInvalid : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", pszInvalid, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-K99:2", "-Yo1,2", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
     void CmdLineParserUnitTests::TestParseCmdLineThreadsPerFileAndThreadStride()
     {
         CmdLineParser p;
@@ -3594,90 +3791,137 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineMeasureLatency()
+    void CmdLineParserUnitTests::TestParseCmdLineIoEngine()
     {
         CmdLineParser p;
-        Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-L", "testfile.dat" };
-        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-        VERIFY_IS_TRUE(profile.GetVerbose() == false);
-        VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -L testfile.dat") == 0);
-        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
-        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
-        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
-        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
-        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
-        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
 
-        vector<TimeSpan> vSpans(profile.GetTimeSpans());
-        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
-        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
-        VERIFY_ARE_EQUAL(vSpans[0].GetWarmup(), (UINT32)5);
-        VERIFY_ARE_EQUAL(vSpans[0].GetCooldown(), (UINT32)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
-        VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
-        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == true);
-        VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
+        // default engine
 
-        const auto& vAffinity(vSpans[0].GetAffinityAssignments());
-        VERIFY_ARE_EQUAL(vAffinity.size(), (size_t)0);
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetIoEngine() == IoEngine::Default);
+        }
 
-        vector<Target> vTargets(vSpans[0].GetTargets());
-        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
-        Target t(vTargets[0]);
+        // io_uring; profile only since the engine is not available on all platforms
 
-        VERIFY_IS_TRUE(t.GetPath().compare("testfile.dat") == 0);
-        VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(128 * 1024));
-        VERIFY_ARE_EQUAL(t.GetRequestCount(), (DWORD)2);
-        VERIFY_IS_TRUE(t.GetRandomRatio() == 0);
-        VERIFY_IS_TRUE(t.GetUseInterlockedSequential() == false);
-        VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
-        VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
-        VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
-        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
-        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
-        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
-        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
-        VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
-        VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
-        VERIFY_IS_TRUE(t.GetCreateFile() == false);
-        VERIFY_ARE_EQUAL(t.GetFileSize(), 0);
-        VERIFY_ARE_EQUAL(t.GetMaxFileSize(), 0);
-        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (DWORD)84);
-        VERIFY_IS_TRUE(t.GetUseBurstSize() == false);
-        VERIFY_ARE_EQUAL(t.GetBurstSize(), (DWORD)0);
-        VERIFY_ARE_EQUAL(t.GetThinkTime(), (DWORD)0);
-        VERIFY_IS_TRUE(t.GetEnableThinkTime() == false);
-        VERIFY_IS_TRUE(t.GetSequentialScanHint() == false);
-        VERIFY_IS_TRUE(t.GetRandomAccessHint() == false);
-        VERIFY_IS_TRUE(t.GetTemporaryFileHint() == false);
-        VERIFY_IS_TRUE(t.GetUseLargePages() == false);
-        VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-u", "-o32", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetIoEngine() == IoEngine::IoUring);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetCompletionRoutines() == false);
+        }
+
+        // registered buffers and files
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-uf", "-o32", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetIoEngine() == IoEngine::IoUring);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetRegisteredIo() == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetSqPoll() == false);
+        }
+
+        // submission queue polling, alone and combined with registration
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-up", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetSqPoll() == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetRegisteredIo() == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-ufp", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetSqPoll() == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetRegisteredIo() == true);
+        }
+
+        // invalid cases: unknown/repeated qualifier, conflict with completion routines and mapped IO
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-ux", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-uff", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-upp", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-u", "-x", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-u", "-Sm", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        // Linux AIO, with default and stated minimum completion batch
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-A", "-o32", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetIoEngine() == IoEngine::LinuxAio);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetAioMinEvents() == 1);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-A8", "-o32", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetIoEngine() == IoEngine::LinuxAio);
+            VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetAioMinEvents() == 8);
+        }
+
+        // invalid cases: bad count, combined with io_uring, conflict with completion routines and mapped IO
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-A0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-A", "-u", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-A", "-x", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-A", "-Sm", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineZeroWriteBuffers()
+    void CmdLineParserUnitTests::TestParseCmdLineMeasureLatency()
     {
         CmdLineParser p;
         Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-Z", "testfile.dat" };
+        const char *argv[] = { "foo", "-b128K", "-w84", "-L", "testfile.dat" };
         VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
         VERIFY_IS_TRUE(profile.GetVerbose() == false);
         VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Z testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -L testfile.dat") == 0);
         VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
         VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
         VERIFY_IS_TRUE(profile.GetEtwThread() == false);
@@ -3702,7 +3946,8 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
         VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
         VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
-        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == true);
+        VERIFY_IS_TRUE(vSpans[0].GetIoTracePath().empty());
         VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
 
         const auto& vAffinity(vSpans[0].GetAffinityAssignments());
@@ -3724,7 +3969,7 @@ namespace UnitTests
         VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
         VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
-        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == true);
+        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
         VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
         VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
         VERIFY_IS_TRUE(t.GetCreateFile() == false);
@@ -3740,37 +3985,290 @@ namespace UnitTests
         VERIFY_IS_TRUE(t.GetTemporaryFileHint() == false);
         VERIFY_IS_TRUE(t.GetUseLargePages() == false);
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
-        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), 0);
-        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSourcePath(), "");
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineRandomWriteBuffers()
+    void CmdLineParserUnitTests::TestParseCmdLineReportInterval()
     {
         CmdLineParser p;
-        Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-Zr", "testfile.dat" };
-        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-        VERIFY_IS_TRUE(profile.GetVerbose() == false);
-        VERIFY_IS_TRUE(profile.GetProgress() == 0);
-        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Zr testfile.dat") == 0);
-        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
-        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
-        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
-        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
-        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
-        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
-        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
-        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
 
-        vector<TimeSpan> vSpans(profile.GetTimeSpans());
-        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
-        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetReportIntervalInMilliseconds(), (UINT32)0);
+            VERIFY_IS_FALSE(ts.GetReportIntervalJson());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-U500", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetReportIntervalInMilliseconds(), (UINT32)500);
+            VERIFY_IS_FALSE(ts.GetReportIntervalJson());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-U1000j", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetReportIntervalInMilliseconds(), (UINT32)1000);
+            VERIFY_IS_TRUE(ts.GetReportIntervalJson());
+        }
+
+        // Invalid cases: no interval, zero, bad qualifier
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-U", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-U0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-U100x", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Uj", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineIoTrace()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Lt:io.trc", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_IS_TRUE(ts.GetMeasureLatency() == true);
+            VERIFY_IS_TRUE(ts.GetIoTracePath() == "io.trc");
+        }
+
+        // Invalid cases: no file
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Lt", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Lt:", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineLatencySignificantDigits()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-L", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetLatencySignificantDigits(), (UINT32)Histogram<float>::DefaultSignificantDigits);
+            VERIFY_IS_TRUE(profile.GetXml(0).find("<LatencySignificantDigits>") == string::npos);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Ld5", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_IS_TRUE(ts.GetMeasureLatency() == true);
+            VERIFY_ARE_EQUAL(ts.GetLatencySignificantDigits(), (UINT32)5);
+            VERIFY_IS_TRUE(profile.GetXml(0).find("<LatencySignificantDigits>5</LatencySignificantDigits>") != string::npos);
+        }
+
+        // Invalid cases: no precision, out of range, trailing characters
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Ld", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Ld0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Ld6", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Ld3x", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineLatencySlo()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetLatencySloPercentile(), 0.0);
+            VERIFY_IS_FALSE(ts.GetMeasureLatency());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-K99:2", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetLatencySloPercentile(), 99.0);
+            VERIFY_ARE_EQUAL(ts.GetLatencySloMilliseconds(), 2.0);
+            VERIFY_ARE_EQUAL(ts.GetLatencySloMaxRequestCount(), TimeSpan::LatencySloDefaultMaxRequestCount);
+            VERIFY_IS_TRUE(ts.GetMeasureLatency());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-K99.9:0.5:64", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetLatencySloPercentile(), 99.9);
+            VERIFY_ARE_EQUAL(ts.GetLatencySloMilliseconds(), 0.5);
+            VERIFY_ARE_EQUAL(ts.GetLatencySloMaxRequestCount(), (DWORD)64);
+        }
+
+        // Invalid cases: missing or out of range percentile, latency or count; trailing garbage;
+        // open-loop arrivals, which the outstanding IO count does not pace
+
+        const char *ppszInvalid[] = { "-K", "-K99", "-K99:", "-K0:2", "-K100:2", "-K99:0", "-K99:2:0", "-K99:2:", "-K99:2:8x", "-Kx:2" };
+        for (auto pszInvalid : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", pszInvalid, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-K99:2", "-ga1000", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineZeroWriteBuffers()
+    {
+        CmdLineParser p;
+        Profile profile;
+        struct Synchronization s = {};
+        const char *argv[] = { "foo", "-b128K", "-w84", "-Z", "testfile.dat" };
+        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+        VERIFY_IS_TRUE(profile.GetVerbose() == false);
+        VERIFY_IS_TRUE(profile.GetProgress() == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Z testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
+        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
+        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
+        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
+        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
+        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
+
+        vector<TimeSpan> vSpans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
+        VERIFY_ARE_EQUAL(vSpans[0].GetWarmup(), (UINT32)5);
+        VERIFY_ARE_EQUAL(vSpans[0].GetCooldown(), (UINT32)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetThreadCount(), (DWORD)0);
+        VERIFY_ARE_EQUAL(vSpans[0].GetRequestCount(), (DWORD)0);
+        VERIFY_IS_TRUE(vSpans[0].GetDisableAffinity() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetCompletionRoutines() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetMeasureLatency() == false);
+        VERIFY_IS_TRUE(vSpans[0].GetRandomWriteData() == false);
+
+        const auto& vAffinity(vSpans[0].GetAffinityAssignments());
+        VERIFY_ARE_EQUAL(vAffinity.size(), (size_t)0);
+
+        vector<Target> vTargets(vSpans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t(vTargets[0]);
+
+        VERIFY_IS_TRUE(t.GetPath().compare("testfile.dat") == 0);
+        VERIFY_ARE_EQUAL(t.GetBlockSizeInBytes(), (DWORD)(128 * 1024));
+        VERIFY_ARE_EQUAL(t.GetRequestCount(), (DWORD)2);
+        VERIFY_IS_TRUE(t.GetRandomRatio() == 0);
+        VERIFY_IS_TRUE(t.GetUseInterlockedSequential() == false);
+        VERIFY_ARE_EQUAL(t.GetBlockAlignmentInBytes(), t.GetBlockSizeInBytes());
+        VERIFY_ARE_EQUAL(t.GetBaseFileOffsetInBytes(), 0);
+        VERIFY_IS_TRUE(t.GetUseParallelAsyncIO() == false);
+        VERIFY_IS_TRUE(t.GetCacheMode() == TargetCacheMode::Cached);
+        VERIFY_IS_TRUE(t.GetWriteThroughMode() == WriteThroughMode::Off);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoMode() == MemoryMappedIoMode::Off);
+        VERIFY_IS_TRUE(t.GetMemoryMappedIoFlushMode() == MemoryMappedIoFlushMode::Undefined);
+        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == true);
+        VERIFY_ARE_EQUAL(t.GetThreadsPerFile(), (DWORD)1);
+        VERIFY_ARE_EQUAL(t.GetThreadStrideInBytes(), 0);
+        VERIFY_IS_TRUE(t.GetCreateFile() == false);
+        VERIFY_ARE_EQUAL(t.GetFileSize(), 0);
+        VERIFY_ARE_EQUAL(t.GetMaxFileSize(), 0);
+        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (DWORD)84);
+        VERIFY_IS_TRUE(t.GetUseBurstSize() == false);
+        VERIFY_ARE_EQUAL(t.GetBurstSize(), (DWORD)0);
+        VERIFY_ARE_EQUAL(t.GetThinkTime(), (DWORD)0);
+        VERIFY_IS_TRUE(t.GetEnableThinkTime() == false);
+        VERIFY_IS_TRUE(t.GetSequentialScanHint() == false);
+        VERIFY_IS_TRUE(t.GetRandomAccessHint() == false);
+        VERIFY_IS_TRUE(t.GetTemporaryFileHint() == false);
+        VERIFY_IS_TRUE(t.GetUseLargePages() == false);
+        VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
+        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), 0);
+        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSourcePath(), "");
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineRandomWriteBuffers()
+    {
+        CmdLineParser p;
+        Profile profile;
+        struct Synchronization s = {};
+        const char *argv[] = { "foo", "-b128K", "-w84", "-Zr", "testfile.dat" };
+        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+        VERIFY_IS_TRUE(profile.GetVerbose() == false);
+        VERIFY_IS_TRUE(profile.GetProgress() == 0);
+        VERIFY_IS_TRUE(profile.GetCmdLine().compare("foo -b128K -w84 -Zr testfile.dat") == 0);
+        VERIFY_IS_TRUE(profile.GetEtwEnabled() == false);
+        VERIFY_IS_TRUE(profile.GetEtwProcess() == false);
+        VERIFY_IS_TRUE(profile.GetEtwThread() == false);
+        VERIFY_IS_TRUE(profile.GetEtwImageLoad() == false);
+        VERIFY_IS_TRUE(profile.GetEtwDiskIO() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryPageFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwMemoryHardFaults() == false);
+        VERIFY_IS_TRUE(profile.GetEtwNetwork() == false);
+        VERIFY_IS_TRUE(profile.GetEtwRegistry() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePagedMemory() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUsePerfTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseSystemTimer() == false);
+        VERIFY_IS_TRUE(profile.GetEtwUseCyclesCounter() == false);
+
+        vector<TimeSpan> vSpans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vSpans.size(), (size_t)1);
+        VERIFY_ARE_EQUAL(vSpans[0].GetDuration(), (UINT32)10);
         VERIFY_ARE_EQUAL(vSpans[0].GetWarmup(), (UINT32)5);
         VERIFY_ARE_EQUAL(vSpans[0].GetCooldown(), (UINT32)0);
         VERIFY_ARE_EQUAL(vSpans[0].GetRandSeed(), (UINT32)0);
@@ -3842,53 +4340,329 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(cb, 11332);
         VERIFY_IS_TRUE(sPath == "x:\\foo\\bar");
 
-        cb = 0;
-        sPath = "";
-        p._GetRandomDataWriteBufferData("2M", cb, sPath);
-        VERIFY_ARE_EQUAL(cb, 2 * 1024 * 1024);
-        VERIFY_IS_TRUE(sPath == "");
+        cb = 0;
+        sPath = "";
+        p._GetRandomDataWriteBufferData("2M", cb, sPath);
+        VERIFY_ARE_EQUAL(cb, 2 * 1024 * 1024);
+        VERIFY_IS_TRUE(sPath == "");
+
+        cb = 0;
+        sPath = "";
+        p._GetRandomDataWriteBufferData("2M,x:\\foo\\bar", cb, sPath);
+        VERIFY_ARE_EQUAL(cb, 2 * 1024 * 1024);
+        VERIFY_IS_TRUE(sPath == "x:\\foo\\bar");
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineWriteBufferContentRandomNoFilePath()
+    {
+        CmdLineParser p;
+        Profile profile;
+        struct Synchronization s = {};
+        const char *argv[] = { "foo", "-b128K", "-w84", "-Z2M", "testfile.dat" };
+        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+        vector<TimeSpan> vSpans(profile.GetTimeSpans());
+        vector<Target> vTargets(vSpans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t(vTargets[0]);
+
+        VERIFY_IS_FALSE(t.GetZeroWriteBuffers());
+        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), (size_t)(2 * 1024 * 1024));
+        VERIFY_IS_TRUE(t.GetRandomDataWriteBufferSourcePath() == "");
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineWriteBufferContentRandomWithFilePath()
+    {
+        CmdLineParser p;
+        Profile profile;
+        struct Synchronization s = {};
+        const char *argv[] = { "foo", "-b128K", "-w84", "-Z3M,x:\\foo\\bar.baz", "testfile.dat" };
+        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+
+        vector<TimeSpan> vSpans(profile.GetTimeSpans());
+        vector<Target> vTargets(vSpans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t(vTargets[0]);
+
+        VERIFY_IS_FALSE(t.GetZeroWriteBuffers());
+        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), (size_t)(3 * 1024 * 1024));
+        VERIFY_IS_TRUE(t.GetRandomDataWriteBufferSourcePath() == "x:\\foo\\bar.baz");
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineWriteBufferContentReducible()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            // dedup defaults to all unique, in 4KiB chunks
+            Profile profile;
+            const char *argv[] = { "foo", "-w50", "-Zc2", "testfile1.dat", "testfile2.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            for (const auto& t : profile.GetTimeSpans()[0].GetTargets())
+            {
+                VERIFY_IS_TRUE(t.GetReducibleWriteData());
+                VERIFY_ARE_EQUAL(t.GetCompressionRatio(), 2.0);
+                VERIFY_ARE_EQUAL(t.GetDedupRatio(), 1.0);
+                VERIFY_ARE_EQUAL(t.GetDedupChunkSize(), ReducibleDataPool::DefaultChunkSize);
+                VERIFY_IS_FALSE(t.GetZeroWriteBuffers());
+                VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), (UINT64)0);
+            }
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-w50", "-Zc1.5:3", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetCompressionRatio(), 1.5);
+            VERIFY_ARE_EQUAL(t.GetDedupRatio(), 3.0);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-w50", "-Zc4:2:16K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetCompressionRatio(), 4.0);
+            VERIFY_ARE_EQUAL(t.GetDedupRatio(), 2.0);
+            VERIFY_ARE_EQUAL(t.GetDedupChunkSize(), (UINT32)(16 * 1024));
+        }
+
+        // Invalid cases: no or bad ratios; ratios below 1 or too much compression; chunks not
+        // in whole segments; trailing characters
+
+        const char *ppszInvalid[] = { "-Zc", "-Zcx", "-Zc0.5", "-Zc65", "-Zc2:", "-Zc2:0.9", "-Zc2:3:", "-Zc2:3:1000", "-Zc2:3:0", "-Zc2x" };
+        for (auto pszInvalid : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", pszInvalid, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+
+        // other write data can not be used with it
+        const char *ppszOther[] = { "-Z", "-Zr", "-Z1M" };
+        for (auto pszOther : ppszOther)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Zc2", pszOther, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineWriteBufferContentVerify()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            // unit defaults to 4KiB
+            Profile profile;
+            const char *argv[] = { "foo", "-w50", "-r", "-Zv", "testfile1.dat", "testfile2.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            for (const auto& t : profile.GetTimeSpans()[0].GetTargets())
+            {
+                VERIFY_IS_TRUE(t.GetVerifyData());
+                VERIFY_ARE_EQUAL(t.GetVerifyUnitSize(), DataVerifier::DefaultUnitSize);
+            }
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-w50", "-b64K", "-r", "-Zv", "-Zc2", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetVerifyData());
+            VERIFY_IS_TRUE(t.GetReducibleWriteData());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-w50", "-b64K", "-Zv16K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetVerifyUnitSize(), (UINT32)(16 * 1024));
+        }
+
+        // Invalid cases: bad or unaligned unit sizes; blocks, alignment or offsets which do not
+        // cover whole units; a shared write buffer; the same target twice
+
+        const char *ppszInvalid[][3] = {
+            { "-Zvx", "-b4K", "-r" },
+            { "-Zv0", "-b4K", "-r" },
+            { "-Zv1000", "-b4K", "-r" },
+            { "-Zv8K", "-b4K", "-r" },
+            { "-Zv", "-b4K", "-r512" },
+            { "-Zv", "-b64K", "-B512" },
+            { "-Zv", "-b4K:1,6K:1", "-r" },
+            { "-Zv", "-Z1M", "-r" } };
+        for (auto ppszArgs : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", ppszArgs[0], ppszArgs[1], ppszArgs[2], "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Zv", "testfile.dat", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineFlushAndFuaWrite()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-w30", "-wf1", "testfile1.dat", "testfile2.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            for (const auto& t : profile.GetTimeSpans()[0].GetTargets())
+            {
+                VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)30);
+                VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)1);
+                VERIFY_ARE_EQUAL(t.GetFuaWriteRatio(), (UINT32)0);
+            }
+        }
+        {
+            // forced unit access is Linux only, so profile only
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-wu25", "-w100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)100);
+            VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)0);
+            VERIFY_ARE_EQUAL(t.GetFuaWriteRatio(), (UINT32)25);
+        }
+
+        // Invalid cases: missing or out of range ratios; forced unit access without writes;
+        // flushes with memory mapped IO or completion routines
 
-        cb = 0;
-        sPath = "";
-        p._GetRandomDataWriteBufferData("2M,x:\\foo\\bar", cb, sPath);
-        VERIFY_ARE_EQUAL(cb, 2 * 1024 * 1024);
-        VERIFY_IS_TRUE(sPath == "x:\\foo\\bar");
+        const char *ppszInvalid[][2] = {
+            { "-wf", "-w50" },
+            { "-wf101", "-w50" },
+            { "-wu", "-w50" },
+            { "-wu101", "-w50" },
+            { "-wu50", "-w0" },
+            { "-wf5", "-Sm" },
+            { "-wf5", "-x" } };
+        for (auto ppszArgs : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", ppszArgs[0], ppszArgs[1], "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineWriteBufferContentRandomNoFilePath()
+    void CmdLineParserUnitTests::TestParseCmdLineTrim()
     {
         CmdLineParser p;
-        Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-Z2M", "testfile.dat" };
-        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
 
-        vector<TimeSpan> vSpans(profile.GetTimeSpans());
-        vector<Target> vTargets(vSpans[0].GetTargets());
-        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
-        Target t(vTargets[0]);
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-w30", "-wt10:64K", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)30);
+            VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)0);
+            VERIFY_ARE_EQUAL(t.GetTrimRatio(), (UINT32)10);
+            VERIFY_ARE_EQUAL(t.GetTrimSize(), (DWORD)64*1024);
+        }
+        {
+            // trims default to the block size
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-wf5", "-wt5", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)5);
+            VERIFY_ARE_EQUAL(t.GetTrimRatio(), (UINT32)5);
+            VERIFY_ARE_EQUAL(t.GetTrimSize(), (DWORD)0);
+        }
 
-        VERIFY_IS_FALSE(t.GetZeroWriteBuffers());
-        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), (size_t)(2 * 1024 * 1024));
-        VERIFY_IS_TRUE(t.GetRandomDataWriteBufferSourcePath() == "");
+        // Invalid cases: missing or out of range ratio or size; flushes and trims over 100%;
+        // trims with data verification, memory mapped IO or completion routines
+
+        const char *ppszInvalid[][2] = {
+            { "-wt", "-w50" },
+            { "-wt101", "-w50" },
+            { "-wt5:0", "-w50" },
+            { "-wt5:", "-w50" },
+            { "-wf60", "-wt50" },
+            { "-wt5", "-Zv" },
+            { "-wt5", "-Sm" },
+            { "-wt5", "-x" } };
+        for (auto ppszArgs : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-w50", ppszArgs[0], ppszArgs[1], "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
     }
 
-    void CmdLineParserUnitTests::TestParseCmdLineWriteBufferContentRandomWithFilePath()
+    void CmdLineParserUnitTests::TestParseCmdLineFileSet()
     {
         CmdLineParser p;
-        Profile profile;
         struct Synchronization s = {};
-        const char *argv[] = { "foo", "-b128K", "-w84", "-Z3M,x:\\foo\\bar.baz", "testfile.dat" };
-        VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
-
-        vector<TimeSpan> vSpans(profile.GetTimeSpans());
-        vector<Target> vTargets(vSpans[0].GetTargets());
-        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
-        Target t(vTargets[0]);
 
-        VERIFY_IS_FALSE(t.GetZeroWriteBuffers());
-        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), (size_t)(3 * 1024 * 1024));
-        VERIFY_IS_TRUE(t.GetRandomDataWriteBufferSourcePath() == "x:\\foo\\bar.baz");
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-m100", "-mz0.9", "-mo", "-mm20:sr", "-wt10", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetFileSetCount(), (DWORD)100);
+            VERIFY_ARE_EQUAL(t.GetFileSetSkew(), 0.9);
+            VERIFY_IS_TRUE(t.GetOpenPerIO());
+            VERIFY_ARE_EQUAL(t.GetMetadataRatio(), (UINT32)20);
+            VERIFY_ARE_EQUAL(t.GetMetadataOps(), MetadataOpMask(MetadataOp::Stat) | MetadataOpMask(MetadataOp::Rename));
+        }
+        {
+            // uniform, held open, and all kinds of metadata operation
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-m4", "-mm5", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetFileSetCount(), (DWORD)4);
+            VERIFY_ARE_EQUAL(t.GetFileSetSkew(), 0.0);
+            VERIFY_IS_FALSE(t.GetOpenPerIO());
+            VERIFY_ARE_EQUAL(t.GetMetadataRatio(), (UINT32)5);
+            VERIFY_ARE_EQUAL(t.GetMetadataOps(), MetadataOpMask(MetadataOp::Create) | MetadataOpMask(MetadataOp::Stat) |
+                                                 MetadataOpMask(MetadataOp::Unlink) | MetadataOpMask(MetadataOp::Rename));
+        }
+
+        // Invalid cases: missing or out of range count, skew, ratio or operations; flushes, trims and
+        // metadata operations over 100%; -mz, -mo and -mm without a file set; file sets with data
+        // verification, memory mapped IO or trace replay; opens per IO with completion routines
+
+        const char *ppszInvalid[][2] = {
+            { "-m", "-w50" },
+            { "-m0", "-w50" },
+            { "-m4x", "-w50" },
+            { "-m4", "-mz" },
+            { "-m4", "-mz1" },
+            { "-m4", "-mm" },
+            { "-m4", "-mm101" },
+            { "-m4", "-mm5:x" },
+            { "-m4", "-mm5:" },
+            { "-mz0.5", "-w50" },
+            { "-mo", "-w50" },
+            { "-mm5", "-w50" },
+            { "-m4", "-Zv" },
+            { "-m4", "-Sm" },
+            { "-m4", "-Q:trace.csv" } };
+        for (auto ppszArgs : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-w50", ppszArgs[0], ppszArgs[1], "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-m4", "-mo", "-x", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Rp", "-m4", "-mm5", "-wt96", "testdir" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
     }
 
     void CmdLineParserUnitTests::TestParseCmdLineInterlockedSequential()
@@ -4113,6 +4887,59 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
     }
 
+    void CmdLineParserUnitTests::TestParseCmdLineTotalThroughput()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-gt4000i", "-gr1024", "testfile1.dat", "testfile2.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const TimeSpan& ts(profile.GetTimeSpans()[0]);
+            VERIFY_ARE_EQUAL(ts.GetTotalThroughputInBytesPerMillisecond(), (DWORD)1024);
+            VERIFY_ARE_EQUAL(ts.GetTotalThroughputIOPS(), (DWORD)0);
+            for (const auto& t : ts.GetTargets())
+            {
+                VERIFY_ARE_EQUAL(t.GetTotalThroughputIOPS(), (DWORD)4000);
+                VERIFY_ARE_EQUAL(t.GetTotalThroughputInBytesPerMillisecond(), (DWORD)0);
+                VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
+            }
+        }
+        {
+            // a spin time applies to shared limits as well
+            Profile profile;
+            const char *argv[] = { "foo", "-gr20000i", "-gs100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            VERIFY_ARE_EQUAL(profile.GetTimeSpans()[0].GetTotalThroughputIOPS(), (DWORD)20000);
+        }
+
+        // Invalid cases: no digits, zero, bad unit; with completion routines or open-loop arrivals
+
+        const char *ppszInvalid[] = { "-gt", "-gti", "-gt0", "-gt0i", "-gt10x", "-gt10ii", "-gr", "-gr0", "-grx" };
+        for (auto pszInvalid : ppszInvalid)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", pszInvalid, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-x", "-gt1000", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-x", "-gr1000", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-ga1000", "-gr1000i", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
     void CmdLineParserUnitTests::TestParseCmdLineThroughput()
     {
         CmdLineParser p;
@@ -4131,9 +4958,18 @@ namespace UnitTests
             VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
             VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetTargets()[0].GetThroughputInBytesPerMillisecond() == 1024);
             VERIFY_IS_TRUE(profile.GetTimeSpans()[0].GetTargets()[0].GetThroughputIOPS() == 0);
+            VERIFY_ARE_EQUAL(profile.GetTimeSpans()[0].GetTargets()[0].GetThrottleSpinMicroseconds(), (DWORD)0);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-b4K", "-g2000i", "-gs150", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetThrottleSpinMicroseconds(), (DWORD)150);
+            VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecondExact(), 2000.0 * 4096 / 1000);
         }
 
-        // Invalid cases: valid unit on wrong side, no digits, zeroes, bad unit
+        // Invalid cases: valid unit on wrong side, no digits, zeroes, bad unit; spin without a throttle
 
         {
             Profile profile;
@@ -4165,6 +5001,146 @@ namespace UnitTests
             const char *argv[] = { "foo", "-b128K", "-g100x", "testfile.dat" };
             VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
         }
+
+        const char *ppszInvalidSpin[] = { "-gs", "-gs0", "-gs10x", "-gsx" };
+        for (auto pszInvalid : ppszInvalidSpin)
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-g1024", pszInvalid, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-gs100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineArrivalRate()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-ga2500", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetArrivalRate(), (DWORD)2500);
+            VERIFY_IS_FALSE(t.GetPoissonArrivals());
+            VERIFY_ARE_EQUAL(t.GetThroughputInBytesPerMillisecond(), (DWORD)0);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-ga100p", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_ARE_EQUAL(t.GetArrivalRate(), (DWORD)100);
+            VERIFY_IS_TRUE(t.GetPoissonArrivals());
+        }
+
+        // Invalid cases: no digits, zero, trailing garbage, bad qualifier, conflicts with throttling and think time
+
+        for (auto pszInvalid : { "-ga", "-gap", "-ga12x3", "-ga100pp", "-ga4294967296" })
+        {
+            Profile profile;
+            const char *argv[] = { "foo", pszInvalid, "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-ga0", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-ga100i", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-ga100", "-g10i", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-ga100", "-i4", "-j10", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+    }
+
+    void CmdLineParserUnitTests::TestParseCmdLineTraceReplay()
+    {
+        CmdLineParser p;
+        struct Synchronization s = {};
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q:trace.csv", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetTracePath() == "trace.csv");
+            VERIFY_IS_TRUE(t.GetTraceTimestamps());
+            VERIFY_IS_TRUE(t.GetIOMode() == IOMode::Trace);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Qt:trace.csv", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_IS_TRUE(t.GetTraceTimestamps());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Qf:trace.csv", "-g100i", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == true);
+            const Target& t(profile.GetTimeSpans()[0].GetTargets()[0]);
+            VERIFY_IS_FALSE(t.GetTraceTimestamps());
+            VERIFY_ARE_EQUAL(t.GetThroughputIOPS(), (DWORD)100);
+        }
+
+        // Invalid cases: no path, bad pacing, access pattern/mix/rate conflicts, throttling when paced by timestamps
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q:", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Qx:trace.csv", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q:trace.csv", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q:trace.csv", "-w50", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q:trace.csv", "-b4K:1,8K:1", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q:trace.csv", "-ga100", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-Q:trace.csv", "-g100i", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s) == false);
+        }
     }
 
     void CmdLineParserUnitTests::TestParseCmdLineRandomSequentialMixed()
@@ -4681,6 +5657,82 @@ namespace UnitTests
             const char *argv[] = { "foo", "-rdabs10/10", "-r", "testfile.dat" };
             VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
         }
+
+        //
+        // Skewed distributions: optional parameter, validated in common code
+        //
+
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdzipf", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+
+            auto t = profile.GetTimeSpans()[0].GetTargets()[0];
+            VERIFY_ARE_EQUAL(t.GetDistributionType(), DistributionType::Zipf);
+            VERIFY_ARE_EQUAL(t.GetDistributionSkew(), 0.99);
+            VERIFY_ARE_EQUAL(t.GetDistributionRange().size(), (size_t) 0);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdpareto0.1", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+
+            auto t = profile.GetTimeSpans()[0].GetTargets()[0];
+            VERIFY_ARE_EQUAL(t.GetDistributionType(), DistributionType::Pareto);
+            VERIFY_ARE_EQUAL(t.GetDistributionSkew(), 0.1);
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdzipf1", "-r", "testfile.dat" };
+            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdpareto0.5", "-r", "testfile.dat" };
+            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdzipf0.9x", "-r", "testfile.dat" };
+            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdzipf", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+            VERIFY_IS_FALSE(profile.GetTimeSpans()[0].GetTargets()[0].GetDistributionScatter());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdzipf0.9s", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+
+            auto t = profile.GetTimeSpans()[0].GetTargets()[0];
+            VERIFY_ARE_EQUAL(t.GetDistributionType(), DistributionType::Zipf);
+            VERIFY_ARE_EQUAL(t.GetDistributionSkew(), 0.9);
+            VERIFY_IS_TRUE(t.GetDistributionScatter());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdparetos", "-r", "testfile.dat" };
+            VERIFY_IS_TRUE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+
+            auto t = profile.GetTimeSpans()[0].GetTargets()[0];
+            VERIFY_ARE_EQUAL(t.GetDistributionType(), DistributionType::Pareto);
+            VERIFY_ARE_EQUAL(t.GetDistributionSkew(), 0.2);
+            VERIFY_IS_TRUE(t.GetDistributionScatter());
+        }
+        {
+            Profile profile;
+            const char *argv[] = { "foo", "-rdzipfs0.9", "-r", "testfile.dat" };
+            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+        }
+        {
+            // sequential
+            Profile profile;
+            const char *argv[] = { "foo", "-rdzipf", "testfile.dat" };
+            VERIFY_IS_FALSE(p.ParseCmdLine(_countof(argv), argv, &profile, &s));
+        }
     }
 
     void CmdLineParserUnitTests::TestParseCmdLineResultOutput()
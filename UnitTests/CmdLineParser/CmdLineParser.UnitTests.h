@@ -58,8 +58,10 @@ namespace UnitTests
         TEST_METHOD(Test_GetSizeInBytes);
         TEST_METHOD(TestGetRandomDataWriteBufferData);
         TEST_METHOD(TestParseCmdLine);
+        TEST_METHOD(TestParseCmdLineArrivalRate);
         TEST_METHOD(TestParseCmdLineAssignAffinity);
         TEST_METHOD(TestParseCmdLineBlockSize);
+        TEST_METHOD(TestParseCmdLineBlockSizeMix);
         TEST_METHOD(TestParseCmdLineBufferedWriteThrough);
         TEST_METHOD(TestParseCmdLineBurstSizeAndThinkTime);
         TEST_METHOD(TestParseCmdLineConflictingCacheModes);
@@ -89,22 +91,31 @@ namespace UnitTests
         TEST_METHOD(TestParseCmdLineInterlockedSequential);
         TEST_METHOD(TestParseCmdLineInterlockedSequentialWithStride);
         TEST_METHOD(TestParseCmdLineIOPriority);
+        TEST_METHOD(TestParseCmdLineIoEngine);
+        TEST_METHOD(TestParseCmdLineIoTrace);
+        TEST_METHOD(TestParseCmdLineLatencySignificantDigits);
+        TEST_METHOD(TestParseCmdLineLatencySlo);
         TEST_METHOD(TestParseCmdLineMappedIO);
         TEST_METHOD(TestParseCmdLineMeasureLatency);
         TEST_METHOD(TestParseCmdLineOverlappedCountAndBaseOffset);
+        TEST_METHOD(TestParseCmdLinePhases);
         TEST_METHOD(TestParseCmdLineRandomIOAlignment);
         TEST_METHOD(TestParseCmdLineRandomSequentialMixed);
         TEST_METHOD(TestParseCmdLineRandomWriteBuffers);
         TEST_METHOD(TestParseCmdLineRandSeed);
         TEST_METHOD(TestParseCmdLineRandSeedGetTickCount);
+        TEST_METHOD(TestParseCmdLineReportInterval);
         TEST_METHOD(TestParseCmdLineResultOutput);
         TEST_METHOD(TestParseCmdLineStrideSize);
+        TEST_METHOD(TestParseCmdLineSweep);
         TEST_METHOD(TestParseCmdLineTargetDistribution);
         TEST_METHOD(TestParseCmdLineTargetPosition);
         TEST_METHOD(TestParseCmdLineThreadsPerFileAndThreadStride);
         TEST_METHOD(TestParseCmdLineThroughput);
         TEST_METHOD(TestParseCmdLineTotalThreadCountAndThroughput);
         TEST_METHOD(TestParseCmdLineTotalThreadCountAndTotalRequestCount);
+        TEST_METHOD(TestParseCmdLineTotalThroughput);
+        TEST_METHOD(TestParseCmdLineTraceReplay);
         TEST_METHOD(TestParseCmdLineUseCompletionRoutines);
         TEST_METHOD(TestParseCmdLineUseLargePages);
         TEST_METHOD(TestParseCmdLineUseParallelAsyncIO);
@@ -112,6 +123,11 @@ namespace UnitTests
         TEST_METHOD(TestParseCmdLineWarmupAndCooldown);
         TEST_METHOD(TestParseCmdLineWriteBufferContentRandomNoFilePath);
         TEST_METHOD(TestParseCmdLineWriteBufferContentRandomWithFilePath);
+        TEST_METHOD(TestParseCmdLineWriteBufferContentReducible);
+        TEST_METHOD(TestParseCmdLineWriteBufferContentVerify);
+        TEST_METHOD(TestParseCmdLineFlushAndFuaWrite);
+        TEST_METHOD(TestParseCmdLineTrim);
+        TEST_METHOD(TestParseCmdLineFileSet);
         TEST_METHOD(TestParseCmdLineZeroWriteBuffers);
     };
 }
@@ -249,6 +249,79 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(h1.GetSampleSize(), (unsigned)2);
     }
 
+    void HistogramUnitTests::Test_SignificantDigits()
+    {
+        // 3 digits: 2048 sub-buckets, values < 2048 are exact and larger ones
+        // share buckets 1/1024th of their power of two range wide
+        Histogram<unsigned> h;
+        VERIFY_ARE_EQUAL(h.GetSignificantDigits(), (unsigned)3);
+
+        h.Add(2047);
+        h.Add(2048);
+        h.Add(2049);
+        VERIFY_ARE_EQUAL(h.GetSampleBuckets(), (unsigned)2);
+        VERIFY_ARE_EQUAL(h.GetPercentile(0.3), (unsigned)2047);
+
+        // exact min/max/mean regardless of bucketing
+        h.Add(1000000);
+        h.Add(1000001);
+        VERIFY_ARE_EQUAL(h.GetSampleBuckets(), (unsigned)1);
+        VERIFY_ARE_EQUAL(h.GetMin(), (unsigned)1000000);
+        VERIFY_ARE_EQUAL(h.GetMax(), (unsigned)1000001);
+        VERIFY_ARE_EQUAL(h.GetMean(), 1000000.5);
+
+        // bucket count is bounded by the value range, not the number of distinct values
+        h.Clear();
+        for (unsigned i = 0; i < 1000000; i++)
+        {
+            h.Add(i * 7);
+        }
+        VERIFY_IS_TRUE(h.GetSampleBuckets() < 12 * 1024);
+
+        unsigned median = h.GetMedian();
+        VERIFY_IS_TRUE(median >= 3500000 * 0.999 && median <= 3500000 * 1.001);
+
+        // precision must match to merge
+        Histogram<unsigned> h1(1);
+        Histogram<unsigned> h2(2);
+        h1.Add(1);
+        h2.Add(1);
+        VERIFY_THROWS(h1.Merge(h2), std::invalid_argument);
+        VERIFY_THROWS(Histogram<unsigned>(0), std::invalid_argument);
+        VERIFY_THROWS(Histogram<unsigned>(6), std::invalid_argument);
+
+        // ... unless empty, which takes the precision merged into it
+        Histogram<unsigned> h3;
+        h3.Merge(h2);
+        VERIFY_ARE_EQUAL(h3.GetSignificantDigits(), (unsigned)2);
+        VERIFY_ARE_EQUAL(h3.GetSampleSize(), (unsigned)1);
+
+        // changing the precision discards the data
+        h3.SetSignificantDigits(5);
+        VERIFY_ARE_EQUAL(h3.GetSignificantDigits(), (unsigned)5);
+        VERIFY_ARE_EQUAL(h3.GetSampleSize(), (unsigned)0);
+        h3.Add(200001);
+        h3.Add(200002);
+        VERIFY_ARE_EQUAL(h3.GetSampleBuckets(), (unsigned)2);
+        VERIFY_THROWS(h3.SetSignificantDigits(6), std::invalid_argument);
+    }
+
+    void HistogramUnitTests::Test_FloatResolution()
+    {
+        // floating point values are bucketed in 1/1000 units (microsecond latencies -> ns)
+        Histogram<float> h;
+        h.Add(0.5f);
+        h.Add(1.25f);
+        h.Add(1.2504f);
+        h.Add(3.0f);
+        VERIFY_ARE_EQUAL(h.GetSampleBuckets(), (unsigned)3);
+        VERIFY_ARE_EQUAL(h.GetMin(), 0.5f);
+        VERIFY_ARE_EQUAL(h.GetMax(), 3.0f);
+        VERIFY_ARE_EQUAL(h.GetPercentile(0.0), 0.5f);
+        VERIFY_ARE_EQUAL(h.GetPercentile(0.5), 1.25f);
+        VERIFY_ARE_EQUAL(h.GetPercentile(1.0), 3.0f);
+    }
+
     void IoBucketizerUnitTests::Test_Empty()
     {
         IoBucketizer b;
@@ -366,6 +439,367 @@ namespace UnitTests
         VERIFY_ARE_EQUAL(b.GetStandardDeviationIOPS(), 0.5L);
     }
 
+    void RandomUnitTests::Test_RandBufferFills()
+    {
+        // every supported instruction set generates the same content as the scalar form,
+        // over buffers which start and end off cache lines, and one call after another
+        const RandFill fills[] = { RandFill::Sse2, RandFill::Avx2, RandFill::Avx512, RandFill::Neon };
+        const UINT32 lengths[] = { 1, 7, 64, 100, 128, 4096, 4096 + 3 * 64, 65536 + 13 };
+        const size_t cbMax = 65536 + 13 + 64;
+
+        vector<BYTE> vExpected(cbMax);
+        vector<BYTE> vActual(cbMax);
+
+        Random r;
+        VERIFY_IS_TRUE(Random::IsFillSupported(RandFill::Scalar));
+        VERIFY_IS_TRUE(Random::IsFillSupported(r.GetFill()));
+
+        for (auto fill : fills)
+        {
+            if (!Random::IsFillSupported(fill))
+            {
+                Random rUnsupported;
+                VERIFY_IS_FALSE(rUnsupported.SetFill(fill));
+                continue;
+            }
+            printf("%s\n", Random::FillToString(fill));
+
+            Random rScalar(1234);
+            Random rFill(1234);
+            VERIFY_IS_TRUE(rScalar.SetFill(RandFill::Scalar));
+            VERIFY_IS_TRUE(rFill.SetFill(fill));
+
+            for (size_t iOffset = 0; iOffset < 64; iOffset += 24)
+            {
+                for (auto cb : lengths)
+                {
+                    rScalar.RandBuffer(&vExpected[iOffset], cb, true);
+                    rFill.RandBuffer(&vActual[iOffset], cb, true);
+                    VERIFY_IS_TRUE(memcmp(&vExpected[iOffset], &vActual[iOffset], cb) == 0);
+                }
+            }
+        }
+
+        // the content is not trivially repetitive: no two words of a buffer are the same
+        Random rUnique(5678);
+        rUnique.RandBuffer(&vActual[0], 65536, true);
+        UINT64 *pWords = reinterpret_cast<UINT64 *>(&vActual[0]);
+        vector<UINT64> vWords(pWords, pWords + 65536 / sizeof(UINT64));
+        sort(vWords.begin(), vWords.end());
+        VERIFY_IS_TRUE(adjacent_find(vWords.begin(), vWords.end()) == vWords.end());
+    }
+
+    void ReducibleDataPoolUnitTests::Test_Fill()
+    {
+        const UINT32 cbChunk = 4096;
+        const size_t cChunks = 4096;
+        vector<BYTE> vBuffer(cChunks * cbChunk);
+
+        Random r;
+        ReducibleDataPool pool;
+        VERIFY_IS_TRUE(pool.Initialize(4, 2, cbChunk, 64 * 1024, &r));
+
+        // the pool holds at least the minimum of unique chunks, and the duplicates
+        VERIFY_ARE_EQUAL(pool.GetPoolSize(), (size_t)(ReducibleDataPool::MinUniqueChunkCount + ReducibleDataPool::DuplicateChunkCount) * cbChunk);
+
+        for (size_t i = 0; i < cChunks * cbChunk; i += 64 * 1024)
+        {
+            pool.Fill(&vBuffer[i], 64 * 1024, &r);
+        }
+
+        // compression: the last three quarters of each segment are zero and the first is not
+        for (size_t iSegment = 0; iSegment < vBuffer.size() / ReducibleDataPool::SegmentSize; iSegment++)
+        {
+            const BYTE *pSegment = &vBuffer[iSegment * ReducibleDataPool::SegmentSize];
+            size_t cZero = count(pSegment, pSegment + ReducibleDataPool::SegmentSize, (BYTE)0);
+            if (cZero < 3 * ReducibleDataPool::SegmentSize / 4 ||
+                find_if(pSegment + 3 * ReducibleDataPool::SegmentSize / 4, pSegment + ReducibleDataPool::SegmentSize, [](BYTE b) { return b != 0; }) != pSegment + ReducibleDataPool::SegmentSize)
+            {
+                VERIFY_IS_TRUE(false);
+            }
+        }
+
+        // dedup: about half of the chunks are copies of the few duplicates; the rest are all different
+        map<string, size_t> mChunks;
+        for (size_t iChunk = 0; iChunk < cChunks; iChunk++)
+        {
+            mChunks[string((const char *)&vBuffer[iChunk * cbChunk], cbChunk)]++;
+        }
+        size_t cUnique = 0;
+        for (const auto& chunk : mChunks)
+        {
+            if (chunk.second == 1)
+            {
+                cUnique++;
+            }
+            else
+            {
+                VERIFY_IS_TRUE(chunk.second > 16);
+            }
+        }
+        VERIFY_IS_TRUE(mChunks.size() - cUnique <= ReducibleDataPool::DuplicateChunkCount);
+        VERIFY_IS_TRUE(cUnique > cChunks * 45 / 100 && cUnique < cChunks * 55 / 100);
+
+        // partial chunks at the end of a buffer
+        pool.Fill(&vBuffer[0], 4096 + 700, &r);
+    }
+
+    void DataVerifierUnitTests::Test_Crc32c()
+    {
+        // check value of the CRC-32C catalogue
+        VERIFY_ARE_EQUAL(Crc32c::Compute("123456789", 9), (UINT32)0xe3069283);
+        VERIFY_ARE_EQUAL(Crc32c::ComputeSoftware("123456789", 9), (UINT32)0xe3069283);
+        VERIFY_ARE_EQUAL(Crc32c::Compute("", 0), (UINT32)0);
+
+        vector<BYTE> vData(16 * 1024 + 64);
+        Random r;
+        r.RandBuffer(&vData[0], (UINT32)vData.size(), true);
+
+        // the table and instruction paths agree at all alignments and on each side of the stripe size
+        for (size_t iStart = 0; iStart < 16; iStart++)
+        {
+            for (size_t cb = 0; cb < 4 * 1024; cb += (cb < 1024 ? 1 : 37))
+            {
+                VERIFY_ARE_EQUAL(Crc32c::Compute(&vData[iStart], cb), Crc32c::ComputeSoftware(&vData[iStart], cb));
+            }
+        }
+        VERIFY_ARE_EQUAL(Crc32c::Compute(&vData[3], 16 * 1024), Crc32c::ComputeSoftware(&vData[3], 16 * 1024));
+
+        // chaining
+        UINT32 ulCrc = Crc32c::Compute(&vData[0], 1000);
+        VERIFY_ARE_EQUAL(Crc32c::Compute(&vData[1000], 5000, ulCrc), Crc32c::Compute(&vData[0], 6000));
+    }
+
+    void DataVerifierUnitTests::Test_Verify()
+    {
+        const UINT32 cbUnit = 4096;
+        vector<BYTE> vDevice(64 * 1024);
+        vector<BYTE> vBuffer(2 * cbUnit);
+        vector<BYTE> vRead(2 * cbUnit);
+        UINT64 pullSnapshot[2];
+        UINT64 cChecked = 0;
+        Random r;
+
+        DataVerifier verifier("testfile.dat", 1, cbUnit, 0x1234);
+        VERIFY_IS_TRUE(verifier.Attach(vDevice.size()));
+
+        // nothing has been written: nothing is checked
+        verifier.BeginRead(0, 2 * cbUnit, pullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vDevice[0], 0, 2 * cbUnit, pullSnapshot, &cChecked), (UINT32)0);
+        VERIFY_ARE_EQUAL(cChecked, (UINT64)0);
+
+        // a write stamps each of its units
+        r.RandBuffer(&vBuffer[0], (UINT32)vBuffer.size(), true);
+        verifier.BeginWrite(&vBuffer[0], cbUnit, 2 * cbUnit);
+        const VerifyHeader *pHeader = reinterpret_cast<const VerifyHeader *>(&vBuffer[cbUnit]);
+        VERIFY_ARE_EQUAL(pHeader->ulMagic, DataVerifier::Magic);
+        VERIFY_ARE_EQUAL(pHeader->ullOffset, (UINT64)2 * cbUnit);
+        VERIFY_ARE_EQUAL(pHeader->ulTarget, (UINT32)1);
+        VERIFY_ARE_EQUAL(pHeader->ulGeneration, (UINT32)0);
+        VERIFY_ARE_EQUAL(pHeader->ulSeed, (UINT32)0x1234);
+        VERIFY_ARE_EQUAL(pHeader->ulChecksum, Crc32c::Compute(&vBuffer[cbUnit + 4], cbUnit - 4));
+
+        // a read issued while it is in flight is not checked
+        verifier.BeginRead(cbUnit, 2 * cbUnit, pullSnapshot);
+        memcpy(&vDevice[cbUnit], &vBuffer[0], vBuffer.size());
+        verifier.EndWrite(cbUnit, 2 * cbUnit);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vDevice[cbUnit], cbUnit, 2 * cbUnit, pullSnapshot, &cChecked), (UINT32)0);
+        VERIFY_ARE_EQUAL(cChecked, (UINT64)0);
+
+        // once it has completed it is
+        verifier.BeginRead(cbUnit, 2 * cbUnit, pullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vDevice[cbUnit], cbUnit, 2 * cbUnit, pullSnapshot, &cChecked), (UINT32)0);
+        VERIFY_ARE_EQUAL(cChecked, (UINT64)2);
+
+        // corrupt data
+        vRead.assign(vDevice.begin() + cbUnit, vDevice.begin() + 3 * cbUnit);
+        vRead[cbUnit + 100] ^= 1;
+        verifier.BeginRead(cbUnit, 2 * cbUnit, pullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vRead[0], cbUnit, 2 * cbUnit, pullSnapshot, &cChecked), (UINT32)1);
+        VERIFY_ARE_EQUAL(cChecked, (UINT64)4);
+
+        // misdirected write: the second unit's data read back in place of the first
+        memcpy(&vRead[0], &vDevice[2 * cbUnit], cbUnit);
+        memcpy(&vRead[cbUnit], &vDevice[2 * cbUnit], cbUnit);
+        verifier.BeginRead(cbUnit, 2 * cbUnit, pullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vRead[0], cbUnit, 2 * cbUnit, pullSnapshot, &cChecked), (UINT32)1);
+
+        // lost write: the device keeps the first generation of the first unit
+        vRead.assign(vDevice.begin() + cbUnit, vDevice.begin() + 2 * cbUnit);
+        verifier.BeginWrite(&vBuffer[0], cbUnit, cbUnit);
+        verifier.EndWrite(cbUnit, cbUnit);
+        verifier.BeginRead(cbUnit, cbUnit, pullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vRead[0], cbUnit, cbUnit, pullSnapshot, &cChecked), (UINT32)1);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vBuffer[0], cbUnit, cbUnit, pullSnapshot, &cChecked), (UINT32)0);
+
+        // a unit never written by the run
+        memset(&vRead[0], 0, cbUnit);
+        verifier.BeginRead(cbUnit, cbUnit, pullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vRead[0], cbUnit, cbUnit, pullSnapshot, &cChecked), (UINT32)1);
+
+        // a read with a write issued to its units while it was in flight is not checked
+        cChecked = 0;
+        verifier.BeginRead(cbUnit, cbUnit, pullSnapshot);
+        verifier.BeginWrite(&vBuffer[0], cbUnit, cbUnit);
+        verifier.EndWrite(cbUnit, cbUnit);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vRead[0], cbUnit, cbUnit, pullSnapshot, &cChecked), (UINT32)0);
+        VERIFY_ARE_EQUAL(cChecked, (UINT64)0);
+
+        // a different run is not this one
+        DataVerifier other("testfile.dat", 1, cbUnit, 0x5678);
+        VERIFY_IS_TRUE(other.Attach(vDevice.size()));
+        other.BeginWrite(&vRead[0], cbUnit, cbUnit);
+        other.EndWrite(cbUnit, cbUnit);
+        other.BeginRead(cbUnit, cbUnit, pullSnapshot);
+        VERIFY_ARE_EQUAL(other.EndRead(&vBuffer[0], cbUnit, cbUnit, pullSnapshot, &cChecked), (UINT32)1);
+        VERIFY_ARE_EQUAL(other.EndRead(&vRead[0], cbUnit, cbUnit, pullSnapshot, &cChecked), (UINT32)0);
+    }
+
+    void DataVerifierUnitTests::Test_VerifyOverlapped()
+    {
+        const UINT32 cbUnit = 512;
+        vector<BYTE> vA(cbUnit), vB(cbUnit), vC(cbUnit);
+        UINT64 ullSnapshot;
+        UINT64 cChecked = 0;
+
+        DataVerifier verifier("testfile.dat", 0, cbUnit, 1);
+        VERIFY_IS_TRUE(verifier.Attach(64 * 1024));
+
+        // writes in flight together may complete in either order, so either generation is good
+        verifier.BeginWrite(&vA[0], 0, cbUnit);
+        verifier.BeginWrite(&vB[0], 0, cbUnit);
+        verifier.EndWrite(0, cbUnit);
+        verifier.EndWrite(0, cbUnit);
+        verifier.BeginRead(0, cbUnit, &ullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vA[0], 0, cbUnit, &ullSnapshot, &cChecked), (UINT32)0);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vB[0], 0, cbUnit, &ullSnapshot, &cChecked), (UINT32)0);
+        VERIFY_ARE_EQUAL(cChecked, (UINT64)2);
+
+        // a write issued after they completed replaces both
+        verifier.BeginWrite(&vC[0], 0, cbUnit);
+        verifier.EndWrite(0, cbUnit);
+        verifier.BeginRead(0, cbUnit, &ullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vA[0], 0, cbUnit, &ullSnapshot, &cChecked), (UINT32)1);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vB[0], 0, cbUnit, &ullSnapshot, &cChecked), (UINT32)1);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vC[0], 0, cbUnit, &ullSnapshot, &cChecked), (UINT32)0);
+
+        // generations wrap
+        for (UINT32 i = 0; i < 70000; i++)
+        {
+            verifier.BeginWrite(&vA[0], 0, cbUnit);
+            verifier.EndWrite(0, cbUnit);
+        }
+        verifier.BeginRead(0, cbUnit, &ullSnapshot);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vA[0], 0, cbUnit, &ullSnapshot, &cChecked), (UINT32)0);
+        VERIFY_ARE_EQUAL(verifier.EndRead(&vC[0], 0, cbUnit, &ullSnapshot, &cChecked), (UINT32)1);
+    }
+
+    void LoadPhaseUnitTests::Test_GetLevel()
+    {
+        LoadPhase phase;
+        phase.SetDurationInMilliseconds(1000);
+        VERIFY_ARE_EQUAL(phase.GetLevel(0), 0.0);
+        VERIFY_ARE_EQUAL(phase.GetLevel(999), 0.0);
+
+        phase.SetShape(PhaseShape::Ramp);
+        VERIFY_ARE_EQUAL(phase.GetLevel(0), 0.0);
+        VERIFY_ARE_EQUAL(phase.GetLevel(250), 0.25);
+        VERIFY_ARE_EQUAL(phase.GetLevel(1000), 1.0);
+
+        // sine: up to the to value at half a period and back down by its end
+        phase.SetShape(PhaseShape::Sine);
+        phase.SetPeriodInMilliseconds(200);
+        VERIFY_IS_TRUE(phase.GetLevel(0) < 0.000001);
+        VERIFY_IS_TRUE(phase.GetLevel(100) > 0.999999);
+        VERIFY_IS_TRUE(phase.GetLevel(50) > 0.499999 && phase.GetLevel(50) < 0.500001);
+        VERIFY_IS_TRUE(phase.GetLevel(300) > 0.999999);
+
+        // square: the to value for the last quarter of each period
+        phase.SetShape(PhaseShape::Square);
+        phase.SetDutyPercent(25);
+        VERIFY_ARE_EQUAL(phase.GetLevel(0), 0.0);
+        VERIFY_ARE_EQUAL(phase.GetLevel(149), 0.0);
+        VERIFY_ARE_EQUAL(phase.GetLevel(150), 1.0);
+        VERIFY_ARE_EQUAL(phase.GetLevel(199), 1.0);
+        VERIFY_ARE_EQUAL(phase.GetLevel(200), 0.0);
+
+        phase.SetIOPS(1000, 3000);
+        VERIFY_ARE_EQUAL(phase.GetValue(phase.GetIOPS(), 10), 1000.0);
+        VERIFY_ARE_EQUAL(phase.GetValue(phase.GetIOPS(), 160), 3000.0);
+
+        // settings may fall as well as rise
+        phase.SetShape(PhaseShape::Ramp);
+        phase.SetWriteRatio(100, 0);
+        VERIFY_ARE_EQUAL(phase.GetValue(phase.GetWriteRatio(), 250), 75.0);
+    }
+
+    void LoadPhaseUnitTests::Test_GetPhase()
+    {
+        vector<LoadPhase> vPhases(3);
+        vPhases[0].SetDurationInMilliseconds(1000);
+        vPhases[1].SetDurationInMilliseconds(500);
+        vPhases[2].SetDurationInMilliseconds(2000);
+        PhaseSchedule schedule(vPhases);
+        VERIFY_ARE_EQUAL(schedule.GetPhaseCount(), (size_t)3);
+
+        double lfPhaseMilliseconds;
+        VERIFY_ARE_EQUAL(schedule.GetPhase(0, &lfPhaseMilliseconds), (size_t)0);
+        VERIFY_ARE_EQUAL(lfPhaseMilliseconds, 0.0);
+        VERIFY_ARE_EQUAL(schedule.GetPhase(1200, &lfPhaseMilliseconds), (size_t)1);
+        VERIFY_ARE_EQUAL(lfPhaseMilliseconds, 200.0);
+        VERIFY_ARE_EQUAL(schedule.GetPhase(1500, &lfPhaseMilliseconds), (size_t)2);
+        VERIFY_ARE_EQUAL(lfPhaseMilliseconds, 0.0);
+
+        // the schedule repeats
+        VERIFY_ARE_EQUAL(schedule.GetPhase(3600, &lfPhaseMilliseconds), (size_t)0);
+        VERIFY_ARE_EQUAL(lfPhaseMilliseconds, 100.0);
+        VERIFY_ARE_EQUAL(schedule.GetPhase(9000), (size_t)2);
+
+        // one and a half passes: the first two phases twice, half of the third once
+        vector<double> vlfMilliseconds = schedule.GetPhaseMilliseconds(5250);
+        VERIFY_ARE_EQUAL(vlfMilliseconds.size(), (size_t)3);
+        VERIFY_ARE_EQUAL(vlfMilliseconds[0], 2000.0);
+        VERIFY_ARE_EQUAL(vlfMilliseconds[1], 1000.0);
+        VERIFY_ARE_EQUAL(vlfMilliseconds[2], 2250.0);
+
+        vlfMilliseconds = schedule.GetPhaseMilliseconds(700);
+        VERIFY_ARE_EQUAL(vlfMilliseconds[0], 700.0);
+        VERIFY_ARE_EQUAL(vlfMilliseconds[1], 0.0);
+        VERIFY_ARE_EQUAL(vlfMilliseconds[2], 0.0);
+    }
+
+    void LoadPhaseUnitTests::Test_GetState()
+    {
+        vector<LoadPhase> vPhases(2);
+        vPhases[0].SetDurationInMilliseconds(1000);
+        vPhases[0].SetShape(PhaseShape::Ramp);
+        vPhases[0].SetIOPS(0, 1000);
+        vPhases[0].SetQueueDepth(0, 8);
+        vPhases[1].SetDurationInMilliseconds(1000);
+        vPhases[1].SetWriteRatio(30, 30);
+        PhaseSchedule schedule(vPhases);
+
+        // a rate or queue depth of zero still issues IOs
+        PhaseState state;
+        schedule.GetState(0, &state);
+        VERIFY_ARE_EQUAL(state.iPhase, (size_t)0);
+        VERIFY_ARE_EQUAL(state.lfIOPS, 1.0);
+        VERIFY_ARE_EQUAL(state.ulQueueDepth, (UINT32)1);
+        VERIFY_IS_FALSE(state.fWriteRatio);
+
+        schedule.GetState(500, &state);
+        VERIFY_ARE_EQUAL(state.lfIOPS, 500.0);
+        VERIFY_ARE_EQUAL(state.ulQueueDepth, (UINT32)4);
+
+        // settings the phase does not state are not limited
+        schedule.GetState(1500, &state);
+        VERIFY_ARE_EQUAL(state.iPhase, (size_t)1);
+        VERIFY_ARE_EQUAL(state.lfIOPS, 0.0);
+        VERIFY_ARE_EQUAL(state.ulQueueDepth, (UINT32)0);
+        VERIFY_IS_TRUE(state.fWriteRatio);
+        VERIFY_ARE_EQUAL(state.ulWriteRatio, (UINT32)30);
+    }
+
     void ProfileUnitTests::Test_GetXmlEmptyProfile()
     {
         Profile profile;
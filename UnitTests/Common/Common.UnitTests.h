@@ -61,6 +61,8 @@ namespace UnitTests
         TEST_METHOD(Test_GetPercentile);
         TEST_METHOD(Test_GetMean);
         TEST_METHOD(Test_Merge);
+        TEST_METHOD(Test_SignificantDigits);
+        TEST_METHOD(Test_FloatResolution);
     };
 
     class IoBucketizerUnitTests :  public WEX::TestClass<IoBucketizerUnitTests>
@@ -73,6 +75,38 @@ namespace UnitTests
         TEST_METHOD(Test_GetStandardDeviation);
     };
 
+    class RandomUnitTests : public WEX::TestClass<RandomUnitTests>
+    {
+    public:
+        TEST_CLASS(RandomUnitTests);
+        TEST_METHOD(Test_RandBufferFills);
+    };
+
+    class ReducibleDataPoolUnitTests : public WEX::TestClass<ReducibleDataPoolUnitTests>
+    {
+    public:
+        TEST_CLASS(ReducibleDataPoolUnitTests);
+        TEST_METHOD(Test_Fill);
+    };
+
+    class DataVerifierUnitTests : public WEX::TestClass<DataVerifierUnitTests>
+    {
+    public:
+        TEST_CLASS(DataVerifierUnitTests);
+        TEST_METHOD(Test_Crc32c);
+        TEST_METHOD(Test_Verify);
+        TEST_METHOD(Test_VerifyOverlapped);
+    };
+
+    class LoadPhaseUnitTests : public WEX::TestClass<LoadPhaseUnitTests>
+    {
+    public:
+        TEST_CLASS(LoadPhaseUnitTests);
+        TEST_METHOD(Test_GetLevel);
+        TEST_METHOD(Test_GetPhase);
+        TEST_METHOD(Test_GetState);
+    };
+
     class ProfileUnitTests : public WEX::TestClass<ProfileUnitTests>
     {
     public:
@@ -31,7 +31,11 @@ SOFTWARE.
 #include "IORequestGenerator.UnitTests.h"
 #include "Common.h"
 #include "IORequestGenerator.h"
+#include "IntervalReporter.h"
+#include "LatencySloSearch.h"
 #include <stdlib.h>
+#include <algorithm>
+#include <functional>
 
 using namespace WEX::TestExecution;
 using namespace WEX::Logging;
@@ -1324,4 +1328,814 @@ namespace UnitTests
             v.clear();
         }
     }
-}
\ No newline at end of file
+
+    void IORequestGeneratorUnitTests::Test_ThreadTargetStateSkewedDist()
+    {
+        // this ut validates the offsets drawn from the skewed distributions:
+        // they are aligned, within the target, and hit the hottest offsets
+        // with the expected frequency.
+
+        Target target;
+        target.SetBlockAlignmentInBytes(4*KB);
+        target.SetBlockSizeInBytes(4*KB);
+        target.SetRandomRatio(100);
+
+        Random r;
+        ThreadParameters tp;
+        tp.pRand = &r;
+
+        const UINT64 cOffsets = 100000;
+        const UINT32 cDraws = 1000000;
+
+        // -rdpareto0.2: 80% of IO to the first 20% of the target
+        target.SetDistributionSkew(DistributionType::Pareto, 0.2);
+        tp.vTargets.push_back(target);
+
+        {
+            ThreadTargetState tts(&tp, 0, cOffsets * 4*KB);
+            VERIFY_ARE_EQUAL(tts._cSkewOffsets, cOffsets);
+
+            UINT32 cHot = 0;
+            for (UINT32 i = 0; i < cDraws; i++)
+            {
+                UINT64 offset = tts.NextRelativeRandomOffset();
+                VERIFY_ARE_EQUAL(offset % (4*KB), (UINT64) 0);
+                VERIFY_IS_TRUE(offset < cOffsets * 4*KB);
+                cHot += (offset < (cOffsets / 5) * 4*KB) ? 1 : 0;
+            }
+            VERIFY_IS_TRUE(cHot > cDraws * 0.79 && cHot < cDraws * 0.81);
+            tp.vTargets.clear();
+        }
+
+        // -rdzipf0.99: the hottest offset draws 1/zeta(n, theta) of IO, the next 2^-theta of that
+        target.SetDistributionSkew(DistributionType::Zipf, 0.99);
+        tp.vTargets.push_back(target);
+
+        {
+            ThreadTargetState tts(&tp, 0, cOffsets * 4*KB);
+            double p0 = 1 / Util::Zeta(cOffsets, 0.99);
+
+            UINT32 c0 = 0, c1 = 0;
+            for (UINT32 i = 0; i < cDraws; i++)
+            {
+                UINT64 offset = tts.NextRelativeRandomOffset();
+                VERIFY_IS_TRUE(offset < cOffsets * 4*KB);
+                c0 += (offset == 0) ? 1 : 0;
+                c1 += (offset == 4*KB) ? 1 : 0;
+            }
+            VERIFY_IS_TRUE(fabs(c0 - cDraws * p0) < cDraws * p0 * 0.02);
+            VERIFY_IS_TRUE(fabs(c1 - cDraws * p0 * pow(2, -0.99)) < cDraws * p0 * 0.02);
+            tp.vTargets.clear();
+        }
+
+        // -rdpareto0.2s: the same skew, with the hot set scattered across the target
+        target.SetDistributionSkew(DistributionType::Pareto, 0.2, true);
+        tp.vTargets.push_back(target);
+
+        {
+            ThreadTargetState tts(&tp, 0, cOffsets * 4*KB);
+
+            vector<UINT32> vCount(cOffsets, 0);
+            for (UINT32 i = 0; i < cDraws; i++)
+            {
+                UINT64 offset = tts.NextRelativeRandomOffset();
+                VERIFY_ARE_EQUAL(offset % (4*KB), (UINT64) 0);
+                VERIFY_IS_TRUE(offset < cOffsets * 4*KB);
+                vCount[offset / (4*KB)]++;
+            }
+
+            // the hottest offset is that of the first rank, not the base of the target
+            RankPermutation permutation;
+            permutation.Initialize(cOffsets);
+            UINT64 iHottest = max_element(vCount.begin(), vCount.end()) - vCount.begin();
+            VERIFY_ARE_EQUAL(iHottest, permutation.Permute(0));
+            VERIFY_ARE_NOT_EQUAL(iHottest, (UINT64) 0);
+
+            // the hottest 20% of ranks land about evenly across the target
+            UINT32 cFirst = 0;
+            for (UINT64 i = 0; i < cOffsets / 5; i++)
+            {
+                cFirst += (permutation.Permute(i) < cOffsets / 5) ? 1 : 0;
+            }
+            VERIFY_IS_TRUE(cFirst > cOffsets / 25 * 0.9 && cFirst < cOffsets / 25 * 1.1);
+
+            // while the hottest 20% of offsets still draw 80% of IO
+            sort(vCount.begin(), vCount.end(), greater<UINT32>());
+            UINT32 cHot = 0;
+            for (UINT64 i = 0; i < cOffsets / 5; i++)
+            {
+                cHot += vCount[i];
+            }
+            VERIFY_IS_TRUE(cHot > cDraws * 0.79);
+            tp.vTargets.clear();
+        }
+
+        // the scatter is a permutation of the offsets
+        for (UINT64 cItems : { 1ULL, 2ULL, 3ULL, 1000ULL, 4096ULL, 4097ULL })
+        {
+            RankPermutation permutation;
+            permutation.Initialize(cItems);
+
+            vector<bool> vSeen((size_t) cItems, false);
+            for (UINT64 i = 0; i < cItems; i++)
+            {
+                UINT64 j = permutation.Permute(i);
+                VERIFY_IS_TRUE(j < cItems);
+                VERIFY_IS_FALSE(vSeen[(size_t) j]);
+                vSeen[(size_t) j] = true;
+            }
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_ThreadTargetStateBlockSizeMix()
+    {
+        // this ut validates that IO sizes are drawn in proportion to the weights
+        // of the block size mix, and that sequential IO of mixed sizes is contiguous
+        // and does not run past the end of the target.
+
+        Target target;
+        target.SetBlockSizeMix({ { 4*KB, 3 }, { 64*KB, 1 } });
+
+        Random r;
+        ThreadParameters tp;
+        tp.pRand = &r;
+        tp.vTargets.push_back(target);
+
+        TimeSpan timespan;
+        tp.pTimeSpan = &timespan;
+
+        const UINT64 cbTarget = 1024*KB;
+        const UINT32 cDraws = 100000;
+
+        ThreadTargetState tts(&tp, 0, cbTarget);
+        IORequest ior(tp.pRand);
+
+        UINT64 expectOffset = 0;
+        UINT32 cSmall = 0;
+        for (UINT32 i = 0; i < cDraws; i++)
+        {
+            ULARGE_INTEGER nextOffset;
+
+            tts.NextIORequest(ior);
+            nextOffset.LowPart = ior.GetOverlapped()->Offset;
+            nextOffset.HighPart = ior.GetOverlapped()->OffsetHigh;
+
+            VERIFY_IS_TRUE(ior.GetBlockSize() == 4*KB || ior.GetBlockSize() == 64*KB);
+            VERIFY_ARE_EQUAL(ior.GetBlockSize(), target.GetBlockSizeMix()[ior.GetBlockSizeIndex()].dwBlockSize);
+            VERIFY_IS_TRUE(nextOffset.QuadPart == expectOffset || nextOffset.QuadPart == 0);
+            VERIFY_IS_TRUE(nextOffset.QuadPart + ior.GetBlockSize() <= cbTarget);
+
+            expectOffset = nextOffset.QuadPart + ior.GetBlockSize();
+            cSmall += (ior.GetBlockSize() == 4*KB) ? 1 : 0;
+        }
+        VERIFY_IS_TRUE(cSmall > cDraws * 0.74 && cSmall < cDraws * 0.76);
+    }
+
+    void IORequestGeneratorUnitTests::Test_ThreadTargetStateFlushAndTrim()
+    {
+        // this ut validates that flushes and trims are drawn in proportion to their ratios,
+        // that flushes neither take a size nor move the sequential offset, and that trims of
+        // their own size advance the sequential stream by the stride like any other IO without
+        // running past the end of the target.
+
+        Target target;
+        target.SetBlockSizeInBytes(4*KB);
+        target.SetWriteRatio(50);
+        target.SetFlushRatio(10);
+        target.SetTrimRatio(20);
+        target.SetTrimSize(16*KB);
+
+        Random r;
+        ThreadParameters tp;
+        tp.pRand = &r;
+        tp.vTargets.push_back(target);
+
+        TimeSpan timespan;
+        tp.pTimeSpan = &timespan;
+
+        const UINT64 cbTarget = 1024*KB;
+        const UINT32 cDraws = 100000;
+
+        ThreadTargetState tts(&tp, 0, cbTarget);
+        IORequest ior(tp.pRand);
+
+        UINT64 expectOffset = 0;
+        UINT32 cFlush = 0;
+        UINT32 cTrim = 0;
+        for (UINT32 i = 0; i < cDraws; i++)
+        {
+            ULARGE_INTEGER nextOffset;
+
+            tts.NextIORequest(ior);
+
+            if (ior.GetIoType() == IOOperation::FlushIO)
+            {
+                VERIFY_ARE_EQUAL(ior.GetBlockSize(), (DWORD)0);
+                cFlush++;
+                continue;
+            }
+
+            nextOffset.LowPart = ior.GetOverlapped()->Offset;
+            nextOffset.HighPart = ior.GetOverlapped()->OffsetHigh;
+
+            if (ior.GetIoType() == IOOperation::TrimIO)
+            {
+                VERIFY_ARE_EQUAL(ior.GetBlockSize(), (DWORD)16*KB);
+                cTrim++;
+            }
+            else
+            {
+                VERIFY_ARE_EQUAL(ior.GetBlockSize(), (DWORD)4*KB);
+            }
+            VERIFY_IS_FALSE(ior.GetFua());
+            VERIFY_IS_TRUE(nextOffset.QuadPart == expectOffset || nextOffset.QuadPart == 0);
+            VERIFY_IS_TRUE(nextOffset.QuadPart + ior.GetBlockSize() <= cbTarget);
+
+            expectOffset = nextOffset.QuadPart + 4*KB;
+        }
+        VERIFY_IS_TRUE(cFlush > cDraws * 0.09 && cFlush < cDraws * 0.11);
+        VERIFY_IS_TRUE(cTrim > cDraws * 0.19 && cTrim < cDraws * 0.21);
+    }
+
+    void IORequestGeneratorUnitTests::Test_ThreadTargetStateFileSet()
+    {
+        // this ut validates that the IOs of a file set are spread over its files uniformly, or
+        // ranked by a Zipf skew with the first file the hottest, and that metadata operations are
+        // drawn in proportion to their ratio, only of the kinds asked for and without a size.
+
+        const DWORD cFiles = 100;
+        const UINT32 cDraws = 100000;
+
+        for (double lfSkew : { 0.0, 0.9 })
+        {
+            Target target;
+            target.SetBlockSizeInBytes(4*KB);
+            target.SetRandomRatio(100);
+            target.SetFileSetCount(cFiles);
+            target.SetFileSetSkew(lfSkew);
+            target.SetMetadataRatio(20);
+            target.SetMetadataOps(MetadataOpMask(MetadataOp::Stat) | MetadataOpMask(MetadataOp::Rename));
+
+            Random r;
+            ThreadParameters tp;
+            tp.pRand = &r;
+            tp.vTargets.push_back(target);
+
+            TimeSpan timespan;
+            tp.pTimeSpan = &timespan;
+
+            ThreadTargetState tts(&tp, 0, 1024*KB);
+            IORequest ior(tp.pRand);
+
+            vector<UINT32> vcFile(cFiles);
+            UINT32 cMetadata = 0;
+            UINT32 cStat = 0;
+            for (UINT32 i = 0; i < cDraws; i++)
+            {
+                tts.NextIORequest(ior);
+
+                VERIFY_IS_TRUE(ior.GetFileIndex() < cFiles);
+                vcFile[ior.GetFileIndex()]++;
+
+                if (ior.GetIoType() == IOOperation::MetadataIO)
+                {
+                    VERIFY_ARE_EQUAL(ior.GetBlockSize(), (DWORD)0);
+                    VERIFY_IS_TRUE(ior.GetMetadataOp() == MetadataOp::Stat || ior.GetMetadataOp() == MetadataOp::Rename);
+                    cMetadata++;
+                    cStat += (ior.GetMetadataOp() == MetadataOp::Stat) ? 1 : 0;
+                }
+                else
+                {
+                    VERIFY_ARE_EQUAL(ior.GetBlockSize(), (DWORD)4*KB);
+                }
+            }
+            VERIFY_IS_TRUE(cMetadata > cDraws * 0.19 && cMetadata < cDraws * 0.21);
+            VERIFY_IS_TRUE(cStat > cMetadata * 0.45 && cStat < cMetadata * 0.55);
+
+            if (lfSkew == 0)
+            {
+                for (auto c : vcFile)
+                {
+                    VERIFY_IS_TRUE(c > cDraws / cFiles * 0.8 && c < cDraws / cFiles * 1.2);
+                }
+            }
+            else
+            {
+                // the hottest file draws 1/zeta(files, theta) of the IO
+                double lfExpect = cDraws / Util::Zeta(cFiles, lfSkew);
+                VERIFY_IS_TRUE(vcFile[0] > lfExpect * 0.9 && vcFile[0] < lfExpect * 1.1);
+                VERIFY_IS_TRUE(vcFile[0] > vcFile[1]);
+                VERIFY_IS_TRUE(vcFile[1] > vcFile[10]);
+                VERIFY_IS_TRUE(vcFile[10] > vcFile[cFiles - 1]);
+            }
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_TraceReaderParseLine()
+    {
+        // this ut validates format detection and record parsing for each of the
+        // supported trace formats, including the lines each format skips.
+
+        TraceRecord record;
+        bool fRecord;
+
+        // CSV: timestamp (us), op, offset, length
+
+        VERIFY_ARE_EQUAL(TraceReader::DetectFormat("timestamp,op,offset,length"), TraceFormat::Csv);
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Csv, 'Q', "timestamp,op,offset,length", record, fRecord));
+        VERIFY_IS_FALSE(fRecord);
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Csv, 'Q', "# comment", record, fRecord));
+        VERIFY_IS_FALSE(fRecord);
+
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Csv, 'Q', "1500.5,W,8192,4096", record, fRecord));
+        VERIFY_IS_TRUE(fRecord);
+        VERIFY_ARE_EQUAL(record.ullTime, (UINT64)1500500);
+        VERIFY_IS_TRUE(record.fWrite);
+        VERIFY_ARE_EQUAL(record.ullOffset, (UINT64)8192);
+        VERIFY_ARE_EQUAL(record.dwLength, (DWORD)4096);
+
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Csv, 'Q', "2000, r, 0, 512", record, fRecord));
+        VERIFY_IS_TRUE(fRecord);
+        VERIFY_IS_FALSE(record.fWrite);
+
+        VERIFY_IS_FALSE(TraceReader::ParseLine(TraceFormat::Csv, 'Q', "2000,T,0,512", record, fRecord));
+        VERIFY_IS_FALSE(TraceReader::ParseLine(TraceFormat::Csv, 'Q', "2000,R,0,0", record, fRecord));
+        VERIFY_IS_FALSE(TraceReader::ParseLine(TraceFormat::Csv, 'Q', "2000,R,0", record, fRecord));
+
+        // fio iolog: version 2 is untimed, version 3 is in milliseconds; file actions are skipped
+
+        VERIFY_ARE_EQUAL(TraceReader::DetectFormat("fio version 3 iolog"), TraceFormat::FioIolog);
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::FioIolog, 'Q', "/dev/sdb open", record, fRecord));
+        VERIFY_IS_FALSE(fRecord);
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::FioIolog, 'Q', "12 /dev/sdb sync 0 0", record, fRecord));
+        VERIFY_IS_FALSE(fRecord);
+
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::FioIolog, 'Q', "/dev/sdb write 65536 8192", record, fRecord));
+        VERIFY_IS_TRUE(fRecord);
+        VERIFY_ARE_EQUAL(record.ullTime, (UINT64)0);
+        VERIFY_IS_TRUE(record.fWrite);
+        VERIFY_ARE_EQUAL(record.ullOffset, (UINT64)65536);
+        VERIFY_ARE_EQUAL(record.dwLength, (DWORD)8192);
+
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::FioIolog, 'Q', "12 /dev/sdb read 4096 4096", record, fRecord));
+        VERIFY_IS_TRUE(fRecord);
+        VERIFY_ARE_EQUAL(record.ullTime, (UINT64)12 * 1000 * 1000);
+        VERIFY_IS_FALSE(record.fWrite);
+
+        // blkparse: only events of the replayed action which are reads or writes; offsets in sectors
+
+        const char *pszQueue = "  8,16   1        3     0.000250000  1234  Q  WS 2048 + 16 [fio]";
+        const char *pszIssue = "  8,16   1        4     0.000260000  1234  D  WS 2048 + 16 [fio]";
+        const char *pszDiscard = "  8,16   1        5     0.000270000  1234  Q  DS 4096 + 16 [fio]";
+
+        VERIFY_ARE_EQUAL(TraceReader::DetectFormat(pszQueue), TraceFormat::Blkparse);
+
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Blkparse, 'Q', pszQueue, record, fRecord));
+        VERIFY_IS_TRUE(fRecord);
+        VERIFY_ARE_EQUAL(record.ullTime, (UINT64)250000);
+        VERIFY_IS_TRUE(record.fWrite);
+        VERIFY_ARE_EQUAL(record.ullOffset, (UINT64)2048 * 512);
+        VERIFY_ARE_EQUAL(record.dwLength, (DWORD)16 * 512);
+
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Blkparse, 'Q', pszIssue, record, fRecord));
+        VERIFY_IS_FALSE(fRecord);
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Blkparse, 'D', pszIssue, record, fRecord));
+        VERIFY_IS_TRUE(fRecord);
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Blkparse, 'Q', pszDiscard, record, fRecord));
+        VERIFY_IS_FALSE(fRecord);
+        VERIFY_IS_TRUE(TraceReader::ParseLine(TraceFormat::Blkparse, 'Q', "CPU1 (8,16):", record, fRecord));
+        VERIFY_IS_FALSE(fRecord);
+    }
+
+    void IORequestGeneratorUnitTests::Test_IoTraceRing()
+    {
+        // this ut validates that the IO trace ring drops records rather than overwriting
+        // undrained ones when full, and that draining writes the records in push order
+        // across the wrap of the ring.
+
+        const size_t cRing = 4;
+        IoTraceRing ring(cRing);
+        IoTraceRecord record = {};
+
+        FILE *pFile = tmpfile();
+        VERIFY_IS_TRUE(pFile != nullptr);
+
+        UINT64 cRecords = 0;
+        UINT64 ullNext = 0;
+
+        // move the head part way round the ring
+        for (size_t i = 0; i < cRing - 1; i++)
+        {
+            record.ullOffset = ullNext++;
+            VERIFY_IS_TRUE(ring.Push(record));
+        }
+        VERIFY_IS_TRUE(ring.Drain(pFile, cRecords));
+        VERIFY_ARE_EQUAL(cRecords, (UINT64)(cRing - 1));
+
+        // fill the ring across its wrap, and then some
+        for (size_t i = 0; i < cRing + 2; i++)
+        {
+            record.ullOffset = ullNext;
+            if (ring.Push(record))
+            {
+                ullNext++;
+            }
+        }
+        VERIFY_ARE_EQUAL(ring.GetDroppedCount(), (UINT64)2);
+
+        VERIFY_IS_TRUE(ring.Drain(pFile, cRecords));
+        VERIFY_ARE_EQUAL(cRecords, ullNext);
+        VERIFY_ARE_EQUAL(cRecords, (UINT64)(2 * cRing - 1));
+
+        rewind(pFile);
+        for (UINT64 i = 0; i < cRecords; i++)
+        {
+            VERIFY_ARE_EQUAL(fread(&record, sizeof(record), 1, pFile), (size_t)1);
+            VERIFY_ARE_EQUAL(record.ullOffset, i);
+        }
+        fclose(pFile);
+    }
+
+    void IORequestGeneratorUnitTests::Test_IntervalCounters()
+    {
+        // this ut validates that interval latency buckets are contiguous and hold their
+        // values to 2 significant digits, and that percentiles are read from their counts.
+
+        UINT64 ullLast = 0;
+        for (size_t i = 1; i < IntervalCounters::LatencyBucketCount; i++)
+        {
+            UINT64 ullHigh = IntervalCounters::LatencyBucketValue(i);
+            VERIFY_ARE_EQUAL(IntervalCounters::LatencyBucket(ullLast + 1), i);
+            VERIFY_ARE_EQUAL(IntervalCounters::LatencyBucket(ullHigh), i);
+            VERIFY_IS_TRUE(ullHigh - ullLast <= max((UINT64)1, ullHigh / 100));
+            ullLast = ullHigh;
+        }
+
+        // latencies beyond the layout are counted in the last bucket
+        VERIFY_ARE_EQUAL(IntervalCounters::LatencyBucket(MAXUINT64), IntervalCounters::LatencyBucketCount - 1);
+
+        IntervalCounters counters;
+        counters.Initialize();
+        for (UINT64 i = 1; i <= 1000; i++)
+        {
+            counters.Add(IOOperation::ReadIO, 4096, i * 1000, true);
+        }
+        counters.Add(IOOperation::WriteIO, 8192, 0, false);
+        counters.Add(IOOperation::FlushIO, 0, 0, false);
+
+        VERIFY_ARE_EQUAL(counters.ullReadIOCount, (UINT64)1000);
+        VERIFY_ARE_EQUAL(counters.ullReadBytesCount, (UINT64)1000 * 4096);
+        VERIFY_ARE_EQUAL(counters.ullWriteIOCount, (UINT64)1);
+        VERIFY_ARE_EQUAL(counters.ullWriteBytesCount, (UINT64)8192);
+        VERIFY_ARE_EQUAL(counters.ullFlushIOCount, (UINT64)1);
+
+        UINT64 ullP50 = IntervalReporter::GetLatencyPercentile(counters.vLatencyCounts, 1000, 50);
+        UINT64 ullP99 = IntervalReporter::GetLatencyPercentile(counters.vLatencyCounts, 1000, 99);
+        VERIFY_IS_TRUE(ullP50 >= 500000 && ullP50 <= 505000);
+        VERIFY_IS_TRUE(ullP99 >= 990000 && ullP99 <= 1000000);
+    }
+
+    void IORequestGeneratorUnitTests::Test_ThreadStatistics()
+    {
+        // this ut validates that observers of thread statistics only see what the owning thread
+        // published, and that a published copy is read whole while the thread keeps publishing.
+
+        ThreadStatistics statistics;
+        statistics.Initialize(true, PerfTimer::SecondsToPerfTime(3600));
+
+        IntervalCounters counters;
+        counters.Initialize();
+
+        statistics.Add(IOOperation::ReadIO, 4096, 1000, true);
+        statistics.Read(counters);
+        VERIFY_ARE_EQUAL(counters.ullReadIOCount, (UINT64)0);
+        VERIFY_ARE_EQUAL(counters.cLatencyBuckets, (size_t)0);
+
+        statistics.Publish(PerfTimer::GetTime());
+        statistics.Read(counters);
+        VERIFY_ARE_EQUAL(counters.ullReadIOCount, (UINT64)1);
+        VERIFY_ARE_EQUAL(counters.ullReadBytesCount, (UINT64)4096);
+        VERIFY_ARE_EQUAL(counters.cLatencyBuckets, IntervalCounters::LatencyBucket(1000) + 1);
+        VERIFY_ARE_EQUAL(counters.vLatencyCounts[IntervalCounters::LatencyBucket(1000)], (UINT64)1);
+
+        // until the publication interval passes, further IO is not published
+        for (UINT32 i = 0; i < 128; i++)
+        {
+            statistics.Add(IOOperation::WriteIO, 512, 2000, true);
+        }
+        statistics.Read(counters);
+        VERIFY_ARE_EQUAL(counters.ullWriteIOCount, (UINT64)0);
+
+        // ... unless the thread is about to sleep
+        statistics.PublishPending();
+        statistics.Read(counters);
+        VERIFY_ARE_EQUAL(counters.ullWriteIOCount, (UINT64)128);
+        VERIFY_ARE_EQUAL(counters.vLatencyCounts[IntervalCounters::LatencyBucket(2000)], (UINT64)128);
+
+        // the latency counts are on cache lines of their own
+        VERIFY_ARE_EQUAL((ULONG_PTR)counters.vLatencyCounts.data() % CacheLineAllocator<UINT64>::CacheLineSize, (ULONG_PTR)0);
+
+        // an observer reading concurrently with publication sees consistent counters
+        ThreadStatistics concurrent;
+        concurrent.Initialize(false, 0);
+        volatile bool fDone = false;
+
+        thread publisher([&concurrent, &fDone]() {
+            for (UINT32 i = 0; i < 100000; i++)
+            {
+                concurrent.Add(IOOperation::ReadIO, 4096, 0, false);
+                concurrent.Add(IOOperation::WriteIO, 4096, 0, false);
+            }
+            concurrent.Publish(PerfTimer::GetTime());
+            fDone = true;
+        });
+
+        IntervalCounters observed;
+        UINT64 ullLast = 0;
+        bool fLast = false;
+        while (!fLast)
+        {
+            fLast = fDone;
+            concurrent.Read(observed);
+
+            // the time is checked on every IO, so a copy may be published between a read and its write
+            VERIFY_IS_TRUE(observed.ullReadIOCount == observed.ullWriteIOCount || observed.ullReadIOCount == observed.ullWriteIOCount + 1);
+            VERIFY_ARE_EQUAL(observed.ullReadBytesCount, observed.ullReadIOCount * 4096);
+            VERIFY_IS_TRUE(observed.ullReadIOCount >= ullLast);
+            ullLast = observed.ullReadIOCount;
+        }
+        publisher.join();
+
+        VERIFY_ARE_EQUAL(observed.ullReadIOCount, (UINT64)100000);
+    }
+
+    void IORequestGeneratorUnitTests::Test_LatencySloSearch()
+    {
+        // this ut validates the outstanding IO counts a latency SLO search runs at against a
+        // modeled device, and the knee it finds.
+
+        // IOPS grow with the outstanding IO count up to 64, latency grows linearly with it
+        auto model = [](DWORD dwRequestCount) {
+            LatencySloSearch::Step step = {};
+            step.dwRequestCount = dwRequestCount;
+            step.lfIops = 10000.0 * min<DWORD>(dwRequestCount, 64);
+            step.lfLatencyMilliseconds = 0.1 * dwRequestCount;
+            return step;
+        };
+
+        // double up to 32, miss at 32 (3.2ms > 3ms), then bisect to within an eighth: 24, 28, 30
+        {
+            LatencySloSearch search(3.0, 256);
+            vector<DWORD> vdwCounts;
+            for (DWORD dwRequestCount = search.GetNextRequestCount(); dwRequestCount != 0; dwRequestCount = search.GetNextRequestCount())
+            {
+                vdwCounts.push_back(dwRequestCount);
+                search.AddStep(model(dwRequestCount));
+            }
+
+            vector<DWORD> vdwExpected = { 1, 2, 4, 8, 16, 32, 24, 28, 30 };
+            VERIFY_IS_TRUE(vdwCounts == vdwExpected);
+
+            int iKnee = search.GetKnee();
+            VERIFY_IS_TRUE(iKnee >= 0);
+            VERIFY_ARE_EQUAL(search.GetSteps()[iKnee].dwRequestCount, (DWORD)30);
+            VERIFY_IS_FALSE(search.GetSteps()[5].fMetSlo);
+        }
+
+        // a loose SLO: doubling stops once the IOPS stop growing
+        {
+            LatencySloSearch search(1000.0, 256);
+            DWORD dwLast = 0;
+            for (DWORD dwRequestCount = search.GetNextRequestCount(); dwRequestCount != 0; dwRequestCount = search.GetNextRequestCount())
+            {
+                dwLast = dwRequestCount;
+                search.AddStep(model(dwRequestCount));
+            }
+
+            VERIFY_ARE_EQUAL(dwLast, (DWORD)128);
+            VERIFY_ARE_EQUAL(search.GetSteps()[search.GetKnee()].dwRequestCount, (DWORD)64);
+        }
+
+        // ... or at the maximum count
+        {
+            LatencySloSearch search(1000.0, 20);
+            DWORD dwLast = 0;
+            for (DWORD dwRequestCount = search.GetNextRequestCount(); dwRequestCount != 0; dwRequestCount = search.GetNextRequestCount())
+            {
+                dwLast = dwRequestCount;
+                search.AddStep(model(dwRequestCount));
+            }
+
+            VERIFY_ARE_EQUAL(dwLast, (DWORD)20);
+            VERIFY_ARE_EQUAL(search.GetSteps().size(), (size_t)6);
+        }
+
+        // no knee if a single outstanding IO misses the SLO
+        {
+            LatencySloSearch search(0.05, 256);
+            search.AddStep(model(search.GetNextRequestCount()));
+            VERIFY_ARE_EQUAL(search.GetNextRequestCount(), (DWORD)0);
+            VERIFY_ARE_EQUAL(search.GetKnee(), -1);
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_ThreadResourcePool()
+    {
+        ThreadResourcePool pool;
+        bool fFilled = true;
+
+        // a new buffer is never filled
+        BYTE *pBuffer = pool.AcquireBuffer(8192, false, BufferFill::Pattern, true, &fFilled);
+        VERIFY_IS_TRUE(pBuffer != nullptr);
+        VERIFY_IS_FALSE(fFilled);
+        pool.ReleaseBuffer(pBuffer);
+
+        // the same size and fill comes back filled
+        VERIFY_ARE_EQUAL(pool.AcquireBuffer(8192, false, BufferFill::Pattern, false, &fFilled), pBuffer);
+        VERIFY_IS_TRUE(fFilled);
+        pool.ReleaseBuffer(pBuffer);
+
+        // ... unless the last use did not keep the fill
+        VERIFY_ARE_EQUAL(pool.AcquireBuffer(8192, false, BufferFill::Pattern, true, &fFilled), pBuffer);
+        VERIFY_IS_FALSE(fFilled);
+        pool.ReleaseBuffer(pBuffer);
+
+        // a smaller request reuses the buffer, but must fill it
+        VERIFY_ARE_EQUAL(pool.AcquireBuffer(4096, false, BufferFill::Zero, true, &fFilled), pBuffer);
+        VERIFY_IS_FALSE(fFilled);
+
+        // a buffer in use is not handed out twice
+        BYTE *pOther = pool.AcquireBuffer(4096, false, BufferFill::Zero, true, &fFilled);
+        VERIFY_IS_TRUE(pOther != nullptr);
+        VERIFY_IS_TRUE(pOther != pBuffer);
+        VERIFY_IS_FALSE(fFilled);
+        pool.ReleaseBuffer(pOther);
+        pool.ReleaseBuffer(pBuffer);
+
+        // nothing to fill is never reported as filled
+        pBuffer = pool.AcquireBuffer(4096, false, BufferFill::None, true, &fFilled);
+        VERIFY_IS_FALSE(fFilled);
+        pool.ReleaseBuffer(pBuffer);
+
+        // handles are kept by how they were opened
+        UniqueTarget ut;
+        ut.path = "testfile.dat";
+        ut.priority = IoPriorityHintNormal;
+        ut.caching = TargetCacheMode::Cached;
+        ut.dwDesiredAccess = GENERIC_READ;
+        ut.dwFlags = 0;
+
+        HANDLE hFile = (HANDLE)1;
+        VERIFY_ARE_EQUAL(pool.AcquireHandle(ut), INVALID_HANDLE_VALUE);
+        pool.ReleaseHandle(ut, hFile);
+        ut.dwDesiredAccess = GENERIC_WRITE;
+        VERIFY_ARE_EQUAL(pool.AcquireHandle(ut), INVALID_HANDLE_VALUE);
+        ut.dwDesiredAccess = GENERIC_READ;
+        VERIFY_ARE_EQUAL(pool.AcquireHandle(ut), hFile);
+        VERIFY_ARE_EQUAL(pool.AcquireHandle(ut), INVALID_HANDLE_VALUE);
+    }
+
+    void IORequestGeneratorUnitTests::Test_ThroughputMeterTokenBucket()
+    {
+        // 1 byte per millisecond: a 4KiB block takes seconds to accrue, so the
+        // states below do not depend on how quickly the test runs
+
+        {
+            ThroughputMeter meter;
+            meter.Start(1.0, 4096, 0, 0, 0);
+            VERIFY_IS_TRUE(meter.IsRunning());
+
+            // the first IO is ready at once
+            DWORD dwSleepTime;
+            VERIFY_IS_TRUE(meter.IsReady(&dwSleepTime));
+            VERIFY_ARE_EQUAL(dwSleepTime, (DWORD)0);
+
+            // ... and the next sleeps until its block has accrued
+            meter.Adjust(4096);
+            VERIFY_IS_FALSE(meter.IsReady(&dwSleepTime));
+            VERIFY_IS_TRUE(dwSleepTime > 4000 && dwSleepTime <= 4096);
+        }
+
+        // a spin time as long as the wait polls through it; a shorter one sleeps the rest
+        {
+            ThroughputMeter meter;
+            meter.Start(1.0, 4096, 0, 0, 10 * 1000 * 1000);
+            meter.Adjust(4096);
+
+            DWORD dwSleepTime;
+            VERIFY_IS_FALSE(meter.IsReady(&dwSleepTime));
+            VERIFY_ARE_EQUAL(dwSleepTime, (DWORD)0);
+        }
+        {
+            ThroughputMeter meter;
+            meter.Start(1.0, 4096, 0, 0, 1000 * 1000);
+            meter.Adjust(4096);
+
+            DWORD dwSleepTime;
+            VERIFY_IS_FALSE(meter.IsReady(&dwSleepTime));
+            VERIFY_IS_TRUE(dwSleepTime > 3000 && dwSleepTime <= 3096);
+        }
+
+        // an IO larger than the bucket overdraws it, and the wait repays the debt
+        {
+            ThroughputMeter meter;
+            meter.Start(1.0, 4096, 0, 0, 1000);
+            meter.Adjust(3 * 4096);
+
+            DWORD dwSleepTime;
+            VERIFY_IS_FALSE(meter.IsReady(&dwSleepTime));
+            VERIFY_IS_TRUE(dwSleepTime > 3 * 4096 - 100 && dwSleepTime <= 3 * 4096);
+        }
+
+        // think time waits the same way
+        {
+            ThroughputMeter meter;
+            meter.Start(0, 4096, 5000, 2, 0);
+            VERIFY_IS_TRUE(meter.IsRunning());
+
+            DWORD dwSleepTime;
+            meter.Adjust(4096);
+            VERIFY_IS_TRUE(meter.IsReady(&dwSleepTime));
+            meter.Adjust(4096);
+            VERIFY_IS_FALSE(meter.IsReady(&dwSleepTime));
+            VERIFY_IS_TRUE(dwSleepTime > 4900 && dwSleepTime <= 5000);
+        }
+    }
+
+    void IORequestGeneratorUnitTests::Test_SharedRateLimit()
+    {
+        const UINT64 ullMillisecond = PerfTimer::MillisecondsToPerfTime(1);
+        const UINT64 ullStart = PerfTimer::SecondsToPerfTime(1000);
+
+        // 1 IO per millisecond: grants are a tenth of an IO, and the bucket
+        // holds the sleep resolution's worth before refusing
+        {
+            SharedRateLimit limit(1.0, true, 0);
+            VERIFY_IS_TRUE(limit.IsIOPS());
+            VERIFY_ARE_EQUAL(limit.GetGrantSize(), 0.1);
+
+            UINT32 cGranted = 0;
+            while (limit.TryAcquire(1, ullStart) == 0)
+            {
+                cGranted++;
+            }
+            VERIFY_ARE_EQUAL(cGranted, ThroughputMeter::SleepResolutionMilliseconds + 1);
+
+            // the next is a millisecond away; the wait is stated from now
+            UINT64 ullWait = limit.TryAcquire(1, ullStart);
+            VERIFY_IS_TRUE(ullWait > 0 && ullWait <= ullMillisecond);
+            VERIFY_ARE_EQUAL(limit.TryAcquire(1, ullStart + ullWait / 2), ullWait - ullWait / 2);
+            VERIFY_ARE_EQUAL(limit.TryAcquire(1, ullStart + ullWait), (UINT64)0);
+
+            // after a second idle it is the same bucket depth again, not a second's worth
+            cGranted = 0;
+            while (limit.TryAcquire(1, ullStart + 1000 * ullMillisecond) == 0)
+            {
+                cGranted++;
+            }
+            VERIFY_ARE_EQUAL(cGranted, ThroughputMeter::SleepResolutionMilliseconds + 1);
+        }
+
+        // spinning holds only the spin time's worth
+        {
+            SharedRateLimit limit(1024.0, false, 2000);
+            VERIFY_IS_FALSE(limit.IsIOPS());
+
+            UINT32 cGranted = 0;
+            while (limit.TryAcquire(1024, ullStart) == 0)
+            {
+                cGranted++;
+            }
+            VERIFY_ARE_EQUAL(cGranted, (UINT32)3);
+        }
+
+        // meters on the same limit share it: at 10 IOPS the sleep resolution's
+        // worth is less than an IO, so only the first is issued between the two
+        {
+            SharedRateLimit limit(10.0 / 1000, true, 0);
+            ThroughputMeter meter1, meter2;
+            meter1.Start(0, 4096, 0, 0, 0);
+            meter2.Start(0, 4096, 0, 0, 0);
+            VERIFY_IS_FALSE(meter1.IsRunning());
+            VERIFY_IS_TRUE(meter1.AddSharedLimit(&limit));
+            VERIFY_IS_TRUE(meter2.AddSharedLimit(&limit));
+            VERIFY_IS_TRUE(meter1.IsRunning());
+
+            UINT32 cIssued = 0;
+            DWORD dwSleepTime;
+            for (UINT32 i = 0; i < 100; i++)
+            {
+                ThroughputMeter& meter = (i % 2) ? meter2 : meter1;
+                if (meter.IsReady(&dwSleepTime))
+                {
+                    meter.Adjust(4096);
+                    cIssued++;
+                }
+            }
+
+            VERIFY_ARE_EQUAL(cIssued, (UINT32)1);
+            VERIFY_IS_FALSE(meter1.IsReady(&dwSleepTime));
+            VERIFY_IS_TRUE(dwSleepTime > 50 && dwSleepTime <= 100);
+        }
+    }
+}
@@ -60,5 +60,17 @@ namespace UnitTests
         TEST_METHOD(Test_ThreadTargetStateInit);
         TEST_METHOD(Test_ThreadTargetStateEffectiveDistPct);
         TEST_METHOD(Test_ThreadTargetStateEffectiveDistAbs);
+        TEST_METHOD(Test_ThreadTargetStateSkewedDist);
+        TEST_METHOD(Test_ThreadTargetStateBlockSizeMix);
+        TEST_METHOD(Test_ThreadTargetStateFlushAndTrim);
+        TEST_METHOD(Test_ThreadTargetStateFileSet);
+        TEST_METHOD(Test_TraceReaderParseLine);
+        TEST_METHOD(Test_IoTraceRing);
+        TEST_METHOD(Test_IntervalCounters);
+        TEST_METHOD(Test_ThreadStatistics);
+        TEST_METHOD(Test_LatencySloSearch);
+        TEST_METHOD(Test_ThreadResourcePool);
+        TEST_METHOD(Test_ThroughputMeterTokenBucket);
+        TEST_METHOD(Test_SharedRateLimit);
     };
 }
\ No newline at end of file
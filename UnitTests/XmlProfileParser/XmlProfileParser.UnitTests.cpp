@@ -805,6 +805,226 @@ namespace UnitTests
         VERIFY_IS_TRUE(t.GetRandomDataWriteBufferSourcePath() == "x:\\foo\\bar.dat");
     }
 
+    void XmlProfileParserUnitTests::Test_ParseFileWriteBufferContentReducible()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path></Path>\n"
+                       "                    <WriteBufferContent>\n"
+                       "                        <Pattern>reducible</Pattern>\n"
+                       "                        <DataReduction>\n"
+                       "                            <CompressionRatio>2.5</CompressionRatio>\n"
+                       "                            <DedupRatio>3</DedupRatio>\n"
+                       "                            <ChunkSize>8192</ChunkSize>\n"
+                       "                        </DataReduction>\n"
+                       "                    </WriteBufferContent>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, nullptr, _hModule));
+        VERIFY_IS_TRUE(profile.Validate(false));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        vector<Target> vTargets(vTimespans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t = vTargets[0];
+        VERIFY_IS_TRUE(t.GetReducibleWriteData());
+        VERIFY_ARE_EQUAL(t.GetCompressionRatio(), 2.5);
+        VERIFY_ARE_EQUAL(t.GetDedupRatio(), 3.0);
+        VERIFY_ARE_EQUAL(t.GetDedupChunkSize(), (UINT32)8192);
+        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
+        VERIFY_ARE_EQUAL(t.GetRandomDataWriteBufferSize(), 0);
+        VERIFY_IS_FALSE(t.GetVerifyData());
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileWriteBufferContentVerify()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path></Path>\n"
+                       "                    <BlockSize>65536</BlockSize>\n"
+                       "                    <WriteBufferContent>\n"
+                       "                        <Pattern>sequential</Pattern>\n"
+                       "                        <VerifyUnitSize>8192</VerifyUnitSize>\n"
+                       "                    </WriteBufferContent>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, nullptr, _hModule));
+        VERIFY_IS_TRUE(profile.Validate(false));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        vector<Target> vTargets(vTimespans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t = vTargets[0];
+        VERIFY_IS_TRUE(t.GetVerifyData());
+        VERIFY_ARE_EQUAL(t.GetVerifyUnitSize(), (UINT32)8192);
+        VERIFY_IS_TRUE(t.GetZeroWriteBuffers() == false);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileFlushAndFuaWrite()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path></Path>\n"
+                       "                    <WriteRatio>30</WriteRatio>\n"
+                       "                    <FlushRatio>1</FlushRatio>\n"
+                       "                    <FuaWriteRatio>50</FuaWriteRatio>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, nullptr, _hModule));
+
+        // forced unit access is Linux only, so profile only
+        profile.SetProfileOnly(true);
+        VERIFY_IS_TRUE(profile.Validate(false));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        vector<Target> vTargets(vTimespans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t = vTargets[0];
+        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)30);
+        VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)1);
+        VERIFY_ARE_EQUAL(t.GetFuaWriteRatio(), (UINT32)50);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileTrim()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path></Path>\n"
+                       "                    <WriteRatio>30</WriteRatio>\n"
+                       "                    <FlushRatio>5</FlushRatio>\n"
+                       "                    <TrimRatio>10</TrimRatio>\n"
+                       "                    <TrimSize>65536</TrimSize>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, nullptr, _hModule));
+        VERIFY_IS_TRUE(profile.Validate(false));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        vector<Target> vTargets(vTimespans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)1);
+        Target t = vTargets[0];
+        VERIFY_ARE_EQUAL(t.GetWriteRatio(), (UINT32)30);
+        VERIFY_ARE_EQUAL(t.GetFlushRatio(), (UINT32)5);
+        VERIFY_ARE_EQUAL(t.GetTrimRatio(), (UINT32)10);
+        VERIFY_ARE_EQUAL(t.GetTrimSize(), (DWORD)65536);
+    }
+
+    void XmlProfileParserUnitTests::Test_ParseFileFileSet()
+    {
+        FILE *pFile;
+        fopen_s(&pFile, _sTempFilePath.c_str(), "wb");
+        VERIFY_IS_TRUE(pFile != nullptr);
+        fprintf(pFile, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                       "<Profile>\n"
+                       "    <TimeSpans>\n"
+                       "        <TimeSpan>\n"
+                       "            <Targets>\n"
+                       "                <Target>\n"
+                       "                    <Path></Path>\n"
+                       "                    <WriteRatio>30</WriteRatio>\n"
+                       "                    <FileSet>\n"
+                       "                        <FileCount>1000</FileCount>\n"
+                       "                        <Zipf>0.8</Zipf>\n"
+                       "                        <OpenPerIO>true</OpenPerIO>\n"
+                       "                        <MetadataRatio>15</MetadataRatio>\n"
+                       "                        <MetadataOperations>cu</MetadataOperations>\n"
+                       "                    </FileSet>\n"
+                       "                </Target>\n"
+                       "                <Target>\n"
+                       "                    <Path></Path>\n"
+                       "                    <FileSet>\n"
+                       "                        <FileCount>10</FileCount>\n"
+                       "                        <MetadataRatio>5</MetadataRatio>\n"
+                       "                    </FileSet>\n"
+                       "                </Target>\n"
+                       "            </Targets>\n"
+                       "        </TimeSpan>\n"
+                       "    </TimeSpans>\n"
+                       "</Profile>\n");
+        fclose(pFile);
+
+        XmlProfileParser p;
+        Profile profile;
+        VERIFY_IS_TRUE(p.ParseFile(_sTempFilePath.c_str(), &profile, nullptr, _hModule));
+        VERIFY_IS_TRUE(profile.Validate(false));
+        vector<TimeSpan> vTimespans(profile.GetTimeSpans());
+        VERIFY_ARE_EQUAL(vTimespans.size(), (size_t)1);
+        vector<Target> vTargets(vTimespans[0].GetTargets());
+        VERIFY_ARE_EQUAL(vTargets.size(), (size_t)2);
+
+        Target t = vTargets[0];
+        VERIFY_ARE_EQUAL(t.GetFileSetCount(), (DWORD)1000);
+        VERIFY_ARE_EQUAL(t.GetFileSetSkew(), 0.8);
+        VERIFY_IS_TRUE(t.GetOpenPerIO());
+        VERIFY_ARE_EQUAL(t.GetMetadataRatio(), (UINT32)15);
+        VERIFY_ARE_EQUAL(t.GetMetadataOps(), MetadataOpMask(MetadataOp::Create) | MetadataOpMask(MetadataOp::Unlink));
+
+        // all kinds of metadata operation unless stated
+        t = vTargets[1];
+        VERIFY_ARE_EQUAL(t.GetFileSetCount(), (DWORD)10);
+        VERIFY_ARE_EQUAL(t.GetFileSetSkew(), 0.0);
+        VERIFY_IS_FALSE(t.GetOpenPerIO());
+        VERIFY_ARE_EQUAL(t.GetMetadataRatio(), (UINT32)5);
+        VERIFY_ARE_EQUAL(t.GetMetadataOps(), MetadataOpMask(MetadataOp::Create) | MetadataOpMask(MetadataOp::Stat) |
+                                             MetadataOpMask(MetadataOp::Unlink) | MetadataOpMask(MetadataOp::Rename));
+    }
+
     void XmlProfileParserUnitTests::Test_ParseFileGlobalRequestCount()
     {
         FILE *pFile;
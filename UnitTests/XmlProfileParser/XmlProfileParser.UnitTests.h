@@ -63,6 +63,11 @@ namespace UnitTests
         TEST_METHOD(Test_ParseFileWriteBufferContentRandom);
         TEST_METHOD(Test_ParseFileWriteBufferContentRandomNoFilePath);
         TEST_METHOD(Test_ParseFileWriteBufferContentRandomWithFilePath);
+        TEST_METHOD(Test_ParseFileWriteBufferContentReducible);
+        TEST_METHOD(Test_ParseFileWriteBufferContentVerify);
+        TEST_METHOD(Test_ParseFileFlushAndFuaWrite);
+        TEST_METHOD(Test_ParseFileTrim);
+        TEST_METHOD(Test_ParseFileFileSet);
         TEST_METHOD(Test_ParseFileWriteBufferContentSequential);
         TEST_METHOD(Test_ParseFileWriteBufferContentZero);
         TEST_METHOD(Test_ParseGroupAffinity);
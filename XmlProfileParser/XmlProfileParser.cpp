@@ -560,6 +560,57 @@ HRESULT XmlProfileParser::_ParseTimeSpan(IXMLDOMNode *pXmlNode, TimeSpan *pTimeS
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        string sIoEngine;
+        hr = _GetString(pXmlNode, "IoEngine", &sIoEngine);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            if (sIoEngine == "IoUring")
+            {
+                pTimeSpan->SetIoEngine(IoEngine::IoUring);
+            }
+            else if (sIoEngine == "LinuxAio")
+            {
+                pTimeSpan->SetIoEngine(IoEngine::LinuxAio);
+            }
+            else
+            {
+                hr = E_INVALIDARG;
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fRegisteredIo;
+        hr = _GetBool(pXmlNode, "RegisteredIo", &fRegisteredIo);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetRegisteredIo(fRegisteredIo);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fSqPoll;
+        hr = _GetBool(pXmlNode, "SqPoll", &fSqPoll);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetSqPoll(fSqPoll);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulAioMinEvents;
+        hr = _GetUINT32(pXmlNode, "AioMinEvents", &ulAioMinEvents);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetAioMinEvents(ulAioMinEvents);
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fMeasureLatency;
@@ -570,6 +621,26 @@ HRESULT XmlProfileParser::_ParseTimeSpan(IXMLDOMNode *pXmlNode, TimeSpan *pTimeS
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulLatencySignificantDigits;
+        hr = _GetUINT32(pXmlNode, "LatencySignificantDigits", &ulLatencySignificantDigits);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetLatencySignificantDigits(ulLatencySignificantDigits);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        string sIoTracePath;
+        hr = _GetString(pXmlNode, "IoTrace", &sIoTracePath);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetIoTracePath(sIoTracePath);
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fCalculateIopsStdDev;
@@ -590,6 +661,66 @@ HRESULT XmlProfileParser::_ParseTimeSpan(IXMLDOMNode *pXmlNode, TimeSpan *pTimeS
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseReportInterval(pXmlNode, pTimeSpan);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        double lfPercentile;
+        hr = _GetDouble(pXmlNode, "LatencySlo/Percentile", &lfPercentile);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            // XSD requires the latency bound alongside the percentile
+            double lfMilliseconds = 0;
+            hr = _GetDouble(pXmlNode, "LatencySlo/Latency", &lfMilliseconds);
+            if (SUCCEEDED(hr))
+            {
+                pTimeSpan->SetLatencySloPercentile(lfPercentile);
+                pTimeSpan->SetLatencySloMilliseconds(lfMilliseconds);
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulMaxRequestCount;
+        hr = _GetUINT32(pXmlNode, "LatencySlo/MaxRequestCount", &ulMaxRequestCount);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetLatencySloMaxRequestCount(ulMaxRequestCount);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwTotalThroughput;
+        bool fIOPS;
+        hr = _GetTotalThroughput(pXmlNode, &dwTotalThroughput, &fIOPS);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            if (fIOPS)
+            {
+                pTimeSpan->SetTotalThroughputIOPS(dwTotalThroughput);
+            }
+            else
+            {
+                pTimeSpan->SetTotalThroughput(dwTotalThroughput);
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseSweep(pXmlNode, pTimeSpan);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParsePhases(pXmlNode, pTimeSpan);
+    }
+
     // Look for downlevel non-group aware assignment
     if (SUCCEEDED(hr))
     {
@@ -729,6 +860,30 @@ HRESULT XmlProfileParser::_ParseRandomDataSource(IXMLDOMNode *pXmlNode, Target *
     return hr;
 }
 
+HRESULT XmlProfileParser::_ParseDataReduction(IXMLDOMNode *pXmlNode, Target *pTarget)
+{
+    double lfCompressionRatio = 1;
+    double lfDedupRatio = 1;
+    UINT32 cbChunk = ReducibleDataPool::DefaultChunkSize;
+
+    HRESULT hr = _GetDouble(pXmlNode, "DataReduction/CompressionRatio", &lfCompressionRatio);
+    if (SUCCEEDED(hr))
+    {
+        hr = _GetDouble(pXmlNode, "DataReduction/DedupRatio", &lfDedupRatio);
+    }
+    if (SUCCEEDED(hr))
+    {
+        hr = _GetUINT32(pXmlNode, "DataReduction/ChunkSize", &cbChunk);
+    }
+    if (SUCCEEDED(hr))
+    {
+        // absent elements keep their defaults
+        pTarget->SetReducibleWriteData(lfCompressionRatio, lfDedupRatio, cbChunk);
+        hr = S_OK;
+    }
+    return hr;
+}
+
 HRESULT XmlProfileParser::_ParseWriteBufferContent(IXMLDOMNode *pXmlNode, Target *pTarget)
 {
     CComPtr<IXMLDOMNodeList> spNodeList = nullptr;
@@ -760,11 +915,24 @@ HRESULT XmlProfileParser::_ParseWriteBufferContent(IXMLDOMNode *pXmlNode, Target
                     {
                         hr = _ParseRandomDataSource(spNode, pTarget);
                     }
+                    else if (sPattern == "reducible")
+                    {
+                        hr = _ParseDataReduction(spNode, pTarget);
+                    }
                     else
                     {
                         hr = E_INVALIDARG;
                     }
                 }
+                if (SUCCEEDED(hr))
+                {
+                    UINT32 cbVerifyUnit;
+                    hr = _GetUINT32(spNode, "VerifyUnitSize", &cbVerifyUnit);
+                    if (SUCCEEDED(hr) && (hr != S_FALSE))
+                    {
+                        pTarget->SetVerifyUnitSize(cbVerifyUnit);
+                    }
+                }
             }
         }
     }
@@ -794,6 +962,11 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseBlockSizeMix(pXmlNode, pTarget);
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fInterlockedSequential;
@@ -1023,6 +1196,44 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
         hr = _ParseThroughput(pXmlNode, pTarget);
     }
 
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwTotalThroughput;
+        bool fIOPS;
+        hr = _GetTotalThroughput(pXmlNode, &dwTotalThroughput, &fIOPS);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            if (fIOPS)
+            {
+                pTarget->SetTotalThroughputIOPS(dwTotalThroughput);
+            }
+            else
+            {
+                pTarget->SetTotalThroughput(dwTotalThroughput);
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwThrottleSpin;
+        hr = _GetDWORD(pXmlNode, "ThrottleSpin", &dwThrottleSpin);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetThrottleSpinMicroseconds(dwThrottleSpin);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseArrivalRate(pXmlNode, pTarget);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = _ParseTrace(pXmlNode, pTarget);
+    }
+
     if (SUCCEEDED(hr))
     {
         DWORD dwThreadsPerFile;
@@ -1064,6 +1275,111 @@ HRESULT XmlProfileParser::_ParseTarget(IXMLDOMNode *pXmlNode, Target *pTarget)
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulFlushRatio;
+        hr = _GetUINT32(pXmlNode, "FlushRatio", &ulFlushRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFlushRatio(ulFlushRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulFuaWriteRatio;
+        hr = _GetUINT32(pXmlNode, "FuaWriteRatio", &ulFuaWriteRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFuaWriteRatio(ulFuaWriteRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulTrimRatio;
+        hr = _GetUINT32(pXmlNode, "TrimRatio", &ulTrimRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetTrimRatio(ulTrimRatio);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulTrimSize;
+        hr = _GetUINT32(pXmlNode, "TrimSize", &ulTrimSize);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetTrimSize(ulTrimSize);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        DWORD dwFileCount;
+        hr = _GetDWORD(pXmlNode, "FileSet/FileCount", &dwFileCount);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFileSetCount(dwFileCount);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        double lfSkew;
+        hr = _GetDouble(pXmlNode, "FileSet/Zipf", &lfSkew);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetFileSetSkew(lfSkew);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        bool fOpenPerIO;
+        hr = _GetBool(pXmlNode, "FileSet/OpenPerIO", &fOpenPerIO);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetOpenPerIO(fOpenPerIO);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        UINT32 ulMetadataRatio;
+        hr = _GetUINT32(pXmlNode, "FileSet/MetadataRatio", &ulMetadataRatio);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetMetadataRatio(ulMetadataRatio);
+
+            // all kinds of operation unless stated
+            pTarget->SetMetadataOps(MetadataOpMask(MetadataOp::Create) | MetadataOpMask(MetadataOp::Stat) |
+                                    MetadataOpMask(MetadataOp::Unlink) | MetadataOpMask(MetadataOp::Rename));
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        string sOps;
+        hr = _GetString(pXmlNode, "FileSet/MetadataOperations", &sOps);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            UINT32 ulOps = 0;
+            for (char ch : sOps)
+            {
+                for (UINT32 i = 0; i < static_cast<UINT32>(MetadataOp::Open); i++)
+                {
+                    if (ch == MetadataOpName(static_cast<MetadataOp>(i))[0])
+                    {
+                        ulOps |= MetadataOpMask(static_cast<MetadataOp>(i));
+                    }
+                }
+            }
+            pTarget->SetMetadataOps(ulOps);
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         bool fParallelAsyncIO;
@@ -1182,26 +1498,42 @@ HRESULT XmlProfileParser::_ParseThroughput(IXMLDOMNode *pXmlNode, Target *pTarge
     return hr;
 }
 
-HRESULT XmlProfileParser::_ParseThreadTargets(IXMLDOMNode *pXmlNode, Target *pTarget)
+HRESULT XmlProfileParser::_GetTotalThroughput(IXMLDOMNode *pXmlNode, DWORD *pdwValue, bool *pfIOPS)
 {
-    CComVariant query("ThreadTargets/ThreadTarget");
-    CComPtr<IXMLDOMNodeList> spNodeList = nullptr;
-    HRESULT hr = pXmlNode->selectNodes(query.bstrVal, &spNodeList);
-    if (SUCCEEDED(hr))
+    CComPtr<IXMLDOMNode> spNode = nullptr;
+    CComVariant query("TotalThroughput");
+    HRESULT hr = pXmlNode->selectSingleNode(query.bstrVal, &spNode);
+    if (SUCCEEDED(hr) && (hr != S_FALSE))
     {
-        long cNodes;
-        hr = spNodeList->get_length(&cNodes);
+        BSTR bstrText;
+        hr = spNode->get_text(&bstrText);
         if (SUCCEEDED(hr))
         {
-            for (int i = 0; i < cNodes; i++)
+            *pdwValue = (DWORD) _wtoi64((wchar_t *)bstrText);  // XSD constrains s.t. cast is safe
+            SysFreeString(bstrText);
+        }
+        else
+        {
+            return hr;
+        }
+
+        // get unit - bpms default
+        *pfIOPS = false;
+
+        CComPtr<IXMLDOMNamedNodeMap> spNamedNodeMap = nullptr;
+        CComBSTR attr("unit");
+        hr = spNode->get_attributes(&spNamedNodeMap);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            CComPtr<IXMLDOMNode> spAttrNode = nullptr;
+            HRESULT hrAttr = spNamedNodeMap->getNamedItem(attr, &spAttrNode);
+            if (SUCCEEDED(hrAttr) && (hrAttr != S_FALSE))
             {
-                CComPtr<IXMLDOMNode> spNode = nullptr;
-                hr = spNodeList->get_item(i, &spNode);
-                if (SUCCEEDED(hr))
+                hrAttr = spAttrNode->get_text(&bstrText);
+                if (SUCCEEDED(hrAttr))
                 {
-                    ThreadTarget threadTarget;
-                    _ParseThreadTarget(spNode, &threadTarget);
-                    pTarget->AddThreadTarget(threadTarget);
+                    *pfIOPS = (wcscmp((wchar_t *)bstrText, L"IOPS") == 0);
+                    SysFreeString(bstrText);
                 }
             }
         }
@@ -1209,14 +1541,336 @@ HRESULT XmlProfileParser::_ParseThreadTargets(IXMLDOMNode *pXmlNode, Target *pTa
     return hr;
 }
 
-HRESULT XmlProfileParser::_ParseThreadTarget(IXMLDOMNode *pXmlNode, ThreadTarget *pThreadTarget)
+HRESULT XmlProfileParser::_ParseArrivalRate(IXMLDOMNode *pXmlNode, Target *pTarget)
 {
-    UINT32 ulThread;
-    HRESULT hr = _GetUINT32(pXmlNode, "Thread", &ulThread);
+    CComPtr<IXMLDOMNode> spNode = nullptr;
+    CComVariant query("ArrivalRate");
+    HRESULT hr = pXmlNode->selectSingleNode(query.bstrVal, &spNode);
     if (SUCCEEDED(hr) && (hr != S_FALSE))
     {
-        pThreadTarget->SetThread(ulThread);
-    }
+        // get value
+        UINT32 value = 0;
+
+        BSTR bstrText;
+        hr = spNode->get_text(&bstrText);
+        if (SUCCEEDED(hr))
+        {
+            value = (UINT32) _wtoi64((wchar_t *)bstrText);  // XSD constrains s.t. cast is safe
+            SysFreeString(bstrText);
+        }
+        else
+        {
+            return hr;
+        }
+
+        // get distribution - fixed default
+        bool isPoisson = false;
+
+        CComPtr<IXMLDOMNamedNodeMap> spNamedNodeMap = nullptr;
+        CComBSTR attr("distribution");
+        hr = spNode->get_attributes(&spNamedNodeMap);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            CComPtr<IXMLDOMNode> spAttrNode = nullptr;
+            HRESULT hr = spNamedNodeMap->getNamedItem(attr, &spAttrNode);
+            if (SUCCEEDED(hr) && (hr != S_FALSE))
+            {
+                BSTR bstrText;
+                hr = spAttrNode->get_text(&bstrText);
+                if (SUCCEEDED(hr))
+                {
+                    isPoisson = !wcscmp((wchar_t *)bstrText, L"Poisson");
+                    SysFreeString(bstrText);
+                }
+            }
+        }
+
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetArrivalRate(value);
+            pTarget->SetPoissonArrivals(isPoisson);
+        }
+    }
+    return hr;
+}
+
+HRESULT XmlProfileParser::_ParseReportInterval(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan)
+{
+    CComPtr<IXMLDOMNode> spNode = nullptr;
+    CComVariant query("ReportInterval");
+    HRESULT hr = pXmlNode->selectSingleNode(query.bstrVal, &spNode);
+    if (SUCCEEDED(hr) && (hr != S_FALSE))
+    {
+        // get value
+        UINT32 value = 0;
+
+        BSTR bstrText;
+        hr = spNode->get_text(&bstrText);
+        if (SUCCEEDED(hr))
+        {
+            value = (UINT32) _wtoi64((wchar_t *)bstrText);  // XSD constrains s.t. cast is safe
+            SysFreeString(bstrText);
+        }
+        else
+        {
+            return hr;
+        }
+
+        // get format - text default
+        bool isJson = false;
+
+        CComPtr<IXMLDOMNamedNodeMap> spNamedNodeMap = nullptr;
+        CComBSTR attr("format");
+        hr = spNode->get_attributes(&spNamedNodeMap);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            CComPtr<IXMLDOMNode> spAttrNode = nullptr;
+            HRESULT hr = spNamedNodeMap->getNamedItem(attr, &spAttrNode);
+            if (SUCCEEDED(hr) && (hr != S_FALSE))
+            {
+                BSTR bstrText;
+                hr = spAttrNode->get_text(&bstrText);
+                if (SUCCEEDED(hr))
+                {
+                    isJson = !wcscmp((wchar_t *)bstrText, L"Json");
+                    SysFreeString(bstrText);
+                }
+            }
+        }
+
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTimeSpan->SetReportIntervalInMilliseconds(value);
+            pTimeSpan->SetReportIntervalJson(isJson);
+        }
+    }
+    return hr;
+}
+
+HRESULT XmlProfileParser::_ParseSweep(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan)
+{
+    struct {
+        const char *pszQuery;
+        void (TimeSpan::*pfnSet)(const vector<DWORD>&);
+    } dimensions[] = {
+        { "Sweep/RequestCounts", &TimeSpan::SetSweepRequestCounts },
+        { "Sweep/ThreadCounts", &TimeSpan::SetSweepThreadCounts },
+        { "Sweep/BlockSizes", &TimeSpan::SetSweepBlockSizes }
+    };
+
+    HRESULT hr = S_OK;
+    for (size_t i = 0; SUCCEEDED(hr) && i < _countof(dimensions); i++)
+    {
+        // XSD constrains the list to positive 32 bit integers
+        string sPoints;
+        hr = _GetString(pXmlNode, dimensions[i].pszQuery, &sPoints);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            vector<DWORD> vdwPoints;
+            const char *pszNext = sPoints.c_str();
+            for (;;)
+            {
+                char *pszEnd = nullptr;
+                ULONG ulPoint = strtoul(pszNext, &pszEnd, 10);
+                if (pszEnd == pszNext)
+                {
+                    break;
+                }
+                vdwPoints.push_back(ulPoint);
+                pszNext = pszEnd;
+            }
+
+            (pTimeSpan->*dimensions[i].pfnSet)(vdwPoints);
+        }
+    }
+
+    // absent dimensions are not an error
+    return SUCCEEDED(hr) ? S_OK : hr;
+}
+
+HRESULT XmlProfileParser::_ParsePhases(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan)
+{
+    CComPtr<IXMLDOMNodeList> spNodeList = nullptr;
+    CComVariant query("Phases/Phase");
+    HRESULT hr = pXmlNode->selectNodes(query.bstrVal, &spNodeList);
+    if (SUCCEEDED(hr))
+    {
+        long cNodes;
+        hr = spNodeList->get_length(&cNodes);
+        for (int i = 0; SUCCEEDED(hr) && (i < cNodes); i++)
+        {
+            CComPtr<IXMLDOMNode> spNode = nullptr;
+            hr = spNodeList->get_item(i, &spNode);
+            if (FAILED(hr))
+            {
+                break;
+            }
+
+            LoadPhase phase;
+
+            UINT32 ulValue;
+            hr = _GetUINT32(spNode, "DurationMilliseconds", &ulValue);
+            if (SUCCEEDED(hr) && (hr != S_FALSE))
+            {
+                phase.SetDurationInMilliseconds(ulValue);
+            }
+
+            if (SUCCEEDED(hr))
+            {
+                string sShape;
+                hr = _GetString(spNode, "Shape", &sShape);
+                if (SUCCEEDED(hr) && (hr != S_FALSE))
+                {
+                    if (sShape == "Ramp")
+                    {
+                        phase.SetShape(PhaseShape::Ramp);
+                    }
+                    else if (sShape == "Sine")
+                    {
+                        phase.SetShape(PhaseShape::Sine);
+                    }
+                    else if (sShape == "Square")
+                    {
+                        phase.SetShape(PhaseShape::Square);
+                    }
+                }
+            }
+
+            if (SUCCEEDED(hr))
+            {
+                hr = _GetUINT32(spNode, "PeriodMilliseconds", &ulValue);
+                if (SUCCEEDED(hr) && (hr != S_FALSE))
+                {
+                    phase.SetPeriodInMilliseconds(ulValue);
+                }
+            }
+
+            if (SUCCEEDED(hr))
+            {
+                hr = _GetUINT32(spNode, "Duty", &ulValue);
+                if (SUCCEEDED(hr) && (hr != S_FALSE))
+                {
+                    phase.SetDutyPercent(ulValue);
+                }
+            }
+
+            // each setting states both ends; a constant phase has them equal
+            struct {
+                const char *pszFrom;
+                const char *pszTo;
+                void (LoadPhase::*pfnSet)(UINT32, UINT32);
+            } settings[] = {
+                { "IOPS/From", "IOPS/To", &LoadPhase::SetIOPS },
+                { "WriteRatio/From", "WriteRatio/To", &LoadPhase::SetWriteRatio },
+                { "QueueDepth/From", "QueueDepth/To", &LoadPhase::SetQueueDepth }
+            };
+
+            for (size_t iSetting = 0; SUCCEEDED(hr) && iSetting < _countof(settings); iSetting++)
+            {
+                UINT32 ulFrom;
+                hr = _GetUINT32(spNode, settings[iSetting].pszFrom, &ulFrom);
+                if (SUCCEEDED(hr) && (hr != S_FALSE))
+                {
+                    UINT32 ulTo;
+                    hr = _GetUINT32(spNode, settings[iSetting].pszTo, &ulTo);
+                    if (SUCCEEDED(hr) && (hr != S_FALSE))
+                    {
+                        (phase.*settings[iSetting].pfnSet)(ulFrom, ulTo);
+                    }
+                }
+            }
+
+            if (SUCCEEDED(hr))
+            {
+                pTimeSpan->AddPhase(phase);
+            }
+        }
+    }
+
+    // absent phases are not an error
+    return SUCCEEDED(hr) ? S_OK : hr;
+}
+
+HRESULT XmlProfileParser::_ParseTrace(IXMLDOMNode *pXmlNode, Target *pTarget)
+{
+    CComPtr<IXMLDOMNode> spNode = nullptr;
+    CComVariant query("Trace");
+    HRESULT hr = pXmlNode->selectSingleNode(query.bstrVal, &spNode);
+    if (SUCCEEDED(hr) && (hr != S_FALSE))
+    {
+        string sPath;
+        hr = _GetString(pXmlNode, "Trace", &sPath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // get pacing - timestamps default
+        bool fTimestamps = true;
+
+        CComPtr<IXMLDOMNamedNodeMap> spNamedNodeMap = nullptr;
+        CComBSTR attr("pacing");
+        hr = spNode->get_attributes(&spNamedNodeMap);
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            CComPtr<IXMLDOMNode> spAttrNode = nullptr;
+            HRESULT hr = spNamedNodeMap->getNamedItem(attr, &spAttrNode);
+            if (SUCCEEDED(hr) && (hr != S_FALSE))
+            {
+                BSTR bstrText;
+                hr = spAttrNode->get_text(&bstrText);
+                if (SUCCEEDED(hr))
+                {
+                    fTimestamps = !!wcscmp((wchar_t *)bstrText, L"Fast");
+                    SysFreeString(bstrText);
+                }
+            }
+        }
+
+        if (SUCCEEDED(hr) && (hr != S_FALSE))
+        {
+            pTarget->SetTracePath(sPath);
+            pTarget->SetTraceTimestamps(fTimestamps);
+        }
+    }
+    return hr;
+}
+
+HRESULT XmlProfileParser::_ParseThreadTargets(IXMLDOMNode *pXmlNode, Target *pTarget)
+{
+    CComVariant query("ThreadTargets/ThreadTarget");
+    CComPtr<IXMLDOMNodeList> spNodeList = nullptr;
+    HRESULT hr = pXmlNode->selectNodes(query.bstrVal, &spNodeList);
+    if (SUCCEEDED(hr))
+    {
+        long cNodes;
+        hr = spNodeList->get_length(&cNodes);
+        if (SUCCEEDED(hr))
+        {
+            for (int i = 0; i < cNodes; i++)
+            {
+                CComPtr<IXMLDOMNode> spNode = nullptr;
+                hr = spNodeList->get_item(i, &spNode);
+                if (SUCCEEDED(hr))
+                {
+                    ThreadTarget threadTarget;
+                    _ParseThreadTarget(spNode, &threadTarget);
+                    pTarget->AddThreadTarget(threadTarget);
+                }
+            }
+        }
+    }
+    return hr;
+}
+
+HRESULT XmlProfileParser::_ParseThreadTarget(IXMLDOMNode *pXmlNode, ThreadTarget *pThreadTarget)
+{
+    UINT32 ulThread;
+    HRESULT hr = _GetUINT32(pXmlNode, "Thread", &ulThread);
+    if (SUCCEEDED(hr) && (hr != S_FALSE))
+    {
+        pThreadTarget->SetThread(ulThread);
+    }
 
     if (SUCCEEDED(hr))
     {
@@ -1238,6 +1892,15 @@ struct {
     { "Distribution/Percent/Range",     DistributionType::Percent }
 };
 
+struct {
+    char* xPath;
+    char* xPathScatter;
+    DistributionType t;
+} skewedDistributionTypes[] = {
+    { "Distribution/Zipf",              "Distribution/Zipf/@scatter",       DistributionType::Zipf },
+    { "Distribution/Pareto",            "Distribution/Pareto/@scatter",     DistributionType::Pareto }
+};
+
 HRESULT XmlProfileParser::_ParseDistribution(IXMLDOMNode *pXmlNode, Target *pTarget)
 {
     HRESULT hr = S_OK;
@@ -1329,6 +1992,26 @@ HRESULT XmlProfileParser::_ParseDistribution(IXMLDOMNode *pXmlNode, Target *pTar
         }
     }
 
+    // skewed distributions are stated by a single parameter; XSD allows only one type
+    for (auto& type : skewedDistributionTypes)
+    {
+        if (SUCCEEDED(hr))
+        {
+            double lfSkew;
+            hr = _GetDouble(pXmlNode, type.xPath, &lfSkew);
+            if (SUCCEEDED(hr) && (hr != S_FALSE))
+            {
+                bool fScatter = false;
+                hr = _GetBool(pXmlNode, type.xPathScatter, &fScatter);
+                if (SUCCEEDED(hr))
+                {
+                    pTarget->SetDistributionSkew(type.t, lfSkew, fScatter);
+                }
+                return hr;
+            }
+        }
+    }
+
     return hr;
 }
 
@@ -1371,6 +2054,59 @@ HRESULT XmlProfileParser::_ParseAffinityAssignment(IXMLDOMNode *pXmlNode, TimeSp
     return hr;
 }
 
+HRESULT XmlProfileParser::_ParseBlockSizeMix(IXMLDOMNode *pXmlNode, Target *pTarget)
+{
+    CComPtr<IXMLDOMNodeList> spNodeList = nullptr;
+    CComVariant query("BlockSizeMix/BlockSize");
+    vector<BlockSizeWeight> vMix;
+
+    HRESULT hr = pXmlNode->selectNodes(query.bstrVal, &spNodeList);
+    if (SUCCEEDED(hr))
+    {
+        long cNodes;
+        hr = spNodeList->get_length(&cNodes);
+        if (SUCCEEDED(hr))
+        {
+            for (int i = 0; i < cNodes && SUCCEEDED(hr); i++)
+            {
+                CComPtr<IXMLDOMNode> spNode = nullptr;
+                hr = spNodeList->get_item(i, &spNode);
+                if (SUCCEEDED(hr))
+                {
+                    UINT32 ulWeight = 0;
+                    BSTR bstrText;
+                    hr = _GetUINT32Attr(spNode, "Weight", &ulWeight);
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = spNode->get_text(&bstrText);
+                    }
+                    if (SUCCEEDED(hr))
+                    {
+                        DWORD dwBlockSize = _wtoi((wchar_t *)bstrText);  // TODO: make sure it works on large unsigned ints
+                        SysFreeString(bstrText);
+
+                        if (dwBlockSize == 0 || ulWeight == 0)
+                        {
+                            fprintf(stderr, "ERROR: profile specifies a block size mix entry of zero size or weight\n");
+                            hr = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+                        }
+                        else
+                        {
+                            vMix.push_back({ dwBlockSize, ulWeight });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (SUCCEEDED(hr) && vMix.size())
+    {
+        pTarget->SetBlockSizeMix(vMix);
+    }
+    return hr;
+}
+
 // Group aware affinity assignment. This is the only form emitted by the XML result parser.
 
 HRESULT XmlProfileParser::_ParseAffinityGroupAssignment(IXMLDOMNode *pXmlNode, TimeSpan *pTimeSpan)
@@ -1502,6 +2238,24 @@ HRESULT XmlProfileParser::_GetUINT64(IXMLDOMNode *pXmlNode, const char *pszQuery
     return hr;
 }
 
+HRESULT XmlProfileParser::_GetDouble(IXMLDOMNode *pXmlNode, const char *pszQuery, double *plfValue) const
+{
+    CComPtr<IXMLDOMNode> spNode = nullptr;
+    CComVariant query(pszQuery);
+    HRESULT hr = pXmlNode->selectSingleNode(query.bstrVal, &spNode);
+    if (SUCCEEDED(hr) && (hr != S_FALSE))
+    {
+        BSTR bstrText;
+        hr = spNode->get_text(&bstrText);
+        if (SUCCEEDED(hr))
+        {
+            *plfValue = wcstod((wchar_t *)bstrText, nullptr);
+        }
+        SysFreeString(bstrText);
+    }
+    return hr;
+}
+
 HRESULT XmlProfileParser::_GetDWORD(IXMLDOMNode *pXmlNode, const char *pszQuery, DWORD *pdwValue) const
 {
     UINT32 value = 0;
@@ -27,7 +27,7 @@ SOFTWARE.
 
 */
 
-#include "xmlresultparser.h"
+#include "XmlResultParser.h"
 
 // TODO: refactor to a single function shared with the ResultParser
 char printBuffer[4096] = {};
@@ -83,13 +83,38 @@ void XmlResultParser::_PrintTargetResults(const TargetResults& results)
     // TODO: results.writeBucketizer;
 
     _Print("<Path>%s</Path>\n", results.sPath.c_str());
-    _Print("<BytesCount>%I64u</BytesCount>\n", results.ullBytesCount);
-    _Print("<FileSize>%I64u</FileSize>\n", results.ullFileSize);
-    _Print("<IOCount>%I64u</IOCount>\n", results.ullIOCount);
-    _Print("<ReadBytes>%I64u</ReadBytes>\n", results.ullReadBytesCount);
-    _Print("<ReadCount>%I64u</ReadCount>\n", results.ullReadIOCount);
-    _Print("<WriteBytes>%I64u</WriteBytes>\n", results.ullWriteBytesCount);
-    _Print("<WriteCount>%I64u</WriteCount>\n", results.ullWriteIOCount);
+    _Print("<BytesCount>%llu</BytesCount>\n", results.ullBytesCount);
+    _Print("<FileSize>%llu</FileSize>\n", results.ullFileSize);
+    _Print("<IOCount>%llu</IOCount>\n", results.ullIOCount);
+    _Print("<ReadBytes>%llu</ReadBytes>\n", results.ullReadBytesCount);
+    _Print("<ReadCount>%llu</ReadCount>\n", results.ullReadIOCount);
+    _Print("<WriteBytes>%llu</WriteBytes>\n", results.ullWriteBytesCount);
+    _Print("<WriteCount>%llu</WriteCount>\n", results.ullWriteIOCount);
+
+    if (results.ullFlushIOCount > 0)
+    {
+        _Print("<FlushCount>%llu</FlushCount>\n", results.ullFlushIOCount);
+    }
+
+    if (results.ullTrimIOCount > 0)
+    {
+        _Print("<TrimBytes>%llu</TrimBytes>\n", results.ullTrimBytesCount);
+        _Print("<TrimCount>%llu</TrimCount>\n", results.ullTrimIOCount);
+    }
+
+    if (results.ullFuaWriteIOCount > 0)
+    {
+        _Print("<FuaWriteBytes>%llu</FuaWriteBytes>\n", results.ullFuaWriteBytesCount);
+        _Print("<FuaWriteCount>%llu</FuaWriteCount>\n", results.ullFuaWriteIOCount);
+    }
+
+    if (results.ullVerifiedCount > 0 || results.ullVerifyErrorCount > 0)
+    {
+        _PrintInc("<DataVerification>\n");
+        _Print("<CheckedUnits>%llu</CheckedUnits>\n", results.ullVerifiedCount);
+        _Print("<Failures>%llu</Failures>\n", results.ullVerifyErrorCount);
+        _PrintDec("</DataVerification>\n");
+    }
 
     if (results.vDistributionRange.size())
     {
@@ -106,16 +131,91 @@ void XmlResultParser::_PrintTargetResults(const TargetResults& results)
         {
             if (r._dst.first != expectBase)
             {
-                _Print("<Range IO=\"%u\">%I64u</Range>\n", 0, r._dst.first - expectBase);
+                _Print("<Range IO=\"%u\">%llu</Range>\n", 0, r._dst.first - expectBase);
             }
 
-            _Print("<Range IO=\"%u\">%I64u</Range>\n", r._span, r._dst.second);
+            _Print("<Range IO=\"%u\">%llu</Range>\n", r._span, r._dst.second);
             expectBase = r._dst.first + r._dst.second;
         }
 
         _PrintDec("</Absolute>\n");
         _PrintDec("</Distribution>\n");
     }
+
+    if (results.vBlockSizeResults.size())
+    {
+        _PrintInc("<BlockSizes>\n");
+        for (const auto& b : results.vBlockSizeResults)
+        {
+            _PrintInc("<BlockSize>\n");
+            _Print("<Bytes>%u</Bytes>\n", b.dwBlockSize);
+            _Print("<ReadCount>%llu</ReadCount>\n", b.ullReadIOCount);
+            _Print("<WriteCount>%llu</WriteCount>\n", b.ullWriteIOCount);
+            if (b.readLatencyHistogram.GetSampleSize() > 0)
+            {
+                _Print("<AverageReadLatencyMilliseconds>%.3f</AverageReadLatencyMilliseconds>\n", b.readLatencyHistogram.GetAvg() / 1000);
+            }
+            if (b.writeLatencyHistogram.GetSampleSize() > 0)
+            {
+                _Print("<AverageWriteLatencyMilliseconds>%.3f</AverageWriteLatencyMilliseconds>\n", b.writeLatencyHistogram.GetAvg() / 1000);
+            }
+            _PrintDec("</BlockSize>\n");
+        }
+        _PrintDec("</BlockSizes>\n");
+    }
+
+    if (results.ullMetadataIOCount > 0 || any_of(results.vMetadataResults.begin(), results.vMetadataResults.end(), [](const MetadataResults& m) { return m.ullCount > 0; }))
+    {
+        _PrintInc("<MetadataOperations>\n");
+        _Print("<Count>%llu</Count>\n", results.ullMetadataIOCount);
+        for (size_t i = 0; i < results.vMetadataResults.size(); i++)
+        {
+            const MetadataResults& m = results.vMetadataResults[i];
+
+            if (m.ullCount == 0)
+            {
+                continue;
+            }
+
+            _PrintInc("<Operation>\n");
+            _Print("<Type>%s</Type>\n", MetadataOpName(static_cast<MetadataOp>(i)));
+            _Print("<Count>%llu</Count>\n", m.ullCount);
+            if (m.latencyHistogram.GetSampleSize() > 0)
+            {
+                _Print("<AverageLatencyMilliseconds>%.3f</AverageLatencyMilliseconds>\n", m.latencyHistogram.GetAvg() / 1000);
+                _Print("<LatencyStdev>%.3f</LatencyStdev>\n", m.latencyHistogram.GetStandardDeviation() / 1000);
+                _Print("<Percentile99Milliseconds>%.3f</Percentile99Milliseconds>\n", m.latencyHistogram.GetPercentile(0.99) / 1000);
+            }
+            _PrintDec("</Operation>\n");
+        }
+        _PrintDec("</MetadataOperations>\n");
+    }
+
+    if (results.vPhaseResults.size())
+    {
+        _PrintInc("<Phases>\n");
+        for (size_t i = 0; i < results.vPhaseResults.size(); i++)
+        {
+            const PhaseResults& phase = results.vPhaseResults[i];
+
+            _PrintInc("<Phase>\n");
+            _Print("<Index>%u</Index>\n", (UINT32)i + 1);
+            _Print("<ReadBytes>%llu</ReadBytes>\n", phase.ullReadBytesCount);
+            _Print("<ReadCount>%llu</ReadCount>\n", phase.ullReadIOCount);
+            _Print("<WriteBytes>%llu</WriteBytes>\n", phase.ullWriteBytesCount);
+            _Print("<WriteCount>%llu</WriteCount>\n", phase.ullWriteIOCount);
+            if (phase.readLatencyHistogram.GetSampleSize() > 0)
+            {
+                _Print("<AverageReadLatencyMilliseconds>%.3f</AverageReadLatencyMilliseconds>\n", phase.readLatencyHistogram.GetAvg() / 1000);
+            }
+            if (phase.writeLatencyHistogram.GetSampleSize() > 0)
+            {
+                _Print("<AverageWriteLatencyMilliseconds>%.3f</AverageWriteLatencyMilliseconds>\n", phase.writeLatencyHistogram.GetAvg() / 1000);
+            }
+            _PrintDec("</Phase>\n");
+        }
+        _PrintDec("</Phases>\n");
+    }
 }
 
 void XmlResultParser::_PrintTargetLatency(const TargetResults& results)
@@ -130,9 +230,26 @@ void XmlResultParser::_PrintTargetLatency(const TargetResults& results)
         _Print("<AverageWriteLatencyMilliseconds>%.3f</AverageWriteLatencyMilliseconds>\n", results.writeLatencyHistogram.GetAvg() / 1000);
         _Print("<WriteLatencyStdev>%.3f</WriteLatencyStdev>\n", results.writeLatencyHistogram.GetStandardDeviation() / 1000);
     }
+    if (results.flushLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<AverageFlushLatencyMilliseconds>%.3f</AverageFlushLatencyMilliseconds>\n", results.flushLatencyHistogram.GetAvg() / 1000);
+        _Print("<FlushLatencyStdev>%.3f</FlushLatencyStdev>\n", results.flushLatencyHistogram.GetStandardDeviation() / 1000);
+    }
+    if (results.trimLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<AverageTrimLatencyMilliseconds>%.3f</AverageTrimLatencyMilliseconds>\n", results.trimLatencyHistogram.GetAvg() / 1000);
+        _Print("<TrimLatencyStdev>%.3f</TrimLatencyStdev>\n", results.trimLatencyHistogram.GetStandardDeviation() / 1000);
+    }
+    if (results.fuaWriteLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<AverageFuaWriteLatencyMilliseconds>%.3f</AverageFuaWriteLatencyMilliseconds>\n", results.fuaWriteLatencyHistogram.GetAvg() / 1000);
+        _Print("<FuaWriteLatencyStdev>%.3f</FuaWriteLatencyStdev>\n", results.fuaWriteLatencyHistogram.GetStandardDeviation() / 1000);
+    }
     Histogram<float> totalLatencyHistogram;
     totalLatencyHistogram.Merge(results.readLatencyHistogram);
     totalLatencyHistogram.Merge(results.writeLatencyHistogram);
+    totalLatencyHistogram.Merge(results.flushLatencyHistogram);
+    totalLatencyHistogram.Merge(results.trimLatencyHistogram);
     if (totalLatencyHistogram.GetSampleSize() > 0)
     {
         _Print("<AverageLatencyMilliseconds>%.3f</AverageLatencyMilliseconds>\n", totalLatencyHistogram.GetAvg() / 1000);
@@ -188,71 +305,71 @@ void XmlResultParser::_PrintETW(struct ETWMask ETWMask, struct ETWEventCounters
     if (ETWMask.bDiskIO)
     {
         _PrintInc("<DiskIO>\n");
-        _Print("<Read>%I64u</Read>\n", EtwEventCounters.ullIORead);
-        _Print("<Write>%I64u</Write>\n", EtwEventCounters.ullIOWrite);
+        _Print("<Read>%llu</Read>\n", EtwEventCounters.ullIORead);
+        _Print("<Write>%llu</Write>\n", EtwEventCounters.ullIOWrite);
         _PrintDec("</DiskIO>\n");
     }
     if (ETWMask.bImageLoad)
     {
-        _Print("<LoadImage>%I64u</LoadImage>\n", EtwEventCounters.ullImageLoad);
+        _Print("<LoadImage>%llu</LoadImage>\n", EtwEventCounters.ullImageLoad);
     }
     if (ETWMask.bMemoryPageFaults)
     {
         _PrintInc("<MemoryPageFaults>\n");
-        _Print("<CopyOnWrite>%I64u</CopyOnWrite>\n", EtwEventCounters.ullMMCopyOnWrite);
-        _Print("<DemandZeroFault>%I64u</DemandZeroFault>\n", EtwEventCounters.ullMMDemandZeroFault);
-        _Print("<GuardPageFault>%I64u</GuardPageFault>\n", EtwEventCounters.ullMMGuardPageFault);
-        _Print("<HardPageFault>%I64u</HardPageFault>\n", EtwEventCounters.ullMMHardPageFault);
-        _Print("<TransitionFault>%I64u</TransitionFault>\n", EtwEventCounters.ullMMTransitionFault);
+        _Print("<CopyOnWrite>%llu</CopyOnWrite>\n", EtwEventCounters.ullMMCopyOnWrite);
+        _Print("<DemandZeroFault>%llu</DemandZeroFault>\n", EtwEventCounters.ullMMDemandZeroFault);
+        _Print("<GuardPageFault>%llu</GuardPageFault>\n", EtwEventCounters.ullMMGuardPageFault);
+        _Print("<HardPageFault>%llu</HardPageFault>\n", EtwEventCounters.ullMMHardPageFault);
+        _Print("<TransitionFault>%llu</TransitionFault>\n", EtwEventCounters.ullMMTransitionFault);
         _PrintDec("</MemoryPageFaults>\n");
     }
     if (ETWMask.bMemoryHardFaults && !ETWMask.bMemoryPageFaults)
     {
-        _Print("<HardPageFault>%I64u</HardPageFault>\n", EtwEventCounters.ullMMHardPageFault);
+        _Print("<HardPageFault>%llu</HardPageFault>\n", EtwEventCounters.ullMMHardPageFault);
     }
     if (ETWMask.bNetwork)
     {
         _PrintInc("<Network>\n");
-        _Print("<Accept>%I64u</Accept>\n", EtwEventCounters.ullNetAccept);
-        _Print("<Connect>%I64u</Connect>\n", EtwEventCounters.ullNetConnect);
-        _Print("<Disconnect>%I64u</Disconnect>\n", EtwEventCounters.ullNetDisconnect);
-        _Print("<Reconnect>%I64u</Reconnect>\n", EtwEventCounters.ullNetReconnect);
-        _Print("<Retransmit>%I64u</Retransmit>\n", EtwEventCounters.ullNetRetransmit);
-        _Print("<TCPIPSend>%I64u</TCPIPSend>\n", EtwEventCounters.ullNetTcpSend);
-        _Print("<TCPIPReceive>%I64u</TCPIPReceive>\n", EtwEventCounters.ullNetTcpReceive);
-        _Print("<UDPIPSend>%I64u</UDPIPSend>\n", EtwEventCounters.ullNetUdpSend);
-        _Print("<UDPIPReceive>%I64u</UDPIPReceive>\n", EtwEventCounters.ullNetUdpReceive);
+        _Print("<Accept>%llu</Accept>\n", EtwEventCounters.ullNetAccept);
+        _Print("<Connect>%llu</Connect>\n", EtwEventCounters.ullNetConnect);
+        _Print("<Disconnect>%llu</Disconnect>\n", EtwEventCounters.ullNetDisconnect);
+        _Print("<Reconnect>%llu</Reconnect>\n", EtwEventCounters.ullNetReconnect);
+        _Print("<Retransmit>%llu</Retransmit>\n", EtwEventCounters.ullNetRetransmit);
+        _Print("<TCPIPSend>%llu</TCPIPSend>\n", EtwEventCounters.ullNetTcpSend);
+        _Print("<TCPIPReceive>%llu</TCPIPReceive>\n", EtwEventCounters.ullNetTcpReceive);
+        _Print("<UDPIPSend>%llu</UDPIPSend>\n", EtwEventCounters.ullNetUdpSend);
+        _Print("<UDPIPReceive>%llu</UDPIPReceive>\n", EtwEventCounters.ullNetUdpReceive);
         _PrintDec("</Network>\n");
     }
     if (ETWMask.bProcess)
     {
         _PrintInc("<Process>\n");
-        _Print("<Start>%I64u</Start>\n", EtwEventCounters.ullProcessStart);
-        _Print("<End>%I64u</End>\n", EtwEventCounters.ullProcessEnd);
+        _Print("<Start>%llu</Start>\n", EtwEventCounters.ullProcessStart);
+        _Print("<End>%llu</End>\n", EtwEventCounters.ullProcessEnd);
         _PrintDec("</Process>\n");
     }
     if (ETWMask.bRegistry)
     {
         _PrintInc("<Registry>\n");
-        _Print("<NtCreateKey>%I64u</NtCreateKey>\n", EtwEventCounters.ullRegCreate);
-        _Print("<NtDeleteKey>%I64u</NtDeleteKey>\n", EtwEventCounters.ullRegDelete);
-        _Print("<NtDeleteValueKey>%I64u</NtDeleteValueKey>\n", EtwEventCounters.ullRegDeleteValue);
-        _Print("<NtEnumerateKey>%I64u</NtEnumerateKey>\n", EtwEventCounters.ullRegEnumerateKey);
-        _Print("<NtEnumerateValueKey>%I64u</NtEnumerateValueKey>\n", EtwEventCounters.ullRegEnumerateValueKey);
-        _Print("<NtFlushKey>%I64u</NtFlushKey>\n", EtwEventCounters.ullRegFlush);
-        _Print("<NtOpenKey>%I64u</NtOpenKey>\n", EtwEventCounters.ullRegOpen);
-        _Print("<NtQueryKey>%I64u</NtQueryKey>\n", EtwEventCounters.ullRegQuery);
-        _Print("<NtQueryMultipleValueKey>%I64u</NtQueryMultipleValueKey>\n", EtwEventCounters.ullRegQueryMultipleValue);
-        _Print("<NtQueryValueKey>%I64u</NtQueryValueKey>\n", EtwEventCounters.ullRegQueryValue);
-        _Print("<NtSetInformationKey>%I64u</NtSetInformationKey>\n", EtwEventCounters.ullRegSetInformation);
-        _Print("<NtSetValueKey>%I64u</NtSetValueKey>\n", EtwEventCounters.ullRegSetValue);
+        _Print("<NtCreateKey>%llu</NtCreateKey>\n", EtwEventCounters.ullRegCreate);
+        _Print("<NtDeleteKey>%llu</NtDeleteKey>\n", EtwEventCounters.ullRegDelete);
+        _Print("<NtDeleteValueKey>%llu</NtDeleteValueKey>\n", EtwEventCounters.ullRegDeleteValue);
+        _Print("<NtEnumerateKey>%llu</NtEnumerateKey>\n", EtwEventCounters.ullRegEnumerateKey);
+        _Print("<NtEnumerateValueKey>%llu</NtEnumerateValueKey>\n", EtwEventCounters.ullRegEnumerateValueKey);
+        _Print("<NtFlushKey>%llu</NtFlushKey>\n", EtwEventCounters.ullRegFlush);
+        _Print("<NtOpenKey>%llu</NtOpenKey>\n", EtwEventCounters.ullRegOpen);
+        _Print("<NtQueryKey>%llu</NtQueryKey>\n", EtwEventCounters.ullRegQuery);
+        _Print("<NtQueryMultipleValueKey>%llu</NtQueryMultipleValueKey>\n", EtwEventCounters.ullRegQueryMultipleValue);
+        _Print("<NtQueryValueKey>%llu</NtQueryValueKey>\n", EtwEventCounters.ullRegQueryValue);
+        _Print("<NtSetInformationKey>%llu</NtSetInformationKey>\n", EtwEventCounters.ullRegSetInformation);
+        _Print("<NtSetValueKey>%llu</NtSetValueKey>\n", EtwEventCounters.ullRegSetValue);
         _PrintDec("</Registry>\n");
     }
     if (ETWMask.bThread)
     {
         _PrintInc("<Thread>\n");
-        _Print("<Start>%I64u</Start>\n", EtwEventCounters.ullThreadStart);
-        _Print("<End>%I64u</End>\n", EtwEventCounters.ullThreadEnd);
+        _Print("<Start>%llu</Start>\n", EtwEventCounters.ullThreadStart);
+        _Print("<End>%llu</End>\n", EtwEventCounters.ullThreadEnd);
         _PrintDec("</Thread>\n");
     }
     _PrintDec("</ETW>\n");
@@ -320,6 +437,27 @@ void XmlResultParser::_PrintCpuUtilization(const Results& results, const SystemI
     _Print("<IdlePercent>%.2f</IdlePercent>\n", totalIdleTime / procCount);
     _PrintDec("</Average>\n");
 
+    // io_uring submission queue pollers, only present if used
+    double fTime = PerfTimer::PerfTimeToSeconds(results.ullTimeCount);
+    for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
+    {
+        const ThreadResults& threadResults = results.vThreadResults[iThread];
+        if (threadResults.ulSqPollThreadId == 0)
+        {
+            continue;
+        }
+
+        _PrintInc("<SqPoll>\n");
+        _Print("<Thread>%u</Thread>\n", iThread);
+        if (threadResults.fSqPollAffinity)
+        {
+            _Print("<Group>%d</Group>\n", threadResults.wSqPollGroup);
+            _Print("<Id>%d</Id>\n", threadResults.bSqPollProc);
+        }
+        _Print("<UsagePercent>%.2f</UsagePercent>\n", (fTime > 0) ? (100.0 * threadResults.ullSqPollTime / 10000000.0 / fTime) : 0);
+        _PrintDec("</SqPoll>\n");
+    }
+
     _PrintDec("</CpuUtilization>\n");
 }
 
@@ -394,6 +532,9 @@ void XmlResultParser::_PrintLatencyPercentiles(const Results& results)
 {
     Histogram<float> readLatencyHistogram;
     Histogram<float> writeLatencyHistogram;
+    Histogram<float> flushLatencyHistogram;
+    Histogram<float> trimLatencyHistogram;
+    Histogram<float> fuaWriteLatencyHistogram;
     Histogram<float> totalLatencyHistogram;
 
     for (const auto& thread : results.vThreadResults)
@@ -404,8 +545,16 @@ void XmlResultParser::_PrintLatencyPercentiles(const Results& results)
 
             writeLatencyHistogram.Merge(target.writeLatencyHistogram);
 
+            flushLatencyHistogram.Merge(target.flushLatencyHistogram);
+
+            trimLatencyHistogram.Merge(target.trimLatencyHistogram);
+
+            fuaWriteLatencyHistogram.Merge(target.fuaWriteLatencyHistogram);
+
             totalLatencyHistogram.Merge(target.writeLatencyHistogram);
             totalLatencyHistogram.Merge(target.readLatencyHistogram);
+            totalLatencyHistogram.Merge(target.flushLatencyHistogram);
+            totalLatencyHistogram.Merge(target.trimLatencyHistogram);
         }
     }
 
@@ -424,6 +573,21 @@ void XmlResultParser::_PrintLatencyPercentiles(const Results& results)
         _Print("<AverageWriteMilliseconds>%.3f</AverageWriteMilliseconds>\n", writeLatencyHistogram.GetAvg() / 1000);
         _Print("<WriteLatencyStdev>%.3f</WriteLatencyStdev>\n", writeLatencyHistogram.GetStandardDeviation() / 1000);
     }
+    if (flushLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<AverageFlushMilliseconds>%.3f</AverageFlushMilliseconds>\n", flushLatencyHistogram.GetAvg() / 1000);
+        _Print("<FlushLatencyStdev>%.3f</FlushLatencyStdev>\n", flushLatencyHistogram.GetStandardDeviation() / 1000);
+    }
+    if (trimLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<AverageTrimMilliseconds>%.3f</AverageTrimMilliseconds>\n", trimLatencyHistogram.GetAvg() / 1000);
+        _Print("<TrimLatencyStdev>%.3f</TrimLatencyStdev>\n", trimLatencyHistogram.GetStandardDeviation() / 1000);
+    }
+    if (fuaWriteLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<AverageFuaWriteMilliseconds>%.3f</AverageFuaWriteMilliseconds>\n", fuaWriteLatencyHistogram.GetAvg() / 1000);
+        _Print("<FuaWriteLatencyStdev>%.3f</FuaWriteLatencyStdev>\n", fuaWriteLatencyHistogram.GetStandardDeviation() / 1000);
+    }
     if (totalLatencyHistogram.GetSampleSize() > 0)
     {
         _Print("<AverageTotalMilliseconds>%.3f</AverageTotalMilliseconds>\n", totalLatencyHistogram.GetAvg() / 1000);
@@ -440,6 +604,18 @@ void XmlResultParser::_PrintLatencyPercentiles(const Results& results)
     {
         _Print("<WriteMilliseconds>%.3f</WriteMilliseconds>\n", writeLatencyHistogram.GetMin() / 1000);
     }
+    if (flushLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<FlushMilliseconds>%.3f</FlushMilliseconds>\n", flushLatencyHistogram.GetMin() / 1000);
+    }
+    if (trimLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<TrimMilliseconds>%.3f</TrimMilliseconds>\n", trimLatencyHistogram.GetMin() / 1000);
+    }
+    if (fuaWriteLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<FuaWriteMilliseconds>%.3f</FuaWriteMilliseconds>\n", fuaWriteLatencyHistogram.GetMin() / 1000);
+    }
     if (totalLatencyHistogram.GetSampleSize() > 0)
     {
         _Print("<TotalMilliseconds>%.3f</TotalMilliseconds>\n", totalLatencyHistogram.GetMin() / 1000);
@@ -475,6 +651,18 @@ void XmlResultParser::_PrintLatencyPercentiles(const Results& results)
         {
             _Print("<WriteMilliseconds>%.3f</WriteMilliseconds>\n", writeLatencyHistogram.GetPercentile(p.second / 100) / 1000);
         }
+        if (flushLatencyHistogram.GetSampleSize() > 0)
+        {
+            _Print("<FlushMilliseconds>%.3f</FlushMilliseconds>\n", flushLatencyHistogram.GetPercentile(p.second / 100) / 1000);
+        }
+        if (trimLatencyHistogram.GetSampleSize() > 0)
+        {
+            _Print("<TrimMilliseconds>%.3f</TrimMilliseconds>\n", trimLatencyHistogram.GetPercentile(p.second / 100) / 1000);
+        }
+        if (fuaWriteLatencyHistogram.GetSampleSize() > 0)
+        {
+            _Print("<FuaWriteMilliseconds>%.3f</FuaWriteMilliseconds>\n", fuaWriteLatencyHistogram.GetPercentile(p.second / 100) / 1000);
+        }
         if (totalLatencyHistogram.GetSampleSize() > 0)
         {
             _Print("<TotalMilliseconds>%.3f</TotalMilliseconds>\n", totalLatencyHistogram.GetPercentile(p.second / 100) / 1000);
@@ -492,6 +680,18 @@ void XmlResultParser::_PrintLatencyPercentiles(const Results& results)
     {
         _Print("<WriteMilliseconds>%.3f</WriteMilliseconds>\n", writeLatencyHistogram.GetMax() / 1000);
     }
+    if (flushLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<FlushMilliseconds>%.3f</FlushMilliseconds>\n", flushLatencyHistogram.GetMax() / 1000);
+    }
+    if (trimLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<TrimMilliseconds>%.3f</TrimMilliseconds>\n", trimLatencyHistogram.GetMax() / 1000);
+    }
+    if (fuaWriteLatencyHistogram.GetSampleSize() > 0)
+    {
+        _Print("<FuaWriteMilliseconds>%.3f</FuaWriteMilliseconds>\n", fuaWriteLatencyHistogram.GetMax() / 1000);
+    }
     if (totalLatencyHistogram.GetSampleSize() > 0)
     {
         _Print("<TotalMilliseconds>%.3f</TotalMilliseconds>\n", totalLatencyHistogram.GetMax() / 1000);
@@ -522,6 +722,15 @@ void XmlResultParser::_PrintWaitStats(const ThreadResults &threadResult)
         threadResult.WaitStats.LookasideCompletion[5],
         threadResult.WaitStats.LookasideCompletion[6],
         threadResult.WaitStats.LookasideCompletion[7]);
+    if (threadResult.WaitStats.CompletionTimeCount > 0)
+    {
+        _PrintInc("<CompletionTimeErrorBound>\n");
+        _Print("<Completions>%llu</Completions>\n", threadResult.WaitStats.CompletionTimeCount);
+        _Print("<AverageMicroseconds>%.3f</AverageMicroseconds>\n",
+            PerfTimer::PerfTimeToMicroseconds(threadResult.WaitStats.CompletionTimeError) / threadResult.WaitStats.CompletionTimeCount);
+        _Print("<MaxMicroseconds>%.3f</MaxMicroseconds>\n", PerfTimer::PerfTimeToMicroseconds(threadResult.WaitStats.CompletionTimeErrorMax));
+        _PrintDec("</CompletionTimeErrorBound>\n");
+    }
     _PrintDec("</WaitStatistics>\n");
 }
 
@@ -570,7 +779,7 @@ string XmlResultParser::ParseResults(const Profile& profile, const SystemInforma
                 _PrintETWSessionInfo(results.EtwSessionInfo);
             }
 
-            for (size_t iThread = 0; iThread < results.vThreadResults.size(); iThread++)
+            for (unsigned int iThread = 0; iThread < results.vThreadResults.size(); ++iThread)
             {
                 const ThreadResults& threadResults = results.vThreadResults[iThread];
                 _PrintInc("<Thread>\n");